@@ -0,0 +1,225 @@
+// Vitis/hdmi/iic_bus.c on the bus model: three clock/retimer clients
+// put behind the 0x74 mux (the HDMI drivers sit on the root, this is a
+// board that muxes them), accessed interleaved the way the HDMI bring-up
+// does, against the same accesses with a mux write in front of each.
+// Then an interrupt handler that fires in the middle of a transfer: its
+// synchronous call must come back XST_DEVICE_BUSY and its submitted
+// message must run before the owner returns, and a read-modify-write
+// session must keep the bus against it. Last, another master holds the
+// bus: a transfer waits for it without spending its NACK retries, and
+// fails once the hold outlasts IIC_BUS_IDLE_TIMEOUT_US.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. -I../../../Vitis/hdmi ../../../Vitis/hdmi/iic_bus.c
+//       host_sim/sim_iic.c host_sim/sim_iic_devs.c host_sim/iic_bus_host.c -o iic_bus_host
+//   ./iic_bus_host [iic_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "xparameters.h"
+#include "xiic.h"
+#include "iic_bus.h"
+#include "sim_iic.h"
+
+#define IIC_MUX_ADDRESS         0x74
+#define IDT_ADDRESS             0x7C
+#define DP159_ADDRESS           0x5E
+#define SI5324_ADDRESS          0x68
+#define TRIGGER_ADDRESS         0x20    // Touching it "raises the interrupt"
+
+#define ROUNDS                  200
+
+static IicBus *Bus;
+static IicBusClient Idt;
+static IicBusClient Dp159;
+static IicBusClient Si5324;
+static SimIicDev *IdtDev;
+static SimIicDev *Dp159Dev;
+
+// Handler side of the preemption test
+static int Armed;
+static int IsrSyncStatus;
+static int IsrSubmitStatus;
+static int IsrCallbacks;
+static u8 IsrWrite[2] = { 0x0A, 0x5A };
+static IicBusMsg IsrMsg;
+
+static void isr_done(void *CallBackRef, IicBusMsg *Msg) {
+    (void)CallBackRef;
+    (void)Msg;
+    IsrCallbacks++;
+}
+
+static void isr(void) {
+    u8 Buffer[2] = { 0x0B, 0xA5 };
+
+    IsrSyncStatus = iic_bus_transfer(&Dp159, Buffer, 2, NULL, 0);
+
+    IsrMsg.Client = &Dp159;
+    IsrMsg.WriteBuf = IsrWrite;
+    IsrMsg.WriteLen = 2;
+    IsrMsg.ReadBuf = NULL;
+    IsrMsg.ReadLen = 0;
+    IsrMsg.Callback = isr_done;
+    IsrMsg.CallBackRef = NULL;
+    IsrSubmitStatus = iic_bus_submit(&IsrMsg);
+}
+
+static int trigger_start(SimIicDev *Dev, int Read) {
+    (void)Dev;
+    (void)Read;
+    if (Armed) {
+        Armed = 0;
+        isr();
+    }
+    return 1;
+}
+
+static int trigger_write(SimIicDev *Dev, u8 Byte) {
+    (void)Dev;
+    (void)Byte;
+    return 1;
+}
+
+static u8 trigger_read(SimIicDev *Dev) {
+    (void)Dev;
+    return 0;
+}
+
+static u64 ticks(void) {
+    return sim_now();
+}
+
+// The same register write, with the mux written every time
+static int naive_write(u8 Addr, u8 Channel, u8 Reg, u8 Value) {
+    u8 Buffer[2] = { Reg, Value };
+
+    if (XIic_Send(XPAR_IIC_0_BASEADDR, IIC_MUX_ADDRESS, &Channel, 1, XIIC_STOP) != 1) {
+        return XST_FAILURE;
+    }
+    return XIic_Send(XPAR_IIC_0_BASEADDR, Addr, Buffer, 2, XIIC_STOP) == 2 ? XST_SUCCESS : XST_FAILURE;
+}
+
+static void report(const char *Name, u64 Start, u64 Transfers) {
+    printf("%-22s %8.3f ms  xfers %5llu\n", Name, (sim_now() - Start) / 1e6,
+           (unsigned long long)(sim_iic_stats.Transfers - Transfers));
+}
+
+int main(int argc, char **argv) {
+    static SimIicDev Trigger;
+    IicBusClient TriggerClient;
+    IicBusClient Absent;
+    u8 Buffer[3];
+    u8 Value;
+    u32 Nacks;
+    u64 Start;
+    u64 Transfers;
+    int Failed = 0;
+    int i;
+
+    if (argc > 1) {
+        sim_iic_cfg.iic_hz = (u32)strtoul(argv[1], NULL, 0);
+    }
+
+    sim_iic_reset();
+    sim_mux_create(IIC_MUX_ADDRESS);
+    IdtDev = sim_regdev_create(IDT_ADDRESS, 0x01, 256, 2, 0);
+    Dp159Dev = sim_regdev_create(DP159_ADDRESS, 0x01, 256, 1, 0);
+    sim_regdev_create(SI5324_ADDRESS, 0x02, 256, 1, 0);
+    Trigger.Name = "trigger";
+    Trigger.Addr = TRIGGER_ADDRESS;
+    Trigger.Start = trigger_start;
+    Trigger.Write = trigger_write;
+    Trigger.Read = trigger_read;
+    sim_iic_attach(&Trigger);
+
+    // Mux written in front of every access
+    Start = sim_now();
+    Transfers = sim_iic_stats.Transfers;
+    for (i = 0; i < ROUNDS; i++) {
+        Failed |= naive_write(IDT_ADDRESS, 0x01, (u8)i, (u8)i) != XST_SUCCESS;
+        Failed |= naive_write(DP159_ADDRESS, 0x01, (u8)i, (u8)~i) != XST_SUCCESS;
+        if (i % 16 == 15) {
+            Failed |= naive_write(SI5324_ADDRESS, 0x02, (u8)i, (u8)i) != XST_SUCCESS;
+        }
+    }
+    report("mux every access", Start, Transfers);
+
+    Bus = iic_bus_get(XPAR_IIC_0_BASEADDR);
+    iic_bus_set_clock(Bus, ticks, 1000000000);
+    iic_bus_client_init(&Idt, Bus, "idt", IDT_ADDRESS, 0x01);
+    iic_bus_client_init(&Dp159, Bus, "dp159", DP159_ADDRESS, 0x01);
+    iic_bus_client_init(&Si5324, Bus, "si5324", SI5324_ADDRESS, 0x02);
+    iic_bus_client_init(&TriggerClient, Bus, "trigger", TRIGGER_ADDRESS, IIC_BUS_ROOT);
+
+    // Same sequence through the manager
+    Start = sim_now();
+    Transfers = sim_iic_stats.Transfers;
+    for (i = 0; i < ROUNDS; i++) {
+        Buffer[0] = 0;
+        Buffer[1] = (u8)i;
+        Buffer[2] = (u8)(i + 1);
+        Failed |= iic_bus_transfer(&Idt, Buffer, 3, NULL, 0) != XST_SUCCESS;
+        Buffer[0] = (u8)i;
+        Buffer[1] = (u8)(i * 3);
+        Failed |= iic_bus_transfer(&Dp159, Buffer, 2, NULL, 0) != XST_SUCCESS;
+        if (i % 16 == 15) {
+            Failed |= iic_bus_transfer(&Si5324, Buffer, 2, NULL, 0) != XST_SUCCESS;
+        }
+    }
+    report("iic_bus", Start, Transfers);
+    Failed |= sim_regdev_regs(IdtDev)[ROUNDS - 1] != ROUNDS;
+    Failed |= sim_regdev_regs(Dp159Dev)[ROUNDS - 1] != (u8)((ROUNDS - 1) * 3);
+
+    // Register read with a repeated START
+    Buffer[0] = 0;
+    Buffer[1] = 10;
+    Failed |= iic_bus_transfer(&Idt, Buffer, 2, &Value, 1) != XST_SUCCESS || Value != 11;
+
+    // Interrupt in the middle of a transfer of another client
+    Armed = 1;
+    Failed |= iic_bus_transfer(&TriggerClient, Buffer, 1, NULL, 0) != XST_SUCCESS;
+    Failed |= IsrSyncStatus != XST_DEVICE_BUSY || IsrSubmitStatus != XST_SUCCESS;
+    Failed |= IsrCallbacks != 1 || IsrMsg.Status != XST_SUCCESS;
+    Failed |= sim_regdev_regs(Dp159Dev)[0x0A] != 0x5A || sim_regdev_regs(Dp159Dev)[0x0B] == 0xA5;
+    printf("preempted: sync %s, submitted %s, run by owner %d\n",
+           IsrSyncStatus == XST_DEVICE_BUSY ? "busy" : "?",
+           IsrSubmitStatus == XST_SUCCESS ? "ok" : "?", IsrCallbacks);
+
+    // Read-modify-write session; the handler fires between read and write
+    Failed |= iic_bus_begin(&Idt) != XST_SUCCESS;
+    Buffer[0] = 0;
+    Buffer[1] = 20;
+    Failed |= iic_bus_transfer(&Idt, Buffer, 2, &Value, 1) != XST_SUCCESS;
+    IsrCallbacks = 0;
+    sim_regdev_regs(Dp159Dev)[0x0A] = 0;
+    isr();
+    Failed |= IsrSyncStatus != XST_DEVICE_BUSY || IsrCallbacks != 0;
+    Buffer[2] = (u8)(Value | 0x80);
+    Failed |= iic_bus_transfer(&Idt, Buffer, 3, NULL, 0) != XST_SUCCESS;
+    iic_bus_end(&Idt);
+    Failed |= IsrCallbacks != 1 || sim_regdev_regs(Dp159Dev)[0x0A] != 0x5A;
+    Failed |= sim_regdev_regs(IdtDev)[20] != (21 | 0x80);
+
+    // Nobody at the address
+    iic_bus_client_init(&Absent, Bus, "absent", 0x33, IIC_BUS_ROOT);
+    Failed |= iic_bus_probe(&Absent) == XST_SUCCESS;
+
+    // Another master for 2 ms, then for longer than the manager waits
+    Nacks = Dp159.Nacks;
+    Buffer[0] = 0x0C;
+    Buffer[1] = 0x3C;
+    sim_iic_hold_bus(2000000);
+    Start = sim_now();
+    Failed |= iic_bus_transfer(&Dp159, Buffer, 2, NULL, 0) != XST_SUCCESS;
+    Failed |= sim_now() - Start < 2000000 || sim_regdev_regs(Dp159Dev)[0x0C] != 0x3C;
+    Failed |= Dp159.BusWaits != 1 || Dp159.Nacks != Nacks;
+    printf("other master 2 ms: waited %.3f ms\n", (sim_now() - Start) / 1e6);
+    sim_iic_hold_bus(2ULL * IIC_BUS_IDLE_TIMEOUT_US * 1000);
+    Failed |= iic_bus_transfer(&Dp159, Buffer, 2, NULL, 0) == XST_SUCCESS;
+    Failed |= Dp159.BusWaits != 2;
+
+    iic_bus_report(Bus);
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
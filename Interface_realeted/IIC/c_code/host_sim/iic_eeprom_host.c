@@ -0,0 +1,151 @@
+// iic_eeprom.c on the bus model: an unaligned bulk write to a 24C32 with
+// ACK polling against the same write with a fixed 10 ms (datasheet tWR)
+// delay per page, a one-transaction read back, the CRC verify, and a
+// corrupted byte that the verify has to catch. The part's real write
+// cycle is 5 ms. Last, another master holds the bus: a short hold is
+// waited out without using up ACK polls, one longer than
+// IIC_EEPROM_IDLE_TIMEOUT_US fails the write.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. iic_eeprom.c host_sim/sim_iic.c
+//       host_sim/sim_iic_devs.c host_sim/iic_eeprom_host.c -o iic_eeprom_host
+//   ./iic_eeprom_host [iic_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xiic.h"
+#include "sleep.h"
+#include "iic_eeprom.h"
+#include "sim_iic.h"
+
+#define IIC_MUX_ADDRESS         0x74
+#define IIC_EEPROM_CHANNEL      0x01
+#define EEPROM32_ADDRESS        0x50
+#define EEPROM02_ADDRESS        0x54
+
+#define WRITE_OFFSET            0x3F5
+#define WRITE_SIZE              1000
+#define FIXED_TWR_US            10000
+
+static SimIicDev *Eeprom32;
+static SimIicDev *Eeprom02;
+
+static void setup(void) {
+    u8 Mux = IIC_EEPROM_CHANNEL;
+
+    sim_iic_reset();
+    sim_mux_create(IIC_MUX_ADDRESS);
+    Eeprom32 = sim_eeprom_create(EEPROM32_ADDRESS, IIC_EEPROM_CHANNEL, 4096, 32, 2, 5000);
+    Eeprom02 = sim_eeprom_create(EEPROM02_ADDRESS, IIC_EEPROM_CHANNEL, 256, 16, 1, 5000);
+    XIic_Send(XPAR_IIC_0_BASEADDR, IIC_MUX_ADDRESS, &Mux, 1, XIIC_STOP);
+}
+
+static void report(const char *Name, u64 Start, IicEeprom *Eeprom) {
+    printf("%-24s %8.3f ms  pages %3u  polls %4u  xfers %4llu\n", Name, (sim_now() - Start) / 1e6,
+           Eeprom ? Eeprom->Pages : 0, Eeprom ? Eeprom->Polls : 0,
+           (unsigned long long)sim_iic_stats.Transfers);
+}
+
+// Page writes with a fixed write-cycle delay, the way it is usually done
+static int fixed_delay_write(u32 Offset, const u8 *Data, u32 ByteCount) {
+    u8 WriteBuffer[2 + 32];
+    u32 Count;
+
+    while (ByteCount) {
+        Count = 32 - Offset % 32;
+        if (Count > ByteCount) {
+            Count = ByteCount;
+        }
+        WriteBuffer[0] = (u8)(Offset >> 8);
+        WriteBuffer[1] = (u8)Offset;
+        memcpy(&WriteBuffer[2], Data, Count);
+        if (XIic_Send(XPAR_IIC_0_BASEADDR, EEPROM32_ADDRESS, WriteBuffer, 2 + Count, XIIC_STOP) != 2 + Count) {
+            return XST_FAILURE;
+        }
+        usleep(FIXED_TWR_US);
+        Offset += Count;
+        Data += Count;
+        ByteCount -= Count;
+    }
+    return XST_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    static u8 Data[WRITE_SIZE];
+    static u8 Back[4096];
+    IicEeprom Eeprom;
+    IicEeprom Small;
+    u64 Start;
+    u32 Polls;
+    int Failed = 0;
+    int i;
+
+    if (argc > 1) {
+        sim_iic_cfg.iic_hz = (u32)strtoul(argv[1], NULL, 0);
+    }
+    for (i = 0; i < WRITE_SIZE; i++) {
+        Data[i] = (u8)(i * 31 + 7);
+    }
+
+    setup();
+    Start = sim_now();
+    Failed |= fixed_delay_write(WRITE_OFFSET, Data, WRITE_SIZE) != XST_SUCCESS;
+    report("fixed 10 ms delay", Start, NULL);
+    Failed |= memcmp(sim_eeprom_mem(Eeprom32) + WRITE_OFFSET, Data, WRITE_SIZE) != 0;
+
+    setup();
+    iic_eeprom_init(&Eeprom, XPAR_IIC_0_BASEADDR, EEPROM32_ADDRESS, 4096, 32, 2);
+    Start = sim_now();
+    Failed |= iic_eeprom_write(&Eeprom, WRITE_OFFSET, Data, WRITE_SIZE) != XST_SUCCESS;
+    report("iic_eeprom_write", Start, &Eeprom);
+    Failed |= memcmp(sim_eeprom_mem(Eeprom32) + WRITE_OFFSET, Data, WRITE_SIZE) != 0;
+
+    Start = sim_now();
+    Failed |= iic_eeprom_read(&Eeprom, 0, Back, 4096) != XST_SUCCESS;
+    report("iic_eeprom_read 4 KB", Start, &Eeprom);
+    Failed |= memcmp(Back, sim_eeprom_mem(Eeprom32), 4096) != 0;
+
+    Start = sim_now();
+    Failed |= iic_eeprom_verify(&Eeprom, WRITE_OFFSET, Data, WRITE_SIZE) != XST_SUCCESS;
+    report("iic_eeprom_verify", Start, &Eeprom);
+
+    // One flipped bit must fail the verify
+    sim_eeprom_mem(Eeprom32)[WRITE_OFFSET + 517] ^= 0x10;
+    Failed |= iic_eeprom_verify(&Eeprom, WRITE_OFFSET, Data, WRITE_SIZE) == XST_SUCCESS;
+
+    // 1-byte addressed part, write right behind a read
+    iic_eeprom_init(&Small, XPAR_IIC_0_BASEADDR, EEPROM02_ADDRESS, 256, 16, 1);
+    Start = sim_now();
+    Failed |= iic_eeprom_write(&Small, 3, Data, 200) != XST_SUCCESS;
+    Failed |= iic_eeprom_read(&Small, 0, Back, 256) != XST_SUCCESS;
+    report("24c02 write+read", Start, &Small);
+    Failed |= memcmp(Back + 3, Data, 200) != 0 || memcmp(Back, sim_eeprom_mem(Eeprom02), 256) != 0;
+
+    // Out of range
+    Failed |= iic_eeprom_read(&Small, 200, Back, 57) == XST_SUCCESS;
+
+    // The same page write free, with another master on the bus for 2 ms
+    // and for 20 ms; the held bus must not add ACK polls
+    usleep(FIXED_TWR_US);
+    Polls = Small.Polls;
+    Failed |= iic_eeprom_write(&Small, 0x40, Data, 16) != XST_SUCCESS;
+    Polls = Small.Polls - Polls;
+
+    usleep(FIXED_TWR_US);
+    sim_iic_hold_bus(2000000);
+    Start = sim_now();
+    Polls += Small.Polls;
+    Failed |= iic_eeprom_write(&Small, 0x50, Data + 16, 16) != XST_SUCCESS;
+    report("24c02 bus held 2 ms", Start, &Small);
+    Failed |= Small.BusWaits != 1 || Small.Polls != Polls;
+    Failed |= memcmp(sim_eeprom_mem(Eeprom02) + 0x40, Data, 32) != 0;
+
+    usleep(FIXED_TWR_US);
+    sim_iic_hold_bus(20000000);
+    Failed |= iic_eeprom_write(&Small, 0x60, Data, 16) == XST_SUCCESS;
+    Failed |= Small.BusWaits != 2 || Small.Polls != Polls;
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,311 @@
+// Runs iic_master.c and iic_queue.c against the bus model on the PC: the
+// EEPROM traffic of interface_main.c first through the blocking
+// iic_write/iic_read, then through the queue while the CPU keeps working,
+// then a register batch to a clock chip model, and last a queue wait whose
+// interrupt never comes, which must time out.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. iic_master.c iic_queue.c host_sim/sim_iic.c
+//       host_sim/sim_iic_devs.c host_sim/iic_queue_host.c -o iic_queue_host
+//   ./iic_queue_host [pages] [iic_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xiic.h"
+#include "xintc.h"
+#include "xil_exception.h"
+#include "iic_master.h"
+#include "iic_queue.h"
+#include "sim_iic.h"
+
+#define IIC_MUX_ADDRESS         0x74
+#define IIC_EEPROM_CHANNEL      0x01
+#define EEPROM_ADDRESS          0x54
+#define CLOCK_ADDRESS           0x6C
+
+#define PAGE_SIZE               16
+#define EEPROM_DATA_START_ADDR  128
+#define MAX_PAGES               8
+
+#define WORK_NS                 1000    // One unit of application work
+
+static XIntc Intc;
+static XIic Iic;
+
+static void SendHandler(XIic *InstancePtr) {
+    (void)InstancePtr;
+    TransmitComplete = 0;
+}
+
+static void ReceiveHandler(XIic *InstancePtr) {
+    (void)InstancePtr;
+    ReceiveComplete = 0;
+}
+
+static void StatusHandler(XIic *InstancePtr, int Event) {
+    (void)InstancePtr;
+    (void)Event;
+}
+
+static int setup(void) {
+    sim_iic_reset();
+    sim_mux_create(IIC_MUX_ADDRESS);
+    sim_eeprom_create(EEPROM_ADDRESS, IIC_EEPROM_CHANNEL, 256, PAGE_SIZE, 1, 5000);
+
+    if (iic_init(&Iic, XPAR_IIC_0_DEVICE_ID) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    // Same wiring as SetupInterruptSystem() in interface_main.c
+    XIntc_Initialize(&Intc, XPAR_INTC_0_DEVICE_ID);
+    XIntc_Connect(&Intc, XPAR_INTC_0_IIC_0_VEC_ID, (XInterruptHandler)XIic_InterruptHandler, &Iic);
+    XIntc_Start(&Intc, XIN_REAL_MODE);
+    XIntc_Enable(&Intc, XPAR_INTC_0_IIC_0_VEC_ID);
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XIntc_InterruptHandler, &Intc);
+    Xil_ExceptionEnable();
+
+    return XST_SUCCESS;
+}
+
+static void fill(u8 *Buf, int Page, int Seed) {
+    int i;
+
+    Buf[0] = EEPROM_DATA_START_ADDR + Page * PAGE_SIZE;
+    for (i = 0; i < PAGE_SIZE; i++) {
+        Buf[1 + i] = (u8)(Seed + i * 7 + Page * PAGE_SIZE);
+    }
+}
+
+static int check(u8 Pages[][1 + PAGE_SIZE], u8 Read[][PAGE_SIZE], int Count) {
+    int p;
+
+    for (p = 0; p < Count; p++) {
+        if (memcmp(&Pages[p][1], Read[p], PAGE_SIZE) != 0) {
+            printf("page %d mismatch\n", p);
+            return XST_FAILURE;
+        }
+    }
+    return XST_SUCCESS;
+}
+
+static void report(const char *Name, u64 Ns, u64 Work) {
+    printf("%-10s %8.3f ms  work %6.1f%%  xfers %3llu  stops %3llu  nacks %3llu  irqs %4llu\n", Name,
+           Ns / 1e6, Ns ? 100.0 * (double)(Work * WORK_NS) / (double)Ns : 0.0,
+           (unsigned long long)sim_iic_stats.Transfers, (unsigned long long)sim_iic_stats.Stops,
+           (unsigned long long)sim_iic_stats.Nacks, (unsigned long long)sim_iic_stats.Interrupts);
+}
+
+static int run_blocking(int Count) {
+    u8 Pages[MAX_PAGES][1 + PAGE_SIZE];
+    u8 Read[MAX_PAGES][PAGE_SIZE];
+    u8 Mux = IIC_EEPROM_CHANNEL;
+    u64 Start;
+    int p;
+
+    if (setup() != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    XIic_SetSendHandler(&Iic, &Iic, (XIic_Handler)SendHandler);
+    XIic_SetRecvHandler(&Iic, &Iic, (XIic_Handler)ReceiveHandler);
+    XIic_SetStatusHandler(&Iic, &Iic, (XIic_StatusHandler)StatusHandler);
+
+    Start = sim_now();
+
+    XIic_SetAddress(&Iic, XII_ADDR_TO_SEND_TYPE, IIC_MUX_ADDRESS);
+    if (iic_write(&Iic, &Mux, 1) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    XIic_SetAddress(&Iic, XII_ADDR_TO_SEND_TYPE, EEPROM_ADDRESS);
+    for (p = 0; p < Count; p++) {
+        fill(Pages[p], p, 0x11);
+        if (iic_write(&Iic, Pages[p], 1 + PAGE_SIZE) != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+    }
+    for (p = 0; p < Count; p++) {
+        if (iic_read(&Iic, Pages[p], Read[p], PAGE_SIZE) != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+    }
+
+    // The CPU spun through all of it
+    report("blocking", sim_now() - Start, 0);
+
+    return check(Pages, Read, Count);
+}
+
+static int run_queue(int Count) {
+    u8 Pages[MAX_PAGES][1 + PAGE_SIZE];
+    u8 Read[MAX_PAGES][PAGE_SIZE];
+    IicTxn Write[MAX_PAGES];
+    IicTxn ReadTxn[MAX_PAGES];
+    IicTxn MuxTxn;
+    IicQueue Queue;
+    u8 Mux = IIC_EEPROM_CHANNEL;
+    u64 Start;
+    u64 Work = 0;
+    int p;
+
+    if (setup() != XST_SUCCESS || iic_queue_init(&Queue, &Iic) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    Start = sim_now();
+
+    iic_txn_init(&MuxTxn, IIC_MUX_ADDRESS, &Mux, 1, NULL, 0);
+    iic_queue_submit(&Queue, &MuxTxn);
+    for (p = 0; p < Count; p++) {
+        fill(Pages[p], p, 0x22);
+        iic_txn_init(&Write[p], EEPROM_ADDRESS, Pages[p], 1 + PAGE_SIZE, NULL, 0);
+        iic_queue_submit(&Queue, &Write[p]);
+    }
+    for (p = 0; p < Count; p++) {
+        iic_txn_init(&ReadTxn[p], EEPROM_ADDRESS, Pages[p], 1, Read[p], PAGE_SIZE);
+        iic_queue_submit(&Queue, &ReadTxn[p]);
+    }
+
+    while (!iic_queue_idle(&Queue)) {
+        sim_cpu(WORK_NS);
+        Work++;
+    }
+
+    report("queue", sim_now() - Start, Work);
+    printf("           submitted %u  completed %u  failed %u  retried %u\n",
+           Queue.Submitted, Queue.Completed, Queue.Failed, Queue.Retried);
+
+    if (Queue.Failed || Queue.Completed != Queue.Submitted) {
+        return XST_FAILURE;
+    }
+    for (p = 0; p < Count; p++) {
+        if (ReadTxn[p].Status != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+    }
+
+    return check(Pages, Read, Count);
+}
+
+static int run_batch(void) {
+    static const IicRegWrite Regs[] = {
+        { 0x10, 0xA0 }, { 0x11, 0xA1 }, { 0x12, 0xA2 }, { 0x13, 0xA3 },
+        { 0x14, 0xA4 }, { 0x15, 0xA5 }, { 0x16, 0xA6 }, { 0x17, 0xA7 },
+        { 0x30, 0xB0 }, { 0x31, 0xB1 }, { 0x64, 0xC4 },
+    };
+    const int Count = sizeof(Regs) / sizeof(Regs[0]);
+    IicQueue Queue;
+    IicBatch Batch;
+    IicTxn MuxTxn;
+    IicTxn ReadTxn;
+    SimIicDev *Clock;
+    u8 Mux = IIC_EEPROM_CHANNEL;
+    u8 Reg = 0x10;
+    u8 Back[8];
+    u8 *Dev;
+    u64 Start;
+    u64 Work = 0;
+    int i;
+
+    if (setup() != XST_SUCCESS || iic_queue_init(&Queue, &Iic) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    Clock = sim_regdev_create(CLOCK_ADDRESS, IIC_EEPROM_CHANNEL, 256, 1, 1);
+
+    Start = sim_now();
+
+    iic_txn_init(&MuxTxn, IIC_MUX_ADDRESS, &Mux, 1, NULL, 0);
+    iic_queue_submit(&Queue, &MuxTxn);
+    if (iic_queue_write_regs(&Queue, &Batch, CLOCK_ADDRESS, Regs, Count, 0, NULL, NULL) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    while (Batch.Pending) {
+        sim_cpu(WORK_NS);
+        Work++;
+    }
+
+    report("batch", sim_now() - Start, Work);
+    printf("           %d registers in %d writes\n", Count, Batch.Count);
+
+    Dev = sim_regdev_regs(Clock);
+    for (i = 0; i < Count; i++) {
+        if (Dev[Regs[i].Reg] != Regs[i].Value) {
+            printf("register 0x%02X = 0x%02X, expected 0x%02X\n", Regs[i].Reg, Dev[Regs[i].Reg], Regs[i].Value);
+            return XST_FAILURE;
+        }
+    }
+
+    // Read the first run back with the CPU parked in iic_queue_wait
+    iic_txn_init(&ReadTxn, CLOCK_ADDRESS, &Reg, 1, Back, sizeof(Back));
+    iic_queue_submit(&Queue, &ReadTxn);
+    if (iic_queue_wait(&Queue, &ReadTxn) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    for (i = 0; i < (int)sizeof(Back); i++) {
+        if (Back[i] != Regs[i].Value) {
+            printf("readback 0x%02X = 0x%02X, expected 0x%02X\n", Regs[i].Reg, Back[i], Regs[i].Value);
+            return XST_FAILURE;
+        }
+    }
+
+    return Batch.Status == XST_SUCCESS && Batch.Count == 3 ? XST_SUCCESS : XST_FAILURE;
+}
+
+// The IIC line is masked at the INTC, as if the handler was never connected
+static int run_lost_irq(void) {
+    IicQueue Queue;
+    IicTxn ReadTxn;
+    u8 Reg = 0;
+    u8 Back;
+    u64 Start;
+    int Status;
+
+    if (setup() != XST_SUCCESS || iic_queue_init(&Queue, &Iic) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    XIntc_Disable(&Intc, XPAR_INTC_0_IIC_0_VEC_ID);
+
+    Start = sim_now();
+    iic_txn_init(&ReadTxn, EEPROM_ADDRESS, &Reg, 1, &Back, 1);
+    iic_queue_submit(&Queue, &ReadTxn);
+    Status = iic_queue_wait(&Queue, &ReadTxn);
+    printf("lost irq   %8.3f ms  wait %s\n", (sim_now() - Start) / 1e6,
+           Status == XST_SUCCESS ? "ok" : "failed");
+
+    return Status != XST_SUCCESS && sim_now() - Start >= IIC_QUEUE_WAIT_TIMEOUT_US * 1000ULL ?
+           XST_SUCCESS : XST_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    int Pages = argc > 1 ? atoi(argv[1]) : 4;
+    int Failed = 0;
+
+    if (argc > 2) {
+        sim_iic_cfg.iic_hz = (u32)strtoul(argv[2], NULL, 0);
+    }
+    if (Pages < 1 || Pages > MAX_PAGES) {
+        fprintf(stderr, "pages must be 1..%d\n", MAX_PAGES);
+        return 1;
+    }
+
+    if (run_blocking(Pages) != XST_SUCCESS) {
+        printf("blocking: FAIL\n");
+        Failed++;
+    }
+    if (run_queue(Pages) != XST_SUCCESS) {
+        printf("queue: FAIL\n");
+        Failed++;
+    }
+    if (run_batch() != XST_SUCCESS) {
+        printf("batch: FAIL\n");
+        Failed++;
+    }
+    if (run_lost_irq() != XST_SUCCESS) {
+        printf("lost irq: FAIL\n");
+        Failed++;
+    }
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
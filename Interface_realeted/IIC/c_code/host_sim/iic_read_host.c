@@ -0,0 +1,178 @@
+// EEPROM dumps through iic_master.c on the bus model: the old read path
+// (address write, STOP, START, read) one page at a time against one
+// iic_read_reg() with a repeated START, for a 1-byte addressed 24C02 and a
+// 2-byte addressed 24C32.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. iic_master.c host_sim/sim_iic.c
+//       host_sim/sim_iic_devs.c host_sim/iic_read_host.c -o iic_read_host
+//   ./iic_read_host [iic_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xiic.h"
+#include "xintc.h"
+#include "xil_exception.h"
+#include "iic_master.h"
+#include "sim_iic.h"
+
+#define IIC_MUX_ADDRESS         0x74
+#define IIC_EEPROM_CHANNEL      0x01
+#define EEPROM_ADDRESS          0x54    // 24C02, 256 bytes, 1 address byte
+#define EEPROM32_ADDRESS        0x50    // 24C32, 4 KB, 2 address bytes
+
+#define PAGE_SIZE               16
+#define PAGE_SIZE_32            32
+#define DUMP_SIZE_32            1024
+
+static XIntc Intc;
+static XIic Iic;
+static SimIicDev *Eeprom;
+static SimIicDev *Eeprom32;
+
+static void SendHandler(XIic *InstancePtr) {
+    (void)InstancePtr;
+    TransmitComplete = 0;
+}
+
+static void ReceiveHandler(XIic *InstancePtr) {
+    (void)InstancePtr;
+    ReceiveComplete = 0;
+}
+
+static void StatusHandler(XIic *InstancePtr, int Event) {
+    (void)InstancePtr;
+    (void)Event;
+}
+
+static int setup(void) {
+    u8 Mux = IIC_EEPROM_CHANNEL;
+    u8 *Mem;
+    int i;
+
+    sim_iic_reset();
+    sim_mux_create(IIC_MUX_ADDRESS);
+    Eeprom = sim_eeprom_create(EEPROM_ADDRESS, IIC_EEPROM_CHANNEL, 256, PAGE_SIZE, 1, 5000);
+    Eeprom32 = sim_eeprom_create(EEPROM32_ADDRESS, IIC_EEPROM_CHANNEL, 4096, PAGE_SIZE_32, 2, 5000);
+
+    Mem = sim_eeprom_mem(Eeprom);
+    for (i = 0; i < 256; i++) {
+        Mem[i] = (u8)(i * 13 + 5);
+    }
+    Mem = sim_eeprom_mem(Eeprom32);
+    for (i = 0; i < 4096; i++) {
+        Mem[i] = (u8)(i ^ (i >> 8) ^ 0x5A);
+    }
+
+    if (iic_init(&Iic, XPAR_IIC_0_DEVICE_ID) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    XIntc_Initialize(&Intc, XPAR_INTC_0_DEVICE_ID);
+    XIntc_Connect(&Intc, XPAR_INTC_0_IIC_0_VEC_ID, (XInterruptHandler)XIic_InterruptHandler, &Iic);
+    XIntc_Start(&Intc, XIN_REAL_MODE);
+    XIntc_Enable(&Intc, XPAR_INTC_0_IIC_0_VEC_ID);
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XIntc_InterruptHandler, &Intc);
+    Xil_ExceptionEnable();
+
+    XIic_SetSendHandler(&Iic, &Iic, (XIic_Handler)SendHandler);
+    XIic_SetRecvHandler(&Iic, &Iic, (XIic_Handler)ReceiveHandler);
+    XIic_SetStatusHandler(&Iic, &Iic, (XIic_StatusHandler)StatusHandler);
+
+    XIic_SetAddress(&Iic, XII_ADDR_TO_SEND_TYPE, IIC_MUX_ADDRESS);
+    return iic_write(&Iic, &Mux, 1);
+}
+
+// The read path iic_read() had before: a complete write of the address, then a new transaction
+static int legacy_read(u8 *AddrBuf, u8 AddrBytes, u8 *Buf, u16 ByteCount) {
+    ReceiveComplete = 1;
+
+    if (iic_write(&Iic, AddrBuf, AddrBytes) != XST_SUCCESS ||
+        XIic_Start(&Iic) != XST_SUCCESS ||
+        XIic_MasterRecv(&Iic, Buf, ByteCount) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    while ((ReceiveComplete) || (XIic_IsIicBusy(&Iic) == TRUE)) {}
+
+    return XIic_Stop(&Iic);
+}
+
+static SimIicStats Before;
+static u64 Start;
+
+static void mark(void) {
+    Before = sim_iic_stats;
+    Start = sim_now();
+}
+
+static void report(const char *Name) {
+    printf("%-22s %8.3f ms  xfers %4llu  stops %4llu  rep-starts %4llu  irqs %4llu\n", Name,
+           (sim_now() - Start) / 1e6,
+           (unsigned long long)(sim_iic_stats.Transfers - Before.Transfers),
+           (unsigned long long)(sim_iic_stats.Stops - Before.Stops),
+           (unsigned long long)(sim_iic_stats.RepeatedStarts - Before.RepeatedStarts),
+           (unsigned long long)(sim_iic_stats.Interrupts - Before.Interrupts));
+}
+
+int main(int argc, char **argv) {
+    static u8 Dump[DUMP_SIZE_32];
+    u8 AddrBuf[2];
+    int Failed = 0;
+    int p;
+
+    if (argc > 1) {
+        sim_iic_cfg.iic_hz = (u32)strtoul(argv[1], NULL, 0);
+    }
+    if (setup() != XST_SUCCESS) {
+        printf("setup failed\n");
+        return 1;
+    }
+
+    XIic_SetAddress(&Iic, XII_ADDR_TO_SEND_TYPE, EEPROM_ADDRESS);
+
+    memset(Dump, 0, sizeof(Dump));
+    mark();
+    for (p = 0; p < 256 / PAGE_SIZE; p++) {
+        AddrBuf[0] = (u8)(p * PAGE_SIZE);
+        Failed |= legacy_read(AddrBuf, 1, &Dump[p * PAGE_SIZE], PAGE_SIZE) != XST_SUCCESS;
+    }
+    report("24c02 per page, STOP");
+    Failed |= memcmp(Dump, sim_eeprom_mem(Eeprom), 256) != 0;
+
+    memset(Dump, 0, sizeof(Dump));
+    mark();
+    Failed |= iic_read_reg(&Iic, 0, IIC_REG_ADDR_8, Dump, 256) != XST_SUCCESS;
+    report("24c02 iic_read_reg");
+    Failed |= memcmp(Dump, sim_eeprom_mem(Eeprom), 256) != 0;
+
+    // iic_read() keeps its signature and now goes through the combined path
+    memset(Dump, 0, sizeof(Dump));
+    AddrBuf[0] = 128;
+    mark();
+    Failed |= iic_read(&Iic, AddrBuf, Dump, PAGE_SIZE) != XST_SUCCESS;
+    report("24c02 iic_read page");
+    Failed |= memcmp(Dump, sim_eeprom_mem(Eeprom) + 128, PAGE_SIZE) != 0;
+
+    XIic_SetAddress(&Iic, XII_ADDR_TO_SEND_TYPE, EEPROM32_ADDRESS);
+
+    memset(Dump, 0, sizeof(Dump));
+    mark();
+    for (p = 0; p < DUMP_SIZE_32 / PAGE_SIZE_32; p++) {
+        AddrBuf[0] = (u8)((0x400 + p * PAGE_SIZE_32) >> 8);
+        AddrBuf[1] = (u8)(p * PAGE_SIZE_32);
+        Failed |= legacy_read(AddrBuf, 2, &Dump[p * PAGE_SIZE_32], PAGE_SIZE_32) != XST_SUCCESS;
+    }
+    report("24c32 per page, STOP");
+    Failed |= memcmp(Dump, sim_eeprom_mem(Eeprom32) + 0x400, DUMP_SIZE_32) != 0;
+
+    memset(Dump, 0, sizeof(Dump));
+    mark();
+    Failed |= iic_read_reg(&Iic, 0x400, IIC_REG_ADDR_16, Dump, DUMP_SIZE_32) != XST_SUCCESS;
+    report("24c32 iic_read_reg");
+    Failed |= memcmp(Dump, sim_eeprom_mem(Eeprom32) + 0x400, DUMP_SIZE_32) != 0;
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
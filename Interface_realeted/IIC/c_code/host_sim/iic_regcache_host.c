@@ -0,0 +1,140 @@
+// Vitis/hdmi/iic_regcache.c and the IDT 8T49N24x driver that uses it, on
+// the bus model. Counts the transfers of IDT_8T49N24x_Init and of HDMI
+// mode switches (IDT_8T49N24x_SetClock) against what the driver did
+// before the shadow: one transfer per register write and two per
+// read-modify-write. Checks that the device holds the JA configuration,
+// that the shadow verifies against it and that a register changed behind
+// the driver's back is caught. Then the DP159 ES sequence of i2c_dp159()
+// on the cache alone: 0x09, the 0x0B-0x0D burst, the 0x0A apply write.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. -I../../../Vitis/hdmi ../../../Vitis/hdmi/iic_bus.c
+//       ../../../Vitis/hdmi/iic_regcache.c ../../../Vitis/hdmi/clk_plan.c ../../../Vitis/hdmi/idt_8t49n24x.c host_sim/sim_iic.c
+//       host_sim/sim_iic_devs.c host_sim/iic_regcache_host.c -o iic_regcache_host
+//   ./iic_regcache_host [iic_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "xparameters.h"
+#include "xiic.h"
+#include "iic_bus.h"
+#include "iic_regcache.h"
+#include "idt_8t49n24x.h"
+#include "sim_iic.h"
+
+#define IDT_ADDRESS             0x6C
+#define DP159_ADDRESS           0x5E
+
+// Transfers before the shadow: 3 ID reads, 123 table writes, 2 modifies
+#define IDT_INIT_UNSHADOWED     (3 + 123 + 2 * 2)
+// 37 register writes and 6 read-modify-writes
+#define IDT_SETCLOCK_UNSHADOWED (37 + 6 * 2)
+// 0x09, 0x0B, 0x0C, 0x0D, 0x0A
+#define DP159_UNSHADOWED        5
+
+static SimIicDev *Idt;
+static SimIicDev *Dp159;
+
+static u64 Stops;
+static u64 Start;
+
+static void mark(void) {
+    Stops = sim_iic_stats.Stops;
+    Start = sim_now();
+}
+
+static u64 report(const char *Name, u32 Unshadowed) {
+    u64 Count = sim_iic_stats.Stops - Stops;
+
+    printf("%-28s xfers %3llu (unshadowed %3u)  %7.3f ms\n", Name, (unsigned long long)Count,
+           Unshadowed, (sim_now() - Start) / 1e6);
+    return Count;
+}
+
+// i2c_dp159() for the ES device, on the cache
+static int dp159_mode(IicRegCache *Cache, u8 Reg0B, u8 Reg0C, u8 Reg0A) {
+    int Result = XST_SUCCESS;
+
+    Result |= iic_regcache_write(Cache, 0x09, 0x06);
+    iic_regcache_defer(Cache);
+    Result |= iic_regcache_write(Cache, 0x0B, Reg0B);
+    Result |= iic_regcache_write(Cache, 0x0C, Reg0C);
+    Result |= iic_regcache_write(Cache, 0x0D, 0x00);
+    Result |= iic_regcache_flush(Cache);
+    Result |= iic_regcache_write(Cache, 0x0A, Reg0A);
+
+    return Result;
+}
+
+int main(int argc, char **argv) {
+    IicBusClient Dp159Client;
+    IicRegCache Dp159Cache;
+    u8 *Regs;
+    int Failed = 0;
+    u32 i;
+
+    if (argc > 1) {
+        sim_iic_cfg.iic_hz = (u32)strtoul(argv[1], NULL, 0);
+    }
+
+    sim_iic_reset();
+    Idt = sim_regdev_create(IDT_ADDRESS, 0, 256, 2, 1);
+    Dp159 = sim_regdev_create(DP159_ADDRESS, 0, 32, 1, 1);
+
+    // DEV_ID 0x0606
+    Regs = sim_regdev_regs(Idt);
+    Regs[0x02] = 0x00;
+    Regs[0x03] = 0x60;
+    Regs[0x04] = 0x60;
+
+    mark();
+    Failed |= IDT_8T49N24x_Init(XPAR_IIC_0_BASEADDR, IDT_ADDRESS) != XST_SUCCESS;
+    Failed |= report("IDT_8T49N24x_Init", IDT_INIT_UNSHADOWED) > 10;
+    for (i = 8; i < sizeof(IDT_8T49N24x_Config_JA); i++) {
+        Failed |= i != 0x70 && Regs[i] != IDT_8T49N24x_Config_JA[i];
+    }
+
+    mark();
+    Failed |= IDT_8T49N24x_SetClock(XPAR_IIC_0_BASEADDR, IDT_ADDRESS, 148500000, 297000000, FALSE) != XST_SUCCESS;
+    Failed |= report("SetClock 148.5 -> 297 MHz", IDT_SETCLOCK_UNSHADOWED) > 6;
+
+    mark();
+    Failed |= IDT_8T49N24x_SetClock(XPAR_IIC_0_BASEADDR, IDT_ADDRESS, 148500000, 297000000, FALSE) != XST_SUCCESS;
+    Failed |= report("SetClock same again", IDT_SETCLOCK_UNSHADOWED) != 2;
+
+    mark();
+    Failed |= IDT_8T49N24x_SetClock(XPAR_IIC_0_BASEADDR, IDT_ADDRESS, 74250000, 148500000, FALSE) != XST_SUCCESS;
+    report("SetClock 74.25 -> 148.5 MHz", IDT_SETCLOCK_UNSHADOWED);
+
+    mark();
+    Failed |= IDT_8T49N24x_SetClock(XPAR_IIC_0_BASEADDR, IDT_ADDRESS, 114285000, 148500000, TRUE) != XST_SUCCESS;
+    report("SetClock free run", IDT_SETCLOCK_UNSHADOWED);
+
+    Failed |= IDT_8T49N24x_RegisterVerify(XPAR_IIC_0_BASEADDR, IDT_ADDRESS) != XST_SUCCESS;
+
+    // Written behind the driver's back, the verify has to see it
+    Regs[0x26] ^= 0x01;
+    printf("expect one mismatch:\n");
+    Failed |= IDT_8T49N24x_RegisterVerify(XPAR_IIC_0_BASEADDR, IDT_ADDRESS) == XST_SUCCESS;
+
+    // DP159 ES, 0x0A applies the settings and is never dropped
+    iic_bus_client_init(&Dp159Client, iic_bus_get(XPAR_IIC_0_BASEADDR), "dp159_es", DP159_ADDRESS, IIC_BUS_ROOT);
+    Failed |= iic_regcache_init(&Dp159Cache, &Dp159Client, 0x20, 1, TRUE) != XST_SUCCESS;
+    iic_regcache_nocache(&Dp159Cache, 0x0A);
+
+    mark();
+    Failed |= dp159_mode(&Dp159Cache, 0x9A, 0x49, 0x36) != XST_SUCCESS;
+    Failed |= report("dp159 HDMI 2.0", DP159_UNSHADOWED) != 3;
+    mark();
+    Failed |= dp159_mode(&Dp159Cache, 0x9A, 0x49, 0x36) != XST_SUCCESS;
+    Failed |= report("dp159 HDMI 2.0 again", DP159_UNSHADOWED) != 1;
+    mark();
+    Failed |= dp159_mode(&Dp159Cache, 0x88, 0x48, 0x35) != XST_SUCCESS;
+    Failed |= report("dp159 HDMI 1.4 > 2 Gbps", DP159_UNSHADOWED) != 2;
+    Regs = sim_regdev_regs(Dp159);
+    Failed |= Regs[0x09] != 0x06 || Regs[0x0A] != 0x35 || Regs[0x0B] != 0x88 || Regs[0x0C] != 0x48;
+    Failed |= iic_regcache_verify(&Dp159Cache, 0, 0x20) != XST_SUCCESS;
+    iic_regcache_report(&Dp159Cache);
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
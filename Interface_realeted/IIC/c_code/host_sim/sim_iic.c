@@ -0,0 +1,617 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/time.h>
+#include "sim_iic.h"
+#include "xparameters.h"
+#include "xiic.h"
+#include "xintc.h"
+#include "xil_exception.h"
+
+#define SIM_TICK_US     200         // Host timer standing in for the IIC interrupt line
+
+#define SIM_EV_NONE     0
+#define SIM_EV_SEND     1
+#define SIM_EV_RECV     2
+#define SIM_EV_STATUS   3
+
+SimIicConfig sim_iic_cfg = {
+    100000,     // iic_hz
+    200,        // axil_ns
+    1000,       // isr_ns
+};
+
+SimIicStats sim_iic_stats;
+
+static u64 now_ns;
+// Shared with sim_tick(), which runs as a signal handler
+static volatile sig_atomic_t in_model;
+static volatile sig_atomic_t model_calls;
+
+static SimIicDev *devs;
+static u8 mux_channel;
+
+/***** Controller state *****/
+static XIic_Config iic_config = { XPAR_IIC_0_DEVICE_ID, XPAR_IIC_0_BASEADDR, 0, 0 };
+static XIic *iic;
+static int iic_gie = 1;             // Global interrupt enable of the IIC core
+static int ev_kind;                 // Pending completion, one at a time
+static int ev_status;
+static u64 ev_at;
+static int bnb_armed;               // Bus-not-busy interrupt enabled by a busy MasterSend
+static u64 busy_until;              // SCL busy with our own transfer
+static u64 other_until;             // SCL busy with another master
+static SimIicDev *held;             // Device addressed before a repeated START
+static int holding;                 // No STOP sent yet, the bus is still ours
+static u64 xfer_end;
+
+/***** Interrupt path *****/
+static XIntc *intc;
+static Xil_ExceptionHandler exc_handler;
+static void *exc_data;
+static int exc_enabled;
+static int in_isr;
+
+static void sim_service(void);
+
+u64 sim_now(void) {
+    return now_ns;
+}
+
+u64 sim_iic_xfer_end(void) {
+    return xfer_end;
+}
+
+// The fences keep the compiler from moving model state accesses out of
+// the in_model bracket, which is all sim_tick() relies on
+static void sim_enter(void) {
+    in_model++;
+    model_calls++;
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+static void sim_leave(void) {
+    atomic_signal_fence(memory_order_seq_cst);
+    in_model--;
+    if (in_model == 0) {
+        sim_service();
+    }
+}
+
+static int sim_bus_busy(void) {
+    return holding || now_ns < busy_until || now_ns < other_until;
+}
+
+static int sim_irq_line(void) {
+    if (!iic || !iic_gie) {
+        return 0;
+    }
+    if (ev_kind != SIM_EV_NONE && now_ns >= ev_at) {
+        return 1;
+    }
+    return bnb_armed && !sim_bus_busy();
+}
+
+// Earliest time something can raise the IIC interrupt, 0 if nothing will
+static u64 sim_next_event(void) {
+    u64 t = 0;
+
+    if (ev_kind != SIM_EV_NONE) {
+        t = ev_at;
+    } else if (bnb_armed && !holding) {
+        t = busy_until > other_until ? busy_until : other_until;
+        if (t < now_ns) {
+            t = now_ns;
+        }
+    }
+    return t;
+}
+
+static void sim_service(void) {
+    int Rounds = 16;
+
+    while (!in_isr && exc_enabled && exc_handler && intc && intc->IsStarted &&
+           (intc->EnableMask & (1U << XPAR_INTC_0_IIC_0_VEC_ID)) && sim_irq_line() && Rounds--) {
+        in_isr = 1;
+        in_model++;
+        now_ns += sim_iic_cfg.isr_ns;
+        sim_iic_stats.Interrupts++;
+        exc_handler(exc_data);
+        in_model--;
+        in_isr = 0;
+    }
+}
+
+void sim_cpu(u64 ns) {
+    u64 Target = now_ns + ns;
+    u64 Next;
+
+    while (now_ns < Target) {
+        Next = sim_next_event();
+        now_ns = (Next > now_ns && Next < Target) ? Next : Target;
+        sim_service();
+    }
+}
+
+/*
+ * The application spins on flags its handlers set (TransmitComplete,
+ * Txn->Done, ...) without calling the model, the way it waits for a real
+ * interrupt. The tick is that interrupt: when a whole tick went by with no
+ * model call, time skips to the next event and the handlers run, on top
+ * of whatever the application was doing. It never enters the model from
+ * inside a model call, and the path it runs (model, INTC dispatch, driver
+ * and harness handlers) only touches memory and calls nothing from libc.
+ */
+static void sim_tick(int sig) {
+    int Errno = errno;
+    u64 Next;
+
+    (void)sig;
+    if (in_model == 0 && model_calls == 0) {
+        in_model = 1;
+        atomic_signal_fence(memory_order_seq_cst);
+        Next = sim_next_event();
+        if (Next > now_ns) {
+            now_ns = Next;
+        } else if (Next == 0) {
+            now_ns += SIM_TICK_US * 1000ULL;
+        }
+        sim_service();
+        atomic_signal_fence(memory_order_seq_cst);
+        in_model = 0;
+    }
+    model_calls = 0;
+    errno = Errno;
+}
+
+void sim_iic_reset(void) {
+    static int armed;
+    struct sigaction sa;
+    struct itimerval it;
+
+    if (!armed) {
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = sim_tick;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGALRM, &sa, NULL);
+        it.it_interval.tv_sec = 0;
+        it.it_interval.tv_usec = SIM_TICK_US;
+        it.it_value = it.it_interval;
+        setitimer(ITIMER_REAL, &it, NULL);
+        armed = 1;
+    }
+
+    in_model++;
+    now_ns = 0;
+    memset(&sim_iic_stats, 0, sizeof(sim_iic_stats));
+    devs = NULL;
+    mux_channel = 0;
+    iic = NULL;
+    iic_gie = 1;
+    ev_kind = SIM_EV_NONE;
+    bnb_armed = 0;
+    busy_until = 0;
+    other_until = 0;
+    held = NULL;
+    holding = 0;
+    intc = NULL;
+    exc_handler = NULL;
+    exc_enabled = 0;
+    in_isr = 0;
+    in_model--;
+}
+
+void sim_iic_attach(SimIicDev *Dev) {
+    Dev->Next = devs;
+    devs = Dev;
+}
+
+void sim_iic_hold_bus(u64 ns) {
+    other_until = now_ns + ns;
+}
+
+void sim_iic_set_channel(u8 Channel) {
+    mux_channel = Channel;
+}
+
+u8 sim_iic_channel(void) {
+    return mux_channel;
+}
+
+/***** Bus *****/
+static SimIicDev *sim_find(u8 Addr) {
+    SimIicDev *Dev;
+
+    for (Dev = devs; Dev; Dev = Dev->Next) {
+        if (Dev->Addr == Addr && (Dev->Channel == 0 || (Dev->Channel & mux_channel))) {
+            return Dev;
+        }
+    }
+    return NULL;
+}
+
+static u64 sim_bits_ns(u32 Bits) {
+    return (u64)Bits * 1000000000ULL / sim_iic_cfg.iic_hz;
+}
+
+/*
+ * One START (or repeated START) .. STOP segment, executed against the
+ * device models right away. Returns the number of data bytes ACKed or
+ * moved and sets *Nack when the address or a data byte was not ACKed.
+ * busy_until/xfer_end are set to when the segment ends on SCL.
+ */
+static int sim_xfer(u8 Addr, u8 *Buf, int Count, int Read, int Stop, int *Nack) {
+    SimIicDev *Dev;
+    u64 Start = now_ns > busy_until ? now_ns : busy_until;
+    int Done = 0;
+
+    if (Start < other_until) {
+        Start = other_until;
+    }
+    if (holding) {
+        sim_iic_stats.RepeatedStarts++;
+    }
+    sim_iic_stats.Transfers++;
+    *Nack = 0;
+
+    // The STOP time is needed by devices that start an internal cycle on it
+    xfer_end = Start + sim_bits_ns(2 + 9 * (1 + Count));
+
+    Dev = sim_find(Addr);
+    if (!Dev || !Dev->Start(Dev, Read)) {
+        if (Dev) {
+            Dev->Nacks++;
+        }
+        *Nack = 1;
+    } else {
+        Dev->Starts++;
+        for (Done = 0; Done < Count; Done++) {
+            if (Read) {
+                Buf[Done] = Dev->Read(Dev);
+            } else if (!Dev->Write(Dev, Buf[Done])) {
+                Done++;
+                *Nack = 1;
+                break;
+            }
+        }
+    }
+
+    // A NACK always ends with STOP
+    xfer_end = Start + sim_bits_ns(2 + 9 * (1 + Done));
+    if (*Nack) {
+        sim_iic_stats.Nacks++;
+        Stop = 1;
+    }
+
+    // A repeated START to another device ends the previous device's segment
+    if (held && held != Dev && held->Stop) {
+        held->Stop(held);
+    }
+    if (Stop) {
+        if (Dev && !(*Nack && Done == 0) && Dev->Stop) {
+            Dev->Stop(Dev);
+        }
+        sim_iic_stats.Stops++;
+        held = NULL;
+        holding = 0;
+    } else {
+        held = Dev;
+        holding = 1;
+    }
+
+    sim_iic_stats.Bytes += Done;
+    sim_iic_stats.BusNs += xfer_end - Start;
+    busy_until = xfer_end;
+
+    return Done;
+}
+
+/***** XIic driver API *****/
+XIic_Config *XIic_LookupConfig(u16 DeviceId) {
+    return DeviceId == XPAR_IIC_0_DEVICE_ID ? &iic_config : NULL;
+}
+
+int XIic_CfgInitialize(XIic *InstancePtr, XIic_Config *Config, UINTPTR EffectiveAddr) {
+    sim_enter();
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->BaseAddress = EffectiveAddr;
+    InstancePtr->Has10BitAddr = Config->Has10BitAddr;
+    InstancePtr->IsReady = 1;
+    iic = InstancePtr;
+    now_ns += sim_iic_cfg.axil_ns;
+    sim_leave();
+    return XST_SUCCESS;
+}
+
+int XIic_Start(XIic *InstancePtr) {
+    sim_enter();
+    InstancePtr->IsStarted = 1;
+    now_ns += sim_iic_cfg.axil_ns;
+    sim_leave();
+    return XST_SUCCESS;
+}
+
+int XIic_Stop(XIic *InstancePtr) {
+    sim_enter();
+    InstancePtr->IsStarted = 0;
+    now_ns += sim_iic_cfg.axil_ns;
+    sim_leave();
+    return XST_SUCCESS;
+}
+
+int XIic_SetAddress(XIic *InstancePtr, int AddressType, int Address) {
+    sim_enter();
+    if (AddressType == XII_ADDR_TO_SEND_TYPE) {
+        InstancePtr->AddrOfSlave = Address;
+    }
+    now_ns += sim_iic_cfg.axil_ns / 4;
+    sim_leave();
+    return XST_SUCCESS;
+}
+
+u16 XIic_GetAddress(XIic *InstancePtr, int AddressType) {
+    return AddressType == XII_ADDR_TO_SEND_TYPE ? (u16)InstancePtr->AddrOfSlave : 0;
+}
+
+int XIic_SetOptions(XIic *InstancePtr, u32 Options) {
+    sim_enter();
+    InstancePtr->Options = Options;
+    now_ns += sim_iic_cfg.axil_ns / 4;
+    sim_leave();
+    return XST_SUCCESS;
+}
+
+u32 XIic_GetOptions(XIic *InstancePtr) {
+    return InstancePtr->Options;
+}
+
+// Busy unless we still hold the bus from a repeated START; arms the BNB interrupt like the driver
+static int sim_master_start(XIic *InstancePtr, u8 *Buf, int Count, int Read) {
+    int Nack;
+
+    if (!InstancePtr->IsStarted) {
+        return XST_FAILURE;
+    }
+    if (ev_kind != SIM_EV_NONE || now_ns < busy_until || now_ns < other_until) {
+        InstancePtr->Stats.BusBusy++;
+        bnb_armed = 1;
+        return XST_IIC_BUS_BUSY;
+    }
+
+    if (Read) {
+        InstancePtr->RecvBufferPtr = Buf;
+        InstancePtr->RecvByteCount = Count;
+    } else {
+        InstancePtr->SendBufferPtr = Buf;
+        InstancePtr->SendByteCount = Count;
+    }
+
+    sim_xfer((u8)InstancePtr->AddrOfSlave, Buf, Count, Read,
+             !(InstancePtr->Options & XII_REPEATED_START_OPTION), &Nack);
+
+    ev_kind = Nack ? SIM_EV_STATUS : (Read ? SIM_EV_RECV : SIM_EV_SEND);
+    ev_status = XII_SLAVE_NO_ACK_EVENT;
+    ev_at = busy_until;
+
+    return XST_SUCCESS;
+}
+
+int XIic_MasterSend(XIic *InstancePtr, u8 *TxMsgPtr, int ByteCount) {
+    int Status;
+
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns * 2;
+    Status = sim_master_start(InstancePtr, TxMsgPtr, ByteCount, 0);
+    sim_leave();
+    return Status;
+}
+
+int XIic_MasterRecv(XIic *InstancePtr, u8 *RxMsgPtr, int ByteCount) {
+    int Status;
+
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns * 2;
+    Status = sim_master_start(InstancePtr, RxMsgPtr, ByteCount, 1);
+    sim_leave();
+    return Status;
+}
+
+u32 XIic_IsIicBusy(XIic *InstancePtr) {
+    u32 Busy;
+
+    (void)InstancePtr;
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns / 4;
+    Busy = sim_bus_busy() ? TRUE : FALSE;
+    sim_leave();
+    return Busy;
+}
+
+void XIic_SetSendHandler(XIic *InstancePtr, void *CallBackRef, XIic_Handler FuncPtr) {
+    InstancePtr->SendHandler = FuncPtr;
+    InstancePtr->SendCallBackRef = CallBackRef;
+}
+
+void XIic_SetRecvHandler(XIic *InstancePtr, void *CallBackRef, XIic_Handler FuncPtr) {
+    InstancePtr->RecvHandler = FuncPtr;
+    InstancePtr->RecvCallBackRef = CallBackRef;
+}
+
+void XIic_SetStatusHandler(XIic *InstancePtr, void *CallBackRef, XIic_StatusHandler FuncPtr) {
+    InstancePtr->StatusHandler = FuncPtr;
+    InstancePtr->StatusCallBackRef = CallBackRef;
+}
+
+void XIic_InterruptHandler(void *InstancePtr) {
+    XIic *Inst = (XIic *)InstancePtr;
+    int Kind = SIM_EV_NONE;
+
+    Inst->Stats.IicInterrupts++;
+
+    if (ev_kind != SIM_EV_NONE && now_ns >= ev_at) {
+        Kind = ev_kind;
+        ev_kind = SIM_EV_NONE;
+    } else if (bnb_armed && !sim_bus_busy()) {
+        bnb_armed = 0;
+        if (Inst->StatusHandler) {
+            Inst->StatusHandler(Inst->StatusCallBackRef, XII_BUS_NOT_BUSY_EVENT);
+        }
+        return;
+    }
+
+    switch (Kind) {
+    case SIM_EV_SEND:
+        Inst->Stats.SendInterrupts++;
+        if (Inst->SendHandler) {
+            Inst->SendHandler(Inst->SendCallBackRef, 0);
+        }
+        break;
+    case SIM_EV_RECV:
+        Inst->Stats.RecvInterrupts++;
+        if (Inst->RecvHandler) {
+            Inst->RecvHandler(Inst->RecvCallBackRef, 0);
+        }
+        break;
+    case SIM_EV_STATUS:
+        Inst->Stats.TxErrors++;
+        if (Inst->StatusHandler) {
+            Inst->StatusHandler(Inst->StatusCallBackRef, ev_status);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void XIic_IntrGlobalDisable(UINTPTR BaseAddress) {
+    (void)BaseAddress;
+    iic_gie = 0;
+}
+
+void XIic_IntrGlobalEnable(UINTPTR BaseAddress) {
+    (void)BaseAddress;
+    iic_gie = 1;
+    if (in_model == 0) {
+        sim_service();
+    }
+}
+
+u32 XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset) {
+    u32 Value = 0;
+
+    (void)BaseAddress;
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns / 4;
+    if (RegOffset == XIIC_SR_REG_OFFSET && sim_bus_busy()) {
+        Value |= XIIC_SR_BUS_BUSY_MASK;
+    }
+    sim_leave();
+    return Value;
+}
+
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 Data) {
+    (void)BaseAddress;
+    (void)RegOffset;
+    (void)Data;
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns / 4;
+    sim_leave();
+}
+
+// The CPU waits for the whole transfer, as the polled driver does
+static unsigned sim_polled(u8 Address, u8 *BufferPtr, unsigned ByteCount, u8 Option, int Read) {
+    u64 Before;
+    int Nack;
+    int Done;
+
+    sim_enter();
+    now_ns += sim_iic_cfg.axil_ns;
+    Before = now_ns;
+    Done = sim_xfer(Address, BufferPtr, (int)ByteCount, Read, Option != XIIC_REPEATED_START, &Nack);
+    now_ns = busy_until;
+    sim_iic_stats.PolledNs += now_ns - Before;
+    sim_leave();
+
+    return Nack && Done == 0 ? 0 : (unsigned)Done;
+}
+
+unsigned XIic_Send(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr, unsigned ByteCount, u8 Option) {
+    (void)BaseAddress;
+    return sim_polled(Address, BufferPtr, ByteCount, Option, 0);
+}
+
+unsigned XIic_Recv(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr, unsigned ByteCount, u8 Option) {
+    (void)BaseAddress;
+    return sim_polled(Address, BufferPtr, ByteCount, Option, 1);
+}
+
+/***** AXI INTC and exceptions *****/
+int XIntc_Initialize(XIntc *InstancePtr, u16 DeviceId) {
+    (void)DeviceId;
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->IsReady = 1;
+    intc = InstancePtr;
+    return XST_SUCCESS;
+}
+
+int XIntc_Connect(XIntc *InstancePtr, u8 Id, XInterruptHandler Handler, void *CallBackRef) {
+    InstancePtr->Table[Id].Handler = Handler;
+    InstancePtr->Table[Id].CallBackRef = CallBackRef;
+    return XST_SUCCESS;
+}
+
+int XIntc_Start(XIntc *InstancePtr, u8 Mode) {
+    (void)Mode;
+    InstancePtr->IsStarted = 1;
+    return XST_SUCCESS;
+}
+
+void XIntc_Enable(XIntc *InstancePtr, u8 Id) {
+    InstancePtr->EnableMask |= 1U << Id;
+}
+
+void XIntc_Disable(XIntc *InstancePtr, u8 Id) {
+    InstancePtr->EnableMask &= ~(1U << Id);
+}
+
+void XIntc_InterruptHandler(XIntc *InstancePtr) {
+    XIntc_VectorTableEntry *Entry = &InstancePtr->Table[XPAR_INTC_0_IIC_0_VEC_ID];
+
+    if (sim_irq_line() && Entry->Handler) {
+        Entry->Handler(Entry->CallBackRef);
+    }
+}
+
+void Xil_ExceptionInit(void) {
+}
+
+void Xil_ExceptionEnable(void) {
+    exc_enabled = 1;
+    if (in_model == 0) {
+        sim_service();
+    }
+}
+
+void Xil_ExceptionDisable(void) {
+    exc_enabled = 0;
+}
+
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data) {
+    if (Exception_id == XIL_EXCEPTION_ID_INT) {
+        exc_handler = Handler;
+        exc_data = Data;
+    }
+}
+
+/***** Sleep *****/
+int sim_usleep(unsigned long useconds) {
+    sim_cpu((u64)useconds * 1000ULL);
+    return 0;
+}
+
+unsigned sim_sleep(unsigned int seconds) {
+    sim_cpu((u64)seconds * 1000000000ULL);
+    return 0;
+}
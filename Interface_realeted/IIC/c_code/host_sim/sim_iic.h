@@ -0,0 +1,63 @@
+#ifndef SIM_IIC_H
+#define SIM_IIC_H
+
+// Host model of one AXI IIC master, its AXI INTC line and the I2C bus
+// behind it. Device models attach to the bus; times are simulated ns.
+
+#include "xil_types.h"
+
+typedef struct SimIicDev SimIicDev;
+
+struct SimIicDev {
+    const char *Name;
+    u8 Addr;                        // 7-bit address
+    u8 Channel;                     // Mux channels it sits behind, 0 = root bus
+    int  (*Start)(SimIicDev *Dev, int Read);   // Address phase, 1 = ACK
+    int  (*Write)(SimIicDev *Dev, u8 Byte);    // 1 = ACK
+    u8   (*Read)(SimIicDev *Dev);
+    void (*Stop)(SimIicDev *Dev);
+    void *Priv;
+    u32 Starts;                     // Address phases ACKed, repeated STARTs included
+    u32 Nacks;
+    SimIicDev *Next;
+};
+
+typedef struct {
+    u32 iic_hz;                     // SCL frequency
+    u32 axil_ns;                    // One driver call (a few AXI-Lite accesses)
+    u32 isr_ns;                     // Interrupt entry + exit
+} SimIicConfig;
+
+typedef struct {
+    u64 Transfers;                  // START ... STOP or repeated START segments
+    u64 Bytes;                      // Data bytes, address bytes excluded
+    u64 Nacks;
+    u64 RepeatedStarts;
+    u64 Stops;
+    u64 Interrupts;
+    u64 BusNs;                      // SCL time spent on the bus
+    u64 PolledNs;                   // CPU time lost in XIic_Send/XIic_Recv
+} SimIicStats;
+
+extern SimIicConfig sim_iic_cfg;
+extern SimIicStats sim_iic_stats;
+
+u64  sim_now(void);
+void sim_cpu(u64 ns);               // Application work, interrupts due meanwhile are taken
+void sim_iic_reset(void);           // Clears time, stats, devices and the mux state
+void sim_iic_attach(SimIicDev *Dev);
+void sim_iic_hold_bus(u64 ns);      // Another master owns the bus for a while
+void sim_iic_set_channel(u8 Channel);
+u8   sim_iic_channel(void);
+u64  sim_iic_xfer_end(void);        // STOP time of the transfer being executed
+
+// Device models in sim_iic_devs.c
+SimIicDev *sim_eeprom_create(u8 Addr, u8 Channel, u32 Size, u16 Page, u8 AddrBytes, u32 WriteUs);
+u8        *sim_eeprom_mem(SimIicDev *Dev);
+SimIicDev *sim_mux_create(u8 Addr);
+SimIicDev *sim_regdev_create(u8 Addr, u8 Channel, u16 NumRegs, u8 AddrBytes, int AutoInc);
+u8        *sim_regdev_regs(SimIicDev *Dev);
+u32        sim_regdev_writes(SimIicDev *Dev);      // Register bytes written
+u32        sim_regdev_reads(SimIicDev *Dev);
+
+#endif /* SIM_IIC_H */
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim_iic.h"
+
+/***** 24xx EEPROM *****/
+typedef struct {
+    u8 *Mem;
+    u32 Size;
+    u16 Page;
+    u8 AddrBytes;
+    u32 WriteNs;                    // Internal write cycle
+    u64 BusyUntil;                  // NACKs its address until then
+    u32 Ptr;                        // Current address
+    int AddrLeft;                   // Address bytes still to come in this write
+    u8 *PageBuf;                    // Latched data, committed on STOP
+    u8 *PageValid;
+    int Latched;
+} SimEeprom;
+
+static int eeprom_start(SimIicDev *Dev, int Read) {
+    SimEeprom *E = Dev->Priv;
+
+    if (sim_now() < E->BusyUntil) {
+        return 0;
+    }
+    if (!Read) {
+        E->AddrLeft = E->AddrBytes;
+        E->Latched = 0;
+        memset(E->PageValid, 0, E->Page);
+    }
+    return 1;
+}
+
+static int eeprom_write(SimIicDev *Dev, u8 Byte) {
+    SimEeprom *E = Dev->Priv;
+    u32 Base;
+
+    if (E->AddrLeft) {
+        E->AddrLeft--;
+        if (E->AddrLeft + 1 == E->AddrBytes) {
+            E->Ptr = 0;
+        }
+        E->Ptr = ((E->Ptr << 8) | Byte) % E->Size;
+        return 1;
+    }
+
+    // The address rolls over inside the page, as on the real part
+    Base = E->Ptr - E->Ptr % E->Page;
+    E->PageBuf[E->Ptr % E->Page] = Byte;
+    E->PageValid[E->Ptr % E->Page] = 1;
+    E->Ptr = Base + (E->Ptr + 1) % E->Page;
+    E->Latched = 1;
+    return 1;
+}
+
+static u8 eeprom_read(SimIicDev *Dev) {
+    SimEeprom *E = Dev->Priv;
+    u8 Byte = E->Mem[E->Ptr];
+
+    E->Ptr = (E->Ptr + 1) % E->Size;
+    return Byte;
+}
+
+static void eeprom_stop(SimIicDev *Dev) {
+    SimEeprom *E = Dev->Priv;
+    u32 Base = E->Ptr - E->Ptr % E->Page;
+    u32 i;
+
+    if (!E->Latched) {
+        return;
+    }
+    for (i = 0; i < E->Page; i++) {
+        if (E->PageValid[i]) {
+            E->Mem[Base + i] = E->PageBuf[i];
+        }
+    }
+    E->Latched = 0;
+    E->BusyUntil = sim_iic_xfer_end() + E->WriteNs;
+}
+
+SimIicDev *sim_eeprom_create(u8 Addr, u8 Channel, u32 Size, u16 Page, u8 AddrBytes, u32 WriteUs) {
+    SimIicDev *Dev = calloc(1, sizeof(*Dev));
+    SimEeprom *E = calloc(1, sizeof(*E));
+
+    E->Mem = malloc(Size);
+    memset(E->Mem, 0xFF, Size);
+    E->Size = Size;
+    E->Page = Page;
+    E->AddrBytes = AddrBytes;
+    E->WriteNs = WriteUs * 1000;
+    E->PageBuf = calloc(1, Page);
+    E->PageValid = calloc(1, Page);
+
+    Dev->Name = "eeprom";
+    Dev->Addr = Addr;
+    Dev->Channel = Channel;
+    Dev->Start = eeprom_start;
+    Dev->Write = eeprom_write;
+    Dev->Read = eeprom_read;
+    Dev->Stop = eeprom_stop;
+    Dev->Priv = E;
+    sim_iic_attach(Dev);
+
+    return Dev;
+}
+
+u8 *sim_eeprom_mem(SimIicDev *Dev) {
+    return ((SimEeprom *)Dev->Priv)->Mem;
+}
+
+/***** PCA9548 mux *****/
+static int mux_start(SimIicDev *Dev, int Read) {
+    (void)Dev;
+    (void)Read;
+    return 1;
+}
+
+static int mux_write(SimIicDev *Dev, u8 Byte) {
+    (void)Dev;
+    sim_iic_set_channel(Byte);
+    return 1;
+}
+
+static u8 mux_read(SimIicDev *Dev) {
+    (void)Dev;
+    return sim_iic_channel();
+}
+
+SimIicDev *sim_mux_create(u8 Addr) {
+    SimIicDev *Dev = calloc(1, sizeof(*Dev));
+
+    Dev->Name = "mux";
+    Dev->Addr = Addr;
+    Dev->Start = mux_start;
+    Dev->Write = mux_write;
+    Dev->Read = mux_read;
+    sim_iic_attach(Dev);
+
+    return Dev;
+}
+
+/***** Register file device (clock chips, retimers) *****/
+typedef struct {
+    u8 *Regs;
+    u16 NumRegs;
+    u8 AddrBytes;
+    int AutoInc;
+    u16 Ptr;
+    int AddrLeft;
+    u32 Writes;
+    u32 Reads;
+} SimRegDev;
+
+static int regdev_start(SimIicDev *Dev, int Read) {
+    SimRegDev *R = Dev->Priv;
+
+    if (!Read) {
+        R->AddrLeft = R->AddrBytes;
+    }
+    return 1;
+}
+
+static int regdev_write(SimIicDev *Dev, u8 Byte) {
+    SimRegDev *R = Dev->Priv;
+
+    if (R->AddrLeft) {
+        R->AddrLeft--;
+        if (R->AddrLeft + 1 == R->AddrBytes) {
+            R->Ptr = 0;
+        }
+        R->Ptr = (u16)(((R->Ptr << 8) | Byte) % R->NumRegs);
+        return 1;
+    }
+
+    R->Regs[R->Ptr] = Byte;
+    R->Writes++;
+    if (R->AutoInc) {
+        R->Ptr = (u16)((R->Ptr + 1) % R->NumRegs);
+    }
+    return 1;
+}
+
+static u8 regdev_read(SimIicDev *Dev) {
+    SimRegDev *R = Dev->Priv;
+    u8 Byte = R->Regs[R->Ptr];
+
+    R->Reads++;
+    if (R->AutoInc) {
+        R->Ptr = (u16)((R->Ptr + 1) % R->NumRegs);
+    }
+    return Byte;
+}
+
+SimIicDev *sim_regdev_create(u8 Addr, u8 Channel, u16 NumRegs, u8 AddrBytes, int AutoInc) {
+    SimIicDev *Dev = calloc(1, sizeof(*Dev));
+    SimRegDev *R = calloc(1, sizeof(*R));
+
+    R->Regs = calloc(1, NumRegs);
+    R->NumRegs = NumRegs;
+    R->AddrBytes = AddrBytes;
+    R->AutoInc = AutoInc;
+
+    Dev->Name = "regdev";
+    Dev->Addr = Addr;
+    Dev->Channel = Channel;
+    Dev->Start = regdev_start;
+    Dev->Write = regdev_write;
+    Dev->Read = regdev_read;
+    Dev->Priv = R;
+    sim_iic_attach(Dev);
+
+    return Dev;
+}
+
+u8 *sim_regdev_regs(SimIicDev *Dev) {
+    return ((SimRegDev *)Dev->Priv)->Regs;
+}
+
+u32 sim_regdev_writes(SimIicDev *Dev) {
+    return ((SimRegDev *)Dev->Priv)->Writes;
+}
+
+u32 sim_regdev_reads(SimIicDev *Dev) {
+    return ((SimRegDev *)Dev->Priv)->Reads;
+}
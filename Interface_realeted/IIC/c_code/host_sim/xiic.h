@@ -0,0 +1,106 @@
+#ifndef XIIC_H
+#define XIIC_H
+
+// Host model of the AXI IIC driver API, backed by the bus model in sim_iic.c
+
+#include "xstatus.h"
+
+/***** Options *****/
+#define XII_GENERAL_CALL_OPTION     0x00000001
+#define XII_REPEATED_START_OPTION   0x00000002
+#define XII_SEND_10_BIT_OPTION      0x00000004
+
+/***** Address types *****/
+#define XII_ADDR_TO_SEND_TYPE       1
+#define XII_ADDR_TO_RESPOND_TYPE    2
+
+/***** Status events *****/
+#define XII_BUS_NOT_BUSY_EVENT      0x00000001
+#define XII_ARB_LOST_EVENT          0x00000002
+#define XII_SLAVE_NO_ACK_EVENT      0x00000004
+#define XII_MASTER_READ_EVENT       0x00000008
+#define XII_MASTER_WRITE_EVENT      0x00000010
+#define XII_GENERAL_CALL_EVENT      0x00000020
+
+/***** Low-level XIic_Send/XIic_Recv options *****/
+#define XIIC_STOP                   0x00
+#define XIIC_REPEATED_START         0x01
+
+/***** Registers used directly by the low-level code *****/
+#define XIIC_CR_REG_OFFSET          0x100
+#define XIIC_SR_REG_OFFSET          0x104
+#define XIIC_CR_ENABLE_DEVICE_MASK  0x00000001
+#define XIIC_CR_TX_FIFO_RESET_MASK  0x00000002
+#define XIIC_SR_BUS_BUSY_MASK       0x00000004
+
+typedef void (*XIic_Handler)(void *CallBackRef, int ByteCount);
+typedef void (*XIic_StatusHandler)(void *CallBackRef, int StatusEvent);
+
+typedef struct {
+    u16 DeviceId;
+    UINTPTR BaseAddress;
+    int Has10BitAddr;
+    u8 GpOutWidth;
+} XIic_Config;
+
+typedef struct {
+    u8 ArbitrationLost;
+    u8 RepeatedStarts;
+    u8 BusBusy;
+    u8 RecvBytes;
+    u8 RecvInterrupts;
+    u8 SendBytes;
+    u8 SendInterrupts;
+    u8 TxErrors;
+    u8 IicInterrupts;
+} XIicStats;
+
+typedef struct {
+    XIicStats Stats;
+    UINTPTR BaseAddress;
+    int Has10BitAddr;
+    u32 IsReady;
+    u32 IsStarted;
+    int AddrOfSlave;
+    u32 Options;
+    u8 *SendBufferPtr;
+    u8 *RecvBufferPtr;
+    int SendByteCount;
+    int RecvByteCount;
+    XIic_Handler SendHandler;
+    void *SendCallBackRef;
+    XIic_Handler RecvHandler;
+    void *RecvCallBackRef;
+    XIic_StatusHandler StatusHandler;
+    void *StatusCallBackRef;
+} XIic;
+
+XIic_Config *XIic_LookupConfig(u16 DeviceId);
+int  XIic_CfgInitialize(XIic *InstancePtr, XIic_Config *Config, UINTPTR EffectiveAddr);
+int  XIic_Start(XIic *InstancePtr);
+int  XIic_Stop(XIic *InstancePtr);
+int  XIic_SetAddress(XIic *InstancePtr, int AddressType, int Address);
+u16  XIic_GetAddress(XIic *InstancePtr, int AddressType);
+int  XIic_SetOptions(XIic *InstancePtr, u32 Options);
+u32  XIic_GetOptions(XIic *InstancePtr);
+int  XIic_MasterSend(XIic *InstancePtr, u8 *TxMsgPtr, int ByteCount);
+int  XIic_MasterRecv(XIic *InstancePtr, u8 *RxMsgPtr, int ByteCount);
+u32  XIic_IsIicBusy(XIic *InstancePtr);
+void XIic_SetSendHandler(XIic *InstancePtr, void *CallBackRef, XIic_Handler FuncPtr);
+void XIic_SetRecvHandler(XIic *InstancePtr, void *CallBackRef, XIic_Handler FuncPtr);
+void XIic_SetStatusHandler(XIic *InstancePtr, void *CallBackRef, XIic_StatusHandler FuncPtr);
+void XIic_InterruptHandler(void *InstancePtr);
+
+// Macros on the board, functions here
+void XIic_IntrGlobalDisable(UINTPTR BaseAddress);
+void XIic_IntrGlobalEnable(UINTPTR BaseAddress);
+
+// Register access, macros on the board. Only SR.BB and the CR writes are modelled.
+u32  XIic_ReadReg(UINTPTR BaseAddress, u32 RegOffset);
+void XIic_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 Data);
+
+// Polled low-level transfers, return the number of bytes moved
+unsigned XIic_Send(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr, unsigned ByteCount, u8 Option);
+unsigned XIic_Recv(UINTPTR BaseAddress, u8 Address, u8 *BufferPtr, unsigned ByteCount, u8 Option);
+
+#endif /* XIIC_H */
@@ -0,0 +1,10 @@
+#ifndef XIL_ASSERT_H
+#define XIL_ASSERT_H
+
+#include <assert.h>
+#include "xil_printf.h"
+
+#define Xil_AssertVoid(Expression)      assert(Expression)
+#define Xil_AssertNonvoid(Expression)   assert(Expression)
+
+#endif /* XIL_ASSERT_H */
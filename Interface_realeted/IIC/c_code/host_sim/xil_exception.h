@@ -0,0 +1,13 @@
+#ifndef XIL_EXCEPTION_H
+#define XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+#define XIL_EXCEPTION_ID_INT    0U
+
+void Xil_ExceptionInit(void);
+void Xil_ExceptionEnable(void);
+void Xil_ExceptionDisable(void);
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data);
+
+#endif /* XIL_EXCEPTION_H */
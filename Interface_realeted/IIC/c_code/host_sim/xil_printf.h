@@ -0,0 +1,9 @@
+#ifndef XIL_PRINTF_H
+#define XIL_PRINTF_H
+
+#include <stdio.h>
+
+#define xil_printf printf
+#define print(s)   fputs((s), stdout)
+
+#endif /* XIL_PRINTF_H */
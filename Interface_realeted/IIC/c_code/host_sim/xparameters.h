@@ -0,0 +1,11 @@
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// One AXI IIC behind one AXI INTC, as in the MicroBlaze designs
+
+#define XPAR_IIC_0_DEVICE_ID        0
+#define XPAR_IIC_0_BASEADDR         0x40800000
+#define XPAR_INTC_0_DEVICE_ID       0
+#define XPAR_INTC_0_IIC_0_VEC_ID    0
+
+#endif /* XPARAMETERS_H */
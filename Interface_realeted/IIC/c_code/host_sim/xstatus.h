@@ -0,0 +1,14 @@
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS             0L
+#define XST_FAILURE             1L
+#define XST_DEVICE_NOT_FOUND    2L
+#define XST_DEVICE_IS_STARTED   5L
+#define XST_DEVICE_BUSY         21L
+#define XST_IIC_BUS_BUSY        1076L
+#define XST_IIC_GENERAL_CALL_ADDRESS 1077L
+
+#endif /* XSTATUS_H */
@@ -0,0 +1,212 @@
+#include "sleep.h"
+#include "iic_eeprom.h"
+
+// Slave address and address bytes of Offset
+static u8 iic_eeprom_address(IicEeprom *Eeprom, u32 Offset, u8 *AddrBuffer) {
+    if (Eeprom->AddrBytes == 2) {
+        AddrBuffer[0] = (u8)(Offset >> 8);
+        AddrBuffer[1] = (u8)Offset;
+        return Eeprom->Addr;
+    }
+
+    AddrBuffer[0] = (u8)Offset;
+    return Eeprom->Addr | (u8)((Offset >> 8) & 0x07);
+}
+
+// Another master owns the bus until its STOP, check once per microsecond
+static int iic_eeprom_wait_idle(IicEeprom *Eeprom) {
+    int TimeOut = IIC_EEPROM_IDLE_TIMEOUT_US;
+
+    if (!(XIic_ReadReg(Eeprom->BaseAddress, XIIC_SR_REG_OFFSET) & XIIC_SR_BUS_BUSY_MASK)) {
+        return XST_SUCCESS;
+    }
+
+    Eeprom->BusWaits++;
+    while (TimeOut) {
+        usleep(1U);
+        if (!(XIic_ReadReg(Eeprom->BaseAddress, XIIC_SR_REG_OFFSET) & XIIC_SR_BUS_BUSY_MASK)) {
+            return XST_SUCCESS;
+        }
+        TimeOut--;
+    }
+
+    return XST_FAILURE;
+}
+
+// Sends Count bytes, repeating while the part NACKs its address (write cycle)
+static int iic_eeprom_send(IicEeprom *Eeprom, u8 Addr, u8 *BufferPtr, unsigned Count, u8 Option) {
+    unsigned Sent;
+    u32 Polls;
+
+    for (Polls = 0; Polls < IIC_EEPROM_POLL_MAX; Polls++) {
+        // Another master is not a NACK, wait for it without using up a poll
+        if (iic_eeprom_wait_idle(Eeprom) != XST_SUCCESS) {
+            xil_printf("EEPROM 0x%02X bus stays busy\r\n", Addr);
+            return XST_FAILURE;
+        }
+
+        Sent = XIic_Send(Eeprom->BaseAddress, Addr, BufferPtr, Count, Option);
+        if (Sent == Count) {
+            return XST_SUCCESS;
+        }
+
+        // Send is aborted so reset Tx FIFO
+        XIic_WriteReg(Eeprom->BaseAddress, XIIC_CR_REG_OFFSET, XIIC_CR_TX_FIFO_RESET_MASK);
+        XIic_WriteReg(Eeprom->BaseAddress, XIIC_CR_REG_OFFSET, XIIC_CR_ENABLE_DEVICE_MASK);
+
+        // A NACK after the address byte is an error, not a busy part
+        if (Sent != 0) {
+            return XST_FAILURE;
+        }
+        Eeprom->Polls++;
+    }
+
+    xil_printf("EEPROM 0x%02X does not ACK\r\n", Addr);
+    return XST_FAILURE;
+}
+
+int iic_eeprom_init(IicEeprom *Eeprom, UINTPTR BaseAddress, u8 Addr, u32 Size, u16 PageSize, u8 AddrBytes) {
+    if ((AddrBytes != 1 && AddrBytes != 2) || PageSize == 0 || PageSize > IIC_EEPROM_MAX_PAGE ||
+        (AddrBytes == 1 && Size > 2048) || Size % PageSize) {
+        xil_printf("EEPROM 0x%02X geometry not supported\r\n", Addr);
+        return XST_FAILURE;
+    }
+
+    Eeprom->BaseAddress = BaseAddress;
+    Eeprom->Addr = Addr;
+    Eeprom->AddrBytes = AddrBytes;
+    Eeprom->PageSize = PageSize;
+    Eeprom->Size = Size;
+    Eeprom->Polls = 0;
+    Eeprom->BusWaits = 0;
+    Eeprom->Pages = 0;
+
+    return XST_SUCCESS;
+}
+
+int iic_eeprom_read(IicEeprom *Eeprom, u32 Offset, u8 *BufferPtr, u32 ByteCount) {
+    u8 AddrBuffer[2];
+    u8 Addr;
+    u32 Count;
+
+    if (Offset > Eeprom->Size || ByteCount > Eeprom->Size - Offset) {
+        return XST_FAILURE;
+    }
+
+    while (ByteCount) {
+        // One transaction for everything a single slave address reaches
+        Count = ByteCount;
+        if (Eeprom->AddrBytes == 1 && Count > 256 - (Offset & 0xFF)) {
+            Count = 256 - (Offset & 0xFF);
+        }
+
+        Addr = iic_eeprom_address(Eeprom, Offset, AddrBuffer);
+        if (iic_eeprom_send(Eeprom, Addr, AddrBuffer, Eeprom->AddrBytes, XIIC_REPEATED_START) != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+        if (XIic_Recv(Eeprom->BaseAddress, Addr, BufferPtr, Count, XIIC_STOP) != Count) {
+            return XST_FAILURE;
+        }
+
+        Offset += Count;
+        BufferPtr += Count;
+        ByteCount -= Count;
+    }
+
+    return XST_SUCCESS;
+}
+
+int iic_eeprom_write(IicEeprom *Eeprom, u32 Offset, const u8 *BufferPtr, u32 ByteCount) {
+    u8 WriteBuffer[2 + IIC_EEPROM_MAX_PAGE];
+    u8 Addr;
+    u32 Count;
+    u32 i;
+
+    if (Offset > Eeprom->Size || ByteCount > Eeprom->Size - Offset) {
+        return XST_FAILURE;
+    }
+
+    while (ByteCount) {
+        // Never cross a page, the part would wrap to the start of it
+        Count = Eeprom->PageSize - Offset % Eeprom->PageSize;
+        if (Count > ByteCount) {
+            Count = ByteCount;
+        }
+
+        Addr = iic_eeprom_address(Eeprom, Offset, WriteBuffer);
+        for (i = 0; i < Count; i++) {
+            WriteBuffer[Eeprom->AddrBytes + i] = BufferPtr[i];
+        }
+
+        // The address phase ACK-polls the write cycle of the previous page
+        if (iic_eeprom_send(Eeprom, Addr, WriteBuffer, Eeprom->AddrBytes + Count, XIIC_STOP) != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+        Eeprom->Pages++;
+
+        Offset += Count;
+        BufferPtr += Count;
+        ByteCount -= Count;
+    }
+
+    // The last page is committed once this returns
+    return iic_eeprom_wait_ready(Eeprom);
+}
+
+int iic_eeprom_wait_ready(IicEeprom *Eeprom) {
+    u8 AddrBuffer[2] = { 0, 0 };
+
+    // Setting the address pointer is harmless and only ACKs when idle
+    return iic_eeprom_send(Eeprom, Eeprom->Addr, AddrBuffer, Eeprom->AddrBytes, XIIC_STOP);
+}
+
+u32 iic_crc32(u32 Crc, const u8 *BufferPtr, u32 ByteCount) {
+    static const u32 Table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    u32 i;
+
+    // Nibble table: 64 bytes of rodata instead of 1 KB
+    Crc = ~Crc;
+    for (i = 0; i < ByteCount; i++) {
+        Crc ^= BufferPtr[i];
+        Crc = (Crc >> 4) ^ Table[Crc & 0x0F];
+        Crc = (Crc >> 4) ^ Table[Crc & 0x0F];
+    }
+    return ~Crc;
+}
+
+int iic_eeprom_crc(IicEeprom *Eeprom, u32 Offset, u32 ByteCount, u32 *Crc) {
+    u8 Buffer[IIC_EEPROM_CRC_CHUNK];
+    u32 Count;
+
+    *Crc = 0;
+    while (ByteCount) {
+        Count = ByteCount < IIC_EEPROM_CRC_CHUNK ? ByteCount : IIC_EEPROM_CRC_CHUNK;
+        if (iic_eeprom_read(Eeprom, Offset, Buffer, Count) != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
+        *Crc = iic_crc32(*Crc, Buffer, Count);
+        Offset += Count;
+        ByteCount -= Count;
+    }
+
+    return XST_SUCCESS;
+}
+
+int iic_eeprom_verify(IicEeprom *Eeprom, u32 Offset, const u8 *BufferPtr, u32 ByteCount) {
+    u32 Expected = iic_crc32(0, BufferPtr, ByteCount);
+    u32 Crc;
+
+    if (iic_eeprom_crc(Eeprom, Offset, ByteCount, &Crc) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    if (Crc != Expected) {
+        xil_printf("EEPROM 0x%02X CRC 0x%08X at 0x%04X, expected 0x%08X\r\n",
+                   Eeprom->Addr, Crc, Offset, Expected);
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
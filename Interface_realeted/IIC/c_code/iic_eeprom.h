@@ -0,0 +1,58 @@
+#ifndef IIC_EEPROM_H
+#define IIC_EEPROM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xiic.h"
+#include "xil_printf.h"
+
+/*
+ * Bulk driver for 24xx serial EEPROMs on the polled low-level XIic
+ * functions, usable at boot before any interrupt is set up.
+ *
+ * Reads of any length are one address write, repeated START and one
+ * sequential read; 1-byte addressed parts larger than 256 bytes (24C04..16)
+ * carry the upper address bits in the slave address, so there a read is
+ * split per 256-byte block. Writes are split at page boundaries. The
+ * write cycle of a page is waited for by ACK polling: the next address
+ * phase is simply repeated until the part ACKs it. A bus held by another
+ * master is waited out first, up to IIC_EEPROM_IDLE_TIMEOUT_US, and does
+ * not count as a poll.
+ *
+ * Must not run while the interrupt driven driver has a transfer in flight.
+ */
+
+#define IIC_EEPROM_MAX_PAGE     64      // Largest page supported, 24C256/512
+#define IIC_EEPROM_POLL_MAX     2000    // Address NACKs before giving up, > 20 ms at 400 kHz
+#define IIC_EEPROM_IDLE_TIMEOUT_US 10000 // Wait for another master's STOP
+#define IIC_EEPROM_CRC_CHUNK    256     // Read size of iic_eeprom_crc()
+
+typedef struct {
+    UINTPTR BaseAddress;            // AXI IIC
+    u8 Addr;                        // 7-bit slave address, block bits clear
+    u8 AddrBytes;                   // 1 or 2 address bytes
+    u16 PageSize;
+    u32 Size;
+    u32 Polls;                      // Address phases NACKed while busy
+    u32 BusWaits;                   // Address phases that found another master on the bus
+    u32 Pages;                      // Page writes
+} IicEeprom;
+
+int iic_eeprom_init(IicEeprom *Eeprom, UINTPTR BaseAddress, u8 Addr, u32 Size, u16 PageSize, u8 AddrBytes);
+int iic_eeprom_read(IicEeprom *Eeprom, u32 Offset, u8 *BufferPtr, u32 ByteCount);
+int iic_eeprom_write(IicEeprom *Eeprom, u32 Offset, const u8 *BufferPtr, u32 ByteCount);
+int iic_eeprom_wait_ready(IicEeprom *Eeprom);
+
+// CRC-32 (IEEE 802.3), start with Crc = 0
+u32 iic_crc32(u32 Crc, const u8 *BufferPtr, u32 ByteCount);
+int iic_eeprom_crc(IicEeprom *Eeprom, u32 Offset, u32 ByteCount, u32 *Crc);
+int iic_eeprom_verify(IicEeprom *Eeprom, u32 Offset, const u8 *BufferPtr, u32 ByteCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIC_EEPROM_H */
@@ -63,20 +63,58 @@ int iic_write(XIic* IicInstPtr, u8* WriteBuffer, u16 ByteCount) {
 }
 
 int iic_read(XIic *IicInstPtr, u8 *WriteBuffer, u8 *BufferPtr, u16 ByteCount) {
+    return iic_read_reg(IicInstPtr, WriteBuffer[0], IIC_REG_ADDR_8, BufferPtr, ByteCount);
+}
+
+int iic_read_reg(XIic *IicInstPtr, u16 RegAddr, u8 AddrBytes, u8 *BufferPtr, u16 ByteCount) {
     int Status;
+    u32 Options;
+    u8 AddrBuffer[2];
+
+    if (AddrBytes == IIC_REG_ADDR_16) {
+        AddrBuffer[0] = (u8)(RegAddr >> 8);
+        AddrBuffer[1] = (u8)RegAddr;
+    } else if (AddrBytes == IIC_REG_ADDR_8) {
+        AddrBuffer[0] = (u8)RegAddr;
+    } else {
+        return XST_FAILURE;
+    }
 
+    TransmitComplete = 1;
     ReceiveComplete = 1;
+    IicInstPtr->Stats.TxErrors = 0;
 
-    Status = iic_write(IicInstPtr, WriteBuffer, 1);
+    Status = XIic_Start(IicInstPtr);
     if (Status != XST_SUCCESS) {
         return XST_FAILURE;
     }
 
-    Status = XIic_Start(IicInstPtr);
+    // Address phase without STOP, the read follows with a repeated START
+    Options = XIic_GetOptions(IicInstPtr);
+    XIic_SetOptions(IicInstPtr, Options | XII_REPEATED_START_OPTION);
+
+    Status = XIic_MasterSend(IicInstPtr, AddrBuffer, AddrBytes);
     if (Status != XST_SUCCESS) {
+        XIic_SetOptions(IicInstPtr, Options);
         return XST_FAILURE;
     }
 
+    // The bus stays ours, so only wait for the send handler. A NACK
+    // (e.g. an EEPROM still in its write cycle) ends with STOP: start over.
+    while (TransmitComplete) {
+        if (IicInstPtr->Stats.TxErrors != 0) {
+            if (!XIic_IsIicBusy(IicInstPtr)) {
+                Status = XIic_MasterSend(IicInstPtr, AddrBuffer, AddrBytes);
+                if (Status == XST_SUCCESS) {
+                    IicInstPtr->Stats.TxErrors = 0;
+                }
+            }
+        }
+    }
+
+    // The read ends the transaction with STOP
+    XIic_SetOptions(IicInstPtr, Options);
+
     Status = XIic_MasterRecv(IicInstPtr, BufferPtr, ByteCount);
     if (Status != XST_SUCCESS) {
         return XST_FAILURE;
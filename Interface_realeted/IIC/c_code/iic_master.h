@@ -9,10 +9,19 @@ extern "C" {
 #include "xiic.h"
 #include "xil_printf.h"
 
+/***** Register address width of iic_read_reg *****/
+#define IIC_REG_ADDR_8      1
+#define IIC_REG_ADDR_16     2
+
 int iic_init(XIic* IicInstPtr, u16 DeviceId);
 int iic_write(XIic* IicInstPtr, u8* WriteBuffer, u16 ByteCount);
 int iic_read(XIic *IicInstPtr, u8 *WriteBuffer, u8 *BufferPtr, u16 ByteCount);
 
+// Register address write, repeated START, then ByteCount bytes read in the
+// same transaction. EEPROMs keep incrementing across page boundaries on a
+// read, so a whole dump is one call.
+int iic_read_reg(XIic *IicInstPtr, u16 RegAddr, u8 AddrBytes, u8 *BufferPtr, u16 ByteCount);
+
 extern volatile u8 TransmitComplete;
 extern volatile u8 ReceiveComplete;
 
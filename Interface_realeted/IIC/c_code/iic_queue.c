@@ -0,0 +1,318 @@
+#include "iic_queue.h"
+#include "sleep.h"
+
+static void iic_queue_kick(IicQueue *Queue);
+
+static void iic_queue_lock(IicQueue *Queue) {
+    XIic_IntrGlobalDisable(Queue->IicInstPtr->BaseAddress);
+}
+
+static void iic_queue_unlock(IicQueue *Queue) {
+    XIic_IntrGlobalEnable(Queue->IicInstPtr->BaseAddress);
+}
+
+// Pops the head and reports it, the caller starts the next one
+static void iic_queue_complete(IicQueue *Queue, int Status) {
+    IicTxn *Txn = Queue->Head;
+
+    Queue->Head = Txn->Next;
+    if (Queue->Head == NULL) {
+        Queue->Tail = NULL;
+    }
+    Queue->Phase = IIC_QUEUE_IDLE;
+
+    if (Status == XST_SUCCESS) {
+        Queue->Completed++;
+    } else {
+        Queue->Failed++;
+    }
+
+    Txn->Next = NULL;
+    Txn->Status = Status;
+    Txn->Done = 1;
+    if (Txn->Callback) {
+        Txn->Callback(Txn->CallBackRef, Txn);
+    }
+}
+
+// Starts Phase of the head transaction, XST_IIC_BUS_BUSY leaves it waiting for BNB
+static int iic_queue_start_phase(IicQueue *Queue, int Phase) {
+    IicTxn *Txn = Queue->Head;
+    u32 Options;
+    int Status;
+
+    Queue->Phase = Phase;
+    Status = XIic_SetAddress(Queue->IicInstPtr, XII_ADDR_TO_SEND_TYPE, Txn->Addr);
+    if (Status != XST_SUCCESS) {
+        return Status;
+    }
+
+    // A write followed by a read keeps the bus: repeated START, no STOP in between
+    Options = XIic_GetOptions(Queue->IicInstPtr) & ~XII_REPEATED_START_OPTION;
+    if (Phase == IIC_QUEUE_WRITE && Txn->ReadLen) {
+        Options |= XII_REPEATED_START_OPTION;
+    }
+    XIic_SetOptions(Queue->IicInstPtr, Options);
+
+    if (Phase == IIC_QUEUE_WRITE) {
+        Status = XIic_MasterSend(Queue->IicInstPtr, Txn->WriteBuf, Txn->WriteLen);
+    } else {
+        Status = XIic_MasterRecv(Queue->IicInstPtr, Txn->ReadBuf, Txn->ReadLen);
+    }
+
+    if (Status == XST_IIC_BUS_BUSY) {
+        Queue->WaitBus = 1;
+        return XST_SUCCESS;
+    }
+    return Status;
+}
+
+// Starts the head transaction, failing the ones that cannot start
+static void iic_queue_kick(IicQueue *Queue) {
+    IicTxn *Txn;
+
+    while ((Txn = Queue->Head) != NULL) {
+        if (iic_queue_start_phase(Queue, Txn->WriteLen ? IIC_QUEUE_WRITE : IIC_QUEUE_READ) == XST_SUCCESS) {
+            return;
+        }
+        iic_queue_complete(Queue, XST_FAILURE);
+    }
+}
+
+static void iic_queue_next_phase(IicQueue *Queue, int Phase) {
+    if (iic_queue_start_phase(Queue, Phase) != XST_SUCCESS) {
+        iic_queue_complete(Queue, XST_FAILURE);
+        iic_queue_kick(Queue);
+    }
+}
+
+static void iic_queue_send_handler(void *CallBackRef, int ByteCount) {
+    IicQueue *Queue = (IicQueue *)CallBackRef;
+
+    (void)ByteCount;
+    if (Queue->Head == NULL || Queue->Phase != IIC_QUEUE_WRITE) {
+        return;
+    }
+
+    if (Queue->Head->ReadLen) {
+        iic_queue_next_phase(Queue, IIC_QUEUE_READ);
+        return;
+    }
+
+    iic_queue_complete(Queue, XST_SUCCESS);
+    iic_queue_kick(Queue);
+}
+
+static void iic_queue_recv_handler(void *CallBackRef, int ByteCount) {
+    IicQueue *Queue = (IicQueue *)CallBackRef;
+
+    (void)ByteCount;
+    if (Queue->Head == NULL || Queue->Phase != IIC_QUEUE_READ) {
+        return;
+    }
+
+    iic_queue_complete(Queue, XST_SUCCESS);
+    iic_queue_kick(Queue);
+}
+
+static void iic_queue_status_handler(void *CallBackRef, int Event) {
+    IicQueue *Queue = (IicQueue *)CallBackRef;
+    IicTxn *Txn = Queue->Head;
+
+    if (Txn == NULL) {
+        return;
+    }
+
+    if (Event & XII_BUS_NOT_BUSY_EVENT) {
+        if (Queue->WaitBus) {
+            Queue->WaitBus = 0;
+            iic_queue_next_phase(Queue, Queue->Phase);
+        }
+        return;
+    }
+
+    if (Event & (XII_SLAVE_NO_ACK_EVENT | XII_ARB_LOST_EVENT)) {
+        // A NACK also covers an EEPROM busy with its write cycle: run the
+        // whole transaction again, its register address included
+        if (Txn->Retries) {
+            Txn->Retries--;
+            Queue->Retried++;
+            iic_queue_next_phase(Queue, Txn->WriteLen ? IIC_QUEUE_WRITE : IIC_QUEUE_READ);
+            return;
+        }
+        iic_queue_complete(Queue, XST_FAILURE);
+        iic_queue_kick(Queue);
+    }
+}
+
+int iic_queue_init(IicQueue *Queue, XIic *IicInstPtr) {
+    int Status;
+
+    Queue->IicInstPtr = IicInstPtr;
+    Queue->Head = NULL;
+    Queue->Tail = NULL;
+    Queue->Phase = IIC_QUEUE_IDLE;
+    Queue->WaitBus = 0;
+    Queue->Submitted = 0;
+    Queue->Completed = 0;
+    Queue->Failed = 0;
+    Queue->Retried = 0;
+
+    XIic_SetSendHandler(IicInstPtr, Queue, iic_queue_send_handler);
+    XIic_SetRecvHandler(IicInstPtr, Queue, iic_queue_recv_handler);
+    XIic_SetStatusHandler(IicInstPtr, Queue, iic_queue_status_handler);
+
+    // The queue owns the controller from now on, it stays started
+    Status = XIic_Start(IicInstPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("IIC queue start failed\r\n");
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+void iic_txn_init(IicTxn *Txn, u8 Addr, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen) {
+    Txn->Addr = Addr;
+    Txn->WriteBuf = WriteBuf;
+    Txn->WriteLen = WriteLen;
+    Txn->ReadBuf = ReadBuf;
+    Txn->ReadLen = ReadLen;
+    Txn->Retries = IIC_QUEUE_RETRIES;
+    Txn->Callback = NULL;
+    Txn->CallBackRef = NULL;
+    Txn->Status = XST_SUCCESS;
+    Txn->Done = 0;
+    Txn->Next = NULL;
+}
+
+int iic_queue_submit(IicQueue *Queue, IicTxn *Txn) {
+    if (Txn->WriteLen == 0 && Txn->ReadLen == 0) {
+        return XST_FAILURE;
+    }
+
+    Txn->Status = IIC_TXN_PENDING;
+    Txn->Done = 0;
+    Txn->Next = NULL;
+
+    iic_queue_lock(Queue);
+
+    if (Queue->Tail) {
+        Queue->Tail->Next = Txn;
+    } else {
+        Queue->Head = Txn;
+    }
+    Queue->Tail = Txn;
+    Queue->Submitted++;
+
+    // Otherwise the handlers pick it up when the ones before are done
+    if (Queue->Head == Txn) {
+        iic_queue_kick(Queue);
+    }
+
+    iic_queue_unlock(Queue);
+
+    return XST_SUCCESS;
+}
+
+int iic_queue_wait(IicQueue *Queue, IicTxn *Txn) {
+    int TimeOut = IIC_QUEUE_WAIT_TIMEOUT_US;
+
+    (void)Queue;
+
+    // Done is set from the handlers, look again every microsecond
+    while (TimeOut) {
+        if (Txn->Done) {
+            return Txn->Status;
+        }
+        TimeOut--;
+        usleep(1U);
+    }
+
+    xil_printf("IIC queue wait timed out for device 0x%02X\r\n", Txn->Addr);
+    return XST_FAILURE;
+}
+
+int iic_queue_idle(IicQueue *Queue) {
+    return Queue->Head == NULL;
+}
+
+static void iic_batch_done(void *CallBackRef, IicTxn *Txn) {
+    IicBatch *Batch = (IicBatch *)CallBackRef;
+
+    if (Txn->Status != XST_SUCCESS) {
+        Batch->Status = XST_FAILURE;
+    }
+
+    Batch->Pending--;
+    if (Batch->Pending == 0) {
+        if (Batch->Status == IIC_TXN_PENDING) {
+            Batch->Status = XST_SUCCESS;
+        }
+        if (Batch->Handler) {
+            Batch->Handler(Batch->CallBackRef, Batch->Status);
+        }
+    }
+}
+
+int iic_queue_write_regs(IicQueue *Queue, IicBatch *Batch, u8 Addr, const IicRegWrite *Regs,
+                         u16 Count, u32 Flags, IicBatchHandler Handler, void *CallBackRef) {
+    IicTxn *Txn = NULL;
+    u16 Used = 0;
+    u16 i;
+    u8 n;
+
+    if (Count == 0) {
+        return XST_FAILURE;
+    }
+
+    // Build every transaction first, nothing goes out if the batch does not fit
+    Batch->Count = 0;
+    for (i = 0; i < Count; i++) {
+        if (Txn == NULL || (Flags & IIC_BATCH_NO_MERGE) ||
+            Regs[i].Reg != (u8)(Regs[i - 1].Reg + 1)) {
+            if (Batch->Count == IIC_BATCH_MAX_TXN || Used + 2 > IIC_BATCH_BUF) {
+                xil_printf("IIC batch too large for device 0x%02X\r\n", Addr);
+                return XST_FAILURE;
+            }
+            Txn = &Batch->Txn[Batch->Count++];
+            iic_txn_init(Txn, Addr, &Batch->Buf[Used], 1, NULL, 0);
+            Txn->Callback = iic_batch_done;
+            Txn->CallBackRef = Batch;
+            Batch->Buf[Used++] = Regs[i].Reg;
+        } else if (Used + 1 > IIC_BATCH_BUF) {
+            xil_printf("IIC batch too large for device 0x%02X\r\n", Addr);
+            return XST_FAILURE;
+        }
+        Batch->Buf[Used++] = Regs[i].Value;
+        Txn->WriteLen++;
+    }
+
+    Batch->Handler = Handler;
+    Batch->CallBackRef = CallBackRef;
+    Batch->Status = IIC_TXN_PENDING;
+    Batch->Pending = Batch->Count;
+
+    for (n = 0; n < Batch->Count; n++) {
+        iic_queue_submit(Queue, &Batch->Txn[n]);
+    }
+
+    return XST_SUCCESS;
+}
+
+int iic_batch_wait(IicQueue *Queue, IicBatch *Batch) {
+    int TimeOut = IIC_QUEUE_WAIT_TIMEOUT_US;
+
+    (void)Queue;
+
+    while (TimeOut) {
+        if (Batch->Pending == 0) {
+            return Batch->Status;
+        }
+        TimeOut--;
+        usleep(1U);
+    }
+
+    xil_printf("IIC batch wait timed out, %d writes left\r\n", Batch->Pending);
+    return XST_FAILURE;
+}
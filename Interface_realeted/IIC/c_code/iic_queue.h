@@ -0,0 +1,106 @@
+#ifndef IIC_QUEUE_H
+#define IIC_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xiic.h"
+#include "xil_printf.h"
+
+/*
+ * Interrupt driven IIC transaction queue. Transactions are submitted from
+ * the main loop and run back to back from the Send/Recv/Status handlers of
+ * the XIic driver, so the CPU only spends a few register accesses per
+ * transfer instead of spinning for the whole bus time.
+ *
+ * A transaction is a write of WriteLen bytes, a read of ReadLen bytes, or
+ * a write then a read joined by a repeated START (register address, then
+ * data). Its buffers and the IicTxn itself must stay valid until Done is
+ * set, also after a wait timed out. The callback runs in interrupt context.
+ */
+
+#define IIC_TXN_PENDING         1       // Status while queued or on the bus
+
+#define IIC_QUEUE_RETRIES       500     // Default NACK retries, covers a 5 ms EEPROM write cycle at 400 kHz
+#define IIC_QUEUE_WAIT_TIMEOUT_US   1000000 // iic_queue_wait()/iic_batch_wait() give up after 1 s
+
+typedef struct IicTxn IicTxn;
+
+typedef void (*IicTxnHandler)(void *CallBackRef, IicTxn *Txn);
+
+struct IicTxn {
+    u8 Addr;                        // 7-bit slave address
+    u8 *WriteBuf;
+    u16 WriteLen;
+    u8 *ReadBuf;
+    u16 ReadLen;
+    u16 Retries;                    // NACK / arbitration lost retries left
+    IicTxnHandler Callback;         // Optional, called on completion
+    void *CallBackRef;
+    volatile int Status;            // IIC_TXN_PENDING, then XST_SUCCESS or XST_FAILURE
+    volatile u8 Done;
+    IicTxn *Next;
+};
+
+#define IIC_QUEUE_IDLE          0
+#define IIC_QUEUE_WRITE         1
+#define IIC_QUEUE_READ          2
+
+typedef struct {
+    XIic *IicInstPtr;
+    IicTxn *Head;                   // On the bus, or next to go
+    IicTxn *Tail;
+    volatile int Phase;
+    volatile u8 WaitBus;            // Waiting for the bus-not-busy interrupt
+    u32 Submitted;
+    u32 Completed;
+    u32 Failed;
+    u32 Retried;
+} IicQueue;
+
+int  iic_queue_init(IicQueue *Queue, XIic *IicInstPtr);
+void iic_txn_init(IicTxn *Txn, u8 Addr, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen);
+int  iic_queue_submit(IicQueue *Queue, IicTxn *Txn);
+int  iic_queue_wait(IicQueue *Queue, IicTxn *Txn);
+int  iic_queue_idle(IicQueue *Queue);
+
+/*
+ * Register write batch for one device. Runs of consecutive registers are
+ * merged into one auto-increment write (address byte, then the values);
+ * pass IIC_BATCH_NO_MERGE for devices that do not auto-increment.
+ * Handler, if set, is called once with the batch status after the last
+ * write.
+ */
+#define IIC_BATCH_MAX_TXN       8
+#define IIC_BATCH_BUF           64
+
+#define IIC_BATCH_NO_MERGE      0x01
+
+typedef struct {
+    u8 Reg;
+    u8 Value;
+} IicRegWrite;
+
+typedef void (*IicBatchHandler)(void *CallBackRef, int Status);
+
+typedef struct {
+    IicTxn Txn[IIC_BATCH_MAX_TXN];
+    u8 Buf[IIC_BATCH_BUF];
+    u8 Count;
+    volatile u8 Pending;
+    volatile int Status;
+    IicBatchHandler Handler;
+    void *CallBackRef;
+} IicBatch;
+
+int iic_queue_write_regs(IicQueue *Queue, IicBatch *Batch, u8 Addr, const IicRegWrite *Regs,
+                         u16 Count, u32 Flags, IicBatchHandler Handler, void *CallBackRef);
+int iic_batch_wait(IicQueue *Queue, IicBatch *Batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIC_QUEUE_H */
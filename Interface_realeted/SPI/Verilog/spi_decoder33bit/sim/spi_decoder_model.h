@@ -0,0 +1,123 @@
+// Cycle-level C++ model of spi_decoder.v. One call per SCK rising edge,
+// cs_n as a level: the same registers as the RTL, updated with the values
+// they held before the edge (non-blocking), reset asynchronously while cs_n
+// is high. channel and cmd are not reset, as in the RTL.
+//
+// register_table holds the four banks of kBankWords, bank = channel. Frames
+// longer than 33 bits move one more word per 22 clocks at the next address
+// (block mode).
+
+#ifndef SPI_DECODER_MODEL_H
+#define SPI_DECODER_MODEL_H
+
+#include <cstdint>
+
+class SpiDecoderModel {
+public:
+    static const int kBankBits = 8;                 // BANK_AW of the RTL
+    static const int kBankWords = 1 << kBankBits;
+    static const int kTableSize = 4 * kBankWords;
+    static const int kFrameBits = 33;
+    static const int kWordBits = 22;
+
+    uint32_t register_table[kTableSize];
+
+    SpiDecoderModel()
+        : cs_n_(true), cnt_(0), read_mode_(false), channel_(0), addr_(0), cmd_(0), miso_(false), blk_cnt_(0),
+          blk_addr_(0), blk_data_(0) {
+        static const uint32_t init[10] = {
+            0x06d53e, 0x26d53e, 0x16d53e, 0x36d53e, 0x17d53e,
+            0x16d53f, 0x06d55e, 0x06d54e, 0x06d56e, 0x06d73e,
+        };
+        for (int i = 0; i < kTableSize; i++) {
+            register_table[i] = i < 10 ? init[i] : 0;
+        }
+    }
+
+    void set_cs_n(bool cs_n) {
+        cs_n_ = cs_n;
+        if (cs_n_) {
+            cnt_ = 0;
+            read_mode_ = false;
+            addr_ = 0;
+            miso_ = false;
+            blk_cnt_ = 0;
+            blk_addr_ = 0;
+        }
+    }
+
+    void posedge(bool mosi) {
+        if (cs_n_) {
+            return;
+        }
+
+        // MISO logic, on the values before the edge
+        if (read_mode_ && cnt_ >= 11 && cnt_ <= 32) {
+            miso_ = (register_table[index(addr_)] >> (32 - cnt_)) & 1;
+        } else if (read_mode_ && cnt_ == 33) {
+            miso_ = (register_table[index(blk_addr_)] >> (21 - blk_cnt_)) & 1;
+        }
+
+        // Register write logic
+        if (!read_mode_ && cnt_ == 32) {
+            register_table[index(addr_)] = ((cmd_ << 1) | mosi) & 0x3FFFFF;
+        } else if (!read_mode_ && cnt_ == 33 && blk_cnt_ == 21) {
+            register_table[index(blk_addr_)] = ((blk_data_ << 1) | mosi) & 0x3FFFFF;
+        }
+
+        // Block word counter
+        if (cnt_ == 32) {
+            blk_addr_ = (uint8_t)((addr_ + 1) & (kBankWords - 1));
+        } else if (cnt_ == 33) {
+            if (blk_cnt_ == 21) {
+                blk_cnt_ = 0;
+                blk_addr_ = (uint8_t)((blk_addr_ + 1) & (kBankWords - 1));
+            } else {
+                blk_cnt_++;
+            }
+        }
+
+        // Address and R/W mode capture logic
+        if (cnt_ == 0) {
+            read_mode_ = mosi;
+        } else if (cnt_ <= 2) {
+            channel_ = (uint8_t)(((channel_ << 1) | mosi) & 0x3);
+        } else if (cnt_ <= 10) {
+            addr_ = (uint8_t)((addr_ << 1) | mosi);
+        } else if (cnt_ <= 32) {
+            cmd_ = ((cmd_ << 1) | mosi) & 0x3FFFFF;
+        } else {
+            blk_data_ = ((blk_data_ << 1) | mosi) & 0x3FFFFF;
+        }
+
+        // Counter logic
+        if (cnt_ < 33) {
+            cnt_++;
+        }
+    }
+
+    bool miso() const { return miso_; }
+    bool r_w_flag() const { return read_mode_; }
+    uint8_t channel_sel() const { return cnt_ >= 3 ? channel_ : 0; }
+    uint8_t address() const { return cnt_ >= 11 ? addr_ : 0; }
+    uint32_t spi_cmd() const { return (!read_mode_ && cnt_ >= 33) ? cmd_ : 0; }
+    uint8_t slv_cnt_dbg() const { return cnt_; }
+
+private:
+    bool cs_n_;
+    uint8_t cnt_;
+    bool read_mode_;
+    uint8_t channel_;
+    uint8_t addr_;
+    uint32_t cmd_;
+    bool miso_;
+    uint8_t blk_cnt_;
+    uint8_t blk_addr_;
+    uint32_t blk_data_;
+
+    unsigned index(unsigned addr) const {
+        return (unsigned)channel_ * kBankWords + (addr & (kBankWords - 1));
+    }
+};
+
+#endif // SPI_DECODER_MODEL_H
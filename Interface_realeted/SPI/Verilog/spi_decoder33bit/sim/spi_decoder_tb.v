@@ -0,0 +1,186 @@
+// Self-checking testbench for spi_decoder.v that does not use the C++ model:
+// the ID values of bank 0, writes and reads on separate banks, a block write
+// that wraps at the end of a bank and its block read back, and frames cut
+// short inside the header and inside a block word, which must not store
+// anything they did not finish. Prints each mismatch and PASS or FAIL.
+//
+//   iverilog -o spi_decoder_tb spi_decoder.v sim/xilinx_prims.v sim/spi_decoder_tb.v
+//   vvp spi_decoder_tb
+`timescale 1ns / 1ps
+
+module spi_decoder_tb;
+
+localparam HALF = 50;                   // 10 MHz SCK
+localparam MAX_WORDS = 8;
+
+reg         spi_clk;
+reg         cs_n;
+reg         mosi;
+
+wire        miso;
+wire        r_w_flag;
+wire [1:0]  channel_sel;
+wire [7:0]  address;
+wire [21:0] spi_cmd;
+wire [5:0]  slv_cnt_dbg;
+
+reg  [21:0] tx [0:MAX_WORDS-1];         // Header word, then block words
+reg  [21:0] rx [0:MAX_WORDS-1];         // MISO, same layout
+
+integer     errors;
+integer     w;
+
+spi_decoder dut (
+    .spi_clk    (spi_clk),
+    .cs_n       (cs_n),
+    .mosi       (mosi),
+    .miso       (miso),
+    .r_w_flag   (r_w_flag),
+    .channel_sel(channel_sel),
+    .address    (address),
+    .spi_cmd    (spi_cmd),
+    .slv_cnt_dbg(slv_cnt_dbg)
+);
+
+task check;
+    input [21:0]    got;
+    input [21:0]    expected;
+    input [8*32:1]  what;
+    begin
+        if (got !== expected) begin
+            $display("%0s: got %06h, expected %06h", what, got, expected);
+            errors = errors + 1;
+        end
+    end
+endtask
+
+// One frame of Clocks SCK periods: rw, channel, address, then tx[0], tx[1], ...
+// MISO is sampled after every rising edge into rx[]
+task frame;
+    input           rw;
+    input [1:0]     ch;
+    input [7:0]     addr;
+    input integer   clocks;
+    integer         i;
+    reg   [21:0]    word;
+    reg   [21:0]    shift;
+    begin
+        cs_n = 1'b0;
+        #HALF;
+        for (i = 0; i < clocks; i = i + 1) begin
+            if (i == 0)         mosi = rw;
+            else if (i < 3)     mosi = ch[2 - i];
+            else if (i < 11)    mosi = addr[10 - i];
+            else begin
+                word = tx[(i - 11) / 22];
+                mosi = word[21 - (i - 11) % 22];
+            end
+
+            #HALF spi_clk = 1'b1;
+            #1;
+            if (i >= 11) begin
+                shift = {shift[20:0], miso};
+                if ((i - 11) % 22 == 21)
+                    rx[(i - 11) / 22] = shift;
+            end
+            #(HALF - 1) spi_clk = 1'b0;
+        end
+
+        // Outputs hold the header word while cs_n is low
+        if (clocks >= 33) begin
+            check(r_w_flag, rw, "r_w_flag");
+            check(channel_sel, ch, "channel_sel");
+            check(address, addr, "address");
+            check(spi_cmd, rw ? 22'd0 : tx[0], "spi_cmd");
+        end
+
+        #HALF cs_n = 1'b1;
+        #HALF;
+        check(slv_cnt_dbg, 6'd0, "slv_cnt_dbg after cs_n");
+    end
+endtask
+
+task write_reg;
+    input [1:0]     ch;
+    input [7:0]     addr;
+    input [21:0]    value;
+    begin
+        tx[0] = value;
+        frame(1'b0, ch, addr, 33);
+    end
+endtask
+
+task read_reg;
+    input [1:0]     ch;
+    input [7:0]     addr;
+    input [21:0]    expected;
+    begin
+        tx[0] = 22'd0;
+        frame(1'b1, ch, addr, 33);
+        check(rx[0], expected, "read");
+    end
+endtask
+
+initial begin
+    errors = 0;
+    spi_clk = 1'b0;
+    mosi = 1'b0;
+    cs_n = 1'b0;
+    #HALF cs_n = 1'b1;                  // Reset edge for the cs_n cleared registers
+    #HALF;
+
+    // ID and status values of the initial block, bank 0
+    read_reg(2'd0, 8'h00, 22'h06d53e);
+    read_reg(2'd0, 8'h04, 22'h17d53e);
+    read_reg(2'd0, 8'h09, 22'h06d73e);
+
+    // Same address on different banks
+    write_reg(2'd1, 8'h05, 22'h2a5a5a);
+    write_reg(2'd2, 8'h05, 22'h15a5a5);
+    read_reg(2'd1, 8'h05, 22'h2a5a5a);
+    read_reg(2'd2, 8'h05, 22'h15a5a5);
+    read_reg(2'd0, 8'h05, 22'h16d53f);
+    read_reg(2'd3, 8'h05, 22'h000000);
+
+    // Block write of 5 words from 0xFD, wraps to 0x00 and 0x01 of bank 3
+    for (w = 0; w < 5; w = w + 1)
+        tx[w] = 22'h100000 + w * 22'h01111;
+    frame(1'b0, 2'd3, 8'hFD, 11 + 22 * 5);
+    read_reg(2'd3, 8'hFD, 22'h100000);
+    read_reg(2'd3, 8'hFE, 22'h101111);
+    read_reg(2'd3, 8'hFF, 22'h102222);
+    read_reg(2'd3, 8'h00, 22'h103333);
+    read_reg(2'd3, 8'h01, 22'h104444);
+    read_reg(2'd0, 8'h00, 22'h06d53e);
+
+    // Block read of the same 5 words
+    for (w = 0; w < 5; w = w + 1)
+        tx[w] = 22'd0;
+    frame(1'b1, 2'd3, 8'hFD, 11 + 22 * 5);
+    for (w = 0; w < 5; w = w + 1)
+        check(rx[w], 22'h100000 + w * 22'h01111, "block read");
+
+    // Block write cut 10 bits into its third word: 0x42 keeps its value
+    write_reg(2'd1, 8'h42, 22'h3c3c3c);
+    tx[0] = 22'h000040;
+    tx[1] = 22'h000041;
+    tx[2] = 22'h000042;
+    frame(1'b0, 2'd1, 8'h40, 11 + 22 * 2 + 10);
+    read_reg(2'd1, 8'h40, 22'h000040);
+    read_reg(2'd1, 8'h41, 22'h000041);
+    read_reg(2'd1, 8'h42, 22'h3c3c3c);
+
+    // Header write cut at 20 bits stores nothing
+    write_reg(2'd2, 8'h50, 22'h0abcde);
+    tx[0] = 22'h3fffff;
+    frame(1'b0, 2'd2, 8'h50, 20);
+    read_reg(2'd2, 8'h50, 22'h0abcde);
+
+    if (errors)
+        $display("%0d mismatches\nFAIL", errors);
+    else
+        $display("PASS");
+    $finish;
+end
+
+endmodule
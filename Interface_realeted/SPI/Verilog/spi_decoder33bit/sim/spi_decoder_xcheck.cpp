@@ -0,0 +1,175 @@
+// Runs spi_decoder.v (Verilator) and SpiDecoderModel in lockstep on random
+// frames and compares every output after every SCK edge and every cs_n
+// rise. Most frames are the full 33 bits, some are cut short, some run on
+// into block words (and may stop inside one), and a few use the whole
+// address range. Addresses are mostly low so reads see earlier writes.
+// Reports the mismatches and how fast each side runs.
+//
+//   verilator --cc --exe --build -Wno-fatal --top-module spi_decoder
+//       spi_decoder.v sim/xilinx_prims.v sim/spi_decoder_xcheck.cpp -CFLAGS -I$PWD/sim
+//   obj_dir/Vspi_decoder [frames] [seed]
+
+#include "Vspi_decoder.h"
+#include "verilated.h"
+#include "spi_decoder_model.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define MAX_BLOCK_WORDS 8
+
+struct Frame {
+    uint64_t bits;                  // rw | channel | address | cmd, MSB first
+    uint32_t words[MAX_BLOCK_WORDS];    // Block words after the header frame
+    int clocks;                     // SCK edges with cs_n low
+};
+
+static uint32_t rng_state;
+
+static uint32_t rng() {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+static Frame random_frame() {
+    Frame f;
+    uint32_t kind = rng() % 16;
+    uint64_t rw = rng() & 1;
+    uint64_t ch = rng() & 3;
+    uint64_t addr = (kind == 0) ? (rng() & 0xFF) : (rng() % 16);
+    uint64_t cmd = rng() & 0x3FFFFF;
+
+    f.bits = (rw << 32) | (ch << 30) | (addr << 22) | cmd;
+    for (int w = 0; w < MAX_BLOCK_WORDS; w++) {
+        f.words[w] = rng() & 0x3FFFFF;
+    }
+    if (kind == 1) {
+        f.clocks = 1 + rng() % 32;                                  // Cut short
+    } else if (kind == 2) {
+        f.clocks = SpiDecoderModel::kFrameBits + 1 + rng() % 8;     // Runs long
+    } else if (kind <= 5) {
+        f.clocks = SpiDecoderModel::kFrameBits +                    // Block, maybe cut in a word
+                   (1 + rng() % MAX_BLOCK_WORDS) * SpiDecoderModel::kWordBits - (kind == 3 ? rng() % 22 : 0);
+    } else {
+        f.clocks = SpiDecoderModel::kFrameBits;
+    }
+    return f;
+}
+
+static uint64_t mismatches;
+
+static void compare(Vspi_decoder *rtl, const SpiDecoderModel &model, uint64_t frame, int edge) {
+    bool bad = rtl->r_w_flag != model.r_w_flag() || rtl->channel_sel != model.channel_sel() ||
+               rtl->address != model.address() || rtl->spi_cmd != model.spi_cmd() ||
+               rtl->slv_cnt_dbg != model.slv_cnt_dbg() || rtl->miso != model.miso();
+
+    if (bad && mismatches++ < 10) {
+        printf("frame %llu edge %d: rtl rw %d ch %d addr %02x cmd %06x cnt %2d miso %d | "
+               "model rw %d ch %d addr %02x cmd %06x cnt %2d miso %d\n",
+               (unsigned long long)frame, edge, rtl->r_w_flag, rtl->channel_sel, rtl->address,
+               rtl->spi_cmd, rtl->slv_cnt_dbg, rtl->miso, model.r_w_flag(), model.channel_sel(),
+               model.address(), model.spi_cmd(), model.slv_cnt_dbg(), model.miso());
+    }
+}
+
+static double now_s() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool frame_mosi(const Frame &f, int i) {
+    if (i < SpiDecoderModel::kFrameBits) {
+        return (f.bits >> (32 - i)) & 1;
+    }
+    i -= SpiDecoderModel::kFrameBits;
+    if (i / SpiDecoderModel::kWordBits >= MAX_BLOCK_WORDS) {
+        return 0;
+    }
+    return (f.words[i / SpiDecoderModel::kWordBits] >> (21 - i % SpiDecoderModel::kWordBits)) & 1;
+}
+
+static void rtl_edge(Vspi_decoder *rtl, bool mosi) {
+    rtl->mosi = mosi;
+    rtl->spi_clk = 0;
+    rtl->eval();
+    rtl->spi_clk = 1;
+    rtl->eval();
+}
+
+static void rtl_cs_n(Vspi_decoder *rtl, bool cs_n) {
+    rtl->spi_clk = 0;
+    rtl->cs_n = cs_n;
+    rtl->eval();
+}
+
+int main(int argc, char **argv) {
+    uint64_t count = argc > 1 ? strtoull(argv[1], NULL, 0) : 100000;
+    uint32_t seed = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+
+    Verilated::commandArgs(argc, argv);
+    Vspi_decoder *rtl = new Vspi_decoder;
+    SpiDecoderModel model;
+    std::vector<Frame> frames;
+    uint64_t edges = 0;
+    volatile bool sink = false;
+    double t;
+
+    rng_state = seed;
+    for (uint64_t n = 0; n < count; n++) {
+        frames.push_back(random_frame());
+    }
+
+    rtl->mosi = 0;
+    rtl_cs_n(rtl, true);
+    model.set_cs_n(true);
+
+    // Lockstep
+    for (uint64_t n = 0; n < count; n++) {
+        const Frame &f = frames[n];
+
+        rtl_cs_n(rtl, false);
+        model.set_cs_n(false);
+        for (int i = 0; i < f.clocks; i++) {
+            rtl_edge(rtl, frame_mosi(f, i));
+            model.posedge(frame_mosi(f, i));
+            compare(rtl, model, n, i);
+            edges++;
+        }
+        rtl_cs_n(rtl, true);
+        model.set_cs_n(true);
+        compare(rtl, model, n, -1);
+    }
+
+    // Each side alone, same frames
+    t = now_s();
+    for (uint64_t n = 0; n < count; n++) {
+        rtl_cs_n(rtl, false);
+        for (int i = 0; i < frames[n].clocks; i++) {
+            rtl_edge(rtl, frame_mosi(frames[n], i));
+        }
+        rtl_cs_n(rtl, true);
+    }
+    double rtl_s = now_s() - t;
+
+    t = now_s();
+    for (uint64_t n = 0; n < count; n++) {
+        model.set_cs_n(false);
+        for (int i = 0; i < frames[n].clocks; i++) {
+            model.posedge(frame_mosi(frames[n], i));
+            sink = sink ^ model.miso();
+        }
+        model.set_cs_n(true);
+    }
+    double model_s = now_s() - t;
+
+    printf("%llu frames, %llu edges, %llu mismatches\n", (unsigned long long)count,
+           (unsigned long long)edges, (unsigned long long)mismatches);
+    printf("verilator %8.1f ns/frame, model %6.1f ns/frame\n", rtl_s * 1e9 / count, model_s * 1e9 / count);
+
+    rtl->final();
+    delete rtl;
+    printf(mismatches ? "FAIL\n" : "PASS\n");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+// Behavioural stand-ins for the UNISIM buffers spi_decoder.v instantiates,
+// for simulators without the Xilinx libraries (Verilator)
+
+module IBUF (
+    output wire O,
+    input  wire I
+);
+    assign O = I;
+endmodule
+
+module BUFG (
+    output wire O,
+    input  wire I
+);
+    assign O = I;
+endmodule
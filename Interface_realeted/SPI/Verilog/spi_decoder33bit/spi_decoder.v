@@ -1,4 +1,15 @@
-module spi_decoder(
+// Frame: rw(1) | channel(2) | address(8) | word(22), MSB first. channel picks
+// one of four banks of 2**BANK_AW 22-bit registers. A write frame stores the
+// word at address, a read frame shifts the register at address out on MISO
+// in the word bits.
+//
+// Block mode: keep cs_n low past bit 33 and every further 22 SCK periods move
+// one more word, at address + 1, + 2, ... (wrapping inside the bank). Writes
+// store each word after its last bit; reads shift each register out MSB
+// first. address and spi_cmd keep showing the first word of the frame.
+module spi_decoder #(
+    parameter BANK_AW = 8                                   // Address bits per bank
+)(
     input               spi_clk,
     input               cs_n,
     input               mosi,
@@ -16,8 +27,10 @@ module spi_decoder(
 //================================================================
 //    Register
 //================================================================
+localparam WORDS = 4 << BANK_AW;
+
 reg [5:0]   cnt;                     // Counter for bit position
-reg [21:0]  register_table [0:9];    // Register table with 10 entries, each 22 bits wide
+reg [21:0]  register_table [0:WORDS-1];  // Four banks, selected by channel
 reg [21:0]  data_out;                // Data output register for MISO
 
 reg         read_mode;               // Flag to indicate read mode (1) or write mode (0)
@@ -25,6 +38,10 @@ reg [1:0]   channel;
 reg [7:0]   addr;                    // Address register (8 bits)
 reg [21:0]  cmd;
 
+reg [4:0]   blk_cnt;                 // Bit position in a block word
+reg [BANK_AW-1:0] blk_addr;          // Address of the block word being shifted
+reg [21:0]  blk_data;
+
 //================================================================
 //    Wire
 //================================================================
@@ -76,22 +93,57 @@ always @(posedge spi_clk or posedge cs_n) begin
         else if(cnt >= 1 && cnt <= 2)                   channel <= {channel[0], mosi};
         else if(cnt >= 3 && cnt <= 10)                  addr <= {addr[6:0], mosi};                  // Shift in address bits
         else if(cnt >= 11 && cnt <= 32)                 cmd  <= {cmd[20:0],mosi};
+        else if(cnt == 33)                              blk_data <= {blk_data[20:0], mosi};
         // else if (cnt == 11 && read_mode)                data_out <= register_table[addr[3:0]];   // Use lower 4 bits for 10-entry table
         // else if (read_mode && cnt >= 11 && cnt <= 33)   data_out <= {data_out[20:0], 1'b0};      // Shift data_out left
     end
 end
 
+//================================================================
+//    Block Word Counter
+//================================================================
+always @(posedge spi_clk or posedge cs_n) begin
+    if (cs_n) begin
+        blk_cnt <= 5'd0;
+        blk_addr <= {BANK_AW{1'b0}};
+    end
+    else if (cnt == 32) begin
+        blk_addr <= addr[BANK_AW-1:0] + 1'b1;           // First block word follows the header word
+    end
+    else if (cnt == 33) begin
+        if (blk_cnt == 5'd21) begin
+            blk_cnt <= 5'd0;
+            blk_addr <= blk_addr + 1'b1;
+        end
+        else blk_cnt <= blk_cnt + 5'd1;
+    end
+end
+
+//================================================================
+//    Register Write Logic (Write Operation)
+//================================================================
+always @(posedge spi_clk) begin
+    if (!cs_n && !read_mode) begin
+        if (cnt == 32)                                  // Last bit of the header word
+            register_table[{channel, addr[BANK_AW-1:0]}] <= {cmd[20:0], mosi};
+        else if (cnt == 33 && blk_cnt == 5'd21)         // Last bit of a block word
+            register_table[{channel, blk_addr}] <= {blk_data[20:0], mosi};
+    end
+end
+
 //================================================================
 //    MISO Output Logic (Read Operation)
 //================================================================
 always @(posedge spi_clk or posedge cs_n) begin
     if (cs_n) miso <= 1'b0;                           // Clear MISO when cs_n is high
     else if (read_mode && cnt >= 11 && cnt <= 32)     // Transmit data_out[21:0] during cnt = 11 to 32 for read operation
-        miso <= register_table[addr[3:0]][32-cnt];    // Output MSB first
+        miso <= register_table[{channel, addr[BANK_AW-1:0]}][32-cnt];  // Output MSB first
+    else if (read_mode && cnt == 33)                  // Block words, 22 clocks each
+        miso <= register_table[{channel, blk_addr}][21-blk_cnt];
 end
 
 //================================================================
-//    Register Table Initialization for Synthesis (10 entries, each 22 bits)
+//    Register Table Initialization for Synthesis (bank 0, first 10 entries)
 //================================================================
 // always @(*) begin
 //     // Use direct assignment for constant values to enable synthesis
@@ -107,7 +159,12 @@ end
 //     register_table[9] = 22'h06d73e;  
 // end
 
+integer i;
+
 initial begin
+    for (i = 0; i < WORDS; i = i + 1)
+        register_table[i] = 22'd0;
+
     register_table[0] = 22'h06d53e;  
     register_table[1] = 22'h26d53e;
     register_table[2] = 22'h16d53e;
@@ -0,0 +1,712 @@
+#include <string.h>
+#include "sim_spi.h"
+#include "xparameters.h"
+#include "xspi.h"
+#include "xintc.h"
+#include "xil_exception.h"
+#include "sleep.h"
+
+#define SIM_SPI_FIFO_MAX    256
+#define SIM_SRR_RESET       0x0000000A
+
+SimSpiConfig sim_spi_cfg = {
+    25000000,   // sck_hz
+    100,        // axil_ns
+    400,        // call_ns
+    1000,       // isr_ns
+    XPAR_SPI_0_FIFO_DEPTH,
+};
+
+SimSpiStats sim_spi_stats;
+
+static u64 now_ns;
+static int in_model;
+
+static SimSpiDev *devs;
+
+/***** Core state *****/
+static u32 cr;
+static u32 ssr;
+static u32 dgier;
+static u32 iier;
+static u32 iisr;
+
+static u8 tx_fifo[SIM_SPI_FIFO_MAX];
+static u64 tx_when[SIM_SPI_FIFO_MAX];      // Written at
+static u16 tx_head;
+static u16 tx_count;
+static u8 rx_fifo[SIM_SPI_FIFO_MAX];
+static u16 rx_head;
+static u16 rx_count;
+
+static int shifting;
+static u8 shift_byte;
+static u32 shift_mask;             // Slaves selected for it
+static u64 shift_end;
+static u64 bus_free_at;            // End of the last byte on the wire
+
+static u32 frame_mask;             // Slaves selected now
+static u64 frame_idle_from;        // Selected and SCK stopped since
+
+/***** Interrupt path *****/
+static XIntc *intc;
+static Xil_ExceptionHandler exc_handler;
+static void *exc_data;
+static int exc_enabled;
+static int in_isr;
+
+static XSpi_Config spi_config = {
+    XPAR_SPI_0_DEVICE_ID, XPAR_SPI_0_BASEADDR, 1, 0, XPAR_SPI_0_NUM_SS_BITS, XSP_DATAWIDTH_BYTE,
+    XSP_STANDARD_MODE,
+};
+
+u64 sim_now(void) {
+    return now_ns;
+}
+
+static u16 fifo_depth(void) {
+    return sim_spi_cfg.fifo_depth ? sim_spi_cfg.fifo_depth : 1;
+}
+
+static u32 ss_all(void) {
+    return (1u << XPAR_SPI_0_NUM_SS_BITS) - 1;
+}
+
+static int manual_ss(void) {
+    return (cr & XSP_CR_MANUAL_SS_MASK) != 0;
+}
+
+static int running(void) {
+    return (cr & XSP_CR_ENABLE_MASK) && (cr & XSP_CR_MASTER_MODE_MASK) &&
+           !(cr & XSP_CR_TRANS_INHIBIT_MASK);
+}
+
+/***** Slave select lines *****/
+static void frame_set(u32 Mask, u64 At) {
+    SimSpiDev *Dev;
+
+    if (Mask == frame_mask) {
+        return;
+    }
+    if (frame_mask && At > frame_idle_from) {
+        sim_spi_stats.IdleNs += At - frame_idle_from;
+    }
+    for (Dev = devs; Dev; Dev = Dev->Next) {
+        if ((frame_mask & Dev->Mask) && !(Mask & Dev->Mask)) {
+            if (Dev->Select) {
+                Dev->Select(Dev, 0);
+            }
+        }
+        if (!(frame_mask & Dev->Mask) && (Mask & Dev->Mask)) {
+            Dev->Frames++;
+            if (Dev->Select) {
+                Dev->Select(Dev, 1);
+            }
+        }
+    }
+    if (Mask) {
+        sim_spi_stats.Frames++;
+    }
+    frame_mask = Mask;
+    frame_idle_from = At;
+}
+
+/***** Shift register *****/
+static void rx_push(u8 Byte) {
+    if (rx_count == fifo_depth()) {
+        sim_spi_stats.RxOverruns++;
+        iisr |= XSP_INTR_RX_OVERRUN_MASK;
+        return;
+    }
+    rx_fifo[(rx_head + rx_count) % SIM_SPI_FIFO_MAX] = Byte;
+    rx_count++;
+    iisr |= XSP_INTR_RX_NOT_EMPTY_MASK;
+    if (rx_count == fifo_depth()) {
+        iisr |= XSP_INTR_RX_FULL_MASK;
+    }
+}
+
+static void shift_done(void) {
+    SimSpiDev *Dev;
+    u8 Miso = 0xFF;
+    u8 Out;
+    int Driven = 0;
+
+    for (Dev = devs; Dev; Dev = Dev->Next) {
+        if (!(shift_mask & Dev->Mask)) {
+            continue;
+        }
+        Dev->Bytes++;
+        Out = Dev->Xfer ? Dev->Xfer(Dev, shift_byte) : 0xFF;
+        Miso = Driven ? (u8)(Miso & Out) : Out;
+        Driven = 1;
+    }
+    if (cr & XSP_CR_LOOPBACK_MASK) {
+        Miso = shift_byte;
+    }
+    rx_push(Miso);
+
+    sim_spi_stats.Bytes++;
+    sim_spi_stats.BusNs += 8ull * 1000000000ull / sim_spi_cfg.sck_hz;
+    bus_free_at = shift_end;
+    shifting = 0;
+    frame_idle_from = shift_end;
+
+    if (tx_count == 0) {
+        iisr |= XSP_INTR_TX_EMPTY_MASK;
+        // Automatic slave select lets go once there is nothing more to send
+        if (!manual_ss()) {
+            frame_set(0, shift_end);
+        }
+    }
+}
+
+static void sim_advance(void) {
+    u64 Start;
+    u32 Mask;
+
+    for (;;) {
+        if (shifting) {
+            if (shift_end > now_ns) {
+                return;
+            }
+            shift_done();
+            continue;
+        }
+        if (!running() || tx_count == 0) {
+            return;
+        }
+        Start = tx_when[tx_head] > bus_free_at ? tx_when[tx_head] : bus_free_at;
+        if (Start > now_ns) {
+            return;
+        }
+        Mask = ~ssr & ss_all();
+        if (!manual_ss()) {
+            frame_set(Mask, Start);
+        } else if (frame_mask && Start > frame_idle_from) {
+            sim_spi_stats.IdleNs += Start - frame_idle_from;
+        }
+        shift_byte = tx_fifo[tx_head];
+        tx_head = (tx_head + 1) % SIM_SPI_FIFO_MAX;
+        tx_count--;
+        if (tx_count == fifo_depth() / 2) {
+            iisr |= XSP_INTR_TX_HALF_EMPTY_MASK;
+        }
+        shift_mask = frame_mask;
+        shift_end = Start + 8ull * 1000000000ull / sim_spi_cfg.sck_hz;
+        shifting = 1;
+    }
+}
+
+static int sim_irq_line(void) {
+    return (dgier & XSP_GINTR_ENABLE_MASK) && (iisr & iier);
+}
+
+// Earliest time the shift register changes state, 0 if it will not
+static u64 sim_next_event(void) {
+    u64 Start;
+
+    if (shifting) {
+        return shift_end;
+    }
+    if (!running() || tx_count == 0) {
+        return 0;
+    }
+    Start = tx_when[tx_head] > bus_free_at ? tx_when[tx_head] : bus_free_at;
+    return Start > now_ns ? Start : now_ns;
+}
+
+static void sim_service(void) {
+    int Rounds = 16;
+
+    while (!in_isr && exc_enabled && exc_handler && intc && intc->IsStarted &&
+           (intc->EnableMask & (1U << XPAR_INTC_0_SPI_0_VEC_ID)) && sim_irq_line() && Rounds--) {
+        in_isr = 1;
+        in_model++;
+        now_ns += sim_spi_cfg.isr_ns;
+        sim_advance();
+        sim_spi_stats.Interrupts++;
+        exc_handler(exc_data);
+        in_model--;
+        in_isr = 0;
+    }
+}
+
+static void sim_enter(void) {
+    in_model++;
+}
+
+static void sim_leave(void) {
+    in_model--;
+    if (in_model == 0) {
+        sim_service();
+    }
+}
+
+static void sim_tick(u64 ns) {
+    now_ns += ns;
+    sim_advance();
+}
+
+void sim_cpu(u64 ns) {
+    u64 Target = now_ns + ns;
+    u64 Next;
+
+    while (now_ns < Target) {
+        Next = sim_next_event();
+        now_ns = (Next > now_ns && Next < Target) ? Next : Target;
+        sim_advance();
+        sim_service();
+    }
+}
+
+void sim_spi_driver_call(void) {
+    sim_enter();
+    sim_spi_stats.DriverCalls++;
+    sim_tick(sim_spi_cfg.call_ns);
+    sim_leave();
+}
+
+/***** Registers *****/
+static void core_reset(void) {
+    cr = XSP_CR_TRANS_INHIBIT_MASK | XSP_CR_MANUAL_SS_MASK;
+    ssr = ss_all();
+    dgier = 0;
+    iier = 0;
+    iisr = 0;
+    tx_head = tx_count = 0;
+    rx_head = rx_count = 0;
+    shifting = 0;
+    frame_set(0, now_ns);
+}
+
+static u32 reg_read(u32 Offset) {
+    u32 Value = 0;
+    u8 Byte;
+
+
+    switch (Offset) {
+    case XSP_DGIER_OFFSET:
+        return dgier;
+    case XSP_IISR_OFFSET:
+        return iisr;
+    case XSP_IIER_OFFSET:
+        return iier;
+    case XSP_CR_OFFSET:
+        return cr;
+    case XSP_SR_OFFSET:
+        if (rx_count == 0) {
+            Value |= XSP_SR_RX_EMPTY_MASK;
+        }
+        if (rx_count == fifo_depth()) {
+            Value |= XSP_SR_RX_FULL_MASK;
+        }
+        if (tx_count == 0) {
+            Value |= XSP_SR_TX_EMPTY_MASK;
+        }
+        if (tx_count == fifo_depth()) {
+            Value |= XSP_SR_TX_FULL_MASK;
+        }
+        return Value;
+    case XSP_DRR_OFFSET:
+        if (rx_count == 0) {
+            return 0;
+        }
+        Byte = rx_fifo[rx_head];
+        rx_head = (rx_head + 1) % SIM_SPI_FIFO_MAX;
+        rx_count--;
+        return Byte;
+    case XSP_SSR_OFFSET:
+        return ssr;
+    case XSP_TFO_OFFSET:
+        return tx_count ? tx_count - 1u : 0;
+    case XSP_RFO_OFFSET:
+        return rx_count ? rx_count - 1u : 0;
+    default:
+        return 0;
+    }
+}
+
+u32 sim_spi_read(UINTPTR BaseAddress, u32 Offset) {
+    u32 Value;
+
+    (void)BaseAddress;
+    sim_enter();
+    sim_spi_stats.RegReads++;
+    sim_tick(sim_spi_cfg.axil_ns);
+    Value = reg_read(Offset);
+    sim_leave();
+    return Value;
+}
+
+void sim_spi_write(UINTPTR BaseAddress, u32 Offset, u32 Value) {
+    (void)BaseAddress;
+    sim_enter();
+    sim_spi_stats.RegWrites++;
+    sim_tick(sim_spi_cfg.axil_ns);
+
+    switch (Offset) {
+    case XSP_DGIER_OFFSET:
+        dgier = Value & XSP_GINTR_ENABLE_MASK;
+        break;
+    case XSP_IISR_OFFSET:
+        iisr ^= Value;              // Toggle on write
+        break;
+    case XSP_IIER_OFFSET:
+        iier = Value;
+        break;
+    case XSP_SRR_OFFSET:
+        if (Value == SIM_SRR_RESET) {
+            core_reset();
+        }
+        break;
+    case XSP_CR_OFFSET:
+        if (Value & XSP_CR_TXFIFO_RESET_MASK) {
+            tx_head = tx_count = 0;
+        }
+        if (Value & XSP_CR_RXFIFO_RESET_MASK) {
+            rx_head = rx_count = 0;
+        }
+        cr = Value & ~(XSP_CR_TXFIFO_RESET_MASK | XSP_CR_RXFIFO_RESET_MASK);
+        if (!manual_ss() && !shifting) {
+            frame_set(0, now_ns);
+        } else if (manual_ss()) {
+            frame_set(~ssr & ss_all(), now_ns);
+        }
+        break;
+    case XSP_DTR_OFFSET:
+        if (tx_count == fifo_depth()) {
+            break;                  // Lost, as on the core
+        }
+        tx_fifo[(tx_head + tx_count) % SIM_SPI_FIFO_MAX] = (u8)Value;
+        tx_when[(tx_head + tx_count) % SIM_SPI_FIFO_MAX] = now_ns;
+        tx_count++;
+        if (tx_count > sim_spi_stats.MaxTxLevel) {
+            sim_spi_stats.MaxTxLevel = tx_count;
+        }
+        break;
+    case XSP_SSR_OFFSET:
+        ssr = Value & ss_all();
+        if (manual_ss()) {
+            frame_set(~ssr & ss_all(), now_ns);
+        }
+        break;
+    default:
+        break;
+    }
+    sim_advance();
+    sim_leave();
+}
+
+void sim_spi_reset(void) {
+    in_model++;
+    now_ns = 0;
+    devs = NULL;
+    frame_mask = 0;
+    bus_free_at = 0;
+    core_reset();
+    memset(&sim_spi_stats, 0, sizeof(sim_spi_stats));
+    intc = NULL;
+    exc_handler = NULL;
+    exc_enabled = 0;
+    in_isr = 0;
+    in_model--;
+}
+
+void sim_spi_attach(SimSpiDev *Dev) {
+    Dev->Next = devs;
+    devs = Dev;
+}
+
+/***** XSpi driver model, register traffic as in xspi.c *****/
+XSpi_Config *XSpi_LookupConfig(u16 DeviceId) {
+    sim_spi_driver_call();
+    spi_config.HasFifos = sim_spi_cfg.fifo_depth != 0;
+    return DeviceId == spi_config.DeviceId ? &spi_config : NULL;
+}
+
+void XSpi_Reset(XSpi *InstancePtr) {
+    sim_spi_driver_call();
+    XSpi_WriteReg(InstancePtr->BaseAddr, XSP_SRR_OFFSET, SIM_SRR_RESET);
+    InstancePtr->IsStarted = 0;
+    InstancePtr->IsBusy = FALSE;
+    InstancePtr->SlaveSelectReg = InstancePtr->SlaveSelectMask;
+}
+
+int XSpi_CfgInitialize(XSpi *InstancePtr, XSpi_Config *Config, UINTPTR EffectiveAddr) {
+    sim_spi_driver_call();
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->BaseAddr = EffectiveAddr;
+    InstancePtr->HasFifos = Config->HasFifos;
+    InstancePtr->SlaveOnly = Config->SlaveOnly;
+    InstancePtr->NumSlaveBits = Config->NumSlaveBits;
+    InstancePtr->DataWidth = Config->DataWidth;
+    InstancePtr->SpiMode = Config->SpiMode;
+    InstancePtr->SlaveSelectMask = (1u << Config->NumSlaveBits) - 1;
+    InstancePtr->IsReady = 0x11111111;
+    XSpi_Reset(InstancePtr);
+    return XST_SUCCESS;
+}
+
+int XSpi_SetOptions(XSpi *InstancePtr, u32 Options) {
+    u32 ControlReg;
+
+    sim_spi_driver_call();
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    ControlReg &= ~(XSP_CR_MASTER_MODE_MASK | XSP_CR_CLK_POLARITY_MASK | XSP_CR_CLK_PHASE_MASK |
+                    XSP_CR_LOOPBACK_MASK | XSP_CR_MANUAL_SS_MASK);
+    if (Options & XSP_MASTER_OPTION) {
+        ControlReg |= XSP_CR_MASTER_MODE_MASK;
+    }
+    if (Options & XSP_CLK_ACTIVE_LOW_OPTION) {
+        ControlReg |= XSP_CR_CLK_POLARITY_MASK;
+    }
+    if (Options & XSP_CLK_PHASE_1_OPTION) {
+        ControlReg |= XSP_CR_CLK_PHASE_MASK;
+    }
+    if (Options & XSP_LOOPBACK_OPTION) {
+        ControlReg |= XSP_CR_LOOPBACK_MASK;
+    }
+    if (Options & XSP_MANUAL_SSELECT_OPTION) {
+        ControlReg |= XSP_CR_MANUAL_SS_MASK;
+    }
+    XSpi_SetControlReg(InstancePtr, ControlReg);
+    return XST_SUCCESS;
+}
+
+u32 XSpi_GetOptions(XSpi *InstancePtr) {
+    u32 ControlReg;
+    u32 Options = 0;
+
+    sim_spi_driver_call();
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    if (ControlReg & XSP_CR_MASTER_MODE_MASK) {
+        Options |= XSP_MASTER_OPTION;
+    }
+    if (ControlReg & XSP_CR_LOOPBACK_MASK) {
+        Options |= XSP_LOOPBACK_OPTION;
+    }
+    if (ControlReg & XSP_CR_MANUAL_SS_MASK) {
+        Options |= XSP_MANUAL_SSELECT_OPTION;
+    }
+    return Options;
+}
+
+int XSpi_SetSlaveSelect(XSpi *InstancePtr, u32 SlaveMask) {
+    sim_spi_driver_call();
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+    InstancePtr->SlaveSelectReg = ~SlaveMask & InstancePtr->SlaveSelectMask;
+    return XST_SUCCESS;
+}
+
+int XSpi_Start(XSpi *InstancePtr) {
+    u32 ControlReg;
+
+    sim_spi_driver_call();
+    if (InstancePtr->IsStarted) {
+        return XST_DEVICE_IS_STARTED;
+    }
+    XSpi_IntrEnable(InstancePtr, XSP_INTR_DFT_MASK);
+    InstancePtr->IsStarted = 0x22222222;
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    if (InstancePtr->HasFifos) {
+        ControlReg |= XSP_CR_TXFIFO_RESET_MASK | XSP_CR_RXFIFO_RESET_MASK;
+    }
+    ControlReg |= XSP_CR_ENABLE_MASK;
+    XSpi_SetControlReg(InstancePtr, ControlReg);
+    XSpi_IntrGlobalEnable(InstancePtr);
+    return XST_SUCCESS;
+}
+
+int XSpi_Stop(XSpi *InstancePtr) {
+    u32 GlobalIntr;
+    u32 ControlReg;
+
+    sim_spi_driver_call();
+    GlobalIntr = XSpi_ReadReg(InstancePtr->BaseAddr, XSP_DGIER_OFFSET);
+    XSpi_IntrGlobalDisable(InstancePtr);
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    if (InstancePtr->IsBusy) {
+        if (GlobalIntr) {
+            XSpi_IntrGlobalEnable(InstancePtr);
+        }
+        return XST_DEVICE_BUSY;
+    }
+    XSpi_SetControlReg(InstancePtr, ControlReg & ~XSP_CR_ENABLE_MASK);
+    InstancePtr->IsStarted = 0;
+    if (GlobalIntr) {
+        XSpi_IntrGlobalEnable(InstancePtr);
+    }
+    return XST_SUCCESS;
+}
+
+static void transfer_fill(XSpi *InstancePtr) {
+    while (InstancePtr->RemainingBytes > 0 &&
+           !(XSpi_GetStatusReg(InstancePtr) & XSP_SR_TX_FULL_MASK)) {
+        XSpi_WriteReg(InstancePtr->BaseAddr, XSP_DTR_OFFSET,
+                      InstancePtr->SendBufferPtr ? *InstancePtr->SendBufferPtr++ : 0);
+        InstancePtr->RemainingBytes--;
+    }
+}
+
+// Polled path only; the interrupt path is not used by the code under test
+int XSpi_Transfer(XSpi *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, unsigned int ByteCount) {
+    u32 ControlReg;
+    u32 StatusReg;
+    u32 Data;
+
+    sim_spi_driver_call();
+    if (!InstancePtr->IsStarted) {
+        return XST_DEVICE_IS_STOPPED;
+    }
+    if (InstancePtr->IsBusy) {
+        return XST_DEVICE_BUSY;
+    }
+    (void)XSpi_ReadReg(InstancePtr->BaseAddr, XSP_DGIER_OFFSET);
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+
+    InstancePtr->IsBusy = TRUE;
+    InstancePtr->SendBufferPtr = SendBufPtr;
+    InstancePtr->RecvBufferPtr = RecvBufPtr;
+    InstancePtr->RequestedBytes = ByteCount;
+    InstancePtr->RemainingBytes = ByteCount;
+
+    XSpi_IntrGlobalDisable(InstancePtr);
+    transfer_fill(InstancePtr);
+    XSpi_SetSlaveSelectReg(InstancePtr, InstancePtr->SlaveSelectReg);
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    XSpi_SetControlReg(InstancePtr, ControlReg & ~XSP_CR_TRANS_INHIBIT_MASK);
+
+    while (ByteCount > 0) {
+        do {
+            StatusReg = XSpi_GetStatusReg(InstancePtr);
+        } while (!(StatusReg & XSP_SR_TX_EMPTY_MASK));
+
+        ControlReg = XSpi_GetControlReg(InstancePtr);
+        XSpi_SetControlReg(InstancePtr, ControlReg | XSP_CR_TRANS_INHIBIT_MASK);
+
+        StatusReg = XSpi_GetStatusReg(InstancePtr);
+        while (!(StatusReg & XSP_SR_RX_EMPTY_MASK)) {
+            Data = XSpi_ReadReg(InstancePtr->BaseAddr, XSP_DRR_OFFSET);
+            if (InstancePtr->RecvBufferPtr) {
+                *InstancePtr->RecvBufferPtr++ = (u8)Data;
+            }
+            ByteCount--;
+            StatusReg = XSpi_GetStatusReg(InstancePtr);
+        }
+
+        if (InstancePtr->RemainingBytes > 0) {
+            transfer_fill(InstancePtr);
+            ControlReg = XSpi_GetControlReg(InstancePtr);
+            XSpi_SetControlReg(InstancePtr, ControlReg & ~XSP_CR_TRANS_INHIBIT_MASK);
+        } else if (ByteCount > 0) {
+            // Last byte still on the wire
+            ControlReg = XSpi_GetControlReg(InstancePtr);
+            XSpi_SetControlReg(InstancePtr, ControlReg & ~XSP_CR_TRANS_INHIBIT_MASK);
+        }
+    }
+
+    ControlReg = XSpi_GetControlReg(InstancePtr);
+    XSpi_SetControlReg(InstancePtr, ControlReg | XSP_CR_TRANS_INHIBIT_MASK);
+    XSpi_SetSlaveSelectReg(InstancePtr, InstancePtr->SlaveSelectMask);
+    InstancePtr->IsBusy = FALSE;
+    return XST_SUCCESS;
+}
+
+int XSpi_SelfTest(XSpi *InstancePtr) {
+    u8 Byte = 0xA5;
+    u8 Back = 0;
+    int Status;
+
+    sim_spi_driver_call();
+    XSpi_Reset(InstancePtr);
+    if (XSpi_GetControlReg(InstancePtr) != (XSP_CR_TRANS_INHIBIT_MASK | XSP_CR_MANUAL_SS_MASK)) {
+        return XST_FAILURE;
+    }
+    Status = XSpi_SetOptions(InstancePtr, XSP_MASTER_OPTION | XSP_LOOPBACK_OPTION);
+    Status |= XSpi_Start(InstancePtr);
+    XSpi_IntrGlobalDisable(InstancePtr);
+    Status |= XSpi_Transfer(InstancePtr, &Byte, &Back, 1);
+    Status |= XSpi_Stop(InstancePtr);
+    XSpi_Reset(InstancePtr);
+    return (Status == XST_SUCCESS && Back == Byte) ? XST_SUCCESS : XST_FAILURE;
+}
+
+void XSpi_SetStatusHandler(XSpi *InstancePtr, void *CallBackRef, XSpi_StatusHandler FuncPtr) {
+    InstancePtr->StatusHandler = FuncPtr;
+    InstancePtr->StatusRef = CallBackRef;
+}
+
+/***** AXI INTC and exceptions *****/
+int XIntc_Initialize(XIntc *InstancePtr, u16 DeviceId) {
+    (void)DeviceId;
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->IsReady = 1;
+    intc = InstancePtr;
+    return XST_SUCCESS;
+}
+
+int XIntc_Connect(XIntc *InstancePtr, u8 Id, XInterruptHandler Handler, void *CallBackRef) {
+    InstancePtr->Table[Id].Handler = Handler;
+    InstancePtr->Table[Id].CallBackRef = CallBackRef;
+    return XST_SUCCESS;
+}
+
+int XIntc_Start(XIntc *InstancePtr, u8 Mode) {
+    (void)Mode;
+    InstancePtr->IsStarted = 1;
+    return XST_SUCCESS;
+}
+
+void XIntc_Enable(XIntc *InstancePtr, u8 Id) {
+    InstancePtr->EnableMask |= 1U << Id;
+}
+
+void XIntc_Disable(XIntc *InstancePtr, u8 Id) {
+    InstancePtr->EnableMask &= ~(1U << Id);
+}
+
+void XIntc_InterruptHandler(XIntc *InstancePtr) {
+    XIntc_VectorTableEntry *Entry = &InstancePtr->Table[XPAR_INTC_0_SPI_0_VEC_ID];
+
+    if (sim_irq_line() && Entry->Handler) {
+        Entry->Handler(Entry->CallBackRef);
+    }
+}
+
+void Xil_ExceptionInit(void) {
+}
+
+void Xil_ExceptionEnable(void) {
+    exc_enabled = 1;
+    if (in_model == 0) {
+        sim_service();
+    }
+}
+
+void Xil_ExceptionDisable(void) {
+    exc_enabled = 0;
+}
+
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data) {
+    if (Exception_id == XIL_EXCEPTION_ID_INT) {
+        exc_handler = Handler;
+        exc_data = Data;
+    }
+}
+
+/***** Sleep *****/
+int sim_usleep(unsigned long useconds) {
+    sim_cpu((u64)useconds * 1000ULL);
+    return 0;
+}
+
+unsigned sim_sleep(unsigned int seconds) {
+    sim_cpu((u64)seconds * 1000000000ULL);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+// Host model of one AXI Quad SPI core (standard mode, 8-bit) and the slaves
+// on its select lines. Time is simulated ns: every register access costs
+// axil_ns, every XSpi_* driver call call_ns more, and the shift register
+// moves one byte every 8 SCK periods while it has data and is not held off.
+// The interrupt output goes through an AXI INTC model to the exception
+// handler; a CPU spinning on a flag set from the handler is fast-forwarded
+// to the next byte boundary.
+
+#include "xil_types.h"
+
+typedef struct SimSpiDev SimSpiDev;
+
+struct SimSpiDev {
+    const char *Name;
+    u32 Mask;                                   // Slave select line(s) it sits on
+    void (*Select)(SimSpiDev *Dev, int Selected);
+    u8   (*Xfer)(SimSpiDev *Dev, u8 Mosi);      // Returns MISO of the same byte
+    void *Priv;
+    u32 Frames;                                 // Select ... deselect
+    u32 Bytes;
+    SimSpiDev *Next;
+};
+
+typedef struct {
+    u32 sck_hz;
+    u32 axil_ns;                    // One register access
+    u32 call_ns;                    // Driver function entry, checks and return
+    u32 isr_ns;                     // Interrupt entry + exit
+    u16 fifo_depth;                 // 0: core built without FIFOs
+} SimSpiConfig;
+
+typedef struct {
+    u64 RegReads;
+    u64 RegWrites;
+    u64 DriverCalls;
+    u64 Frames;                     // Slave select assertions with traffic or not
+    u64 Bytes;
+    u64 BusNs;                      // SCK running
+    u64 IdleNs;                     // SCK stopped while a slave was selected
+    u64 RxOverruns;
+    u64 Interrupts;
+    u16 MaxTxLevel;
+} SimSpiStats;
+
+extern SimSpiConfig sim_spi_cfg;
+extern SimSpiStats sim_spi_stats;
+
+u64  sim_now(void);
+void sim_cpu(u64 ns);               // Application work, interrupts due meanwhile are taken
+void sim_spi_reset(void);           // Clears time, stats, devices and the core
+void sim_spi_attach(SimSpiDev *Dev);
+void sim_spi_driver_call(void);     // Charged by the XSpi_* model functions
+
+// Device model in sim_spi_devs.c: logs what it receives, answers from a
+// buffer of responses (or the byte count)
+SimSpiDev *sim_logdev_create(const char *Name, u32 Mask);
+u8        *sim_logdev_data(SimSpiDev *Dev, u32 *Length);       // Bytes received
+u32        sim_logdev_frame_len(SimSpiDev *Dev, u32 Frame);    // Bytes of one frame
+void       sim_logdev_clear(SimSpiDev *Dev);
+void       sim_logdev_reply(SimSpiDev *Dev, const u8 *Reply, u32 Length);
+
+#endif /* SIM_SPI_H */
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim_spi.h"
+
+/***** Logging slave *****/
+typedef struct {
+    u8 *Log;                        // Every byte received, all frames
+    u32 Length;
+    u32 Size;
+    u32 *FrameStart;                // Log offset of each frame
+    u32 FrameCount;
+    u32 FrameSize;
+    const u8 *Reply;                // MISO per byte of a frame
+    u32 ReplyLength;
+    u32 InFrame;                    // Byte index in the current frame
+} SimLogDev;
+
+static void logdev_select(SimSpiDev *Dev, int Selected) {
+    SimLogDev *L = Dev->Priv;
+
+    if (!Selected) {
+        return;
+    }
+    if (L->FrameCount == L->FrameSize) {
+        L->FrameSize = L->FrameSize ? 2 * L->FrameSize : 64;
+        L->FrameStart = realloc(L->FrameStart, L->FrameSize * sizeof(u32));
+    }
+    L->FrameStart[L->FrameCount++] = L->Length;
+    L->InFrame = 0;
+}
+
+static u8 logdev_xfer(SimSpiDev *Dev, u8 Mosi) {
+    SimLogDev *L = Dev->Priv;
+    u8 Miso;
+
+    if (L->Length == L->Size) {
+        L->Size = L->Size ? 2 * L->Size : 1024;
+        L->Log = realloc(L->Log, L->Size);
+    }
+    L->Log[L->Length++] = Mosi;
+
+    if (L->Reply) {
+        Miso = L->InFrame < L->ReplyLength ? L->Reply[L->InFrame] : 0xFF;
+    } else {
+        Miso = (u8)L->InFrame;
+    }
+    L->InFrame++;
+    return Miso;
+}
+
+SimSpiDev *sim_logdev_create(const char *Name, u32 Mask) {
+    SimSpiDev *Dev = calloc(1, sizeof(*Dev));
+    SimLogDev *L = calloc(1, sizeof(*L));
+
+    Dev->Name = Name;
+    Dev->Mask = Mask;
+    Dev->Select = logdev_select;
+    Dev->Xfer = logdev_xfer;
+    Dev->Priv = L;
+    sim_spi_attach(Dev);
+    return Dev;
+}
+
+u8 *sim_logdev_data(SimSpiDev *Dev, u32 *Length) {
+    SimLogDev *L = Dev->Priv;
+
+    *Length = L->Length;
+    return L->Log;
+}
+
+u32 sim_logdev_frame_len(SimSpiDev *Dev, u32 Frame) {
+    SimLogDev *L = Dev->Priv;
+
+    if (Frame >= L->FrameCount) {
+        return 0;
+    }
+    if (Frame + 1 == L->FrameCount) {
+        return L->Length - L->FrameStart[Frame];
+    }
+    return L->FrameStart[Frame + 1] - L->FrameStart[Frame];
+}
+
+void sim_logdev_clear(SimSpiDev *Dev) {
+    SimLogDev *L = Dev->Priv;
+
+    L->Length = 0;
+    L->FrameCount = 0;
+    Dev->Frames = 0;
+    Dev->Bytes = 0;
+}
+
+void sim_logdev_reply(SimSpiDev *Dev, const u8 *Reply, u32 Length) {
+    SimLogDev *L = Dev->Priv;
+
+    L->Reply = Reply;
+    L->ReplyLength = Length;
+}
@@ -0,0 +1,277 @@
+// spi_queue.c on the AXI Quad SPI model with its interrupt wired through the
+// INTC as SetupInterruptSystem() in interface_main.c wires the IIC. A long
+// burst to one slave goes out first through the polled spi_session, then
+// through the queue while the CPU keeps doing work units; both with the
+// default FIFO depth and with 256. Then a queue of short writes and full
+// duplex reads to two slaves, with callbacks and a command joined to its data,
+// and a read waited for with spi_queue_wait. Last, a wait whose interrupt
+// never comes, which must time out.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. spi_master.c spi_queue.c host_sim/sim_spi.c
+//       host_sim/sim_spi_devs.c host_sim/spi_queue_host.c -o spi_queue_host
+//   ./spi_queue_host [burst_bytes] [sck_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xspi.h"
+#include "xintc.h"
+#include "xil_exception.h"
+#include "spi_master.h"
+#include "spi_queue.h"
+#include "sim_spi.h"
+
+#define MAX_BURST       65536
+#define SHORT_TXNS      32
+#define WORK_NS         1000    // One unit of application work
+
+static XIntc Intc;
+static XSpi Spi;
+static SpiQueue Queue;
+static SimSpiDev *Dac;
+static SimSpiDev *Adc;
+
+static u8 Burst[MAX_BURST];
+static u32 BurstLen = 4096;
+
+static int setup(u16 FifoDepth) {
+    sim_spi_cfg.fifo_depth = FifoDepth;
+    sim_spi_reset();
+    Dac = sim_logdev_create("dac", 0x1);
+    Adc = sim_logdev_create("adc", 0x2);
+
+    if (spi_init(&Spi, XPAR_SPI_0_DEVICE_ID) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    if (spi_queue_init(&Queue, &Spi, 0) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    XIntc_Initialize(&Intc, XPAR_INTC_0_DEVICE_ID);
+    XIntc_Connect(&Intc, XPAR_INTC_0_SPI_0_VEC_ID, spi_queue_handler, &Queue);
+    XIntc_Start(&Intc, XIN_REAL_MODE);
+    XIntc_Enable(&Intc, XPAR_INTC_0_SPI_0_VEC_ID);
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT, (Xil_ExceptionHandler)XIntc_InterruptHandler, &Intc);
+    Xil_ExceptionEnable();
+
+    return XST_SUCCESS;
+}
+
+static void report(const char *Name, u64 Ns, u64 Work) {
+    printf("%-16s %8.1f us  wire %8.1f us  work %5.1f%%  irqs %5llu  overruns %llu\n", Name, Ns / 1e3,
+           sim_spi_stats.BusNs / 1e3, Ns ? 100.0 * (double)(Work * WORK_NS) / (double)Ns : 0.0,
+           (unsigned long long)sim_spi_stats.Interrupts, (unsigned long long)sim_spi_stats.RxOverruns);
+}
+
+static int check_burst(void) {
+    u32 Length;
+    u8 *Log = sim_logdev_data(Dac, &Length);
+
+    if (Dac->Frames != 1 || Length != BurstLen || memcmp(Log, Burst, BurstLen) != 0) {
+        printf("burst: %u frames, %u bytes\n", Dac->Frames, Length);
+        return XST_FAILURE;
+    }
+    return sim_spi_stats.RxOverruns ? XST_FAILURE : XST_SUCCESS;
+}
+
+// The CPU spins in spi_segment for the whole burst
+static int run_polled(u16 FifoDepth) {
+    SpiSession Session;
+    char Name[32];
+    u64 Start;
+
+    // The queue holds the core; close it and use a plain session instead
+    if (setup(FifoDepth) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    spi_session_close(&Queue.Session);
+    if (spi_session_open(&Session, &Spi, 0) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    sim_logdev_clear(Dac);
+    memset(&sim_spi_stats, 0, sizeof(sim_spi_stats));
+
+    Start = sim_now();
+    spi_session_transfer(&Session, 0x1, Burst, NULL, BurstLen);
+    snprintf(Name, sizeof(Name), "polled fifo %u", FifoDepth);
+    report(Name, sim_now() - Start, 0);
+    spi_session_close(&Session);
+
+    return check_burst();
+}
+
+static int run_queue(u16 FifoDepth) {
+    SpiTxn Txn;
+    char Name[32];
+    u64 Start;
+    u64 Work = 0;
+
+    if (setup(FifoDepth) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    sim_logdev_clear(Dac);
+    memset(&sim_spi_stats, 0, sizeof(sim_spi_stats));
+
+    Start = sim_now();
+    spi_txn_init(&Txn, 0x1, Burst, NULL, BurstLen);
+    spi_queue_submit(&Queue, &Txn);
+    while (!Txn.Done) {
+        sim_cpu(WORK_NS);
+        Work++;
+    }
+    snprintf(Name, sizeof(Name), "queue fifo %u", FifoDepth);
+    report(Name, sim_now() - Start, Work);
+
+    if (Txn.Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    return check_burst();
+}
+
+typedef struct {
+    u32 Calls;
+    u32 Order;                      // Transactions completed out of order
+    SpiTxn *Expect;
+} TxnLog;
+
+static void txn_done(void *CallBackRef, SpiTxn *Txn) {
+    TxnLog *Log = (TxnLog *)CallBackRef;
+
+    if (Txn != Log->Expect) {
+        Log->Order++;
+    }
+    Log->Expect = Txn + 1;
+    Log->Calls++;
+}
+
+static int run_mixed(void) {
+    static const u8 Reply[] = {0xFF, 0x5A, 0x10, 0x20, 0x30, 0x40};
+    SpiTxn Txns[SHORT_TXNS];
+    SpiTxn Cmd;
+    SpiTxn Data;
+    SpiTxn Last;
+    u8 Writes[SHORT_TXNS][6];
+    u8 Reads[SHORT_TXNS][6];
+    u8 CmdBuf[2] = {0x80, 0x10};
+    u8 DataBuf[3] = {0xA1, 0xA2, 0xA3};
+    u8 Back[6];
+    TxnLog Log = {0, 0, Txns};
+    u32 Length;
+    u8 *Dev;
+    u64 Work = 0;
+    u64 Start;
+    int Failed = 0;
+    int i;
+
+    if (setup(XPAR_SPI_0_FIFO_DEPTH) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    sim_logdev_reply(Adc, Reply, sizeof(Reply));
+    memset(&sim_spi_stats, 0, sizeof(sim_spi_stats));
+
+    // Even: 4-byte DAC writes, odd: 6-byte ADC reads
+    Start = sim_now();
+    for (i = 0; i < SHORT_TXNS; i++) {
+        memset(Writes[i], 0, sizeof(Writes[i]));
+        memset(Reads[i], 0, sizeof(Reads[i]));
+        Writes[i][0] = (u8)(0x40 + i);
+        Writes[i][1] = (u8)i;
+        if (i & 1) {
+            spi_txn_init(&Txns[i], 0x2, Writes[i], Reads[i], 6);
+        } else {
+            spi_txn_init(&Txns[i], 0x1, Writes[i], NULL, 4);
+        }
+        Txns[i].Callback = txn_done;
+        Txns[i].CallBackRef = &Log;
+        spi_queue_submit(&Queue, &Txns[i]);
+    }
+
+    // Command and data from two buffers, one frame
+    spi_txn_init(&Cmd, 0x1, CmdBuf, NULL, sizeof(CmdBuf));
+    Cmd.Flags = SPI_SEG_KEEP_CS;
+    spi_txn_init(&Data, 0x1, DataBuf, NULL, sizeof(DataBuf));
+    spi_queue_submit(&Queue, &Cmd);
+    spi_queue_submit(&Queue, &Data);
+
+    while (!spi_queue_idle(&Queue)) {
+        sim_cpu(WORK_NS);
+        Work++;
+    }
+    report("queue mixed", sim_now() - Start, Work);
+
+    Failed |= Log.Calls != SHORT_TXNS || Log.Order != 0;
+    Failed |= Dac->Frames != SHORT_TXNS / 2 + 1 || Adc->Frames != SHORT_TXNS / 2;
+    for (i = 1; i < SHORT_TXNS; i += 2) {
+        Failed |= memcmp(Reads[i], Reply, sizeof(Reply)) != 0;
+    }
+    Dev = sim_logdev_data(Dac, &Length);
+    Failed |= Length != SHORT_TXNS / 2 * 4 + 5 || sim_logdev_frame_len(Dac, SHORT_TXNS / 2) != 5;
+    Failed |= memcmp(Dev + Length - 5, CmdBuf, 2) != 0 || memcmp(Dev + Length - 3, DataBuf, 3) != 0;
+    for (i = 0; i < SHORT_TXNS; i += 2) {
+        Failed |= memcmp(Dev + i / 2 * 4, Writes[i], 4) != 0;
+    }
+
+    // The CPU parked in spi_queue_wait, sleeping between looks at Done
+    memset(Back, 0, sizeof(Back));
+    spi_txn_init(&Last, 0x2, Writes[0], Back, sizeof(Back));
+    spi_queue_submit(&Queue, &Last);
+    Failed |= spi_queue_wait(&Queue, &Last) != XST_SUCCESS;
+    Failed |= memcmp(Back, Reply, sizeof(Reply)) != 0;
+
+    spi_queue_report(&Queue);
+    Failed |= Queue.Failed != 0 || Queue.Completed != Queue.Submitted;
+
+    return Failed ? XST_FAILURE : XST_SUCCESS;
+}
+
+// The SPI line is masked at the INTC, as if the handler was never connected
+static int run_lost_irq(void) {
+    static SpiTxn Txn;
+    u64 Start;
+    int Status;
+
+    if (setup(XPAR_SPI_0_FIFO_DEPTH) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    XIntc_Disable(&Intc, XPAR_INTC_0_SPI_0_VEC_ID);
+
+    Start = sim_now();
+    spi_txn_init(&Txn, 0x1, Burst, NULL, 64);
+    spi_queue_submit(&Queue, &Txn);
+    Status = spi_queue_wait(&Queue, &Txn);
+    printf("%-16s %8.1f us  wait %s\n", "lost irq", (sim_now() - Start) / 1e3,
+           Status == XST_SUCCESS ? "ok" : "failed");
+
+    return Status != XST_SUCCESS && sim_now() - Start >= SPI_QUEUE_WAIT_TIMEOUT_US * 1000ULL ?
+           XST_SUCCESS : XST_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    int Failed = 0;
+    u32 i;
+
+    if (argc > 1) {
+        BurstLen = (u32)strtoul(argv[1], NULL, 0);
+        if (BurstLen == 0 || BurstLen > MAX_BURST) {
+            BurstLen = MAX_BURST;
+        }
+    }
+    if (argc > 2) {
+        sim_spi_cfg.sck_hz = (u32)strtoul(argv[2], NULL, 0);
+    }
+    for (i = 0; i < BurstLen; i++) {
+        Burst[i] = (u8)(i * 13 + 5);
+    }
+
+    Failed |= run_polled(XPAR_SPI_0_FIFO_DEPTH) != XST_SUCCESS;
+    Failed |= run_queue(XPAR_SPI_0_FIFO_DEPTH) != XST_SUCCESS;
+    Failed |= run_polled(256) != XST_SUCCESS;
+    Failed |= run_queue(256) != XST_SUCCESS;
+    Failed |= run_mixed() != XST_SUCCESS;
+    Failed |= run_lost_irq() != XST_SUCCESS;
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+// spi_master.c on the AXI Quad SPI model. Sends a run of short register
+// writes to one slave, first the way spi_write() used to (options with
+// loopback, slave select, start, XSpi_Transfer, stop, per write), then
+// through spi_write() as it is now, then through one session, and compares
+// the time and register accesses. spi_write() must not be slower than the
+// old path, also with a 256-byte FIFO, which is checked at the end. Then a
+// scatter batch to two slaves with a command and its data joined into one
+// frame and a full duplex read back, a transfer several times the FIFO depth
+// that has to stay one frame without an overrun, and the loopback self-test.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. spi_master.c host_sim/sim_spi.c host_sim/sim_spi_devs.c
+//       host_sim/spi_session_host.c -o spi_session_host
+//   ./spi_session_host [writes] [sck_hz]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi_master.h"
+#include "sim_spi.h"
+
+#define WRITE_LEN       4
+#define LONG_LEN        1000
+
+static u64 Start;
+static u64 Reads;
+static u64 Writes;
+
+static void mark(void) {
+    Start = sim_now();
+    Reads = sim_spi_stats.RegReads;
+    Writes = sim_spi_stats.RegWrites;
+}
+
+static u64 report(const char *Name, u32 Count) {
+    u64 Ns = sim_now() - Start;
+    u64 Accesses = sim_spi_stats.RegReads - Reads + sim_spi_stats.RegWrites - Writes;
+
+    printf("%-24s %8.3f ms  %6.2f us/write  %5.1f reg accesses/write\n", Name, Ns / 1e6,
+           Ns / 1e3 / Count, (double)Accesses / Count);
+    return Ns;
+}
+
+// spi_write() before the session
+static int legacy_write(XSpi *SpiInstPtr, u8 *WriteBuffer, u16 ByteCount, u8 cs_n) {
+    int Status;
+
+    Status = XSpi_SetOptions(SpiInstPtr, XSP_MASTER_OPTION | XSP_LOOPBACK_OPTION);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    Status = XSpi_SetSlaveSelect(SpiInstPtr, cs_n);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    Status = XSpi_Start(SpiInstPtr);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    XSpi_IntrGlobalDisable(SpiInstPtr);
+
+    Status = XSpi_Transfer(SpiInstPtr, WriteBuffer, NULL, ByteCount);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    Status = XSpi_Stop(SpiInstPtr);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    return XST_SUCCESS;
+}
+
+static void fill(u8 *Buffer, u32 Length, u32 Seed) {
+    u32 i;
+
+    for (i = 0; i < Length; i++) {
+        Buffer[i] = (u8)(Seed * 31 + i * 7);
+    }
+}
+
+// Every frame WRITE_LEN bytes, the bytes in order
+static int check_writes(SimSpiDev *Dev, u32 Count) {
+    u8 Expect[WRITE_LEN];
+    u32 Length;
+    u8 *Data = sim_logdev_data(Dev, &Length);
+    u32 i;
+
+    if (Dev->Frames != Count || Length != Count * WRITE_LEN) {
+        printf("%s: %u frames, %u bytes, expected %u, %u\n", Dev->Name, Dev->Frames, Length, Count,
+               Count * WRITE_LEN);
+        return 1;
+    }
+    for (i = 0; i < Count; i++) {
+        fill(Expect, WRITE_LEN, i);
+        if (sim_logdev_frame_len(Dev, i) != WRITE_LEN || memcmp(Data + i * WRITE_LEN, Expect, WRITE_LEN)) {
+            printf("%s: write %u wrong\n", Dev->Name, i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Count writes of WRITE_LEN bytes to Dev through Write, one call each
+static u64 time_writes(const char *Name, SimSpiDev *Dev, XSpi *Spi, u32 Count,
+                       int (*Write)(XSpi *, u8 *, u16, u8), int *Failed) {
+    u8 Buffer[WRITE_LEN];
+    u64 Ns;
+    u32 i;
+
+    sim_logdev_clear(Dev);
+    mark();
+    for (i = 0; i < Count; i++) {
+        fill(Buffer, WRITE_LEN, i);
+        *Failed |= Write(Spi, Buffer, WRITE_LEN, 0x1) != XST_SUCCESS;
+    }
+    Ns = report(Name, Count);
+    *Failed |= check_writes(Dev, Count);
+
+    return Ns;
+}
+
+int main(int argc, char **argv) {
+    static u8 Long[LONG_LEN];
+    static const u8 Reply[] = {0xFF, 0xFF, 0x12, 0x34, 0x56, 0x78};
+    XSpi Spi;
+    SpiSession Session;
+    SimSpiDev *Dac;
+    SimSpiDev *Adc;
+    SpiSeg Segs[4];
+    u8 Buffer[WRITE_LEN];
+    u8 Cmd[2] = {0x80, 0x10};
+    u8 Data[3] = {0xA1, 0xA2, 0xA3};
+    u8 ReadCmd[6] = {0x03, 0x20};
+    u8 Rx[6];
+    u32 Count = 200;
+    u32 Length;
+    u8 *Log;
+    u64 Legacy;
+    u64 OneShot;
+    u64 Fast;
+    int Failed = 0;
+    u32 i;
+
+    if (argc > 1) {
+        Count = (u32)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2) {
+        sim_spi_cfg.sck_hz = (u32)strtoul(argv[2], NULL, 0);
+    }
+
+    sim_spi_reset();
+    Dac = sim_logdev_create("dac", 0x1);
+    Adc = sim_logdev_create("adc", 0x2);
+    Failed |= spi_init(&Spi, XPAR_SPI_0_DEVICE_ID) != XST_SUCCESS;
+
+    // Short writes, one driver round trip each
+    Legacy = time_writes("per write setup", Dac, &Spi, Count, legacy_write, &Failed);
+    OneShot = time_writes("spi_write", Dac, &Spi, Count, spi_write, &Failed);
+    Failed |= OneShot > Legacy;
+
+    // The same through one session
+    sim_logdev_clear(Dac);
+    mark();
+    Failed |= spi_session_open(&Session, &Spi, 0) != XST_SUCCESS;
+    for (i = 0; i < Count; i++) {
+        fill(Buffer, WRITE_LEN, i);
+        Failed |= spi_session_transfer(&Session, 0x1, Buffer, NULL, WRITE_LEN) != XST_SUCCESS;
+    }
+    spi_session_close(&Session);
+    Fast = report("session", Count);
+    Failed |= check_writes(Dac, Count);
+    Failed |= Fast * 2 > Legacy;
+    printf("speedup %.2fx, FIFO depth %u\n", (double)Legacy / Fast, Session.FifoDepth);
+    Failed |= Session.FifoDepth != sim_spi_cfg.fifo_depth;
+
+    // Command and data from two buffers in one frame, then a read
+    sim_logdev_clear(Dac);
+    sim_logdev_clear(Adc);
+    sim_logdev_reply(Adc, Reply, sizeof(Reply));
+    Segs[0] = (SpiSeg){0x1, Cmd, NULL, sizeof(Cmd), SPI_SEG_KEEP_CS};
+    Segs[1] = (SpiSeg){0x1, Data, NULL, sizeof(Data), 0};
+    Segs[2] = (SpiSeg){0x2, ReadCmd, Rx, sizeof(Rx), 0};
+    Segs[3] = (SpiSeg){0x1, Data, NULL, 1, 0};
+    memset(Rx, 0, sizeof(Rx));
+    Failed |= spi_session_open(&Session, &Spi, 0) != XST_SUCCESS;
+    Failed |= spi_session_batch(&Session, Segs, 4) != XST_SUCCESS;
+    spi_session_close(&Session);
+    Log = sim_logdev_data(Dac, &Length);
+    Failed |= Dac->Frames != 2 || Length != 6 || sim_logdev_frame_len(Dac, 0) != 5;
+    Failed |= memcmp(Log, Cmd, 2) || memcmp(Log + 2, Data, 3) || Log[5] != Data[0];
+    Log = sim_logdev_data(Adc, &Length);
+    Failed |= Adc->Frames != 1 || Length != sizeof(Rx) || memcmp(Log, ReadCmd, sizeof(ReadCmd));
+    Failed |= memcmp(Rx, Reply, sizeof(Rx)) != 0;
+    printf("batch: dac %u frames, adc %u frames, read %02x %02x %02x %02x\n", Dac->Frames, Adc->Frames,
+           Rx[2], Rx[3], Rx[4], Rx[5]);
+
+    // Longer than the FIFO, still one frame
+    sim_logdev_clear(Dac);
+    fill(Long, LONG_LEN, 99);
+    Failed |= spi_session_open(&Session, &Spi, 0) != XST_SUCCESS;
+    mark();
+    Failed |= spi_session_transfer(&Session, 0x1, Long, NULL, LONG_LEN) != XST_SUCCESS;
+    Fast = sim_now() - Start;
+    spi_session_close(&Session);
+    Log = sim_logdev_data(Dac, &Length);
+    Failed |= Dac->Frames != 1 || Length != LONG_LEN || memcmp(Log, Long, LONG_LEN) != 0;
+    Failed |= sim_spi_stats.RxOverruns != 0 || sim_spi_stats.MaxTxLevel > sim_spi_cfg.fifo_depth;
+    printf("%u bytes: %.1f us, wire %.1f us, max TX level %u, RX overruns %llu\n", LONG_LEN, Fast / 1e3,
+           LONG_LEN * 8e6 / sim_spi_cfg.sck_hz, sim_spi_stats.MaxTxLevel,
+           (unsigned long long)sim_spi_stats.RxOverruns);
+    spi_session_report(&Session);
+
+    // Loopback only here, nothing selected
+    sim_logdev_clear(Dac);
+    Failed |= spi_loopback_test(&Spi) != XST_SUCCESS;
+    Failed |= Dac->Frames != 0 || Dac->Bytes != 0;
+
+    // One-shot writes with the deepest FIFO, whose depth spi_init() measured once
+    sim_spi_cfg.fifo_depth = SPI_SESSION_FIFO_MAX;
+    sim_spi_reset();
+    Dac = sim_logdev_create("dac", 0x1);
+    Failed |= spi_init(&Spi, XPAR_SPI_0_DEVICE_ID) != XST_SUCCESS;
+    Legacy = time_writes("per write setup, 256", Dac, &Spi, Count, legacy_write, &Failed);
+    OneShot = time_writes("spi_write, 256", Dac, &Spi, Count, spi_write, &Failed);
+    Failed |= OneShot > Legacy;
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+#ifndef XINTC_H
+#define XINTC_H
+
+#include "xstatus.h"
+
+#define XIN_REAL_MODE           1
+#define XPAR_INTC_MAX_NUM_INTR_INPUTS 32
+
+typedef struct {
+    XInterruptHandler Handler;
+    void *CallBackRef;
+} XIntc_VectorTableEntry;
+
+typedef struct {
+    u32 IsReady;
+    u32 IsStarted;
+    u32 EnableMask;
+    XIntc_VectorTableEntry Table[XPAR_INTC_MAX_NUM_INTR_INPUTS];
+} XIntc;
+
+int  XIntc_Initialize(XIntc *InstancePtr, u16 DeviceId);
+int  XIntc_Connect(XIntc *InstancePtr, u8 Id, XInterruptHandler Handler, void *CallBackRef);
+int  XIntc_Start(XIntc *InstancePtr, u8 Mode);
+void XIntc_Enable(XIntc *InstancePtr, u8 Id);
+void XIntc_Disable(XIntc *InstancePtr, u8 Id);
+void XIntc_InterruptHandler(XIntc *InstancePtr);
+
+#endif /* XINTC_H */
@@ -0,0 +1,13 @@
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// One AXI Quad SPI (standard mode, 8-bit, FIFOs) behind one AXI INTC
+
+#define XPAR_SPI_0_DEVICE_ID        0
+#define XPAR_SPI_0_BASEADDR         0x44A00000
+#define XPAR_SPI_0_FIFO_DEPTH       16
+#define XPAR_SPI_0_NUM_SS_BITS      4
+#define XPAR_INTC_0_DEVICE_ID       0
+#define XPAR_INTC_0_SPI_0_VEC_ID    1
+
+#endif /* XPARAMETERS_H */
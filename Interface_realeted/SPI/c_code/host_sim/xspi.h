@@ -0,0 +1,140 @@
+#ifndef XSPI_H
+#define XSPI_H
+
+// Host model of the AXI Quad SPI driver API and registers, backed by the
+// core model in sim_spi.c
+
+#include "xstatus.h"
+
+/***** Options *****/
+#define XSP_MASTER_OPTION               0x1
+#define XSP_CLK_ACTIVE_LOW_OPTION       0x2
+#define XSP_CLK_PHASE_1_OPTION          0x4
+#define XSP_LOOPBACK_OPTION             0x8
+#define XSP_MANUAL_SSELECT_OPTION       0x10
+
+#define XSP_STANDARD_MODE               0
+#define XSP_DUAL_MODE                   1
+#define XSP_QUAD_MODE                   2
+
+#define XSP_DATAWIDTH_BYTE              8
+#define XSP_DATAWIDTH_HALF_WORD         16
+#define XSP_DATAWIDTH_WORD              32
+
+/***** Registers *****/
+#define XSP_DGIER_OFFSET                0x1C
+#define XSP_IISR_OFFSET                 0x20
+#define XSP_IIER_OFFSET                 0x28
+#define XSP_SRR_OFFSET                  0x40
+#define XSP_CR_OFFSET                   0x60
+#define XSP_SR_OFFSET                   0x64
+#define XSP_DTR_OFFSET                  0x68
+#define XSP_DRR_OFFSET                  0x6C
+#define XSP_SSR_OFFSET                  0x70
+#define XSP_TFO_OFFSET                  0x74
+#define XSP_RFO_OFFSET                  0x78
+
+#define XSP_GINTR_ENABLE_MASK           0x80000000
+
+#define XSP_CR_LOOPBACK_MASK            0x00000001
+#define XSP_CR_ENABLE_MASK              0x00000002
+#define XSP_CR_MASTER_MODE_MASK         0x00000004
+#define XSP_CR_CLK_POLARITY_MASK        0x00000008
+#define XSP_CR_CLK_PHASE_MASK           0x00000010
+#define XSP_CR_TXFIFO_RESET_MASK        0x00000020
+#define XSP_CR_RXFIFO_RESET_MASK        0x00000040
+#define XSP_CR_MANUAL_SS_MASK           0x00000080
+#define XSP_CR_TRANS_INHIBIT_MASK       0x00000100
+#define XSP_CR_LSB_MSB_FIRST_MASK       0x00000200
+
+#define XSP_SR_RX_EMPTY_MASK            0x00000001
+#define XSP_SR_RX_FULL_MASK             0x00000002
+#define XSP_SR_TX_EMPTY_MASK            0x00000004
+#define XSP_SR_TX_FULL_MASK             0x00000008
+#define XSP_SR_MODE_FAULT_MASK          0x00000010
+
+#define XSP_INTR_MODE_FAULT_MASK        0x00000001
+#define XSP_INTR_SLAVE_MODE_FAULT_MASK  0x00000002
+#define XSP_INTR_TX_EMPTY_MASK          0x00000004
+#define XSP_INTR_TX_UNDERRUN_MASK       0x00000008
+#define XSP_INTR_RX_FULL_MASK           0x00000010
+#define XSP_INTR_RX_OVERRUN_MASK        0x00000020
+#define XSP_INTR_TX_HALF_EMPTY_MASK     0x00000040
+#define XSP_INTR_RX_NOT_EMPTY_MASK      0x00000100
+
+#define XSP_INTR_DFT_MASK   (XSP_INTR_MODE_FAULT_MASK | XSP_INTR_TX_UNDERRUN_MASK | \
+                             XSP_INTR_RX_OVERRUN_MASK | XSP_INTR_SLAVE_MODE_FAULT_MASK | \
+                             XSP_INTR_TX_EMPTY_MASK)
+
+u32  sim_spi_read(UINTPTR BaseAddress, u32 Offset);
+void sim_spi_write(UINTPTR BaseAddress, u32 Offset, u32 Value);
+
+#define XSpi_ReadReg(BaseAddress, RegOffset)        sim_spi_read((BaseAddress), (RegOffset))
+#define XSpi_WriteReg(BaseAddress, RegOffset, Data) sim_spi_write((BaseAddress), (RegOffset), (Data))
+
+typedef void (*XSpi_StatusHandler)(void *CallBackRef, u32 StatusEvent, unsigned int ByteCount);
+
+typedef struct {
+    u16 DeviceId;
+    UINTPTR BaseAddress;
+    int HasFifos;
+    u32 SlaveOnly;
+    u8 NumSlaveBits;
+    u8 DataWidth;
+    u8 SpiMode;
+} XSpi_Config;
+
+typedef struct {
+    UINTPTR BaseAddr;
+    u32 IsReady;
+    u32 IsStarted;
+    u32 HasFifos;
+    u32 SlaveOnly;
+    u8 NumSlaveBits;
+    u8 DataWidth;
+    u8 SpiMode;
+    u32 SlaveSelectMask;
+    u32 SlaveSelectReg;
+    u8 *SendBufferPtr;
+    u8 *RecvBufferPtr;
+    unsigned int RequestedBytes;
+    unsigned int RemainingBytes;
+    int IsBusy;
+    XSpi_StatusHandler StatusHandler;
+    void *StatusRef;
+} XSpi;
+
+XSpi_Config *XSpi_LookupConfig(u16 DeviceId);
+int  XSpi_CfgInitialize(XSpi *InstancePtr, XSpi_Config *Config, UINTPTR EffectiveAddr);
+int  XSpi_SelfTest(XSpi *InstancePtr);
+void XSpi_Reset(XSpi *InstancePtr);
+int  XSpi_SetOptions(XSpi *InstancePtr, u32 Options);
+u32  XSpi_GetOptions(XSpi *InstancePtr);
+int  XSpi_SetSlaveSelect(XSpi *InstancePtr, u32 SlaveMask);
+int  XSpi_Start(XSpi *InstancePtr);
+int  XSpi_Stop(XSpi *InstancePtr);
+int  XSpi_Transfer(XSpi *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr, unsigned int ByteCount);
+void XSpi_SetStatusHandler(XSpi *InstancePtr, void *CallBackRef, XSpi_StatusHandler FuncPtr);
+void XSpi_InterruptHandler(void *InstancePtr);
+
+#define XSpi_IntrGlobalEnable(InstancePtr) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_DGIER_OFFSET, XSP_GINTR_ENABLE_MASK)
+#define XSpi_IntrGlobalDisable(InstancePtr) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_DGIER_OFFSET, 0)
+#define XSpi_IntrEnable(InstancePtr, EnableMask) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_IIER_OFFSET, \
+                  XSpi_ReadReg((InstancePtr)->BaseAddr, XSP_IIER_OFFSET) | (EnableMask))
+#define XSpi_IntrDisable(InstancePtr, DisableMask) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_IIER_OFFSET, \
+                  XSpi_ReadReg((InstancePtr)->BaseAddr, XSP_IIER_OFFSET) & ~(DisableMask))
+#define XSpi_IntrGetStatus(InstancePtr) XSpi_ReadReg((InstancePtr)->BaseAddr, XSP_IISR_OFFSET)
+#define XSpi_IntrClear(InstancePtr, ClearMask) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_IISR_OFFSET, (ClearMask))
+
+#define XSpi_GetControlReg(InstancePtr) XSpi_ReadReg((InstancePtr)->BaseAddr, XSP_CR_OFFSET)
+#define XSpi_SetControlReg(InstancePtr, Mask) XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_CR_OFFSET, (Mask))
+#define XSpi_GetStatusReg(InstancePtr) XSpi_ReadReg((InstancePtr)->BaseAddr, XSP_SR_OFFSET)
+#define XSpi_SetSlaveSelectReg(InstancePtr, Mask) \
+    XSpi_WriteReg((InstancePtr)->BaseAddr, XSP_SSR_OFFSET, (Mask))
+
+#endif /* XSPI_H */
@@ -0,0 +1,15 @@
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS             0L
+#define XST_FAILURE             1L
+#define XST_DEVICE_NOT_FOUND    2L
+#define XST_DEVICE_IS_STARTED   5L
+#define XST_DEVICE_IS_STOPPED   6L
+#define XST_DEVICE_BUSY         21L
+#define XST_SPI_MODE_FAULT      1151L
+#define XST_SPI_TRANSFER_DONE   1152L
+
+#endif /* XSTATUS_H */
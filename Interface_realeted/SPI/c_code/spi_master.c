@@ -1,5 +1,7 @@
 #include "spi_master.h"
 
+static u16 spi_fifo_measure(XSpi *SpiInstPtr);
+
 int spi_init(XSpi* SpiInstPtr, u16 DeviceId) {
     int Status;
     XSpi_Config *ConfigPtr;
@@ -22,43 +24,229 @@ int spi_init(XSpi* SpiInstPtr, u16 DeviceId) {
         return XST_FAILURE;
     }
 
+    // Measured here once, sessions opened later only look it up
+    spi_fifo_measure(SpiInstPtr);
+
     xil_printf("SPI initialized successfully with Device ID: %d\r\n", DeviceId);
     return XST_SUCCESS;
 }
 
-int spi_write(XSpi* SpiInstPtr, u8* WriteBuffer, u16 ByteCount, u8 cs_n) {
-    
+void spi_session_select(SpiSession *Session, u32 SlaveMask) {
+    u32 SlaveSelect = Session->SpiInstPtr->SlaveSelectMask & ~SlaveMask;
+
+    if (SlaveSelect != Session->SlaveSelect) {
+        XSpi_WriteReg(Session->BaseAddr, XSP_SSR_OFFSET, SlaveSelect);
+        Session->SlaveSelect = SlaveSelect;
+        Session->Selects++;
+    }
+}
+
+// FIFO depth of each core, measured by spi_init()
+static struct {
+    XSpi *SpiInstPtr;
+    u16 FifoDepth;
+} SpiFifos[SPI_MAX_INSTANCES];
+
+// Bytes the TX FIFO takes while the transmitter is held off
+static u16 spi_fifo_measure(XSpi *SpiInstPtr) {
+    UINTPTR BaseAddr = SpiInstPtr->BaseAddr;
+    u32 Control;
+    u16 Depth = 0;
+    int i;
+
+    if (SpiInstPtr->HasFifos) {
+        Control = XSpi_ReadReg(BaseAddr, XSP_CR_OFFSET);
+        XSpi_WriteReg(BaseAddr, XSP_CR_OFFSET, Control | XSP_CR_TRANS_INHIBIT_MASK);
+        while (Depth < SPI_SESSION_FIFO_MAX &&
+               !(XSpi_ReadReg(BaseAddr, XSP_SR_OFFSET) & XSP_SR_TX_FULL_MASK)) {
+            XSpi_WriteReg(BaseAddr, XSP_DTR_OFFSET, 0);
+            Depth++;
+        }
+        XSpi_WriteReg(BaseAddr, XSP_CR_OFFSET,
+                      Control | XSP_CR_TRANS_INHIBIT_MASK | XSP_CR_TXFIFO_RESET_MASK);
+        XSpi_WriteReg(BaseAddr, XSP_CR_OFFSET, Control);
+    } else {
+        Depth = 1;
+    }
+
+    for (i = 0; i < SPI_MAX_INSTANCES; i++) {
+        if (SpiFifos[i].SpiInstPtr == SpiInstPtr || SpiFifos[i].SpiInstPtr == NULL) {
+            SpiFifos[i].SpiInstPtr = SpiInstPtr;
+            SpiFifos[i].FifoDepth = Depth;
+            break;
+        }
+    }
+
+    return Depth;
+}
+
+// Looked up, only a core that did not go through spi_init() is measured here
+static u16 spi_fifo_depth(XSpi *SpiInstPtr) {
+    int i;
+
+    for (i = 0; i < SPI_MAX_INSTANCES; i++) {
+        if (SpiFifos[i].SpiInstPtr == SpiInstPtr) {
+            return SpiFifos[i].FifoDepth;
+        }
+    }
+
+    return spi_fifo_measure(SpiInstPtr);
+}
+
+static int spi_session_setup(SpiSession *Session, XSpi *SpiInstPtr, u32 Options) {
     int Status;
 
-    /*
-	 * Run loopback test only in case of standard SPI mode.
-	 */
-    if(SpiInstPtr->SpiMode != XSP_STANDARD_MODE) {
-        xil_printf("SPI is not in standard mode. Loopback test is not possible.\r\n");
+    Session->SpiInstPtr = SpiInstPtr;
+    Session->BaseAddr = SpiInstPtr->BaseAddr;
+    Session->Open = 0;
+    Session->Segments = 0;
+    Session->Bytes = 0;
+    Session->Selects = 0;
+
+    if (SpiInstPtr->SpiMode != XSP_STANDARD_MODE || SpiInstPtr->DataWidth != XSP_DATAWIDTH_BYTE) {
+        xil_printf("SPI session needs standard mode and 8-bit transfers.\r\n");
         return XST_FAILURE;
     }
 
-	Status = XSpi_SetOptions(SpiInstPtr, XSP_MASTER_OPTION |
- 					XSP_LOOPBACK_OPTION);
-	if (Status != XST_SUCCESS) return XST_FAILURE;
-
-    Status = XSpi_SetSlaveSelect(SpiInstPtr, cs_n);
+    Status = XSpi_SetOptions(SpiInstPtr, Options | XSP_MASTER_OPTION | XSP_MANUAL_SSELECT_OPTION);
     if (Status != XST_SUCCESS) return XST_FAILURE;
-    
+
     Status = XSpi_Start(SpiInstPtr);
-    if (Status != XST_SUCCESS) return XST_FAILURE;
+    if (Status != XST_SUCCESS && Status != XST_DEVICE_IS_STARTED) return XST_FAILURE;
 
     XSpi_IntrGlobalDisable(SpiInstPtr);
 
-    Status = XSpi_Transfer(SpiInstPtr, WriteBuffer, NULL, ByteCount);
-    if (Status != XST_SUCCESS) return XST_FAILURE;
+    // Nothing selected; from here on bytes go out as soon as they are in the FIFO
+    Session->SlaveSelect = SpiInstPtr->SlaveSelectMask;
+    XSpi_WriteReg(Session->BaseAddr, XSP_SSR_OFFSET, Session->SlaveSelect);
+    Session->FifoDepth = spi_fifo_depth(SpiInstPtr);
+    Session->Control = XSpi_ReadReg(Session->BaseAddr, XSP_CR_OFFSET) & ~XSP_CR_TRANS_INHIBIT_MASK;
+    XSpi_WriteReg(Session->BaseAddr, XSP_CR_OFFSET, Session->Control);
+    Session->Open = 1;
+
+    return XST_SUCCESS;
+}
+
+int spi_session_open(SpiSession *Session, XSpi *SpiInstPtr, u32 Options) {
+    return spi_session_setup(Session, SpiInstPtr, Options & ~XSP_LOOPBACK_OPTION);
+}
+
+static void spi_session_segment(SpiSession *Session, const SpiSeg *Seg) {
+    u32 Sent = 0;
+    u32 Received = 0;
+    u8 Data;
+
+    spi_session_select(Session, Seg->SlaveMask);
+
+    // Keep the TX FIFO topped up, at most FifoDepth bytes ahead of RX
+    while (Received < Seg->Length) {
+        while (Sent < Seg->Length && Sent - Received < Session->FifoDepth) {
+            XSpi_WriteReg(Session->BaseAddr, XSP_DTR_OFFSET, Seg->WriteBuf ? Seg->WriteBuf[Sent] : 0);
+            Sent++;
+        }
+        if (XSpi_ReadReg(Session->BaseAddr, XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK) {
+            continue;
+        }
+        Data = (u8)XSpi_ReadReg(Session->BaseAddr, XSP_DRR_OFFSET);
+        if (Seg->ReadBuf) {
+            Seg->ReadBuf[Received] = Data;
+        }
+        Received++;
+    }
 
-    Status = XSpi_Stop(SpiInstPtr);
+    if (!(Seg->Flags & SPI_SEG_KEEP_CS)) {
+        spi_session_select(Session, 0);
+    }
+    Session->Segments++;
+    Session->Bytes += Seg->Length;
+}
+
+int spi_session_batch(SpiSession *Session, const SpiSeg *Segs, u16 Count) {
+    u16 i;
+
+    if (!Session->Open) {
+        return XST_FAILURE;
+    }
+    for (i = 0; i < Count; i++) {
+        spi_session_segment(Session, &Segs[i]);
+    }
+
+    return XST_SUCCESS;
+}
+
+int spi_session_transfer(SpiSession *Session, u32 SlaveMask, const u8 *WriteBuf, u8 *ReadBuf,
+                         u32 ByteCount) {
+    SpiSeg Seg;
+
+    Seg.SlaveMask = SlaveMask;
+    Seg.WriteBuf = WriteBuf;
+    Seg.ReadBuf = ReadBuf;
+    Seg.Length = ByteCount;
+    Seg.Flags = 0;
+
+    return spi_session_batch(Session, &Seg, 1);
+}
+
+void spi_session_close(SpiSession *Session) {
+    if (!Session->Open) {
+        return;
+    }
+    spi_session_select(Session, 0);
+    XSpi_WriteReg(Session->BaseAddr, XSP_CR_OFFSET, Session->Control | XSP_CR_TRANS_INHIBIT_MASK);
+    XSpi_Stop(Session->SpiInstPtr);
+    Session->Open = 0;
+}
+
+void spi_session_report(SpiSession *Session) {
+    xil_printf("#spisession,fifo_depth,segments,bytes,selects\r\n");
+    xil_printf("spisession,%d,%d,%d,%d\r\n", Session->FifoDepth, Session->Segments, Session->Bytes,
+               Session->Selects);
+}
+
+// MOSI looped back to MISO inside the core, nothing selected
+int spi_loopback_test(XSpi *SpiInstPtr) {
+    SpiSession Session;
+    u8 WriteBuffer[64];
+    u8 ReadBuffer[64];
+    int Status;
+    u16 i;
+
+    for (i = 0; i < sizeof(WriteBuffer); i++) {
+        WriteBuffer[i] = (u8)(i * 7 + 1);
+        ReadBuffer[i] = 0;
+    }
+
+    Status = spi_session_setup(&Session, SpiInstPtr, XSP_LOOPBACK_OPTION);
     if (Status != XST_SUCCESS) return XST_FAILURE;
 
+    spi_session_transfer(&Session, 0, WriteBuffer, ReadBuffer, sizeof(WriteBuffer));
+    spi_session_close(&Session);
+
+    for (i = 0; i < sizeof(WriteBuffer); i++) {
+        if (ReadBuffer[i] != WriteBuffer[i]) {
+            xil_printf("SPI loopback mismatch at %d: 0x%02x, expected 0x%02x\r\n", i, ReadBuffer[i],
+                       WriteBuffer[i]);
+            return XST_FAILURE;
+        }
+    }
+
     return XST_SUCCESS;
 }
 
+// One-off write; for many transfers keep a session open instead
+int spi_write(XSpi* SpiInstPtr, u8* WriteBuffer, u16 ByteCount, u8 cs_n) {
+    SpiSession Session;
+    int Status;
+
+    Status = spi_session_open(&Session, SpiInstPtr, 0);
+    if (Status != XST_SUCCESS) return XST_FAILURE;
+
+    Status = spi_session_transfer(&Session, cs_n, WriteBuffer, NULL, ByteCount);
+    spi_session_close(&Session);
+
+    return Status;
+}
+
 // int spi_write(XSpi* SpiInstPtr, u8* WriteBuffer, u16 ByteCount, u8 cs_n) {
     
 //     int Status;
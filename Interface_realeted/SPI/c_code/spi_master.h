@@ -13,6 +13,59 @@ int spi_init(XSpi* SpiInstPtr, u16 DeviceId);
 int spi_write(XSpi* SpiInstPtr, u8* WriteBuffer, u16 ByteCount, u8 cs_n);
 // int spi_read(XSpi *SpiInstPtr, u8 *WriteBuffer, u8 *BufferPtr, u16 ByteCount);
 
+/*
+ * SPI session: the core is configured once (master, manual slave select,
+ * clock options) and then streams any number of transfers through its
+ * registers, without the XSpi_SetOptions / XSpi_Start / XSpi_Transfer /
+ * XSpi_Stop round trip per write.
+ *
+ * - A segment is one chip select frame: the slaves in SlaveMask are selected
+ *   for its first byte and released after its last, however long it is.
+ *   SPI_SEG_KEEP_CS leaves them selected for the next segment, e.g. a
+ *   command and its data from two buffers.
+ * - Full duplex: what comes back is stored in ReadBuf, if given. A NULL
+ *   WriteBuf sends zeros.
+ * - No more bytes than the TX FIFO holds are in flight, so neither FIFO can
+ *   overrun. The depth is measured once per XSpi, by spi_init() (or the
+ *   first session of a core set up elsewhere).
+ * - Loopback is only used by spi_loopback_test().
+ */
+
+#define SPI_SESSION_FIFO_MAX    256     // Deepest FIFO the AXI Quad SPI offers
+#define SPI_MAX_INSTANCES       4       // Cores whose FIFO depth is remembered
+
+#define SPI_SEG_KEEP_CS         0x01    // Frame continues with the next segment
+
+typedef struct {
+    u32 SlaveMask;                  // As for XSpi_SetSlaveSelect
+    const u8 *WriteBuf;
+    u8 *ReadBuf;
+    u32 Length;
+    u8 Flags;
+} SpiSeg;
+
+typedef struct {
+    XSpi *SpiInstPtr;
+    UINTPTR BaseAddr;
+    u32 Control;                    // CR while the session is open
+    u32 SlaveSelect;                // SSR as last written
+    u16 FifoDepth;
+    u8 Open;
+    u32 Segments;
+    u32 Bytes;
+    u32 Selects;                    // SSR writes
+} SpiSession;
+
+int  spi_session_open(SpiSession *Session, XSpi *SpiInstPtr, u32 Options);
+int  spi_session_transfer(SpiSession *Session, u32 SlaveMask, const u8 *WriteBuf, u8 *ReadBuf,
+                          u32 ByteCount);
+int  spi_session_batch(SpiSession *Session, const SpiSeg *Segs, u16 Count);
+void spi_session_close(SpiSession *Session);
+void spi_session_select(SpiSession *Session, u32 SlaveMask);   // 0 releases all
+void spi_session_report(SpiSession *Session);
+
+int spi_loopback_test(XSpi *SpiInstPtr);
+
 #ifdef __cplusplus
 }
 #endif
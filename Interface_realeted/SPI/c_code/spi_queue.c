@@ -0,0 +1,206 @@
+#include "spi_queue.h"
+#include "sleep.h"
+
+static void spi_queue_lock(SpiQueue *Queue) {
+    XSpi_WriteReg(Queue->Session.BaseAddr, XSP_DGIER_OFFSET, 0);
+}
+
+static void spi_queue_unlock(SpiQueue *Queue) {
+    XSpi_WriteReg(Queue->Session.BaseAddr, XSP_DGIER_OFFSET, XSP_GINTR_ENABLE_MASK);
+}
+
+// Pops the head and reports it, the caller starts the next one
+static void spi_queue_complete(SpiQueue *Queue, int Status) {
+    SpiTxn *Txn = Queue->Head;
+
+    Queue->Head = Txn->Next;
+    if (Queue->Head == NULL) {
+        Queue->Tail = NULL;
+    }
+    if (Status != XST_SUCCESS || !(Txn->Flags & SPI_SEG_KEEP_CS)) {
+        spi_session_select(&Queue->Session, 0);
+    }
+    Queue->Sent = 0;
+    Queue->Received = 0;
+
+    if (Status == XST_SUCCESS) {
+        Queue->Completed++;
+        Queue->Session.Segments++;
+        Queue->Session.Bytes += Txn->Length;
+    } else {
+        Queue->Failed++;
+    }
+
+    Txn->Next = NULL;
+    Txn->Status = Status;
+    Txn->Done = 1;
+    if (Txn->Callback) {
+        Txn->Callback(Txn->CallBackRef, Txn);
+    }
+}
+
+static void spi_queue_drain(SpiQueue *Queue, SpiTxn *Txn) {
+    UINTPTR BaseAddr = Queue->Session.BaseAddr;
+    u32 Count;
+    u8 Data;
+
+    if (Queue->Received == Queue->Sent ||
+        (XSpi_ReadReg(BaseAddr, XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK)) {
+        return;
+    }
+
+    // One occupancy read instead of a status read per byte
+    Count = Queue->Session.FifoDepth > 1 ? XSpi_ReadReg(BaseAddr, XSP_RFO_OFFSET) + 1 : 1;
+    while (Count-- && Queue->Received < Queue->Sent) {
+        Data = (u8)XSpi_ReadReg(BaseAddr, XSP_DRR_OFFSET);
+        if (Txn->ReadBuf) {
+            Txn->ReadBuf[Queue->Received] = Data;
+        }
+        Queue->Received++;
+    }
+}
+
+// No more than FifoDepth bytes ahead of RX, so neither FIFO can overrun
+static void spi_queue_fill(SpiQueue *Queue, SpiTxn *Txn) {
+    while (Queue->Sent < Txn->Length && Queue->Sent - Queue->Received < Queue->Session.FifoDepth) {
+        XSpi_WriteReg(Queue->Session.BaseAddr, XSP_DTR_OFFSET,
+                      Txn->WriteBuf ? Txn->WriteBuf[Queue->Sent] : 0);
+        Queue->Sent++;
+    }
+}
+
+// Moves the head along as far as the FIFOs allow, completing what is done
+static void spi_queue_pump(SpiQueue *Queue) {
+    SpiTxn *Txn;
+
+    while ((Txn = Queue->Head) != NULL) {
+        if (Queue->Sent == 0) {
+            spi_session_select(&Queue->Session, Txn->SlaveMask);
+        }
+        spi_queue_drain(Queue, Txn);
+        if (Queue->Received == Txn->Length) {
+            spi_queue_complete(Queue, XST_SUCCESS);
+            continue;
+        }
+        spi_queue_fill(Queue, Txn);
+        return;
+    }
+}
+
+void spi_queue_handler(void *CallBackRef) {
+    SpiQueue *Queue = (SpiQueue *)CallBackRef;
+    UINTPTR BaseAddr = Queue->Session.BaseAddr;
+    u32 Status;
+
+    // IISR bits toggle on write, writing back what was read clears them
+    Status = XSpi_ReadReg(BaseAddr, XSP_IISR_OFFSET);
+    XSpi_WriteReg(BaseAddr, XSP_IISR_OFFSET, Status);
+    Queue->Interrupts++;
+
+    if ((Status & (XSP_INTR_RX_OVERRUN_MASK | XSP_INTR_MODE_FAULT_MASK)) && Queue->Head) {
+        // Bytes were lost, the head cannot finish; start clean with the next one
+        XSpi_WriteReg(BaseAddr, XSP_CR_OFFSET,
+                      Queue->Session.Control | XSP_CR_TXFIFO_RESET_MASK | XSP_CR_RXFIFO_RESET_MASK);
+        spi_queue_complete(Queue, XST_FAILURE);
+    }
+
+    spi_queue_pump(Queue);
+}
+
+int spi_queue_init(SpiQueue *Queue, XSpi *SpiInstPtr, u32 Options) {
+    UINTPTR BaseAddr;
+    int Status;
+
+    Queue->Head = NULL;
+    Queue->Tail = NULL;
+    Queue->Sent = 0;
+    Queue->Received = 0;
+    Queue->Submitted = 0;
+    Queue->Completed = 0;
+    Queue->Failed = 0;
+    Queue->Interrupts = 0;
+
+    // The queue owns the controller from now on, the session stays open
+    Status = spi_session_open(&Queue->Session, SpiInstPtr, Options);
+    if (Status != XST_SUCCESS) {
+        xil_printf("SPI queue start failed\r\n");
+        return XST_FAILURE;
+    }
+
+    BaseAddr = Queue->Session.BaseAddr;
+    XSpi_WriteReg(BaseAddr, XSP_IIER_OFFSET, SPI_QUEUE_INTR_MASK);
+    XSpi_WriteReg(BaseAddr, XSP_IISR_OFFSET, XSpi_ReadReg(BaseAddr, XSP_IISR_OFFSET));
+    spi_queue_unlock(Queue);
+
+    return XST_SUCCESS;
+}
+
+void spi_txn_init(SpiTxn *Txn, u32 SlaveMask, const u8 *WriteBuf, u8 *ReadBuf, u32 Length) {
+    Txn->SlaveMask = SlaveMask;
+    Txn->WriteBuf = WriteBuf;
+    Txn->ReadBuf = ReadBuf;
+    Txn->Length = Length;
+    Txn->Flags = 0;
+    Txn->Callback = NULL;
+    Txn->CallBackRef = NULL;
+    Txn->Status = XST_SUCCESS;
+    Txn->Done = 0;
+    Txn->Next = NULL;
+}
+
+int spi_queue_submit(SpiQueue *Queue, SpiTxn *Txn) {
+    if (Txn->Length == 0 || !Queue->Session.Open) {
+        return XST_FAILURE;
+    }
+
+    Txn->Status = SPI_TXN_PENDING;
+    Txn->Done = 0;
+    Txn->Next = NULL;
+
+    spi_queue_lock(Queue);
+
+    if (Queue->Tail) {
+        Queue->Tail->Next = Txn;
+    } else {
+        Queue->Head = Txn;
+    }
+    Queue->Tail = Txn;
+    Queue->Submitted++;
+
+    // Otherwise the interrupt picks it up when the ones before are done
+    if (Queue->Head == Txn) {
+        spi_queue_pump(Queue);
+    }
+
+    spi_queue_unlock(Queue);
+
+    return XST_SUCCESS;
+}
+
+int spi_queue_wait(SpiQueue *Queue, SpiTxn *Txn) {
+    int TimeOut = SPI_QUEUE_WAIT_TIMEOUT_US;
+
+    (void)Queue;
+
+    // Done is set from the handler, look again every microsecond
+    while (TimeOut) {
+        if (Txn->Done) {
+            return Txn->Status;
+        }
+        TimeOut--;
+        usleep(1U);
+    }
+
+    xil_printf("SPI queue wait timed out\r\n");
+    return XST_FAILURE;
+}
+
+int spi_queue_idle(SpiQueue *Queue) {
+    return Queue->Head == NULL;
+}
+
+void spi_queue_report(SpiQueue *Queue) {
+    xil_printf("#spiqueue,fifo_depth,submitted,completed,failed,interrupts,bytes\r\n");
+    xil_printf("spiqueue,%d,%d,%d,%d,%d,%d\r\n", Queue->Session.FifoDepth, Queue->Submitted,
+               Queue->Completed, Queue->Failed, Queue->Interrupts, Queue->Session.Bytes);
+}
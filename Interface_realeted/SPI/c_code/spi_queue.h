@@ -0,0 +1,78 @@
+#ifndef SPI_QUEUE_H
+#define SPI_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xspi.h"
+#include "xil_printf.h"
+#include "spi_master.h"
+
+/*
+ * Interrupt driven SPI transfer queue on top of an SPI session. Transfers
+ * are submitted from the main loop and run back to back from the SPI
+ * interrupt: the TX FIFO is topped up when it falls to half empty, the RX
+ * FIFO is drained at the same time and once more when the TX FIFO has run
+ * dry, so the CPU only spends a few register accesses per half FIFO.
+ *
+ * spi_queue_handler() goes on the SPI line of the interrupt controller, in
+ * place of XSpi_InterruptHandler:
+ *
+ *     XIntc_Connect(&Intc, XPAR_INTC_0_SPI_0_VEC_ID, spi_queue_handler, &Queue);
+ *
+ * A transfer is one chip select frame (SPI_SEG_KEEP_CS joins it to the
+ * next one), full duplex as in spi_session_batch(). Its buffers and the
+ * SpiTxn itself must stay valid until Done is set, also after a wait timed
+ * out. The callback runs in interrupt context.
+ */
+
+#define SPI_TXN_PENDING         1       // Status while queued or on the bus
+#define SPI_QUEUE_WAIT_TIMEOUT_US   1000000 // spi_queue_wait() gives up after 1 s
+
+#define SPI_QUEUE_INTR_MASK     (XSP_INTR_TX_HALF_EMPTY_MASK | XSP_INTR_TX_EMPTY_MASK | \
+                                 XSP_INTR_RX_OVERRUN_MASK | XSP_INTR_MODE_FAULT_MASK)
+
+typedef struct SpiTxn SpiTxn;
+
+typedef void (*SpiTxnHandler)(void *CallBackRef, SpiTxn *Txn);
+
+struct SpiTxn {
+    u32 SlaveMask;                  // As for XSpi_SetSlaveSelect
+    const u8 *WriteBuf;             // NULL sends zeros
+    u8 *ReadBuf;                    // Optional
+    u32 Length;
+    u8 Flags;                       // SPI_SEG_KEEP_CS
+    SpiTxnHandler Callback;         // Optional, called on completion
+    void *CallBackRef;
+    volatile int Status;            // SPI_TXN_PENDING, then XST_SUCCESS or XST_FAILURE
+    volatile u8 Done;
+    SpiTxn *Next;
+};
+
+typedef struct {
+    SpiSession Session;
+    SpiTxn *Head;                   // On the bus, or next to go
+    SpiTxn *Tail;
+    u32 Sent;                       // Bytes of the head written to DTR
+    u32 Received;                   // Bytes of the head read from DRR
+    u32 Submitted;
+    u32 Completed;
+    u32 Failed;
+    u32 Interrupts;
+} SpiQueue;
+
+int  spi_queue_init(SpiQueue *Queue, XSpi *SpiInstPtr, u32 Options);
+void spi_queue_handler(void *CallBackRef);
+void spi_txn_init(SpiTxn *Txn, u32 SlaveMask, const u8 *WriteBuf, u8 *ReadBuf, u32 Length);
+int  spi_queue_submit(SpiQueue *Queue, SpiTxn *Txn);
+int  spi_queue_wait(SpiQueue *Queue, SpiTxn *Txn);
+int  spi_queue_idle(SpiQueue *Queue);
+void spi_queue_report(SpiQueue *Queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPI_QUEUE_H */
@@ -0,0 +1,538 @@
+#include "ddr_bench.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+
+#define DDR_WORD_BYTES      ((u32)sizeof(ddr_word))
+#define DDR_WORD_BITS       (DDR_WORD_BYTES * 8)
+
+// Keeps the compiler from merging or dropping repeated passes over the same memory
+#define DDR_BARRIER()       __asm__ volatile("" ::: "memory")
+
+// Mismatches printed per pattern test, the rest are only counted
+#define DDR_BENCH_MAX_PRINT 8
+
+#define DDR_PATTERN_ADDR    0
+#define DDR_PATTERN_ADDR_INV 1
+#define DDR_PATTERN_WALK1   2
+
+static volatile ddr_word DdrSink;
+
+/***** Timebase ******/
+#if defined(DDR_BENCH_HOST)
+#include <time.h>
+
+#define DDR_BENCH_TICK_HZ   1000000000ULL
+
+XilFlushHook Xil_HostFlushHook;
+
+int ddr_bench_timer_init(void) {
+    return XST_SUCCESS;
+}
+
+u64 ddr_bench_ticks(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+#elif defined(XPAR_TMRCTR_0_DEVICE_ID)
+#include "xtmrctr.h"
+
+#define DDR_BENCH_TICK_HZ   ((u64)XPAR_TMRCTR_0_CLOCK_FREQ_HZ)
+
+static XTmrCtr DdrTimer;
+static u32 DdrTimerLast;
+static u64 DdrTimerHigh;
+
+int ddr_bench_timer_init(void) {
+    // Already running when a second test suite starts
+    if (DdrTimer.IsReady) {
+        return XST_SUCCESS;
+    }
+
+    if (XTmrCtr_Initialize(&DdrTimer, XPAR_TMRCTR_0_DEVICE_ID) != XST_SUCCESS) {
+        xil_printf("DDR bench timer init failed\r\n");
+        return XST_FAILURE;
+    }
+
+    // Free-running up counter, the wraps are folded into DdrTimerHigh
+    XTmrCtr_SetOptions(&DdrTimer, 0, XTC_AUTO_RELOAD_OPTION);
+    XTmrCtr_SetResetValue(&DdrTimer, 0, 0);
+    XTmrCtr_Start(&DdrTimer, 0);
+    DdrTimerLast = 0;
+    DdrTimerHigh = 0;
+
+    return XST_SUCCESS;
+}
+
+// Must be called at least once per wrap (43 s at 100 MHz): the bench passes
+// are short, the march tests call it once per chunk
+u64 ddr_bench_ticks(void) {
+    u32 Now = XTmrCtr_GetValue(&DdrTimer, 0);
+
+    if (Now < DdrTimerLast) {
+        DdrTimerHigh += 0x100000000ULL;
+    }
+    DdrTimerLast = Now;
+
+    return DdrTimerHigh | Now;
+}
+
+#else
+
+#define DDR_BENCH_TICK_HZ   1ULL
+
+int ddr_bench_timer_init(void) {
+    xil_printf("DDR bench: no AXI Timer in the design, timings will read 0\r\n");
+    return XST_SUCCESS;
+}
+
+u64 ddr_bench_ticks(void) {
+    return 0;
+}
+
+#endif
+
+u64 ddr_bench_tick_hz(void) {
+    return DDR_BENCH_TICK_HZ;
+}
+
+/***** Report ******/
+static void ddr_print_fixed(double Value) {
+    u32 Whole, Frac;
+
+    if (Value < 0) {
+        Value = 0;
+    }
+    Whole = (u32)Value;
+    Frac = (u32)((Value - Whole) * 100.0 + 0.5);
+    if (Frac >= 100) {
+        Whole++;
+        Frac -= 100;
+    }
+    xil_printf("%d.%02d", Whole, Frac);
+}
+
+static void ddr_report(const char *Test, const char *Cache, u32 Block, u32 Stride,
+                       u32 Bytes, u32 Accesses, u64 Ticks, u32 Errors) {
+    double Ns = (double)Ticks * 1e9 / (double)DDR_BENCH_TICK_HZ;
+
+    xil_printf("ddrbench,%s,%s,%d,%d,%d,%d,", Test, Cache, Block, Stride, Bytes, (u32)Ticks);
+    ddr_print_fixed(Ns > 0 ? (double)Bytes * 1e3 / Ns : 0);
+    xil_printf(",");
+    ddr_print_fixed(Accesses ? Ns / Accesses : 0);
+    xil_printf(",%d\r\n", Errors);
+}
+
+static u32 ddr_reps(u32 Bytes) {
+    return Bytes >= DDR_BENCH_MIN_BYTES ? 1 : DDR_BENCH_MIN_BYTES / Bytes;
+}
+
+/***** Sequential ******/
+// Unrolled by 8 with independent accumulators, so the loads issue back to back
+static ddr_word ddr_read_block(const ddr_word *Ptr, u32 Words) {
+    ddr_word s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    u32 i;
+
+    for (i = 0; i < Words; i += 8) {
+        s0 ^= Ptr[i + 0];
+        s1 ^= Ptr[i + 1];
+        s2 ^= Ptr[i + 2];
+        s3 ^= Ptr[i + 3];
+        s4 ^= Ptr[i + 4];
+        s5 ^= Ptr[i + 5];
+        s6 ^= Ptr[i + 6];
+        s7 ^= Ptr[i + 7];
+    }
+
+    return s0 ^ s1 ^ s2 ^ s3 ^ s4 ^ s5 ^ s6 ^ s7;
+}
+
+static void ddr_write_block(ddr_word *Ptr, u32 Words, ddr_word Value) {
+    u32 i;
+
+    for (i = 0; i < Words; i += 8) {
+        Ptr[i + 0] = Value;
+        Ptr[i + 1] = Value;
+        Ptr[i + 2] = Value;
+        Ptr[i + 3] = Value;
+        Ptr[i + 4] = Value;
+        Ptr[i + 5] = Value;
+        Ptr[i + 6] = Value;
+        Ptr[i + 7] = Value;
+    }
+}
+
+static void ddr_copy_block(ddr_word *Dst, const ddr_word *Src, u32 Words) {
+    u32 i;
+
+    for (i = 0; i < Words; i += 8) {
+        Dst[i + 0] = Src[i + 0];
+        Dst[i + 1] = Src[i + 1];
+        Dst[i + 2] = Src[i + 2];
+        Dst[i + 3] = Src[i + 3];
+        Dst[i + 4] = Src[i + 4];
+        Dst[i + 5] = Src[i + 5];
+        Dst[i + 6] = Src[i + 6];
+        Dst[i + 7] = Src[i + 7];
+    }
+}
+
+static void ddr_bench_seq(UINTPTR Base, u32 Size, const char *Cache) {
+    static const u32 Blocks[] = DDR_BENCH_BLOCKS;
+    ddr_word *Ptr = (ddr_word *)Base;
+    u32 b, r, Block, Words, Reps;
+    u64 Start, Ticks;
+
+    for (b = 0; b < sizeof(Blocks) / sizeof(Blocks[0]); b++) {
+        Block = Blocks[b];
+        Words = Block / DDR_WORD_BYTES;
+        if (Block > Size || Words < 8) {
+            continue;
+        }
+        Reps = ddr_reps(Block);
+
+        Start = ddr_bench_ticks();
+        for (r = 0; r < Reps; r++) {
+            ddr_write_block(Ptr, Words, (ddr_word)r);
+            DDR_BARRIER();
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        ddr_report("seq_write", Cache, Block, DDR_WORD_BYTES, Block * Reps, Words * Reps, Ticks, 0);
+
+        Start = ddr_bench_ticks();
+        for (r = 0; r < Reps; r++) {
+            DdrSink = ddr_read_block(Ptr, Words);
+            DDR_BARRIER();
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        ddr_report("seq_read", Cache, Block, DDR_WORD_BYTES, Block * Reps, Words * Reps, Ticks, 0);
+
+        // Source and destination are both one block, so copy needs twice the space
+        if (2 * Block > Size) {
+            continue;
+        }
+        Start = ddr_bench_ticks();
+        for (r = 0; r < Reps; r++) {
+            ddr_copy_block(Ptr + Words, Ptr, Words);
+            DDR_BARRIER();
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        ddr_report("seq_copy", Cache, Block, DDR_WORD_BYTES, 2 * Block * Reps, 2 * Words * Reps, Ticks, 0);
+    }
+}
+
+/***** Strided ******/
+static void ddr_bench_stride(UINTPTR Base, u32 Size, const char *Cache) {
+    static const u32 Blocks[] = DDR_BENCH_BLOCKS;
+    static const u32 Strides[] = DDR_BENCH_STRIDES;
+    u32 b, s, r, Off, Block = 0, Stride, Accesses, Reps;
+    ddr_word Sum;
+    u64 Start, Ticks;
+
+    for (b = 0; b < sizeof(Blocks) / sizeof(Blocks[0]); b++) {
+        if (Blocks[b] <= Size && Blocks[b] > Block) {
+            Block = Blocks[b];
+        }
+    }
+
+    for (s = 0; s < sizeof(Strides) / sizeof(Strides[0]); s++) {
+        Stride = Strides[s];
+        if (Stride < DDR_WORD_BYTES || Stride > Block) {
+            continue;
+        }
+        Accesses = Block / Stride;
+        // As many accesses as a sequential pass touches lines
+        Reps = ddr_reps(Accesses * DDR_BENCH_LINE);
+
+        Start = ddr_bench_ticks();
+        for (r = 0; r < Reps; r++) {
+            for (Off = 0; Off < Block; Off += Stride) {
+                *(ddr_word *)(Base + Off) = (ddr_word)Off;
+            }
+            DDR_BARRIER();
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        ddr_report("stride_write", Cache, Block, Stride, Accesses * Reps * DDR_WORD_BYTES,
+                   Accesses * Reps, Ticks, 0);
+
+        Sum = 0;
+        Start = ddr_bench_ticks();
+        for (r = 0; r < Reps; r++) {
+            for (Off = 0; Off < Block; Off += Stride) {
+                Sum += *(const ddr_word *)(Base + Off);
+            }
+            DDR_BARRIER();
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        DdrSink = Sum;
+        ddr_report("stride_read", Cache, Block, Stride, Accesses * Reps * DDR_WORD_BYTES,
+                   Accesses * Reps, Ticks, 0);
+    }
+}
+
+/***** Pointer chasing ******/
+static u32 ddr_rand(u32 *State) {
+    u32 x = *State;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *State = x;
+
+    return x;
+}
+
+/*
+ * Every node holds the address of the next one, in an order that is a
+ * single random cycle (Sattolo's shuffle), so each load depends on the
+ * previous one and the prefetcher cannot guess the next line.
+ */
+static void ddr_bench_chase(UINTPTR Base, u32 Size, const char *Cache) {
+    static const u32 Blocks[] = DDR_BENCH_BLOCKS;
+    u32 b, i, j, Nodes, Seed = 0x2545F491;
+    UINTPTR *Node, Tmp, Ptr;
+    u64 Start, Ticks;
+
+    for (b = 0; b < sizeof(Blocks) / sizeof(Blocks[0]); b++) {
+        if (Blocks[b] > Size) {
+            continue;
+        }
+        Nodes = Blocks[b] / DDR_BENCH_CHASE_STRIDE;
+        if (Nodes < 2) {
+            continue;
+        }
+
+        for (i = 0; i < Nodes; i++) {
+            *(UINTPTR *)(Base + i * DDR_BENCH_CHASE_STRIDE) = i;
+        }
+        for (i = Nodes - 1; i > 0; i--) {
+            j = ddr_rand(&Seed) % i;
+            Node = (UINTPTR *)(Base + i * DDR_BENCH_CHASE_STRIDE);
+            Tmp = *Node;
+            *Node = *(UINTPTR *)(Base + j * DDR_BENCH_CHASE_STRIDE);
+            *(UINTPTR *)(Base + j * DDR_BENCH_CHASE_STRIDE) = Tmp;
+        }
+        for (i = 0; i < Nodes; i++) {
+            Node = (UINTPTR *)(Base + i * DDR_BENCH_CHASE_STRIDE);
+            *Node = Base + *Node * DDR_BENCH_CHASE_STRIDE;
+        }
+
+        Ptr = Base;
+        Start = ddr_bench_ticks();
+        for (i = 0; i < DDR_BENCH_CHASE_HOPS; i++) {
+            Ptr = *(volatile UINTPTR *)Ptr;
+        }
+        Ticks = ddr_bench_ticks() - Start;
+        DdrSink = (ddr_word)Ptr;
+
+        ddr_report("chase", Cache, Blocks[b], DDR_BENCH_CHASE_STRIDE,
+                   DDR_BENCH_CHASE_HOPS * (u32)sizeof(UINTPTR), DDR_BENCH_CHASE_HOPS, Ticks, 0);
+    }
+}
+
+/***** Address patterns ******/
+static u32 ddr_mismatch(UINTPTR Addr, ddr_word Expected, ddr_word Got, u32 Errors) {
+    if (Errors < DDR_BENCH_MAX_PRINT) {
+        xil_printf("DDR mismatch at 0x%08x: expected 0x%08x, got 0x%08x\r\n",
+                   (u32)Addr, (u32)Expected, (u32)Got);
+    }
+    return Errors + 1;
+}
+
+// One bit at a time on the data lines, each value goes through DDR and back
+static u32 ddr_data_walk(UINTPTR Base) {
+    volatile ddr_word *Ptr = (volatile ddr_word *)Base;
+    ddr_word Value;
+    u32 Bit, Errors = 0;
+
+    for (Bit = 0; Bit < DDR_WORD_BITS; Bit++) {
+        Value = (ddr_word)1 << Bit;
+        *Ptr = Value;
+        Xil_DCacheFlushRange(Base, DDR_WORD_BYTES);
+        Xil_DCacheInvalidateRange(Base, DDR_WORD_BYTES);
+        if (*Ptr != Value) {
+            Errors = ddr_mismatch(Base, Value, *Ptr, Errors);
+        }
+    }
+
+    return Errors;
+}
+
+// Push the walk words out to DDR and drop them from the cache. Only these
+// words: a whole-cache invalidate would also throw away dirty lines of the
+// stack and data this program runs from.
+static void ddr_addr_walk_sync(UINTPTR Base, u32 Words) {
+    u32 Off;
+
+    Xil_DCacheFlushRange(Base, DDR_WORD_BYTES);
+    Xil_DCacheInvalidateRange(Base, DDR_WORD_BYTES);
+    for (Off = 1; Off < Words; Off <<= 1) {
+        Xil_DCacheFlushRange(Base + Off * DDR_WORD_BYTES, DDR_WORD_BYTES);
+        Xil_DCacheInvalidateRange(Base + Off * DDR_WORD_BYTES, DDR_WORD_BYTES);
+    }
+}
+
+// Walking ones on the address lines: a stuck or shorted line aliases two offsets
+static u32 ddr_addr_walk(UINTPTR Base, u32 Size) {
+    volatile ddr_word *Ptr = (volatile ddr_word *)Base;
+    const ddr_word Pattern = (ddr_word)0xAAAAAAAAAAAAAAAAULL;
+    const ddr_word Anti = ~Pattern;
+    u32 Words = Size / DDR_WORD_BYTES;
+    u32 Off, Test, Errors = 0;
+
+    for (Off = 1; Off < Words; Off <<= 1) {
+        Ptr[Off] = Pattern;
+    }
+    Ptr[0] = Anti;
+    ddr_addr_walk_sync(Base, Words);
+
+    // Stuck high: writing offset 0 must not show up anywhere else
+    for (Off = 1; Off < Words; Off <<= 1) {
+        if (Ptr[Off] != Pattern) {
+            Errors = ddr_mismatch(Base + Off * DDR_WORD_BYTES, Pattern, Ptr[Off], Errors);
+        }
+    }
+    Ptr[0] = Pattern;
+
+    // Stuck low or shorted: each power-of-two offset must only change itself
+    for (Test = 1; Test < Words; Test <<= 1) {
+        Ptr[Test] = Anti;
+        ddr_addr_walk_sync(Base, Words);
+
+        if (Ptr[0] != Pattern) {
+            Errors = ddr_mismatch(Base, Pattern, Ptr[0], Errors);
+        }
+        for (Off = 1; Off < Words; Off <<= 1) {
+            if (Off != Test && Ptr[Off] != Pattern) {
+                Errors = ddr_mismatch(Base + Off * DDR_WORD_BYTES, Pattern, Ptr[Off], Errors);
+            }
+        }
+        Ptr[Test] = Pattern;
+    }
+
+    return Errors;
+}
+
+static ddr_word ddr_pattern(UINTPTR Addr, u32 Index, int Kind) {
+    switch (Kind) {
+    case DDR_PATTERN_ADDR_INV: return ~(ddr_word)Addr;
+    case DDR_PATTERN_WALK1:    return (ddr_word)1 << (Index & (DDR_WORD_BITS - 1));
+    default:                   return (ddr_word)Addr;
+    }
+}
+
+/*
+ * Fill the whole region through the cache, then write it back and drop it
+ * with one range flush/invalidate each, so DDR only sees full-line bursts
+ * in both directions.
+ */
+static u32 ddr_pattern_pass(UINTPTR Base, u32 Size, int Kind, u64 *Ticks) {
+    ddr_word *Ptr = (ddr_word *)Base;
+    u32 Words = Size / DDR_WORD_BYTES;
+    u32 i, k, Errors = 0;
+    ddr_word Value;
+    u64 Start;
+
+    Start = ddr_bench_ticks();
+
+    for (i = 0; i < Words; i += 8) {
+        for (k = 0; k < 8; k++) {
+            Ptr[i + k] = ddr_pattern((UINTPTR)&Ptr[i + k], i + k, Kind);
+        }
+    }
+    Xil_DCacheFlushRange(Base, Size);
+    Xil_DCacheInvalidateRange(Base, Size);
+
+    for (i = 0; i < Words; i += 8) {
+        for (k = 0; k < 8; k++) {
+            Value = ddr_pattern((UINTPTR)&Ptr[i + k], i + k, Kind);
+            if (Ptr[i + k] != Value) {
+                Errors = ddr_mismatch((UINTPTR)&Ptr[i + k], Value, Ptr[i + k], Errors);
+            }
+        }
+    }
+
+    *Ticks = ddr_bench_ticks() - Start;
+
+    return Errors;
+}
+
+static u32 ddr_bench_pattern(UINTPTR Base, u32 Size, const char *Cache) {
+    static const char *Names[] = { "addr_in_addr", "addr_in_addr_inv", "walk1" };
+    u32 Errors, Total = 0;
+    u64 Start, Ticks;
+    int Kind;
+
+    Start = ddr_bench_ticks();
+    Errors = ddr_data_walk(Base);
+    ddr_report("data_walk1", Cache, DDR_WORD_BYTES, 0, 0, DDR_WORD_BITS, ddr_bench_ticks() - Start, Errors);
+    Total += Errors;
+
+    Start = ddr_bench_ticks();
+    Errors = ddr_addr_walk(Base, Size);
+    ddr_report("addr_walk1", Cache, Size, 0, 0, 0, ddr_bench_ticks() - Start, Errors);
+    Total += Errors;
+
+    for (Kind = DDR_PATTERN_ADDR; Kind <= DDR_PATTERN_WALK1; Kind++) {
+        Errors = ddr_pattern_pass(Base, Size, Kind, &Ticks);
+        ddr_report(Names[Kind], Cache, Size, DDR_WORD_BYTES, 2 * Size,
+                   2 * (Size / DDR_WORD_BYTES), Ticks, Errors);
+        Total += Errors;
+    }
+
+    return Total;
+}
+
+/***** Entry ******/
+static u32 ddr_bench_pass(UINTPTR Base, u32 Size, u32 Flags, const char *Cache) {
+    u32 Errors = 0;
+
+    if (Flags & DDR_BENCH_SEQ) {
+        ddr_bench_seq(Base, Size, Cache);
+    }
+    if (Flags & DDR_BENCH_STRIDE) {
+        ddr_bench_stride(Base, Size, Cache);
+    }
+    if (Flags & DDR_BENCH_CHASE) {
+        ddr_bench_chase(Base, Size, Cache);
+    }
+    if (Flags & DDR_BENCH_PATTERN) {
+        Errors += ddr_bench_pattern(Base, Size, Cache);
+    }
+
+    return Errors;
+}
+
+int ddr_bench_run(UINTPTR Base, u32 Size, u32 Flags) {
+    u32 Errors;
+
+    // The unrolled loops work in groups of 8 words
+    if ((Base % (8 * DDR_WORD_BYTES)) || (Size % (8 * DDR_WORD_BYTES)) || Size == 0) {
+        xil_printf("DDR bench region must be %d-byte aligned\r\n", 8 * DDR_WORD_BYTES);
+        return XST_FAILURE;
+    }
+
+    if (ddr_bench_timer_init() != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    xil_printf("#ddrbench,test,cache,block,stride,bytes,ticks,mbps,ns_per_access,errors\r\n");
+    xil_printf("#ddrbench,base=0x%08x,size=%d,tick_hz=%d\r\n", (u32)Base, Size, (u32)DDR_BENCH_TICK_HZ);
+
+    Errors = ddr_bench_pass(Base, Size, Flags, "cached");
+
+    // The pattern tests rely on the cache for their bursts, so the uncached
+    // pass only repeats the bandwidth and latency numbers
+    if (Flags & DDR_BENCH_UNCACHED) {
+        Xil_DCacheDisable();
+        ddr_bench_pass(Base, Size, Flags & ~DDR_BENCH_PATTERN, "uncached");
+        Xil_DCacheEnable();
+    }
+
+    xil_printf("ddrbench,done,,,,,,,,%d\r\n", Errors);
+
+    return Errors ? XST_FAILURE : XST_SUCCESS;
+}
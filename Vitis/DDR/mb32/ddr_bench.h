@@ -0,0 +1,75 @@
+#ifndef DDR_BENCH_H
+#define DDR_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+
+/*
+ * DDR benchmark and address-pattern test over one memory region.
+ *
+ * Every result is printed as one CSV line so a host script can collect the
+ * UART log:
+ *
+ *   ddrbench,<test>,<cache>,<block>,<stride>,<bytes>,<ticks>,<MB/s>,<ns/access>,<errors>
+ *
+ * <block> and <stride> are in bytes, <bytes> is the traffic the numbers are
+ * computed from (read + write for copy), <ns/access> is per word or per
+ * pointer hop. MB/s and ns come with two decimals.
+ */
+
+// Test groups, or-ed into the Flags of ddr_bench_run()
+#define DDR_BENCH_SEQ           0x01    // Sequential read/write/copy per block size
+#define DDR_BENCH_STRIDE        0x02    // One word every <stride> bytes
+#define DDR_BENCH_CHASE         0x04    // Random pointer chasing, load-to-use latency
+#define DDR_BENCH_PATTERN       0x08    // Walking ones, address-in-address
+#define DDR_BENCH_ALL           0x0F
+#define DDR_BENCH_UNCACHED      0x10    // Repeat everything with the D-cache off
+
+// Block sizes of the sequential and chase tests, the ones above the region size are skipped
+#ifndef DDR_BENCH_BLOCKS
+#define DDR_BENCH_BLOCKS        { 4096, 32768, 262144, 2097152, 16777216 }
+#endif
+
+// Strides of the strided tests, run over the largest block that fits
+#ifndef DDR_BENCH_STRIDES
+#define DDR_BENCH_STRIDES       { 8, 16, 32, 64, 128, 256, 1024, 4096 }
+#endif
+
+// Every measurement moves at least this much, small blocks are repeated
+#ifndef DDR_BENCH_MIN_BYTES
+#define DDR_BENCH_MIN_BYTES     0x01000000
+#endif
+
+// D-cache line of the CPU under test
+#ifndef DDR_BENCH_LINE
+#define DDR_BENCH_LINE          64
+#endif
+
+// Distance between pointer-chase nodes, one per cache line
+#ifndef DDR_BENCH_CHASE_STRIDE
+#define DDR_BENCH_CHASE_STRIDE  DDR_BENCH_LINE
+#endif
+
+#ifndef DDR_BENCH_CHASE_HOPS
+#define DDR_BENCH_CHASE_HOPS    0x00100000
+#endif
+
+// Native word, one bus access on the CPU running the benchmark
+typedef UINTPTR ddr_word;
+
+int ddr_bench_run(UINTPTR Base, u32 Size, u32 Flags);
+
+// Timebase shared with the other DDR tests: AXI Timer 0 on the board, the
+// monotonic clock on the host
+int ddr_bench_timer_init(void);
+u64 ddr_bench_ticks(void);
+u64 ddr_bench_tick_hz(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DDR_BENCH_H */
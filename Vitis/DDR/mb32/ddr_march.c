@@ -0,0 +1,264 @@
+#include "ddr_march.h"
+#include "ddr_bench.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+
+#define DDR_MARCH_UP        0
+#define DDR_MARCH_DOWN      1
+
+#define DDR_MARCH_W         1       // Write only
+#define DDR_MARCH_R         2       // Read only
+#define DDR_MARCH_RW        3       // Read, check, then write the same cell
+
+#define DDR_MARCH_WORDS     (DDR_MARCH_CHUNK / sizeof(u64))
+
+static void ddr_march_fail(DdrMarchResult *Result, UINTPTR Addr, u64 Expected, u64 Got) {
+    u64 Diff = Expected ^ Got;
+
+    if (Result->Errors < DDR_MARCH_MAX_PRINT) {
+        xil_printf("ddrmarch,fail,0x%08x,0x%08x%08x,0x%08x%08x,0x%08x%08x\r\n", (u32)Addr,
+                   (u32)(Expected >> 32), (u32)Expected, (u32)(Got >> 32), (u32)Got,
+                   (u32)(Diff >> 32), (u32)Diff);
+    }
+
+    if (Result->Errors == 0) {
+        Result->FirstFail = Addr;
+    }
+    Result->LastFail = Addr;
+    Result->FailMask |= Diff;
+    Result->Errors++;
+}
+
+// One cell of a read element, v is the value the cell held
+#define DDR_MARCH_CHECK(p, k, Rd, Result)                                   \
+    do {                                                                    \
+        u64 v = (p)[k];                                                     \
+        if (v != (Rd)) {                                                    \
+            ddr_march_fail(Result, (UINTPTR)&(p)[k], Rd, v);                \
+        }                                                                   \
+    } while (0)
+
+#define DDR_MARCH_CHECK_WRITE(p, k, Rd, Wr, Result)                         \
+    do {                                                                    \
+        u64 v = (p)[k];                                                     \
+        (p)[k] = (Wr);                                                      \
+        if (v != (Rd)) {                                                    \
+            ddr_march_fail(Result, (UINTPTR)&(p)[k], Rd, v);                \
+        }                                                                   \
+    } while (0)
+
+/*
+ * One march element over the whole region. Cells are visited in address
+ * order (or reverse), 4 per iteration, and every chunk is flushed once
+ * done so the next element reads it back from DDR.
+ */
+static void ddr_march_element(UINTPTR Base, UINTPTR Size, int Dir, int Ops,
+                              u64 Rd, u64 Wr, DdrMarchResult *Result) {
+    UINTPTR Chunks = Size / DDR_MARCH_CHUNK;
+    UINTPTR c;
+    u64 *p;
+    u32 i;
+
+    for (c = 0; c < Chunks; c++) {
+        p = (u64 *)(Base + (Dir == DDR_MARCH_UP ? c : Chunks - 1 - c) * DDR_MARCH_CHUNK);
+
+        if (Ops == DDR_MARCH_W) {
+            for (i = 0; i < DDR_MARCH_WORDS; i += 4) {
+                p[i + 0] = Wr;
+                p[i + 1] = Wr;
+                p[i + 2] = Wr;
+                p[i + 3] = Wr;
+            }
+        } else if (Ops == DDR_MARCH_R) {
+            for (i = 0; i < DDR_MARCH_WORDS; i += 4) {
+                DDR_MARCH_CHECK(p, i + 0, Rd, Result);
+                DDR_MARCH_CHECK(p, i + 1, Rd, Result);
+                DDR_MARCH_CHECK(p, i + 2, Rd, Result);
+                DDR_MARCH_CHECK(p, i + 3, Rd, Result);
+            }
+        } else if (Dir == DDR_MARCH_UP) {
+            for (i = 0; i < DDR_MARCH_WORDS; i += 4) {
+                DDR_MARCH_CHECK_WRITE(p, i + 0, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i + 1, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i + 2, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i + 3, Rd, Wr, Result);
+            }
+        } else {
+            for (i = DDR_MARCH_WORDS; i > 0; i -= 4) {
+                DDR_MARCH_CHECK_WRITE(p, i - 1, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i - 2, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i - 3, Rd, Wr, Result);
+                DDR_MARCH_CHECK_WRITE(p, i - 4, Rd, Wr, Result);
+            }
+        }
+
+        // Write back and drop the chunk: full-line bursts, and the next
+        // element cannot hit a stale copy in the cache
+        Xil_DCacheFlushRange((UINTPTR)p, DDR_MARCH_CHUNK);
+
+        // A pass over the whole DDR outlasts a timer wrap, read it often
+        // enough that ddr_bench_ticks() sees every wrap
+        (void)ddr_bench_ticks();
+    }
+}
+
+static void ddr_march_report(const char *Test, u64 Pattern, UINTPTR Size, u32 Passes,
+                             u64 Ticks, u32 Errors, u64 FailMask) {
+    double Bytes = (double)Size * Passes;
+    double Sec = (double)Ticks / (double)ddr_bench_tick_hz();
+
+    xil_printf("ddrmarch,%s,0x%08x%08x,%d,0x%08x%08x,%d,%d,0x%08x%08x\r\n", Test,
+               (u32)(Pattern >> 32), (u32)Pattern, (u32)(Bytes / 1048576.0),
+               (u32)(Ticks >> 32), (u32)Ticks,
+               Sec > 0 ? (u32)(Bytes / Sec / 1e6) : 0, Errors,
+               (u32)(FailMask >> 32), (u32)FailMask);
+}
+
+// up(w0) up(r0,w1) up(r1,w0) dn(r0,w1) dn(r1,w0) up(r0)
+static void ddr_march_c(UINTPTR Base, UINTPTR Size, u64 Bg, DdrMarchResult *Result) {
+    u32 Errors = Result->Errors;
+    u64 Mask = Result->FailMask;
+    u64 Start = ddr_bench_ticks();
+
+    // FailMask only holds this test's bits until the report
+    Result->FailMask = 0;
+
+    ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_W,  0,   Bg,  Result);
+    ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_RW, Bg,  ~Bg, Result);
+    ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_RW, ~Bg, Bg,  Result);
+    ddr_march_element(Base, Size, DDR_MARCH_DOWN, DDR_MARCH_RW, Bg,  ~Bg, Result);
+    ddr_march_element(Base, Size, DDR_MARCH_DOWN, DDR_MARCH_RW, ~Bg, Bg,  Result);
+    ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_R,  Bg,  0,   Result);
+
+    // 1 write pass, 4 read+write passes, 1 read pass
+    ddr_march_report("march_c", Bg, Size, 10, ddr_bench_ticks() - Start,
+                     Result->Errors - Errors, Result->FailMask);
+    Result->FailMask |= Mask;
+}
+
+// up(wp) up(rp,w~p) dn(r~p,wp), then the same with ~p
+static void ddr_march_movinv(UINTPTR Base, UINTPTR Size, u64 Pattern, DdrMarchResult *Result) {
+    u32 Errors = Result->Errors;
+    u64 Mask = Result->FailMask;
+    u64 Start = ddr_bench_ticks();
+    u64 p = Pattern;
+    int k;
+
+    Result->FailMask = 0;
+
+    for (k = 0; k < 2; k++, p = ~p) {
+        ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_W,  0,  p,  Result);
+        ddr_march_element(Base, Size, DDR_MARCH_UP,   DDR_MARCH_RW, p,  ~p, Result);
+        ddr_march_element(Base, Size, DDR_MARCH_DOWN, DDR_MARCH_RW, ~p, p,  Result);
+    }
+
+    ddr_march_report("movinv", Pattern, Size, 10, ddr_bench_ticks() - Start,
+                     Result->Errors - Errors, Result->FailMask);
+    Result->FailMask |= Mask;
+}
+
+static u64 ddr_march_rand(u64 *State) {
+    u64 x = *State;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *State = x;
+
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Fill with a random sequence, then check it while writing the inverse, then check that
+static void ddr_march_random(UINTPTR Base, UINTPTR Size, u32 Seed, DdrMarchResult *Result) {
+    UINTPTR Chunks = Size / DDR_MARCH_CHUNK;
+    u32 Errors = Result->Errors;
+    u64 Mask = Result->FailMask;
+    u64 Start = ddr_bench_ticks();
+    u64 State, Value;
+    UINTPTR c;
+    u64 *p;
+    u32 i;
+    int Pass;
+
+    Result->FailMask = 0;
+
+    for (Pass = 0; Pass < 3; Pass++) {
+        // Same sequence every pass, xorshift state must not be zero
+        State = ((u64)Seed << 32) | 0x9E3779B9u;
+
+        for (c = 0; c < Chunks; c++) {
+            p = (u64 *)(Base + c * DDR_MARCH_CHUNK);
+
+            if (Pass == 0) {
+                for (i = 0; i < DDR_MARCH_WORDS; i++) {
+                    p[i] = ddr_march_rand(&State);
+                }
+            } else if (Pass == 1) {
+                for (i = 0; i < DDR_MARCH_WORDS; i++) {
+                    Value = ddr_march_rand(&State);
+                    DDR_MARCH_CHECK_WRITE(p, i, Value, ~Value, Result);
+                }
+            } else {
+                for (i = 0; i < DDR_MARCH_WORDS; i++) {
+                    Value = ~ddr_march_rand(&State);
+                    DDR_MARCH_CHECK(p, i, Value, Result);
+                }
+            }
+
+            Xil_DCacheFlushRange((UINTPTR)p, DDR_MARCH_CHUNK);
+            (void)ddr_bench_ticks();
+        }
+    }
+
+    ddr_march_report("random", Seed, Size, 4, ddr_bench_ticks() - Start,
+                     Result->Errors - Errors, Result->FailMask);
+    Result->FailMask |= Mask;
+}
+
+int ddr_march_run(UINTPTR Base, UINTPTR Size, u32 Tests, u32 Seed, DdrMarchResult *Result) {
+    static const u64 Backgrounds[] = DDR_MARCH_C_BACKGROUNDS;
+    static const u64 Patterns[] = DDR_MARCH_MOVINV_PATTERNS;
+    u32 i;
+
+    if ((Base % sizeof(u64)) || (Size % DDR_MARCH_CHUNK) || Size == 0) {
+        xil_printf("DDR march region must be a multiple of %d bytes\r\n", DDR_MARCH_CHUNK);
+        return XST_FAILURE;
+    }
+
+    if (ddr_bench_timer_init() != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    Result->Errors = 0;
+    Result->FailMask = 0;
+    Result->FirstFail = 0;
+    Result->LastFail = 0;
+
+    xil_printf("#ddrmarch,test,pattern,mbytes,ticks,mbps,errors,fail_mask\r\n");
+    xil_printf("#ddrmarch,base=0x%08x,size=0x%08x,tick_hz=%d\r\n",
+               (u32)Base, (u32)Size, (u32)ddr_bench_tick_hz());
+
+    // Nothing of the region may still be dirty or cached when the first element runs
+    Xil_DCacheFlush();
+
+    if (Tests & DDR_MARCH_C) {
+        for (i = 0; i < sizeof(Backgrounds) / sizeof(Backgrounds[0]); i++) {
+            ddr_march_c(Base, Size, Backgrounds[i], Result);
+        }
+    }
+
+    if (Tests & DDR_MARCH_MOVINV) {
+        for (i = 0; i < sizeof(Patterns) / sizeof(Patterns[0]); i++) {
+            ddr_march_movinv(Base, Size, Patterns[i], Result);
+        }
+    }
+
+    if (Tests & DDR_MARCH_RANDOM) {
+        ddr_march_random(Base, Size, Seed, Result);
+    }
+
+    xil_printf("ddrmarch,done,,,,,%d,0x%08x%08x\r\n", Result->Errors,
+               (u32)(Result->FailMask >> 32), (u32)Result->FailMask);
+
+    return Result->Errors ? XST_FAILURE : XST_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#ifndef DDR_MARCH_H
+#define DDR_MARCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+
+/*
+ * Production memory test over a whole DDR region: March C-, moving
+ * inversions and a seeded random pattern. Cells are 64-bit words; every
+ * march element walks the region in DDR_MARCH_CHUNK pieces and writes each
+ * piece back with one range flush, so DDR only sees full cache-line bursts
+ * and a pass runs at close to the sequential bandwidth.
+ *
+ * Each finished test prints
+ *
+ *   ddrmarch,<test>,<pattern>,<MB moved>,<ticks>,<MB/s>,<errors>,<fail mask>
+ *
+ * and the first DDR_MARCH_MAX_PRINT bad cells print
+ *
+ *   ddrmarch,fail,<address>,<expected>,<got>,<xor>
+ *
+ * The fail mask is the OR of every wrong bit, i.e. the DQ lines involved.
+ * Ticks are 64-bit hex like the pattern and the mask: a pass over the
+ * whole DDR can run for minutes.
+ */
+
+// Tests, or-ed into the Tests of ddr_march_run()
+#define DDR_MARCH_C             0x01    // March C-: up(w0) up(r0,w1) up(r1,w0) dn(r0,w1) dn(r1,w0) up(r0)
+#define DDR_MARCH_MOVINV        0x02    // Moving inversions: up(wp) up(rp,w~p) dn(r~p,wp)
+#define DDR_MARCH_RANDOM        0x04    // Seeded random fill, then its inverse
+#define DDR_MARCH_ALL           0x07
+
+// Region walked between two flushes, a multiple of the cache line
+#ifndef DDR_MARCH_CHUNK
+#define DDR_MARCH_CHUNK         0x1000
+#endif
+
+// Data backgrounds of March C-, "0" is the background and "1" its inverse
+#ifndef DDR_MARCH_C_BACKGROUNDS
+#define DDR_MARCH_C_BACKGROUNDS     { 0x0000000000000000ULL, 0x5555555555555555ULL }
+#endif
+
+// Patterns of the moving inversions test, each one also runs inverted
+#ifndef DDR_MARCH_MOVINV_PATTERNS
+#define DDR_MARCH_MOVINV_PATTERNS   { 0x0000000000000000ULL, 0x5555555555555555ULL, \
+                                      0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL, \
+                                      0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, \
+                                      0x00000000FFFFFFFFULL }
+#endif
+
+#ifndef DDR_MARCH_MAX_PRINT
+#define DDR_MARCH_MAX_PRINT     16
+#endif
+
+typedef struct {
+    u32 Errors;                 // Bad cell reads over all tests
+    u64 FailMask;               // OR of every wrong bit
+    UINTPTR FirstFail;          // Address of the first bad cell, 0 if none
+    UINTPTR LastFail;
+} DdrMarchResult;
+
+int ddr_march_run(UINTPTR Base, UINTPTR Size, u32 Tests, u32 Seed, DdrMarchResult *Result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DDR_MARCH_H */
@@ -0,0 +1,54 @@
+// Runs ddr_bench over a mmap'd buffer on the PC, to check the harness
+// (patterns, report format, repetition counts) without a board:
+//
+//   gcc -O2 -DDDR_BENCH_HOST -Ihost_sim -I. ddr_bench.c host_sim/ddr_bench_host.c -o ddr_bench_host
+//   ./ddr_bench_host [size_mb] [flags] [file]
+//
+// flags is the DDR_BENCH_* mask (default all tests plus the uncached pass),
+// file is mapped instead of anonymous memory, e.g. a hugetlbfs file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ddr_bench.h"
+
+int main(int argc, char **argv) {
+    u32 SizeMb = argc > 1 ? (u32)strtoul(argv[1], NULL, 0) : 32;
+    u32 Flags = argc > 2 ? (u32)strtoul(argv[2], NULL, 0) : DDR_BENCH_ALL | DDR_BENCH_UNCACHED;
+    size_t Size = (size_t)SizeMb << 20;
+    void *Buf;
+    int Fd = -1;
+    int Status;
+
+    if (SizeMb == 0 || SizeMb >= 4096) {
+        fprintf(stderr, "size_mb must be 1..4095\n");
+        return 1;
+    }
+
+    if (argc > 3) {
+        Fd = open(argv[3], O_RDWR | O_CREAT, 0600);
+        if (Fd < 0 || ftruncate(Fd, (off_t)Size) != 0) {
+            perror(argv[3]);
+            return 1;
+        }
+        Buf = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    } else {
+        Buf = mmap(NULL, Size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    }
+    if (Buf == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    Status = ddr_bench_run((UINTPTR)Buf, (u32)Size, Flags);
+
+    munmap(Buf, Size);
+    if (Fd >= 0) {
+        close(Fd);
+    }
+
+    return Status == XST_SUCCESS ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// Runs the DDR march tests over a mmap'd buffer or file on the PC:
+//
+//   gcc -O2 -DDDR_BENCH_HOST -Ihost_sim -I. ddr_bench.c ddr_march.c host_sim/ddr_march_host.c -o ddr_march_host
+//   ./ddr_march_host [size_mb] [tests] [seed] [file]
+//
+// tests is the DDR_MARCH_* mask (default all), file is mapped instead of
+// anonymous memory. After the clean run the first MB is tested again with
+// a fault behind the cache flush, a stuck data bit and then two aliased
+// cells, and the result must name the bad cells and bits.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ddr_march.h"
+#include "xil_cache.h"
+
+#define FAULT_REGION    0x100000
+#define FAULT_CELL      0x2468          // Byte offset of the bad cell
+#define FAULT_BIT       37
+#define FAULT_ALIAS     0x40000         // Address line shorted in the alias run
+
+static u64 *StuckCell;
+static u64 *AliasLo;
+static u64 *AliasHi;
+
+static int in_range(u64 *Cell, UINTPTR Adr, u32 Len) {
+    return (UINTPTR)Cell >= Adr && (UINTPTR)Cell < Adr + Len;
+}
+
+// DQ line stuck at 0: whatever is written back loses the bit
+static void stuck_bit(UINTPTR Adr, u32 Len) {
+    if (in_range(StuckCell, Adr, Len)) {
+        *StuckCell &= ~(1ULL << FAULT_BIT);
+    }
+}
+
+// Both addresses decode to one cell, the last write back wins
+static void alias(UINTPTR Adr, u32 Len) {
+    if (in_range(AliasLo, Adr, Len)) {
+        *AliasHi = *AliasLo;
+    } else if (in_range(AliasHi, Adr, Len)) {
+        *AliasLo = *AliasHi;
+    }
+}
+
+static int check_stuck(UINTPTR Base, u32 Tests, u32 Seed) {
+    DdrMarchResult Result;
+
+    StuckCell = (u64 *)(Base + FAULT_CELL);
+    Xil_HostFlushHook = stuck_bit;
+    ddr_march_run(Base, FAULT_REGION, Tests, Seed, &Result);
+    Xil_HostFlushHook = NULL;
+
+    printf("stuck bit %d at 0x%lx: %u errors, mask 0x%016llx, first 0x%lx, last 0x%lx\n",
+           FAULT_BIT, (unsigned long)StuckCell, Result.Errors, (unsigned long long)Result.FailMask,
+           (unsigned long)Result.FirstFail, (unsigned long)Result.LastFail);
+
+    return Result.Errors != 0 && Result.FailMask == (1ULL << FAULT_BIT) &&
+           Result.FirstFail == (UINTPTR)StuckCell && Result.LastFail == (UINTPTR)StuckCell;
+}
+
+static int check_alias(UINTPTR Base, u32 Tests, u32 Seed) {
+    DdrMarchResult Result;
+
+    AliasLo = (u64 *)(Base + FAULT_CELL);
+    AliasHi = (u64 *)(Base + (FAULT_CELL ^ FAULT_ALIAS));
+    Xil_HostFlushHook = alias;
+    ddr_march_run(Base, FAULT_REGION, Tests, Seed, &Result);
+    Xil_HostFlushHook = NULL;
+
+    printf("alias 0x%lx/0x%lx: %u errors, mask 0x%016llx, first 0x%lx, last 0x%lx\n",
+           (unsigned long)AliasLo, (unsigned long)AliasHi, Result.Errors,
+           (unsigned long long)Result.FailMask, (unsigned long)Result.FirstFail,
+           (unsigned long)Result.LastFail);
+
+    return Result.Errors != 0 && Result.FailMask != 0 &&
+           (Result.FirstFail == (UINTPTR)AliasLo || Result.FirstFail == (UINTPTR)AliasHi) &&
+           (Result.LastFail == (UINTPTR)AliasLo || Result.LastFail == (UINTPTR)AliasHi);
+}
+
+int main(int argc, char **argv) {
+    u32 SizeMb = argc > 1 ? (u32)strtoul(argv[1], NULL, 0) : 64;
+    u32 Tests = argc > 2 ? (u32)strtoul(argv[2], NULL, 0) : DDR_MARCH_ALL;
+    u32 Seed = argc > 3 ? (u32)strtoul(argv[3], NULL, 0) : 1;
+    size_t Size = (size_t)SizeMb << 20;
+    DdrMarchResult Result;
+    void *Buf;
+    int Fd = -1;
+    int Failed;
+
+    if (SizeMb == 0) {
+        fprintf(stderr, "size_mb must be at least 1\n");
+        return 1;
+    }
+
+    if (argc > 4) {
+        Fd = open(argv[4], O_RDWR | O_CREAT, 0600);
+        if (Fd < 0 || ftruncate(Fd, (off_t)Size) != 0) {
+            perror(argv[4]);
+            return 1;
+        }
+        Buf = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    } else {
+        Buf = mmap(NULL, Size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    }
+    if (Buf == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    Failed = ddr_march_run((UINTPTR)Buf, (UINTPTR)Size, Tests, Seed, &Result) != XST_SUCCESS;
+    if (Failed) {
+        printf("clean run: FAIL\n");
+    }
+
+    if (!check_stuck((UINTPTR)Buf, Tests, Seed)) {
+        printf("stuck bit: FAIL\n");
+        Failed++;
+    }
+    if (!check_alias((UINTPTR)Buf, Tests, Seed)) {
+        printf("alias: FAIL\n");
+        Failed++;
+    }
+
+    munmap(Buf, Size);
+    if (Fd >= 0) {
+        close(Fd);
+    }
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,6 @@
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// No hardware on the host: no AXI Timer, DDR is a mmap'd buffer
+
+#endif /* XPARAMETERS_H */
@@ -6,6 +6,8 @@
 #include "xil_cache.h"
 #include <stdint.h>
 #include "iic_master.h"
+#include "ddr_bench.h"
+#include "ddr_march.h"
 #include "platform.h"
 #include "sleep.h"
 
@@ -30,10 +32,13 @@
 
 /***** Start address of DDR *****/
 #define DDR_BASE_ADDR            XPAR_DDR4_0_C0_DDR4_MEMORY_MAP_BASEADDR
-#define BUFFER_OFFSET            0x00000000                 // 4KB offset
-// #define SIZE                  (9 * 1024 / 4)
-#define SIZE                     4
-#define CACHE_LINE_SIZE          16   
+#define BUFFER_OFFSET            0x01000000                 // 16MB offset, clear of anything linked to DDR
+#define BENCH_SIZE               0x02000000                 // 32MB under test
+#define BENCH_FLAGS              (DDR_BENCH_ALL | DDR_BENCH_UNCACHED)
+#define DDR_HIGH_ADDR            XPAR_DDR4_0_C0_DDR4_MEMORY_MAP_HIGHADDR
+#define MARCH_SIZE               (DDR_HIGH_ADDR - DDR_BASE_ADDR + 1 - BUFFER_OFFSET)   // Everything above the offset
+#define MARCH_TESTS              DDR_MARCH_ALL
+#define MARCH_SEED               1
 
 static int  SetupInterruptSystem(XIic *IicInstPtr, XIntc *IntcInstPtr);
 static void SendHandler(XIic *InstancePtr);
@@ -48,8 +53,7 @@ int main(void){
 	XIntc IntcInstPtr;
 	XIic IicInstPtr;
 	int Status;
-    u64 i;                   // Test data index
-   	volatile u64* ddr_addr;
+	DdrMarchResult MarchResult;
 
     // Enable the cache
     Xil_DCacheEnable();
@@ -71,27 +75,19 @@ int main(void){
 	XIic_SetStatusHandler(&IicInstPtr, &IicInstPtr,
 				  (XIic_StatusHandler) StatusHandler);
 
-    /* Data Write */
-    ddr_addr = (u64 *)(DDR_BASE_ADDR + BUFFER_OFFSET);
-    
-	// u32 buffer[8] = {0x00000000, 0x11111111, 0x22222222, 0x33333333, 0x44444444, 0x55555555, 0x66666666, 0x77777777};
+    /* Bandwidth, latency and address-pattern tests, one CSV line per result */
+    Status = ddr_bench_run(DDR_BASE_ADDR + BUFFER_OFFSET, BENCH_SIZE, BENCH_FLAGS);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DDR test failed\r\n");
+    }
 
-    for(i = 0; i < SIZE; i=i+2){
-         *(ddr_addr+i) = 0x0000000000000000 + i*0x1111111111111111;
-//		*(ddr_addr+i) = ((u64)buffer[i]<<32) | buffer[i+1];
+    /* Production qualification: march tests over the rest of the DDR */
+    Status = ddr_march_run(DDR_BASE_ADDR + BUFFER_OFFSET, MARCH_SIZE, MARCH_TESTS, MARCH_SEED, &MarchResult);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DDR march failed: %d errors, first at 0x%08x, bit mask 0x%08x%08x\r\n",
+                   MarchResult.Errors, (u32)MarchResult.FirstFail,
+                   (u32)(MarchResult.FailMask >> 32), (u32)MarchResult.FailMask);
     }
-//     Xil_DCacheFlushRange((UINTPTR)ddr_addr, sizeof(u64) * SIZE);
-
-//     Xil_DCacheInvalidateRange((UINTPTR)ddr_addr, sizeof(u64) * SIZE);
-    
-    volatile u64* read_ptr = (u64 *)(DDR_BASE_ADDR + BUFFER_OFFSET);
-    for (i = 0; i < 10; i++) {
-		xil_printf("Data[%d] = %llx\r\n", i, read_ptr[i]);
-		// if(read_ptr[i] != i*2){
-		//     xil_printf("ERROR at Index %d: Expected %d, Got %d\r\n", i, i*2, read_ptr[i]);
-		//     // return XST_FAILURE;
-		// }
-	}
 
     Xil_DCacheDisable();
     cleanup_platform();
@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim_spi33.h"
+#include "xil_io.h"
+#include "sleep.h"
+#include "spi_decoder_model.h"
+
+#define SIM_SPI33_START     0x0
+#define SIM_SPI33_HIGH_1    0x4
+#define SIM_SPI33_LOW_32    0x8
+#define SIM_SPI33_READ      0xC
+#define SIM_SPI33_BLK_LEN   0x10
+#define SIM_SPI33_BLK_DATA  0x14
+
+#define SIM_SPI33_FIFO_MAX  1024
+
+SimSpi33Config sim_spi33_cfg = {
+    10000000,   // sck_hz
+    100,        // axil_ns
+    0,          // blk_words
+};
+
+SimSpi33Stats sim_spi33_stats;
+
+static u64 now_ns;
+static UINTPTR base;
+
+/***** Master registers *****/
+static u32 start_reg;
+static u32 high_reg;
+static u32 low_reg;
+static u32 read_reg;
+static u32 read_next;               // READ_SPI once the frame is over
+static u64 busy_until;
+
+/***** Block registers *****/
+static u32 blk_len;
+static u32 tx_fifo[SIM_SPI33_FIFO_MAX];
+static u32 tx_count;
+static u32 rx_fifo[SIM_SPI33_FIFO_MAX];
+static u32 rx_next[SIM_SPI33_FIFO_MAX];     // RX FIFO once the frame is over
+static u32 rx_count;
+static u32 rx_next_count;
+static u32 rx_head;
+
+static SimSpi33Write *write_log;
+static u32 write_count;
+static u32 write_size;
+
+static SpiDecoderModel decoder;
+
+u64 sim_now(void) {
+    return now_ns;
+}
+
+static void sim_update(void) {
+    if (busy_until && now_ns >= busy_until) {
+        read_reg = read_next;
+        memcpy(rx_fifo, rx_next, rx_next_count * sizeof(u32));
+        rx_count = rx_next_count;
+        rx_head = 0;
+        busy_until = 0;
+    }
+}
+
+static int sim_busy(void) {
+    sim_update();
+    return busy_until != 0;
+}
+
+// One frame through spi_decoder, MSB first, and BLK_LEN block words after
+// it. The decoder moves MISO on the rising edge, the master samples it on the
+// falling one.
+static void sim_frame(void) {
+    u64 Data = ((u64)(high_reg & 0x1) << 32) | low_reg;
+    u64 Bits = SpiDecoderModel::kFrameBits + (u64)blk_len * SpiDecoderModel::kWordBits;
+    u64 FrameNs = Bits * 1000000000ull / sim_spi33_cfg.sck_hz;
+    u32 Miso = 0;
+    u32 Word;
+    u32 w;
+    int i;
+
+    decoder.set_cs_n(false);
+    for (i = 0; i < SpiDecoderModel::kFrameBits; i++) {
+        decoder.posedge((Data >> (SpiDecoderModel::kFrameBits - 1 - i)) & 1);
+        Miso = (Miso << 1) | decoder.miso();
+    }
+    read_next = Miso & 0x3FFFFF;
+
+    // An empty TX FIFO sends zeros; RX only fills on read frames
+    rx_next_count = 0;
+    for (w = 0; w < blk_len; w++) {
+        Word = w < tx_count ? tx_fifo[w] : 0;
+        Miso = 0;
+        for (i = 0; i < SpiDecoderModel::kWordBits; i++) {
+            decoder.posedge((Word >> (SpiDecoderModel::kWordBits - 1 - i)) & 1);
+            Miso = (Miso << 1) | decoder.miso();
+        }
+        if (high_reg & 0x1) {
+            rx_next[rx_next_count++] = Miso;
+        }
+    }
+    tx_count = 0;
+    blk_len = 0;
+
+    // cmd reaches the fabric once all 33 bits are in
+    if (!decoder.r_w_flag()) {
+        if (write_count == write_size) {
+            write_size = write_size ? 2 * write_size : 256;
+            write_log = (SimSpi33Write *)realloc(write_log, write_size * sizeof(*write_log));
+        }
+        write_log[write_count].Channel = decoder.channel_sel();
+        write_log[write_count].Addr = decoder.address();
+        write_log[write_count].Cmd = decoder.spi_cmd();
+        write_count++;
+    }
+    decoder.set_cs_n(true);
+
+    busy_until = now_ns + FrameNs;
+    sim_spi33_stats.Frames++;
+    sim_spi33_stats.BusNs += FrameNs;
+}
+
+u32 sim_io_read(UINTPTR Addr) {
+    sim_spi33_stats.RegReads++;
+    now_ns += sim_spi33_cfg.axil_ns;
+
+    switch (Addr - base) {
+    case SIM_SPI33_START:
+        return start_reg;
+    case SIM_SPI33_HIGH_1:
+        return high_reg;
+    case SIM_SPI33_LOW_32:
+        return low_reg;
+    case SIM_SPI33_READ:
+        if (sim_busy()) {
+            sim_spi33_stats.EarlyReads++;
+        }
+        return read_reg;
+    case SIM_SPI33_BLK_LEN:
+        return sim_spi33_cfg.blk_words ? blk_len : 0;
+    case SIM_SPI33_BLK_DATA:
+        if (!sim_spi33_cfg.blk_words) {
+            return 0;
+        }
+        if (sim_busy()) {
+            sim_spi33_stats.EarlyReads++;
+        }
+        return rx_head < rx_count ? rx_fifo[rx_head++] : 0;
+    default:
+        return 0;
+    }
+}
+
+void sim_io_write(UINTPTR Addr, u32 Value) {
+    sim_spi33_stats.RegWrites++;
+    now_ns += sim_spi33_cfg.axil_ns;
+
+    switch (Addr - base) {
+    case SIM_SPI33_START:
+        if ((Value & 0x1) && !(start_reg & 0x1)) {
+            if (sim_busy()) {
+                sim_spi33_stats.Collisions++;
+            } else {
+                sim_frame();
+            }
+        }
+        start_reg = Value & 0x1;
+        break;
+    case SIM_SPI33_HIGH_1:
+    case SIM_SPI33_LOW_32:
+        if (sim_busy()) {
+            sim_spi33_stats.LateWrites++;
+        }
+        if (Addr - base == SIM_SPI33_HIGH_1) {
+            high_reg = Value & 0x1;
+        } else {
+            low_reg = Value;
+        }
+        break;
+    case SIM_SPI33_BLK_LEN:
+        if (sim_spi33_cfg.blk_words) {
+            blk_len = Value < sim_spi33_cfg.blk_words ? Value : sim_spi33_cfg.blk_words;
+        }
+        break;
+    case SIM_SPI33_BLK_DATA:
+        if (sim_spi33_cfg.blk_words) {
+            if (sim_busy()) {
+                sim_spi33_stats.LateWrites++;
+            }
+            if (tx_count < sim_spi33_cfg.blk_words) {
+                tx_fifo[tx_count++] = Value & 0x3FFFFF;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void sim_spi33_reset(UINTPTR BaseAddr) {
+    base = BaseAddr;
+    now_ns = 0;
+    start_reg = 0;
+    high_reg = 0;
+    low_reg = 0;
+    read_reg = 0;
+    read_next = 0;
+    busy_until = 0;
+    blk_len = 0;
+    tx_count = 0;
+    rx_count = 0;
+    rx_next_count = 0;
+    rx_head = 0;
+    write_count = 0;
+    decoder = SpiDecoderModel();
+    if (sim_spi33_cfg.blk_words > SIM_SPI33_FIFO_MAX) {
+        sim_spi33_cfg.blk_words = SIM_SPI33_FIFO_MAX;
+    }
+    memset(&sim_spi33_stats, 0, sizeof(sim_spi33_stats));
+}
+
+const SimSpi33Write *sim_spi33_writes(u32 *Count) {
+    *Count = write_count;
+    return write_log;
+}
+
+const u32 *sim_spi33_bank(u8 Channel, u32 *Count) {
+    *Count = SpiDecoderModel::kBankWords;
+    return &decoder.register_table[(Channel & 0x3) * SpiDecoderModel::kBankWords];
+}
+
+/***** Sleep *****/
+int sim_usleep(unsigned long useconds) {
+    now_ns += (u64)useconds * 1000ULL;
+    sim_update();
+    return 0;
+}
+
+unsigned sim_sleep(unsigned int seconds) {
+    now_ns += (u64)seconds * 1000000000ULL;
+    sim_update();
+    return 0;
+}
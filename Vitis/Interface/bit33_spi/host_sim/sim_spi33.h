@@ -0,0 +1,57 @@
+#ifndef SIM_SPI33_H
+#define SIM_SPI33_H
+
+// Host model of the 33-bit SPI master (spi_mst, four AXI-Lite registers) with
+// spi_decoder.v on its select line, clocked bit by bit through the
+// cycle-level SpiDecoderModel. Time is simulated ns: every register access
+// costs axil_ns, a frame takes 33 SCK periods from the START rising edge,
+// usleep() advances the clock. The model counts what the real master
+// would get wrong: a START or data register write while a frame is still
+// shifting, and a READ_SPI or BLK_DATA read before the frame is over.
+//
+// With blk_words set the master also has the block registers: BLK_LEN extra
+// 22-bit words after the header frame, sent from a TX FIFO of blk_words and
+// received into an RX FIFO of the same depth on read frames.
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    u32 sck_hz;
+    u32 axil_ns;                    // One register access
+    u32 blk_words;                  // Block FIFO depth, 0: no block registers
+} SimSpi33Config;
+
+typedef struct {
+    u64 RegReads;
+    u64 RegWrites;
+    u64 Frames;
+    u64 BusNs;
+    u64 Collisions;                 // START while busy, frame lost
+    u64 LateWrites;                 // Data register written while busy
+    u64 EarlyReads;                 // READ_SPI read while busy
+} SimSpi33Stats;
+
+// What spi_decoder presents to the fabric after a write frame (header word)
+typedef struct {
+    u8  Channel;
+    u8  Addr;
+    u32 Cmd;
+} SimSpi33Write;
+
+extern SimSpi33Config sim_spi33_cfg;
+extern SimSpi33Stats sim_spi33_stats;
+
+u64  sim_now(void);
+void sim_spi33_reset(UINTPTR BaseAddr);     // Clears time, stats and the write log
+const SimSpi33Write *sim_spi33_writes(u32 *Count);
+const u32 *sim_spi33_bank(u8 Channel, u32 *Count);  // One bank of register_table
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_SPI33_H */
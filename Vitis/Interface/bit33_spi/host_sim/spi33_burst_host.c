@@ -0,0 +1,247 @@
+// spi33.c on the spi_mst model with spi_decoder behind it, clocked bit by bit
+// through SpiDecoderModel (spi_decoder33bit/sim). Programs a 64-entry command
+// table and reads back the decoder's 10 ID and status registers, first with the
+// per-frame sequence of the old spi_test.c loop (HIGH_1_DATA, LOW_32_DATA,
+// START pulse, READ_SPI, 1 s sleep), then with spi33_write_table and
+// spi33_read_table. Checks what the decoder received, the data read back and
+// that no register was touched while a frame was still shifting. Then a mixed
+// read/write burst and a burst with a bad frame, which must not send anything.
+// Last, a whole 256-register bank is written and read back one frame per
+// register and then in block frames, with a master that has block FIFOs of
+// blk_words. Times are given per batch and per register.
+//
+//   gcc -O2 -Wall -Ihost_sim -I. -c spi33.c host_sim/spi33_burst_host.c
+//   g++ -O2 -Wall -Ihost_sim -I../../../Interface_realeted/SPI/Verilog/spi_decoder33bit/sim
+//       -c host_sim/sim_spi33.cpp
+//   g++ spi33.o spi33_burst_host.o sim_spi33.o -o spi33_burst_host
+//   ./spi33_burst_host [sck_hz] [blk_words]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "spi33.h"
+#include "sim_spi33.h"
+#include "xil_io.h"
+#include "sleep.h"
+
+#define SPI_MST_BASEADDR    0x44A10000
+#define CMD_TABLE           64
+#define CMD_CHANNEL         2
+#define CMD_FIRST_ADDR      0x20
+#define REG_TABLE_SIZE      10          // ID and status registers, bank 0
+#define BANK_WORDS          256
+#define BANK_CHANNEL        1
+#define BLOCK_CHANNEL       3
+
+static u32 Cmds[CMD_TABLE];
+static u32 BankData[BANK_WORDS];
+static u32 Back[BANK_WORDS];
+
+static void report(const char *Name, u64 Ns, u32 Regs) {
+    printf("%-12s %3u regs %12.3f ms  %9.2f us/reg  late writes %llu  early reads %llu  lost starts %llu\n",
+           Name, Regs, Ns / 1e6, Ns / 1e3 / Regs, (unsigned long long)sim_spi33_stats.LateWrites,
+           (unsigned long long)sim_spi33_stats.EarlyReads, (unsigned long long)sim_spi33_stats.Collisions);
+}
+
+// One pass of the old spi_test.c loop, the UART prompts left out
+static u32 legacy_frame(u8 rw, u8 ch, u8 addr, u32 cmd) {
+    u64 spi_data_full = ((u64)rw << 32) | ((u64)ch << 30) | ((u64)addr << 22) | cmd;
+    u32 spi_read_data;
+
+    Xil_Out32(SPI_MST_BASEADDR + SPI33_HIGH_1_OFFSET, (spi_data_full >> 32) & 0x1);
+    Xil_Out32(SPI_MST_BASEADDR + SPI33_LOW_32_OFFSET, spi_data_full & 0xFFFFFFFF);
+    Xil_Out32(SPI_MST_BASEADDR + SPI33_START_OFFSET, 0x1);
+    Xil_Out32(SPI_MST_BASEADDR + SPI33_START_OFFSET, 0x0);
+    spi_read_data = Xil_In32(SPI_MST_BASEADDR + SPI33_READ_OFFSET);
+    usleep(1000000);
+
+    return spi_read_data;
+}
+
+// The decoder saw exactly the command table, in order
+static int check_writes(void) {
+    const SimSpi33Write *Log;
+    u32 Count;
+    u32 i;
+
+    Log = sim_spi33_writes(&Count);
+    if (Count != CMD_TABLE) {
+        printf("decoder got %u writes, expected %u\n", Count, CMD_TABLE);
+        return 1;
+    }
+    for (i = 0; i < Count; i++) {
+        if (Log[i].Channel != CMD_CHANNEL || Log[i].Addr != CMD_FIRST_ADDR + i || Log[i].Cmd != Cmds[i]) {
+            printf("write %u: ch %u addr 0x%02x cmd 0x%06x\n", i, Log[i].Channel, Log[i].Addr, Log[i].Cmd);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_table(const u32 *Data) {
+    const u32 *Table;
+    u32 Count;
+    u32 i;
+
+    Table = sim_spi33_bank(0, &Count);
+    for (i = 0; i < REG_TABLE_SIZE; i++) {
+        if (Data[i] != Table[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// The bank holds BankData and it was read back as such
+static int check_bank(u8 Channel) {
+    const u32 *Bank;
+    u32 Count;
+    u32 i;
+
+    Bank = sim_spi33_bank(Channel, &Count);
+    for (i = 0; i < BANK_WORDS; i++) {
+        if (Bank[i] != BankData[i] || Back[i] != BankData[i]) {
+            printf("bank %u reg 0x%02x: 0x%06x read 0x%06x\n", Channel, i, Bank[i], Back[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int run_block(u32 BlockWords) {
+    Spi33 Spi;
+    u64 Frame;
+    u64 Block;
+    u64 Start;
+    u64 Mark;
+    u64 Frames;
+    int Failed = 0;
+    u32 i;
+
+    for (i = 0; i < BANK_WORDS; i++) {
+        BankData[i] = (i * 0x2F1D3u + 0x155u) & SPI33_CMD_MASK;
+    }
+    sim_spi33_cfg.blk_words = BlockWords;
+    sim_spi33_reset(SPI_MST_BASEADDR);
+    Failed |= spi33_init(&Spi, SPI_MST_BASEADDR, sim_spi33_cfg.sck_hz) != XST_SUCCESS;
+
+    // One frame per register
+    Start = sim_now();
+    Failed |= spi33_write_table(&Spi, BANK_CHANNEL, 0, BankData, BANK_WORDS) != XST_SUCCESS;
+    Mark = sim_now();
+    report("frame write", Mark - Start, BANK_WORDS);
+    Failed |= spi33_read_table(&Spi, BANK_CHANNEL, 0, Back, BANK_WORDS) != XST_SUCCESS;
+    Frame = sim_now() - Start;
+    report("frame read", Frame - (Mark - Start), BANK_WORDS);
+    Failed |= check_bank(BANK_CHANNEL);
+
+    // Block frames
+    spi33_enable_block(&Spi, BlockWords);
+    Start = sim_now();
+    Failed |= spi33_block_write(&Spi, BLOCK_CHANNEL, 0, BankData, BANK_WORDS) != XST_SUCCESS;
+    Mark = sim_now();
+    report("block write", Mark - Start, BANK_WORDS);
+    Failed |= spi33_block_read(&Spi, BLOCK_CHANNEL, 0, Back, BANK_WORDS) != XST_SUCCESS;
+    Block = sim_now() - Start;
+    report("block read", Block - (Mark - Start), BANK_WORDS);
+    printf("             %.1fx faster, %u block frames of up to %u words\n", (double)Frame / Block, Spi.Blocks,
+           Spi.BlockMax);
+    Failed |= check_bank(BLOCK_CHANNEL);
+
+    // ID and status registers, one block frame
+    Failed |= spi33_block_read(&Spi, 0, 0, Back, REG_TABLE_SIZE) != XST_SUCCESS;
+    Failed |= check_table(Back);
+
+    // Past the end of the bank: nothing is sent
+    Frames = sim_spi33_stats.Frames;
+    Failed |= spi33_block_write(&Spi, BLOCK_CHANNEL, 0xF0, BankData, 32) != XST_FAILURE;
+    Failed |= sim_spi33_stats.Frames != Frames;
+
+    Failed |= sim_spi33_stats.LateWrites || sim_spi33_stats.EarlyReads || sim_spi33_stats.Collisions;
+    spi33_report(&Spi);
+
+    return Failed;
+}
+
+int main(int argc, char **argv) {
+    Spi33 Spi;
+    Spi33Frame Frames[8];
+    u32 Data[16];
+    u32 Count = REG_TABLE_SIZE;
+    u32 BlockWords = 64;
+    u64 Legacy;
+    u64 Burst;
+    u64 Start;
+    u64 Mark;
+    int Failed = 0;
+    u32 i;
+
+    if (argc > 1) {
+        sim_spi33_cfg.sck_hz = (u32)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2) {
+        BlockWords = (u32)strtoul(argv[2], NULL, 0);
+    }
+    for (i = 0; i < CMD_TABLE; i++) {
+        Cmds[i] = (i * 0x9E37u + 0x1234u) & SPI33_CMD_MASK;
+    }
+
+    // Old loop; its READ_SPI read comes before the frame is out
+    sim_spi33_reset(SPI_MST_BASEADDR);
+    for (i = 0; i < CMD_TABLE; i++) {
+        legacy_frame(0, CMD_CHANNEL, CMD_FIRST_ADDR + i, Cmds[i]);
+    }
+    Mark = sim_now();
+    report("loop write", Mark, CMD_TABLE);
+    for (i = 0; i < Count; i++) {
+        Data[i] = legacy_frame(1, 0, i, 0);
+    }
+    Legacy = sim_now();
+    report("loop read", Legacy - Mark, Count);
+    report("loop total", Legacy, CMD_TABLE + Count);
+    printf("             table read back %s\n", check_table(Data) ? "wrong (stale READ_SPI)" : "right");
+    Failed |= check_writes();
+
+    // Bursts
+    sim_spi33_reset(SPI_MST_BASEADDR);
+    Failed |= spi33_init(&Spi, SPI_MST_BASEADDR, sim_spi33_cfg.sck_hz) != XST_SUCCESS;
+    Start = sim_now();
+    Failed |= spi33_write_table(&Spi, CMD_CHANNEL, CMD_FIRST_ADDR, Cmds, CMD_TABLE) != XST_SUCCESS;
+    Mark = sim_now();
+    report("burst write", Mark - Start, CMD_TABLE);
+    Failed |= spi33_read_table(&Spi, 0, 0, Data, Count) != XST_SUCCESS;
+    Burst = sim_now() - Start;
+    report("burst read", Burst - (Mark - Start), Count);
+    report("burst total", Burst, CMD_TABLE + Count);
+    printf("             %.0fx faster, wire time %.1f us\n", (double)Legacy / Burst,
+           sim_spi33_stats.BusNs / 1e3);
+    Failed |= check_writes() || check_table(Data);
+    Failed |= sim_spi33_stats.LateWrites || sim_spi33_stats.EarlyReads || sim_spi33_stats.Collisions;
+    // One HIGH_1_DATA write for the writes, one for the reads
+    Failed |= Spi.HighWrites != 2;
+
+    // Mixed: each read right after a write gets that write back
+    for (i = 0; i < 8; i++) {
+        Frames[i].Rw = (i & 1) ? SPI33_READ : SPI33_WRITE;
+        Frames[i].Channel = (u8)(i / 2 & 3);
+        Frames[i].Addr = (u8)(0x80 + i / 2);
+        Frames[i].Cmd = 0x100 + i;
+    }
+    Failed |= spi33_burst(&Spi, Frames, 8, Data) != XST_SUCCESS;
+    for (i = 0; i < 8; i++) {
+        Failed |= Data[i] != ((i & 1) ? 0x100 + i - 1 : 0);
+    }
+
+    // Out of range channel: nothing is sent
+    Count = (u32)sim_spi33_stats.Frames;
+    Frames[3].Channel = 4;
+    Failed |= spi33_burst(&Spi, Frames, 8, Data) != XST_FAILURE;
+    Failed |= sim_spi33_stats.Frames != Count;
+
+    Failed |= sim_spi33_stats.LateWrites || sim_spi33_stats.EarlyReads || sim_spi33_stats.Collisions;
+    spi33_report(&Spi);
+
+    Failed |= run_block(BlockWords);
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
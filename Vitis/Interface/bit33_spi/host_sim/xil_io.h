@@ -0,0 +1,22 @@
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+// AXI-Lite accesses go to the spi_mst model in sim_spi33.cpp
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+u32  sim_io_read(UINTPTR Addr);
+void sim_io_write(UINTPTR Addr, u32 Value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define Xil_In32(Addr)          sim_io_read((UINTPTR)(Addr))
+#define Xil_Out32(Addr, Value)  sim_io_write((UINTPTR)(Addr), (u32)(Value))
+
+#endif /* XIL_IO_H */
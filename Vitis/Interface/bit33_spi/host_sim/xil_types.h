@@ -0,0 +1,30 @@
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+// Host model of the standalone BSP types
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+typedef uintptr_t UINTPTR;
+typedef int XStatus;
+
+#ifndef TRUE
+#define TRUE    1U
+#endif
+#ifndef FALSE
+#define FALSE   0U
+#endif
+
+typedef void (*Xil_ExceptionHandler)(void *Data);
+typedef void (*XInterruptHandler)(void *InstancePtr);
+
+#endif /* XIL_TYPES_H */
@@ -0,0 +1,9 @@
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS             0L
+#define XST_FAILURE             1L
+
+#endif /* XSTATUS_H */
@@ -0,0 +1,221 @@
+#include "spi33.h"
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "sleep.h"
+
+// Bits SCK periods rounded up, and one more for the START edge to be seen
+static u32 spi33_frame_us(Spi33 *Spi, u32 Bits) {
+    return (u32)(((u64)Bits * 1000000u + Spi->SckHz - 1) / Spi->SckHz) + 1;
+}
+
+int spi33_init(Spi33 *Spi, UINTPTR BaseAddr, u32 SckHz) {
+    if (SckHz == 0) {
+        xil_printf("SPI33: SCK rate not set\r\n");
+        return XST_FAILURE;
+    }
+
+    Spi->BaseAddr = BaseAddr;
+    Spi->SckHz = SckHz;
+    Spi->FrameUs = spi33_frame_us(Spi, SPI33_FRAME_BITS);
+    Spi->BlockMax = 1;
+    Spi->HighValid = 0;
+    Spi->Frames = 0;
+    Spi->Reads = 0;
+    Spi->HighWrites = 0;
+    Spi->Blocks = 0;
+    Spi->BlockWords = 0;
+
+    Xil_Out32(Spi->BaseAddr + SPI33_START_OFFSET, 0x0);
+
+    return XST_SUCCESS;
+}
+
+u64 spi33_pack(const Spi33Frame *Frame) {
+    return ((u64)(Frame->Rw & 0x1) << 32) | ((u64)(Frame->Channel & 0x3) << 30) |
+           ((u64)Frame->Addr << 22) | (Frame->Cmd & SPI33_CMD_MASK);
+}
+
+static int spi33_check(const Spi33Frame *Frame) {
+    return Frame->Rw <= SPI33_READ && Frame->Channel < SPI33_CHANNELS && Frame->Cmd <= SPI33_CMD_MASK;
+}
+
+// HIGH_1_DATA and LOW_32_DATA for the next START
+static void spi33_load(Spi33 *Spi, const Spi33Frame *Frame) {
+    u64 Data = spi33_pack(Frame);
+    u8 High = (u8)(Data >> 32);
+
+    if (!Spi->HighValid || Spi->High != High) {
+        Xil_Out32(Spi->BaseAddr + SPI33_HIGH_1_OFFSET, High);
+        Spi->High = High;
+        Spi->HighValid = 1;
+        Spi->HighWrites++;
+    }
+    Xil_Out32(Spi->BaseAddr + SPI33_LOW_32_OFFSET, (u32)Data);
+}
+
+static void spi33_frame(Spi33 *Spi, const Spi33Frame *Frame, u32 *ReadData) {
+    spi33_load(Spi, Frame);
+
+    Xil_Out32(Spi->BaseAddr + SPI33_START_OFFSET, 0x1);
+    Xil_Out32(Spi->BaseAddr + SPI33_START_OFFSET, 0x0);
+
+    // The data registers and READ_SPI belong to the frame until it is out
+    usleep(Spi->FrameUs);
+
+    if (Frame->Rw == SPI33_READ) {
+        Spi->Reads++;
+        if (ReadData) {
+            *ReadData = Xil_In32(Spi->BaseAddr + SPI33_READ_OFFSET);
+        }
+    } else if (ReadData) {
+        *ReadData = 0;
+    }
+    Spi->Frames++;
+}
+
+int spi33_burst(Spi33 *Spi, const Spi33Frame *Frames, u32 Count, u32 *ReadData) {
+    u32 i;
+
+    // Nothing goes out if any frame is out of range
+    for (i = 0; i < Count; i++) {
+        if (!spi33_check(&Frames[i])) {
+            xil_printf("SPI33: frame %d out of range\r\n", i);
+            return XST_FAILURE;
+        }
+    }
+
+    for (i = 0; i < Count; i++) {
+        spi33_frame(Spi, &Frames[i], ReadData ? &ReadData[i] : NULL);
+    }
+
+    return XST_SUCCESS;
+}
+
+int spi33_transfer(Spi33 *Spi, const Spi33Frame *Frame, u32 *ReadData) {
+    return spi33_burst(Spi, Frame, 1, ReadData);
+}
+
+static int spi33_table(Spi33 *Spi, u8 Rw, u8 Channel, u8 FirstAddr, const u32 *Cmds, u32 *Data,
+                       u32 Count) {
+    Spi33Frame Frames[SPI33_BURST_MAX];
+    u32 Done;
+    u32 Len;
+    u32 i;
+    int Status;
+
+    if ((u32)FirstAddr + Count > 256) {
+        xil_printf("SPI33: table 0x%02x + %d past the address range\r\n", FirstAddr, Count);
+        return XST_FAILURE;
+    }
+
+    for (Done = 0; Done < Count; Done += Len) {
+        Len = Count - Done < SPI33_BURST_MAX ? Count - Done : SPI33_BURST_MAX;
+        for (i = 0; i < Len; i++) {
+            Frames[i].Rw = Rw;
+            Frames[i].Channel = Channel;
+            Frames[i].Addr = (u8)(FirstAddr + Done + i);
+            Frames[i].Cmd = Cmds ? Cmds[Done + i] : 0;
+        }
+        Status = spi33_burst(Spi, Frames, Len, Data ? &Data[Done] : NULL);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+int spi33_write_table(Spi33 *Spi, u8 Channel, u8 FirstAddr, const u32 *Cmds, u32 Count) {
+    return spi33_table(Spi, SPI33_WRITE, Channel, FirstAddr, Cmds, NULL, Count);
+}
+
+int spi33_read_table(Spi33 *Spi, u8 Channel, u8 FirstAddr, u32 *Data, u32 Count) {
+    return spi33_table(Spi, SPI33_READ, Channel, FirstAddr, NULL, Data, Count);
+}
+
+void spi33_enable_block(Spi33 *Spi, u32 FifoWords) {
+    Spi->BlockMax = FifoWords + 1;
+}
+
+// One header frame and Len - 1 block words. The first word goes through
+// LOW_32_DATA and READ_SPI like a single frame, the rest through BLK_DATA.
+static void spi33_block(Spi33 *Spi, u8 Rw, u8 Channel, u8 Addr, const u32 *Wr, u32 *Rd, u32 Len) {
+    Spi33Frame Header;
+    u32 i;
+
+    Header.Rw = Rw;
+    Header.Channel = Channel;
+    Header.Addr = Addr;
+    Header.Cmd = Wr ? Wr[0] : 0;
+    spi33_load(Spi, &Header);
+
+    Xil_Out32(Spi->BaseAddr + SPI33_BLK_LEN_OFFSET, Len - 1);
+    if (Wr) {
+        for (i = 1; i < Len; i++) {
+            Xil_Out32(Spi->BaseAddr + SPI33_BLK_DATA_OFFSET, Wr[i]);
+        }
+    }
+
+    Xil_Out32(Spi->BaseAddr + SPI33_START_OFFSET, 0x1);
+    Xil_Out32(Spi->BaseAddr + SPI33_START_OFFSET, 0x0);
+
+    usleep(spi33_frame_us(Spi, SPI33_FRAME_BITS + (Len - 1) * SPI33_WORD_BITS));
+
+    if (Rd) {
+        Rd[0] = Xil_In32(Spi->BaseAddr + SPI33_READ_OFFSET);
+        for (i = 1; i < Len; i++) {
+            Rd[i] = Xil_In32(Spi->BaseAddr + SPI33_BLK_DATA_OFFSET);
+        }
+        Spi->Reads++;
+    }
+    Spi->Frames++;
+    Spi->Blocks++;
+    Spi->BlockWords += Len;
+}
+
+static int spi33_blocks(Spi33 *Spi, u8 Rw, u8 Channel, u8 FirstAddr, const u32 *Wr, u32 *Rd, u32 Count) {
+    u32 Done;
+    u32 Len;
+    u32 i;
+
+    if (Spi->BlockMax <= 1) {
+        return spi33_table(Spi, Rw, Channel, FirstAddr, Wr, Rd, Count);
+    }
+
+    // Nothing goes out if any word is out of range
+    if (Channel >= SPI33_CHANNELS) {
+        xil_printf("SPI33: channel %d out of range\r\n", Channel);
+        return XST_FAILURE;
+    }
+    if ((u32)FirstAddr + Count > 256) {
+        xil_printf("SPI33: block 0x%02x + %d past the address range\r\n", FirstAddr, Count);
+        return XST_FAILURE;
+    }
+    for (i = 0; Wr && i < Count; i++) {
+        if (Wr[i] > SPI33_CMD_MASK) {
+            xil_printf("SPI33: word %d out of range\r\n", i);
+            return XST_FAILURE;
+        }
+    }
+
+    for (Done = 0; Done < Count; Done += Len) {
+        Len = Count - Done < Spi->BlockMax ? Count - Done : Spi->BlockMax;
+        spi33_block(Spi, Rw, Channel, (u8)(FirstAddr + Done), Wr ? &Wr[Done] : NULL, Rd ? &Rd[Done] : NULL, Len);
+    }
+
+    return XST_SUCCESS;
+}
+
+int spi33_block_write(Spi33 *Spi, u8 Channel, u8 FirstAddr, const u32 *Data, u32 Count) {
+    return spi33_blocks(Spi, SPI33_WRITE, Channel, FirstAddr, Data, NULL, Count);
+}
+
+int spi33_block_read(Spi33 *Spi, u8 Channel, u8 FirstAddr, u32 *Data, u32 Count) {
+    return spi33_blocks(Spi, SPI33_READ, Channel, FirstAddr, NULL, Data, Count);
+}
+
+void spi33_report(Spi33 *Spi) {
+    xil_printf("#spi33,frame_us,frames,reads,high_writes,blocks,block_words\r\n");
+    xil_printf("spi33,%d,%d,%d,%d,%d,%d\r\n", Spi->FrameUs, Spi->Frames, Spi->Reads, Spi->HighWrites,
+               Spi->Blocks, Spi->BlockWords);
+}
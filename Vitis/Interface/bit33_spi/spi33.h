@@ -0,0 +1,97 @@
+#ifndef SPI33_H
+#define SPI33_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Driver for the 33-bit SPI master (spi_mst) talking to spi_decoder.v.
+ *
+ * A frame is rw(1) | channel(2) | address(8) | cmd(22), MSB first. A read
+ * frame gets the 22-bit register of the addressed entry back on MISO in the
+ * same frame; it is in READ_SPI once the frame is over.
+ *
+ * spi33_burst() sends an array of frames back to back: HIGH_1_DATA is only
+ * written when the rw bit changes, each frame is started as soon as the one
+ * before has shifted out, and READ_SPI is only read for read frames. The
+ * master has no busy flag, so the frame time comes from the SCK rate given
+ * to spi33_init().
+ *
+ * Block mode: spi_decoder keeps going past bit 33 while the select line is
+ * low, one 22-bit word per 22 SCK periods at the next address of the bank
+ * (the channel). A master built with the block registers (BLK_LEN, and
+ * BLK_DATA in front of a word FIFO each way) sends BLK_LEN extra words after
+ * the header frame on the next START; BLK_LEN goes back to 0 after it.
+ * spi33_block_write() and spi33_block_read() use it once spi33_enable_block()
+ * has been given the FIFO depth, and fall back to one frame per word
+ * otherwise.
+ */
+
+/***** Register offsets *****/
+#define SPI33_START_OFFSET      0x0
+#define SPI33_HIGH_1_OFFSET     0x4
+#define SPI33_LOW_32_OFFSET     0x8
+#define SPI33_READ_OFFSET       0xC
+#define SPI33_BLK_LEN_OFFSET    0x10    // Extra words in the next frame
+#define SPI33_BLK_DATA_OFFSET   0x14    // Write: TX FIFO, read: RX FIFO
+
+#define SPI33_WRITE             0
+#define SPI33_READ              1
+
+#define SPI33_FRAME_BITS        33
+#define SPI33_WORD_BITS         22
+#define SPI33_CMD_MASK          0x3FFFFF
+#define SPI33_CHANNELS          4
+
+#define SPI33_BURST_MAX         32      // Frames built per table chunk
+
+typedef struct {
+    u8  Rw;                         // SPI33_WRITE or SPI33_READ
+    u8  Channel;                    // 0 .. 3
+    u8  Addr;
+    u32 Cmd;                        // 22 bits, ignored by the decoder on reads
+} Spi33Frame;
+
+typedef struct {
+    UINTPTR BaseAddr;
+    u32 SckHz;
+    u32 FrameUs;                    // One frame on the wire, rounded up, plus margin
+    u32 BlockMax;                   // Words per block frame, 1 without block mode
+    u8  High;                       // HIGH_1_DATA as last written
+    u8  HighValid;
+    u32 Frames;
+    u32 Reads;
+    u32 HighWrites;
+    u32 Blocks;
+    u32 BlockWords;
+} Spi33;
+
+int  spi33_init(Spi33 *Spi, UINTPTR BaseAddr, u32 SckHz);
+u64  spi33_pack(const Spi33Frame *Frame);
+
+// ReadData, if given, gets one word per frame: the register for reads, 0 for writes
+int  spi33_transfer(Spi33 *Spi, const Spi33Frame *Frame, u32 *ReadData);
+int  spi33_burst(Spi33 *Spi, const Spi33Frame *Frames, u32 Count, u32 *ReadData);
+
+// Count consecutive addresses from FirstAddr on one channel
+int  spi33_write_table(Spi33 *Spi, u8 Channel, u8 FirstAddr, const u32 *Cmds, u32 Count);
+int  spi33_read_table(Spi33 *Spi, u8 Channel, u8 FirstAddr, u32 *Data, u32 Count);
+
+// FifoWords: depth of the master's block FIFOs, 0 for a master without them
+void spi33_enable_block(Spi33 *Spi, u32 FifoWords);
+
+// Same as the tables, one header per block frame instead of one per word
+int  spi33_block_write(Spi33 *Spi, u8 Channel, u8 FirstAddr, const u32 *Data, u32 Count);
+int  spi33_block_read(Spi33 *Spi, u8 Channel, u8 FirstAddr, u32 *Data, u32 Count);
+
+void spi33_report(Spi33 *Spi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPI33_H */
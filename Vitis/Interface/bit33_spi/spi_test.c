@@ -5,51 +5,53 @@
 #include "xuartlite.h"
 
 #include "uart_getchar.h"
-#include "xil_io.h"
 #include "sleep.h"
+#include "spi33.h"
 
 #define SPI_MST_BASEADDR    XPAR_SPI_MST_0_S00_AXI_BASEADDR
-#define START (SPI_MST_BASEADDR + 0x0)
-#define HIGH_1_DATA (SPI_MST_BASEADDR + 0x4)
-#define LOW_32_DATA (SPI_MST_BASEADDR + 0x8)
-#define READ_SPI    (SPI_MST_BASEADDR + 0xC)
 
-/* Function prototype */
-void single_transfer();
+#define SPI_MST_SCK_HZ      10000000    // SCK of spi_mst as built
+#define REG_TABLE_SIZE      10          // ID and status entries of register_table bank 0
 
-/* Function implementation */
-// Transfer
-void single_transfer(){
-    Xil_Out32(START, 0x1);
-    // usleep(1);
-    Xil_Out32(START, 0x0);
-}
+#ifdef XPAR_SPI_MST_0_BLOCK_WORDS
+#define SPI_MST_BLOCK_WORDS XPAR_SPI_MST_0_BLOCK_WORDS
+#else
+#define SPI_MST_BLOCK_WORDS 0               // spi_mst without BLK_LEN / BLK_DATA
+#endif
 
 int main(){
 
     xil_printf("Hello, SPI!\r\n");
 
-    u64 spi_data_full;
-    u32 spi_data_low;
-    u8  spi_data_high;
+    Spi33 spi;
+    Spi33Frame frame;
+    u32 table[REG_TABLE_SIZE];
     u32 spi_read_data;
 
+    if (spi33_init(&spi, SPI_MST_BASEADDR, SPI_MST_SCK_HZ) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+    spi33_enable_block(&spi, SPI_MST_BLOCK_WORDS);
+
+    // ID and status registers in one block frame
+    if (spi33_block_read(&spi, 0, 0, table, REG_TABLE_SIZE) == XST_SUCCESS) {
+        for (int i = 0; i < REG_TABLE_SIZE; i++) {
+            xil_printf("register_table[%d] = 0x%06x\r\n", i, table[i]);
+        }
+    }
+
     while (1){
         u8 rw = read_single_bit("Please enter a value from 0 to 1, then press enter(0:Write or 1:Read): ", 1);
         u8 ch = read_hex_input("Please enter channel from 0 to 3, then press enter(0:CH0; 1:CH1; 2:CH2; 3:CH3): ", 1) & 0x3;
         u8 addr = read_hex_input("Please enter address from 0x00 to 0xFF, then press enter: ", 2) & 0xFF;
         u32 cmd = read_hex_input("Please enter command from 000000 to 3FFFFF, then press enter: ", 6) & 0x3FFFFF;
 
-        spi_data_full = ((u64)rw << 32) | ((u64)ch << 30) | ((u64)addr << 22) | cmd;
-        spi_data_high = (spi_data_full >> 32) & 0x1;     
-        spi_data_low = spi_data_full & 0xFFFFFFFF;
-
-        Xil_Out32(HIGH_1_DATA, spi_data_high);
-        Xil_Out32(LOW_32_DATA, spi_data_low);
-
-        single_transfer();
+        frame.Rw = rw;
+        frame.Channel = ch;
+        frame.Addr = addr;
+        frame.Cmd = cmd;
 
-        spi_read_data = Xil_In32(READ_SPI);
+        spi33_transfer(&spi, &frame, &spi_read_data);
 
         switch (spi_read_data) {
             case 0x06d53e:
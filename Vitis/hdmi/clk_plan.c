@@ -0,0 +1,105 @@
+#include "clk_plan.h"
+#include "xil_printf.h"
+
+static const ClkPlanKey *clk_plan_entry(const void *Base, u32 EntrySize, u32 Index) {
+    return (const ClkPlanKey *)((const u8 *)Base + Index * EntrySize);
+}
+
+int clk_plan_match(const ClkPlanKey *Key, u32 FIn, u32 FOut) {
+    u32 Tol = (u32)(((u64)FIn * CLK_PLAN_TOL_PPM) / 1000000);
+
+    if (Key->FIn + Tol < FIn || Key->FIn > FIn + Tol) {
+        return FALSE;
+    }
+    return (u64)Key->FOut * FIn == (u64)FOut * Key->FIn;
+}
+
+void clk_plan_init(ClkPlanCache *Cache, const void *Table, u32 TableCount, void *Lru, u8 LruWays,
+                   u32 EntrySize) {
+    Cache->Table = Table;
+    Cache->TableCount = TableCount;
+    Cache->EntrySize = EntrySize;
+    Cache->Lru = Lru;
+    Cache->LruWays = (LruWays > CLK_PLAN_LRU_MAX) ? CLK_PLAN_LRU_MAX : LruWays;
+    Cache->LruUsed = 0;
+    Cache->Clock = 0;
+    Cache->TableHits = 0;
+    Cache->LruHits = 0;
+    Cache->Misses = 0;
+}
+
+const void *clk_plan_find(ClkPlanCache *Cache, u32 FIn, u32 FOut) {
+    const ClkPlanKey *Key;
+    u32 Tol = (u32)(((u64)FIn * CLK_PLAN_TOL_PPM) / 1000000);
+    u32 Low = 0;
+    u32 High = Cache->TableCount;
+    u32 Mid;
+    u8 i;
+
+    // First plan with FIn inside the tolerance, then the few after it
+    while (Low < High) {
+        Mid = (Low + High) / 2;
+        Key = clk_plan_entry(Cache->Table, Cache->EntrySize, Mid);
+        if (Key->FIn + Tol < FIn) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    for (; Low < Cache->TableCount; Low++) {
+        Key = clk_plan_entry(Cache->Table, Cache->EntrySize, Low);
+        if (Key->FIn > FIn + Tol) {
+            break;
+        }
+        if (clk_plan_match(Key, FIn, FOut)) {
+            Cache->TableHits++;
+            return Key;
+        }
+    }
+
+    for (i = 0; i < Cache->LruUsed; i++) {
+        Key = clk_plan_entry(Cache->Lru, Cache->EntrySize, i);
+        if (clk_plan_match(Key, FIn, FOut)) {
+            Cache->LruAge[i] = ++Cache->Clock;
+            Cache->LruHits++;
+            return Key;
+        }
+    }
+
+    Cache->Misses++;
+    return NULL;
+}
+
+void clk_plan_store(ClkPlanCache *Cache, const void *Entry) {
+    u8 *Slot;
+    u32 n;
+    u8 Way;
+    u8 i;
+
+    if (Cache->LruWays == 0) {
+        return;
+    }
+
+    if (Cache->LruUsed < Cache->LruWays) {
+        Way = Cache->LruUsed++;
+    } else {
+        Way = 0;
+        for (i = 1; i < Cache->LruWays; i++) {
+            if (Cache->LruAge[i] < Cache->LruAge[Way]) {
+                Way = i;
+            }
+        }
+    }
+
+    Slot = (u8 *)Cache->Lru + Way * Cache->EntrySize;
+    for (n = 0; n < Cache->EntrySize; n++) {
+        Slot[n] = ((const u8 *)Entry)[n];
+    }
+    Cache->LruAge[Way] = ++Cache->Clock;
+}
+
+void clk_plan_report(ClkPlanCache *Cache, const char *Name) {
+    xil_printf("#clkplan,chip,table,table_hits,lru_hits,solved\r\n");
+    xil_printf("clkplan,%s,%d,%d,%d,%d\r\n", Name, Cache->TableCount, Cache->TableHits,
+               Cache->LruHits, Cache->Misses);
+}
@@ -0,0 +1,71 @@
+#ifndef CLK_PLAN_H
+#define CLK_PLAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+
+/*
+ * Divider plans of a clock chip by (input, output) frequency.
+ *
+ * A plan is found in a constant table first. The table is sorted by FIn,
+ * then FOut, and generated on the host by running the chip's own solver
+ * over the standard HDMI clocks (host_sim/clk_plan_gen.c). Other
+ * frequencies are kept in a small LRU after the solver has run once, so a
+ * resolution switch only solves a pair the first time it is seen.
+ *
+ * In locked mode FIn is the reference clock the VPHY measured, a few hundred
+ * Hz off the nominal rate. A plan fits when FOut / FIn is the same ratio and
+ * FIn is within CLK_PLAN_TOL_PPM of the plan's: the PLL keeps the ratio, so
+ * the output follows the real input. In free-run mode FIn is the crystal and
+ * FOut the nominal rate, and only an exact pair has the same ratio. The
+ * generator keeps plans with the same ratio further apart than that, so
+ * 1/1.001 rates still find their own.
+ *
+ * Every plan type starts with a ClkPlanKey; the cache only looks at the key
+ * and copies whole entries of EntrySize bytes.
+ */
+
+#define CLK_PLAN_LRU_MAX        16
+#define CLK_PLAN_TOL_PPM        200     // Input clock measurement error accepted
+
+typedef struct {
+    u32 FIn;
+    u32 FOut;
+} ClkPlanKey;
+
+typedef struct {
+    const void *Table;
+    u32 TableCount;
+    u32 EntrySize;
+    void *Lru;                      // LruWays entries
+    u8 LruWays;
+    u8 LruUsed;
+    u32 LruAge[CLK_PLAN_LRU_MAX];
+    u32 Clock;
+    u32 TableHits;
+    u32 LruHits;
+    u32 Misses;                     // Solver runs
+} ClkPlanCache;
+
+void clk_plan_init(ClkPlanCache *Cache, const void *Table, u32 TableCount, void *Lru, u8 LruWays,
+                   u32 EntrySize);
+
+// Table, then LRU; NULL when the solver has to run
+const void *clk_plan_find(ClkPlanCache *Cache, u32 FIn, u32 FOut);
+
+// Keep a solved plan, evicting the least recently used one
+void clk_plan_store(ClkPlanCache *Cache, const void *Entry);
+
+void clk_plan_report(ClkPlanCache *Cache, const char *Name);
+
+// Plan of Key usable for FIn, FOut
+int clk_plan_match(const ClkPlanKey *Key, u32 FIn, u32 FOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLK_PLAN_H */
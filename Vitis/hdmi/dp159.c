@@ -19,11 +19,14 @@
 	v1.4 - Update vswing setting to recommened values to pass compliance
 	v1.5 - Update the register setting sequence to write 0x0A the last
            to set APPLY_RXTX_CHANGES
+	v1.6 - ES register writes go through a shadow register cache
 */
 
 #include "dp159.h"
 #include "sleep.h"
 #include "xiic.h"
+#include "iic_bus.h"
+#include "iic_regcache.h"
 
 #define DP159_VERBOSE			0
 #define DP159_ZOMBIE 			0
@@ -32,46 +35,62 @@
 #define I2C_DP159_ZOMBIE_ADDR 	0x2C
 #define I2C_DP159_ES_ADDR 		0x5E
 
+#define DP159_ES_REGS			0x20
+#define DP159_ES_APPLY			0x0A
+
+static IicBusClient Dp159Client[2];
+static IicRegCache Dp159EsCache;
+
+// Bus manager client of the ES or zombie device, set up on first use
+static IicBusClient *i2c_dp159_client(u8 dev) {
+	IicBus *Bus;
+
+	if (Dp159Client[0].Bus == NULL) {
+		Bus = iic_bus_get(XPAR_IIC_0_BASEADDR);
+		iic_bus_client_init(&Dp159Client[0], Bus, "dp159_zombie", I2C_DP159_ZOMBIE_ADDR, IIC_BUS_ROOT);
+		iic_bus_client_init(&Dp159Client[1], Bus, "dp159_es", I2C_DP159_ES_ADDR, IIC_BUS_ROOT);
+
+		// Writing 0x0A applies the other settings, it is never dropped
+		iic_regcache_init(&Dp159EsCache, &Dp159Client[1], DP159_ES_REGS, 1, TRUE);
+		iic_regcache_nocache(&Dp159EsCache, DP159_ES_APPLY);
+	}
+
+	return &Dp159Client[(dev == DP159_ES) ? 1 : 0];
+}
+
 // I2C DP159 check
 // This routine checks if any data can be read from the DP159
 u8 i2c_dp159_chk(u8 dev) {
-	u32 r;
-	u8 buf[1];
-
-	// DP159 ES
-	if (dev == DP159_ES) {
-		r = XIic_Recv(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 1, XIIC_STOP);
-	}
-	else
-		r = XIic_Recv(XPAR_IIC_0_BASEADDR, I2C_DP159_ZOMBIE_ADDR, (u8 *)buf, 1, XIIC_STOP);
+	u8 r;
 
 	// When a device is found, it returns one byte
-	if (r == 1)
-	  return XST_SUCCESS;
-	else
-	  return XST_FAILURE;
+	r = iic_bus_probe(i2c_dp159_client(dev));
+
+	// A device that went away lost its registers
+	if ((r != XST_SUCCESS) && (dev == DP159_ES))
+		iic_regcache_invalidate(&Dp159EsCache);
+
+	return r;
 }
 
 // I2C DP159 write
+// ES writes of the value the register already holds are dropped
 u32 i2c_dp159_write(u8 dev, u8 addr, u8 dat)
 {
-  u32 r;
+  IicBusClient *client;
   u8 buf[2];
+  int r;
 
   buf[0] = addr;
   buf[1] = dat;
 
-  // DP159 ES
-  if (dev == DP159_ES) {
-	  r = XIic_Send(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 2, XIIC_STOP);
-  }
-
-  // Zombie
-  else {
-	  r = XIic_Send(XPAR_IIC_0_BASEADDR, I2C_DP159_ZOMBIE_ADDR, (u8 *)buf, 2, XIIC_STOP);
-  }
+  client = i2c_dp159_client(dev);
+  if (dev == DP159_ES)
+	  r = iic_regcache_write(&Dp159EsCache, addr, dat);
+  else
+	  r = iic_bus_transfer(client, (u8 *)buf, 2, NULL, 0);
 
-  if (r == 2)
+  if (r == XST_SUCCESS)
 	  return XST_SUCCESS;
   else
 	  return XST_FAILURE;
@@ -80,24 +99,12 @@ u32 i2c_dp159_write(u8 dev, u8 addr, u8 dat)
 // I2C DP159 read
 u8 i2c_dp159_read(u8 dev, u8 addr)
 {
-  u32 r;
   u8 buf[2];
 
   buf[0] = addr;
 
-  // DP159 ES
-  if (dev == DP159_ES) {
-	  r = XIic_Send(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 1, XII_REPEATED_START_OPTION);
-	  r = XIic_Recv(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 1, XIIC_STOP);
-  }
-
-  // Zombie
-  else {
-	  r = XIic_Send(XPAR_IIC_0_BASEADDR, I2C_DP159_ZOMBIE_ADDR, (u8 *)buf, 1, XII_REPEATED_START_OPTION);
-	  r = XIic_Recv(XPAR_IIC_0_BASEADDR, I2C_DP159_ZOMBIE_ADDR, (u8 *)buf, 1, XIIC_STOP);
-  }
-
-  if (r == 1)
+  // Register address, repeated start, data
+  if (iic_bus_transfer(i2c_dp159_client(dev), (u8 *)buf, 1, (u8 *)buf, 1) == XST_SUCCESS)
 	return buf[0];
   else
 	return 0;
@@ -113,14 +120,27 @@ void i2c_dp159_dump(void)
 
   buf[0] = 0x0;
   xil_printf("DP159 register dump\r\n");
-  r = XIic_Send(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 1, XII_REPEATED_START_OPTION);
+  r = (iic_bus_transfer(i2c_dp159_client(DP159_ES), (u8 *)buf, 1, (u8 *)buf, 32) == XST_SUCCESS) ? 32 : 0;
 
-  r = XIic_Recv(XPAR_IIC_0_BASEADDR, I2C_DP159_ES_ADDR, (u8 *)buf, 32, XIIC_STOP);
   for (i = 0; i< 0x20; i++) {
 	  xil_printf("(%d) ADDR: %0x DATA: %0x\r\n", r, i, buf[i]);
   }
  }
 
+// I2C DP159 verify
+// This routine compares the ES shadow registers with the device
+u32 i2c_dp159_verify(void)
+{
+  u32 r;
+
+  i2c_dp159_client(DP159_ES);
+  iic_regcache_dump(&Dp159EsCache);
+  r = iic_regcache_verify(&Dp159EsCache, 0, DP159_ES_REGS);
+  iic_regcache_report(&Dp159EsCache);
+
+  return (r == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+}
+
 // DP159
 #ifndef versal
 u32 i2c_dp159(XVphy *VphyPtr, u8 QuadId, u64 TxLineRate)
@@ -424,6 +444,9 @@ u32 i2c_dp159(XHdmiphy1 *Hdmiphy1Ptr, u8 QuadId, u64 TxLineRate)
 		  //xil_printf("Program DP159 ES... \r\n");
 		  r = i2c_dp159_write(DP159_ES, 0x09, 0x06);
 
+		  // 0x0B - 0x0D go out as one burst, only when they changed
+		  iic_regcache_defer(&Dp159EsCache);
+
 		  // HDMI 2.0
 		  if ((TxLineRate / (1000000)) > 3400) {
 			  if (DP159_VERBOSE)
@@ -439,6 +462,7 @@ u32 i2c_dp159(XHdmiphy1 *Hdmiphy1Ptr, u8 QuadId, u64 TxLineRate)
 			                                                // PRE_SEL = Reg0Ch[1:0] = 00 (labeled HDMI_TWPST)
 #endif
 			  r = i2c_dp159_write(DP159_ES, 0x0D, 0x00);
+			  r = iic_regcache_flush(&Dp159EsCache);
 			  r = i2c_dp159_write(DP159_ES, 0x0A, 0x36);	// Automatic retimer for HDMI 2.0
 		  }
 
@@ -456,6 +480,7 @@ u32 i2c_dp159(XHdmiphy1 *Hdmiphy1Ptr, u8 QuadId, u64 TxLineRate)
 			                                                // PRE_SEL = Reg0Ch[1:0] = 00 (labeled HDMI_TWPST)
 #endif
 			  r = i2c_dp159_write(DP159_ES, 0x0D, 0x00);
+			  r = iic_regcache_flush(&Dp159EsCache);
 			  r = i2c_dp159_write(DP159_ES, 0x0A, 0x35);	// Automatic redriver to retimer crossover at 1.0 Gbps
 		  }
 		  // HDMI 1.4 (< 2 Gbps)
@@ -472,6 +497,7 @@ u32 i2c_dp159(XHdmiphy1 *Hdmiphy1Ptr, u8 QuadId, u64 TxLineRate)
 			                                                // PRE_SEL = Reg0Ch[1:0] = 00 (labeled HDMI_TWPST)
 #endif
 			  r = i2c_dp159_write(DP159_ES, 0x0D, 0x00);
+			  r = iic_regcache_flush(&Dp159EsCache);
 			  r = i2c_dp159_write(DP159_ES, 0x0A, 0x35);	// Automatic redriver to retimer crossover at 1.0 Gbps
 		}
 		return XST_SUCCESS;
@@ -24,5 +24,6 @@ u32 i2c_dp159(XHdmiphy1 *Hdmiphy1Ptr, u8 QuadId, u64 TxLineRate);
 u32 i2c_dp159_write(u8 dev, u8 addr, u8 dat);
 u8 i2c_dp159_read(u8 dev, u8 addr);
 void i2c_dp159_dump(void);
+u32 i2c_dp159_verify(void);
 
 #endif
@@ -0,0 +1,494 @@
+// Offline search and check of the clock chip frequency plans. Runs the
+// drivers' own solvers (IDT_8T49N24x_CalculateSettings,
+// Si5324_CalcFreqSettings) on a pool of threads, recomputes from the
+// register settings the output frequency, VCO and phase detector frequency
+// the chip will really run at, and either writes the firmware tables or
+// reports every pair.
+//
+// Pairs, for every reference clock r of the timings below:
+//   (crystal, r)   free-run mode
+//   (r, r)         locked mode
+//   (r, 4 r)       locked mode above 3.4 Gbps, TX reference = 4 x RX
+// where r is the TMDS clock, or a quarter of it above 340 MHz. -r adds
+// locked 1:1 pairs over a range of r.
+//
+//   gcc -O2 -Wall -Wno-maybe-uninitialized -I../../Interface_realeted/IIC/c_code/host_sim
+//       -I. -include xil_printf.h clk_plan.c iic_bus.c iic_regcache.c idt_8t49n24x.c si5324drv.c
+//       ../../Interface_realeted/IIC/c_code/host_sim/sim_iic.c
+//       ../../Interface_realeted/IIC/c_code/host_sim/sim_iic_devs.c
+//       host_sim/clk_plan_gen.c -lpthread -lm -o clk_plan_gen
+//
+//   ./clk_plan_gen idt > idt_8t49n24x_plans.h
+//   ./clk_plan_gen si5324 > si5324_plans.h
+//   ./clk_plan_gen [-j threads] [-p ppm] [-r fmin:fmax:step] sweep [idt|si5324]
+//
+// Tables: pairs that fail (no solution, VCO or phase detector out of range,
+// more than -p ppm off) are reported on stderr and left out; the driver
+// solves them at run time as before.
+//
+// Sweep: one CSV line per pair, then a summary per chip with the worst
+// error and the solve times. Exits 1 when a pair fails that is not in
+// KnownFailures, so it doubles as a regression check of the solvers'
+// accuracy and speed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "xil_types.h"
+#include "xstatus.h"
+#include "idt_8t49n24x.h"
+#include "si5324drv.h"
+
+#define MAX_PAIRS               8192
+#define MAX_THREADS             64
+#define PPM_MAX                 1.0         // Default accepted output error
+#define TMDS_MAX                600000000   // HDMI 2.0
+#define TMDS_RATIO_MAX          340000000   // Above it the reference clock is TMDS / 4
+
+// Data sheet phase detector limit; IDT_8T49N24X_FPD_MAX (128 kHz) is the
+// driver's target, which its P = floor(FIn / 128 kHz) slightly overshoots
+#define IDT_FPD_MAX_HW          8000000
+
+enum { CHIP_IDT, CHIP_SI5324, CHIPS };
+
+// Pairs the solvers are known not to solve; not counted as a regression
+static const struct {
+    int Chip;
+    ClkPlanKey Key;
+} KnownFailures[] = {
+    { CHIP_SI5324, { 148351648, 593406592 } },   // 4K60 / 1.001, TX reference x4
+    { CHIP_SI5324, { 148500000, 594000000 } },   // 4K60, TX reference x4
+};
+
+// CEA-861 pixel clocks; also at 1/1.001 and with deep colour
+static const u32 CeaClocks[] = {
+    25200000, 27000000, 54000000, 74250000, 108000000, 148500000, 297000000, 594000000,
+};
+
+// VESA DMT pixel clocks, 8 bits per component only
+static const u32 VesaClocks[] = {
+    31500000,  35500000,  36000000,  40000000,  49500000,  50000000,  56250000,  65000000,
+    68250000,  71000000,  75000000,  78750000,  79500000,  83500000,  85500000,  88750000,
+    94500000,  101000000, 106500000, 119000000, 121750000, 135000000, 146250000, 154000000,
+    156000000, 162000000, 175500000, 187000000, 193250000, 204750000, 234000000, 241500000,
+    245250000, 268250000,
+};
+
+// TMDS clock / pixel clock for 8, 10, 12 and 16 bits per component
+static const u32 DepthNum[] = { 4, 5, 6, 8 };
+#define DEPTH_DEN               4
+
+typedef struct {
+    const char *Name;
+    u32 Xtal;
+    u32 FOutMax;
+    double VcoMin;
+    double VcoMax;
+    double PfdMin;
+    double PfdMax;
+} Chip;
+
+static const Chip Chips[CHIPS] = {
+    { "idt", IDT_8T49N24X_XTAL_FREQ, IDT_8T49N24X_FOUT_MAX, IDT_8T49N24X_FVCO_MIN,
+      IDT_8T49N24X_FVCO_MAX, IDT_8T49N24X_FPD_MIN, IDT_FPD_MAX_HW },
+    { "si5324", SI5324_XTAL_FREQ, SI5324_FOUT_MAX, SI5324_FOSC_MIN, SI5324_FOSC_MAX, SI5324_F3_MIN,
+      SI5324_F3_MAX },
+};
+
+typedef struct {
+    ClkPlanKey Key;
+    int Solved;
+    IDT_8T49N24x_Plan Idt;
+    si5324_plan_t Si5324;
+    double FActual;     // Output frequency from the register settings
+    double Ppm;
+    double Vco;
+    double Pfd;
+    int VcoOk;
+    int PfdOk;
+    double SolveUs;     // Thread CPU time
+} Job;
+
+static Job Jobs[MAX_PAIRS];
+static int NumJobs;
+static int NextJob;
+static int JobChip;
+static double PpmMax = PPM_MAX;
+
+static double cpu_us(void) {
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Ts);
+    return Ts.tv_sec * 1e6 + Ts.tv_nsec / 1e3;
+}
+
+static double wall_ms(void) {
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return Ts.tv_sec * 1e3 + Ts.tv_nsec / 1e6;
+}
+
+static int key_cmp(const void *A, const void *B) {
+    const ClkPlanKey *KeyA = &((const Job *)A)->Key;
+    const ClkPlanKey *KeyB = &((const Job *)B)->Key;
+
+    if (KeyA->FIn != KeyB->FIn) {
+        return KeyA->FIn < KeyB->FIn ? -1 : 1;
+    }
+    if (KeyA->FOut != KeyB->FOut) {
+        return KeyA->FOut < KeyB->FOut ? -1 : 1;
+    }
+    return 0;
+}
+
+static void add_pair(u32 FIn, u32 FOut, u32 FOutMax) {
+    int i;
+
+    if (FOut > FOutMax) {
+        return;
+    }
+    // An earlier plan already covers it, see clk_plan_match()
+    for (i = 0; i < NumJobs; i++) {
+        if (clk_plan_match(&Jobs[i].Key, FIn, FOut)) {
+            return;
+        }
+    }
+    if (NumJobs == MAX_PAIRS) {
+        fprintf(stderr, "clk_plan_gen: more than %d pairs\n", MAX_PAIRS);
+        exit(2);
+    }
+    memset(&Jobs[NumJobs], 0, sizeof(Jobs[0]));
+    Jobs[NumJobs].Key.FIn = FIn;
+    Jobs[NumJobs].Key.FOut = FOut;
+    NumJobs++;
+}
+
+static void add_pixel_clock(u32 Pixel, int DeepColour, u32 Xtal, u32 FOutMax) {
+    u32 Tmds;
+    u32 Ref;
+    int d;
+
+    for (d = 0; d < (DeepColour ? 4 : 1); d++) {
+        Tmds = (u32)((u64)Pixel * DepthNum[d] / DEPTH_DEN);
+        if (Tmds > TMDS_MAX) {
+            continue;
+        }
+        Ref = Tmds > TMDS_RATIO_MAX ? Tmds / 4 : Tmds;
+        add_pair(Xtal, Ref, FOutMax);
+        add_pair(Ref, Ref, FOutMax);
+        if (Tmds > TMDS_RATIO_MAX) {
+            add_pair(Ref, Ref * 4, FOutMax);
+        }
+    }
+}
+
+static void add_pairs(const Chip *C, u32 RangeMin, u32 RangeMax, u32 RangeStep) {
+    unsigned i;
+    u32 f;
+
+    NumJobs = 0;
+    for (i = 0; i < sizeof(CeaClocks) / sizeof(CeaClocks[0]); i++) {
+        add_pixel_clock(CeaClocks[i], TRUE, C->Xtal, C->FOutMax);
+        add_pixel_clock((u32)((u64)CeaClocks[i] * 1000 / 1001), TRUE, C->Xtal, C->FOutMax);
+    }
+    for (i = 0; i < sizeof(VesaClocks) / sizeof(VesaClocks[0]); i++) {
+        add_pixel_clock(VesaClocks[i], FALSE, C->Xtal, C->FOutMax);
+    }
+    if (RangeStep != 0) {
+        for (f = RangeMin; f <= RangeMax; f += RangeStep) {
+            add_pair(f, f, C->FOutMax);
+        }
+    }
+    qsort(Jobs, NumJobs, sizeof(Jobs[0]), key_cmp);
+}
+
+// Output, VCO and phase detector from the register values. Free run: the
+// upper loop multiplies the doubled crystal, Pfd is left 0. Locked: the
+// lower loop, FIn * M1 / P.
+static void check_idt(Job *J) {
+    const IDT_8T49N24x_Settings *S = &J->Idt.Settings;
+    double OutDiv = 2.0 * (S->N_Qx + S->NFRAC_Qx / 268435456.0);
+
+    if (J->Key.FIn == IDT_8T49N24X_XTAL_FREQ) {
+        J->Vco = 2.0 * IDT_8T49N24X_XTAL_FREQ * (S->DSM_INT + S->DSM_FRAC / 2097152.0);
+        J->Pfd = 0;
+    } else {
+        J->Vco = S->PRE_x ? (double)J->Key.FIn * S->M1_x / S->PRE_x : 0;
+        J->Pfd = S->PRE_x ? (double)J->Key.FIn / S->PRE_x : 0;
+    }
+    J->FActual = OutDiv > 0 ? J->Vco / OutDiv : 0;
+}
+
+// fosc = fin * N2_HS * N2_LS / N3, fout = fosc / (N1_HS * NC1_LS)
+static void check_si5324(Job *J) {
+    const si5324_plan_t *P = &J->Si5324;
+    double N1 = (double)(P->N1_hs + 4) * (P->NCn_ls + 1);
+
+    J->Pfd = (double)J->Key.FIn / (P->N3n + 1);
+    J->Vco = J->Pfd * (P->N2_hs + 4) * (P->N2_ls + 1);
+    J->FActual = J->Vco / N1;
+}
+
+static void solve(Job *J) {
+    const Chip *C = &Chips[JobChip];
+    double Start = cpu_us();
+
+    if (JobChip == CHIP_IDT) {
+        J->Solved = IDT_8T49N24x_CalculateSettings(J->Key.FIn, J->Key.FOut, &J->Idt.Settings) ==
+                    XST_SUCCESS;
+        J->Idt.Key = J->Key;
+    } else {
+        J->Solved = Si5324_CalcFreqSettings(J->Key.FIn, J->Key.FOut, &J->Si5324.N1_hs,
+                                            &J->Si5324.NCn_ls, &J->Si5324.N2_hs, &J->Si5324.N2_ls,
+                                            &J->Si5324.N3n, &J->Si5324.BwSel) == SI5324_SUCCESS;
+        J->Si5324.Key = J->Key;
+    }
+    J->SolveUs = cpu_us() - Start;
+    if (!J->Solved) {
+        return;
+    }
+
+    if (JobChip == CHIP_IDT) {
+        check_idt(J);
+    } else {
+        check_si5324(J);
+    }
+    J->Ppm = (J->FActual - J->Key.FOut) / J->Key.FOut * 1e6;
+    J->VcoOk = J->Vco >= C->VcoMin && J->Vco <= C->VcoMax;
+    J->PfdOk = J->Pfd == 0 || (J->Pfd >= C->PfdMin && J->Pfd <= C->PfdMax);
+}
+
+static int job_ok(const Job *J) {
+    return J->Solved && J->VcoOk && J->PfdOk && fabs(J->Ppm) <= PpmMax;
+}
+
+static int job_known_failure(const Job *J) {
+    unsigned i;
+
+    for (i = 0; i < sizeof(KnownFailures) / sizeof(KnownFailures[0]); i++) {
+        if (KnownFailures[i].Chip == JobChip && KnownFailures[i].Key.FIn == J->Key.FIn &&
+            KnownFailures[i].Key.FOut == J->Key.FOut) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void *worker(void *Arg) {
+    int i;
+
+    (void)Arg;
+    while ((i = __atomic_fetch_add(&NextJob, 1, __ATOMIC_RELAXED)) < NumJobs) {
+        solve(&Jobs[i]);
+    }
+    return NULL;
+}
+
+// Solves every job, returns the wall time in ms
+static double run(int Chip, int Threads) {
+    pthread_t Tid[MAX_THREADS];
+    double Start = wall_ms();
+    int t;
+
+    JobChip = Chip;
+    NextJob = 0;
+    for (t = 0; t < Threads; t++) {
+        pthread_create(&Tid[t], NULL, worker, NULL);
+    }
+    for (t = 0; t < Threads; t++) {
+        pthread_join(Tid[t], NULL);
+    }
+    return wall_ms() - Start;
+}
+
+static void reject(const Job *J) {
+    fprintf(stderr, "clk_plan_gen: %s %u -> %u left out:%s%s%s", Chips[JobChip].Name, J->Key.FIn,
+            J->Key.FOut, J->Solved ? "" : " not solved", J->Solved && !J->VcoOk ? " vco" : "",
+            J->Solved && !J->PfdOk ? " pfd" : "");
+    if (J->Solved && fabs(J->Ppm) > PpmMax) {
+        fprintf(stderr, " %.3f ppm", J->Ppm);
+    }
+    fprintf(stderr, "\n");
+}
+
+static void banner(const char *Solver, int Count) {
+    printf("/*\n");
+    printf(" * Generated by host_sim/clk_plan_gen.c (%s), do not edit.\n", Chips[JobChip].Name);
+    printf(" * %d plans solved with %s, sorted by FIn, FOut.\n", Count, Solver);
+    printf(" */\n");
+}
+
+static void table_idt(void) {
+    const IDT_8T49N24x_Settings *S;
+    int Count = 0;
+    int i;
+
+    for (i = 0; i < NumJobs; i++) {
+        Count += job_ok(&Jobs[i]);
+    }
+    banner("IDT_8T49N24x_CalculateSettings", Count);
+    printf("static const IDT_8T49N24x_Plan IDT_8T49N24x_Plans[] = {\n");
+    printf("\t/* FIn, FOut, NS1_Qx, NS2_Qx, N_Qx, NFRAC_Qx, DSM_INT, DSM_FRAC, M1_x, PRE_x, LOS_x */\n");
+    for (i = 0; i < NumJobs; i++) {
+        if (!job_ok(&Jobs[i])) {
+            reject(&Jobs[i]);
+            continue;
+        }
+        S = &Jobs[i].Idt.Settings;
+        printf("\t{ { %9u, %9u }, { %u, %u, %u, %u, %u, %u, %u, %u, %u } },\n", Jobs[i].Key.FIn,
+               Jobs[i].Key.FOut, S->NS1_Qx, S->NS2_Qx, S->N_Qx, S->NFRAC_Qx, S->DSM_INT,
+               S->DSM_FRAC, S->M1_x, S->PRE_x, S->LOS_x);
+    }
+    printf("};\n");
+}
+
+static void table_si5324(void) {
+    const si5324_plan_t *P;
+    int Count = 0;
+    int i;
+
+    for (i = 0; i < NumJobs; i++) {
+        Count += job_ok(&Jobs[i]);
+    }
+    banner("Si5324_CalcFreqSettings", Count);
+    printf("static const si5324_plan_t Si5324_Plans[] = {\n");
+    printf("    // FIn, FOut, N1_hs, N2_hs, BwSel, NCn_ls, N2_ls, N3n\n");
+    for (i = 0; i < NumJobs; i++) {
+        if (!job_ok(&Jobs[i])) {
+            reject(&Jobs[i]);
+            continue;
+        }
+        P = &Jobs[i].Si5324;
+        printf("    { { %9u, %9u }, %u, %u, %u, %u, %u, %u },\n", P->Key.FIn, P->Key.FOut,
+               P->N1_hs, P->N2_hs, P->BwSel, P->NCn_ls, P->N2_ls, P->N3n);
+    }
+    printf("};\n");
+}
+
+// CSV lines of one chip, then its summary; returns the unexpected failures
+static int sweep(int Chip, int Threads, int Header) {
+    const Job *J;
+    double WallMs = run(Chip, Threads);
+    double MaxPpm = 0;
+    double SumUs = 0;
+    double MaxUs = 0;
+    int Unsolved = 0;
+    int VcoFail = 0;
+    int PfdFail = 0;
+    int Known = 0;
+    int Failed = 0;
+    int i;
+
+    if (Header) {
+        printf("#clkplan_sweep,chip,fin,fout,fout_actual,ppm,vco,vco_ok,pfd,pfd_ok,solve_us\n");
+    }
+    for (i = 0; i < NumJobs; i++) {
+        J = &Jobs[i];
+        printf("clkplan_sweep,%s,%u,%u,%.3f,%.6f,%.0f,%d,%.1f,%d,%.1f\n", Chips[Chip].Name,
+               J->Key.FIn, J->Key.FOut, J->FActual, J->Ppm, J->Vco, J->VcoOk, J->Pfd, J->PfdOk,
+               J->SolveUs);
+        SumUs += J->SolveUs;
+        if (J->SolveUs > MaxUs) {
+            MaxUs = J->SolveUs;
+        }
+        if (!J->Solved) {
+            Unsolved++;
+        } else {
+            VcoFail += !J->VcoOk;
+            PfdFail += !J->PfdOk;
+            if (fabs(J->Ppm) > fabs(MaxPpm)) {
+                MaxPpm = J->Ppm;
+            }
+        }
+        if (!job_ok(J)) {
+            if (job_known_failure(J)) {
+                Known++;
+            } else {
+                Failed++;
+            }
+        }
+    }
+
+    fprintf(stderr, "#clkplan_summary,chip,pairs,failed,known,unsolved,vco_fail,pfd_fail,max_ppm,"
+                    "mean_us,max_us,wall_ms,threads\n");
+    fprintf(stderr, "clkplan_summary,%s,%d,%d,%d,%d,%d,%d,%.6f,%.1f,%.1f,%.1f,%d\n",
+            Chips[Chip].Name, NumJobs, Failed, Known, Unsolved, VcoFail, PfdFail, MaxPpm, NumJobs ? SumUs / NumJobs : 0, MaxUs,
+            WallMs, Threads);
+    return Failed;
+}
+
+static void usage(const char *Prog) {
+    fprintf(stderr, "usage: %s [-j threads] [-p ppm] [-r fmin:fmax:step] idt|si5324|sweep [idt|si5324]\n",
+            Prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    unsigned long RangeMin = 0;
+    unsigned long RangeMax = 0;
+    unsigned long RangeStep = 0;
+    int Threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int Failed = 0;
+    int Chip;
+    int Opt;
+
+    while ((Opt = getopt(argc, argv, "j:p:r:")) != -1) {
+        switch (Opt) {
+        case 'j':
+            Threads = atoi(optarg);
+            break;
+        case 'p':
+            PpmMax = atof(optarg);
+            break;
+        case 'r':
+            if (sscanf(optarg, "%lu:%lu:%lu", &RangeMin, &RangeMax, &RangeStep) != 3 || RangeStep == 0) {
+                usage(argv[0]);
+            }
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if (Threads < 1) {
+        Threads = 1;
+    }
+    if (Threads > MAX_THREADS) {
+        Threads = MAX_THREADS;
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+    }
+
+    if (strcmp(argv[optind], "sweep") == 0) {
+        for (Chip = 0; Chip < CHIPS; Chip++) {
+            if (optind + 1 < argc && strcmp(argv[optind + 1], Chips[Chip].Name) != 0) {
+                continue;
+            }
+            add_pairs(&Chips[Chip], RangeMin, RangeMax, RangeStep);
+            Failed += sweep(Chip, Threads, Chip == 0 || optind + 1 < argc);
+        }
+        return Failed ? 1 : 0;
+    }
+
+    for (Chip = 0; Chip < CHIPS; Chip++) {
+        if (strcmp(argv[optind], Chips[Chip].Name) == 0) {
+            break;
+        }
+    }
+    if (Chip == CHIPS) {
+        usage(argv[0]);
+    }
+    add_pairs(&Chips[Chip], RangeMin, RangeMax, RangeStep);
+    run(Chip, Threads);
+    if (Chip == CHIP_IDT) {
+        table_idt();
+    } else {
+        table_si5324();
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Checks the frequency plan tables against the solvers and times a mode
+// switch's settings lookup with and without them:
+// - every table entry equals what the solver gives now (tables not stale),
+// - a measured reference clock a little off the nominal rate hits the table
+//   and gets the nominal rate's settings,
+// - other pairs are solved once, then come from the LRU until evicted.
+//
+//   gcc -O2 -Wall -Wno-maybe-uninitialized -I../../Interface_realeted/IIC/c_code/host_sim
+//       -I. -include xil_printf.h clk_plan.c iic_bus.c iic_regcache.c idt_8t49n24x.c si5324drv.c
+//       ../../Interface_realeted/IIC/c_code/host_sim/sim_iic.c
+//       ../../Interface_realeted/IIC/c_code/host_sim/sim_iic_devs.c
+//       host_sim/clk_plan_host.c -o clk_plan_host
+//   ./clk_plan_host
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "xil_types.h"
+#include "xstatus.h"
+#include "idt_8t49n24x.h"
+#include "si5324drv.h"
+#include "idt_8t49n24x_plans.h"
+#include "si5324_plans.h"
+
+#define ROUNDS                  20
+
+static double now_us(void) {
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &Ts);
+    return Ts.tv_sec * 1e6 + Ts.tv_nsec / 1e3;
+}
+
+static int si5324_same(const si5324_plan_t *Plan, u32 FIn, u32 FOut, int Solve) {
+    si5324_plan_t Got;
+    int Status;
+
+    if (Solve) {
+        Status = Si5324_CalcFreqSettings(FIn, FOut, &Got.N1_hs, &Got.NCn_ls, &Got.N2_hs,
+                                         &Got.N2_ls, &Got.N3n, &Got.BwSel);
+    } else {
+        Status = Si5324_GetFreqSettings(FIn, FOut, &Got.N1_hs, &Got.NCn_ls, &Got.N2_hs,
+                                        &Got.N2_ls, &Got.N3n, &Got.BwSel);
+    }
+    return Status == SI5324_SUCCESS && Got.N1_hs == Plan->N1_hs && Got.NCn_ls == Plan->NCn_ls &&
+           Got.N2_hs == Plan->N2_hs && Got.N2_ls == Plan->N2_ls && Got.N3n == Plan->N3n &&
+           Got.BwSel == Plan->BwSel;
+}
+
+int main(void) {
+    const int IdtCount = sizeof(IDT_8T49N24x_Plans) / sizeof(IDT_8T49N24x_Plans[0]);
+    const int SiCount = sizeof(Si5324_Plans) / sizeof(Si5324_Plans[0]);
+    IDT_8T49N24x_Settings S;
+    si5324_plan_t Plan;
+    double Start;
+    double SolveUs;
+    double LookupUs;
+    int Failed = 0;
+    int r;
+    int i;
+
+    for (i = 0; i < IdtCount; i++) {
+        IDT_8T49N24x_CalculateSettings(IDT_8T49N24x_Plans[i].Key.FIn, IDT_8T49N24x_Plans[i].Key.FOut, &S);
+        if (memcmp(&S, &IDT_8T49N24x_Plans[i].Settings, sizeof(S)) != 0) {
+            printf("idt %u -> %u: table differs from the solver\n", IDT_8T49N24x_Plans[i].Key.FIn,
+                   IDT_8T49N24x_Plans[i].Key.FOut);
+            Failed = 1;
+        }
+    }
+    for (i = 0; i < SiCount; i++) {
+        if (!si5324_same(&Si5324_Plans[i], Si5324_Plans[i].Key.FIn, Si5324_Plans[i].Key.FOut, TRUE)) {
+            printf("si5324 %u -> %u: table differs from the solver\n", Si5324_Plans[i].Key.FIn,
+                   Si5324_Plans[i].Key.FOut);
+            Failed = 1;
+        }
+    }
+    printf("tables: idt %d plans, si5324 %d plans\n", IdtCount, SiCount);
+
+    // Mode switches through every standard pair: solver against lookup
+    Start = now_us();
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < SiCount; i++) {
+            si5324_same(&Si5324_Plans[i], Si5324_Plans[i].Key.FIn, Si5324_Plans[i].Key.FOut, TRUE);
+        }
+    }
+    SolveUs = (now_us() - Start) / (ROUNDS * SiCount);
+    Start = now_us();
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < SiCount; i++) {
+            Failed |= !si5324_same(&Si5324_Plans[i], Si5324_Plans[i].Key.FIn, Si5324_Plans[i].Key.FOut, FALSE);
+        }
+    }
+    LookupUs = (now_us() - Start) / (ROUNDS * SiCount);
+    printf("si5324 per switch: solve %.3f us, lookup %.3f us\n", SolveUs, LookupUs);
+
+    // 148.5 MHz measured 120 ppm high, locked 1:1; settings of 148.5 MHz
+    for (i = 0; i < SiCount; i++) {
+        if (Si5324_Plans[i].Key.FIn == 148500000 && Si5324_Plans[i].Key.FOut == 148500000) {
+            break;
+        }
+    }
+    Failed |= i == SiCount || !si5324_same(&Si5324_Plans[i], 148517820, 148517820, FALSE);
+
+    // Not in the table: solved once, then an LRU hit
+    Plan.Key.FIn = 0;
+    Failed |= Si5324_CalcFreqSettings(100000000, 125000000, &Plan.N1_hs, &Plan.NCn_ls, &Plan.N2_hs,
+                                      &Plan.N2_ls, &Plan.N3n, &Plan.BwSel) != SI5324_SUCCESS;
+    for (r = 0; r < 3; r++) {
+        Failed |= !si5324_same(&Plan, 100000000, 125000000, FALSE);
+    }
+    // SI5324_PLAN_LRU other pairs push it out, it is solved again
+    for (r = 0; r < SI5324_PLAN_LRU; r++) {
+        Failed |= Si5324_GetFreqSettings(10000000 + r * 1000000, 125000000, &Plan.N1_hs, &Plan.NCn_ls,
+                                         &Plan.N2_hs, &Plan.N2_ls, &Plan.N3n, &Plan.BwSel) != SI5324_SUCCESS;
+    }
+    Failed |= Si5324_GetFreqSettings(100000000, 125000000, &Plan.N1_hs, &Plan.NCn_ls, &Plan.N2_hs,
+                                     &Plan.N2_ls, &Plan.N3n, &Plan.BwSel) != SI5324_SUCCESS;
+
+    // Expected: ROUNDS * table + 1 table hits, 2 LRU hits, 1 + 8 + 1 solved
+    Si5324_PlanReport();
+
+    printf(Failed ? "FAIL\n" : "PASS\n");
+    return Failed ? 1 : 0;
+}
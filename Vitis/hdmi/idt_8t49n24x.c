@@ -28,6 +28,10 @@
 /***************************** Include Files *********************************/
 #include "idt_8t49n24x.h"
 #include "xiic.h"
+#include "iic_bus.h"
+#include "iic_regcache.h"
+#include "clk_plan.h"
+#include "idt_8t49n24x_plans.h"
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xstatus.h"
@@ -35,6 +39,7 @@
 
 /************************** Constant Definitions *****************************/
 #define IDT_8T49N24X_ADV_FUNC_EN 0 /* Enable unused APIs */
+#define IDT_8T49N24X_CACHE_REGS  256 /* Shadowed registers 0x000 - 0x0ff */
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -43,6 +48,10 @@
 /************************** Function Prototypes ******************************/
 
 /************************** Variable Definitions *****************************/
+static IicBusClient IdtClient;
+static IicRegCache IdtCache;
+static ClkPlanCache IdtPlans;
+static IDT_8T49N24x_Plan IdtPlanLru[IDT_8T49N24X_PLAN_LRU];
 
 /************************** Function Definitions *****************************/
 static u8 IDT_8T49N24x_GetRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
@@ -69,7 +78,7 @@ static int IDT_8T49N24x_OutputDividerFractional(u32 I2CBaseAddress,
 static int IDT_8T49N24x_Mode(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 							u8 Synthesizer);
 static int IDT_8T49N24x_GetIntDivTable(int FOut, int *DivTable, u8 Bypass);
-static int IDT_8T49N24x_CalculateSettings(int FIn, int FOut,
+static int IDT_8T49N24x_GetSettings(int FIn, int FOut,
 							IDT_8T49N24x_Settings* RegSettings);
 static int IDT_8T49N24x_Enable(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 							u8 Enable);
@@ -85,6 +94,84 @@ static int IDT_8T49N24x_SelectInputReference(u32 I2CBaseAddress,
 							u8 I2CSlaveAddress, u8 Input);
 static int IDT_8T49N24x_Configure(u32 I2CBaseAddress, u8 I2CSlaveAddress);
 #endif
+
+/*****************************************************************************/
+/**
+*
+* This function returns the IIC bus manager client of the IDT 8T49N24x
+*
+* @param I2CBaseAddress is the baseaddress of the I2C core.
+* @param I2CSlaveAddress is the 7-bit I2C slave address.
+*
+* @return The client, set up on first use.
+*
+* @note The shadow register cache is set up (empty) along with it.
+*
+******************************************************************************/
+static IicBusClient *IDT_8T49N24x_Client(u32 I2CBaseAddress, u8 I2CSlaveAddress)
+{
+	if ((IdtClient.Bus == NULL) ||
+	    (IdtClient.Bus->BaseAddress != I2CBaseAddress) ||
+	    (IdtClient.Addr != I2CSlaveAddress)) {
+		iic_bus_client_init(&IdtClient, iic_bus_get(I2CBaseAddress),
+							"idt_8t49n24x", I2CSlaveAddress, IIC_BUS_ROOT);
+		/* The device steps the register address within a transfer */
+		iic_regcache_init(&IdtCache, &IdtClient, IDT_8T49N24X_CACHE_REGS,
+							2, TRUE);
+	}
+
+	return &IdtClient;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the shadow register cache of the IDT 8T49N24x
+*
+* @param I2CBaseAddress is the baseaddress of the I2C core.
+* @param I2CSlaveAddress is the 7-bit I2C slave address.
+*
+* @return The cache, set up on first use.
+*
+* @note None.
+*
+******************************************************************************/
+static IicRegCache *IDT_8T49N24x_Cache(u32 I2CBaseAddress, u8 I2CSlaveAddress)
+{
+	IDT_8T49N24x_Client(I2CBaseAddress, I2CSlaveAddress);
+
+	return &IdtCache;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function writes all deferred register updates to the IDT 8T49N24x
+*
+* @param I2CBaseAddress is the baseaddress of the I2C core.
+* @param I2CSlaveAddress is the 7-bit I2C slave address.
+*
+* @return
+*    - XST_SUCCESS
+*    - XST_FAILURE I2C write error.
+*
+* @note Contiguous registers are written in one burst.
+*
+******************************************************************************/
+static int IDT_8T49N24x_Flush(u32 I2CBaseAddress, u8 I2CSlaveAddress)
+{
+	int Result;
+
+	Result = iic_regcache_flush(IDT_8T49N24x_Cache(I2CBaseAddress,
+							I2CSlaveAddress));
+#ifdef versal
+	/* This delay prevents IIC access from hanging */
+	usleep(500);
+#endif
+
+	return (Result == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+}
+
 /*****************************************************************************/
 /**
 *
@@ -103,54 +190,23 @@ static int IDT_8T49N24x_Configure(u32 I2CBaseAddress, u8 I2CSlaveAddress);
 static u8 IDT_8T49N24x_GetRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 							u16 RegisterAddress)
 {
-	u32 ByteCount = 0;
 	u8 Buffer[2];
-	u8 Data;
-	u8 Retry = 0;
-	u8 Exit;
-
 
-	Exit = FALSE;
-	Data = 0;
-
-	do {
-		/* Set Address */
-		Buffer[0] = (RegisterAddress >> 8);
-		Buffer[1] = RegisterAddress & 0xff;
-		ByteCount = XIic_Send(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer,
-							2, XIIC_REPEATED_START);
+	/* Set Address, then read data after a repeated start.
+	 * NACKs are retried by the bus manager. */
+	Buffer[0] = (RegisterAddress >> 8);
+	Buffer[1] = RegisterAddress & 0xff;
+	if (iic_bus_transfer(IDT_8T49N24x_Client(I2CBaseAddress, I2CSlaveAddress),
+						Buffer, 2, Buffer, 1) != XST_SUCCESS) {
+		return 0;
+	}
 
 #ifdef versal
-		/* This delay prevents IIC access from hanging */
-		usleep(500);
+	/* This delay prevents IIC access from hanging */
+	usleep(500);
 #endif
 
-		if (ByteCount != 2) {
-			Retry++;
-
-			/* Maximum retries */
-			if (Retry == 255) {
-				Exit = TRUE;
-			}
-		}
-
-		/* Read data */
-		else {
-			/* Read data */
-			ByteCount = XIic_Recv(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer,
-							1, XIIC_STOP);
-			if (ByteCount != 1) {
-				Exit = FALSE;
-			}
-
-			else {
-				Data = Buffer[0];
-				Exit = TRUE;
-			}
-		}
-	} while (!Exit);
-
-	return Data;
+	return Buffer[0];
 }
 
 /*****************************************************************************/
@@ -165,42 +221,33 @@ static u8 IDT_8T49N24x_GetRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 *    - XST_SUCCESS Initialization was successful.
 *    - XST_FAILURE I2C write error.
 *
-* @note None.
+* @note The write goes through the shadow register cache: it is dropped
+*       when the register already holds Value, and only marks the register
+*       dirty while writes are deferred.
 *
 ******************************************************************************/
 static int IDT_8T49N24x_SetRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 							u16 RegisterAddress, u8 Value)
 {
-	u32 ByteCount = 0;
-	u8 Buffer[3];
-	u8 Retry = 0;
+	IicRegCache *Cache;
+#ifdef versal
+	u32 Transfers;
+#endif
+	int Result;
 
 	/* Write data */
-	Buffer[0] = (RegisterAddress >> 8);
-	Buffer[1] = RegisterAddress & 0xff;
-	Buffer[2] = Value;
-
-	while (1) {
-		ByteCount = XIic_Send(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer,
-							3, XIIC_STOP);
+	Cache = IDT_8T49N24x_Cache(I2CBaseAddress, I2CSlaveAddress);
+#ifdef versal
+	Transfers = Cache->Transfers;
+#endif
+	Result = iic_regcache_write(Cache, RegisterAddress, Value);
 #ifdef versal
-		/* This delay prevents IIC access from hanging */
+	/* This delay prevents IIC access from hanging */
+	if (Cache->Transfers != Transfers)
 		usleep(500);
 #endif
 
-		if (ByteCount != 3) {
-			Retry++;
-
-			/* Maximum retries */
-			if (Retry == 255) {
-				return XST_FAILURE;
-			}
-		}
-
-		else {
-			return XST_SUCCESS;
-		}
-	}
+	return (Result == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
 }
 
 /*****************************************************************************/
@@ -215,30 +262,32 @@ static int IDT_8T49N24x_SetRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 *    - XST_SUCCESS Initialization was successful.
 *    - XST_FAILURE I2C write error.
 *
-* @note None.
+* @note The register is only read from the device when the shadow register
+*       cache does not know it yet; the bus is then kept up to the write.
 *
 ******************************************************************************/
 static int IDT_8T49N24x_ModifyRegister(u32 I2CBaseAddress, u8 I2CSlaveAddress,
 							u16 RegisterAddress, u8 Value, u8 Mask)
 {
-	u8 Data;
+	IicRegCache *Cache;
+#ifdef versal
+	u32 Transfers;
+#endif
 	int Result;
 
-	/* Read data */
-	Data = IDT_8T49N24x_GetRegister(I2CBaseAddress, I2CSlaveAddress,
-							RegisterAddress);
-
-	/* Clear masked bits */
-	Data &= ~Mask;
-
-	/* Update */
-	Data |= (Value & Mask);
-
-	/* Write data */
-	Result = IDT_8T49N24x_SetRegister(I2CBaseAddress, I2CSlaveAddress,
-							RegisterAddress, Data);
+	/* Read, clear masked bits, update and write */
+	Cache = IDT_8T49N24x_Cache(I2CBaseAddress, I2CSlaveAddress);
+#ifdef versal
+	Transfers = Cache->Transfers;
+#endif
+	Result = iic_regcache_modify(Cache, RegisterAddress, Value, Mask);
+#ifdef versal
+	/* This delay prevents IIC access from hanging */
+	if (Cache->Transfers != Transfers)
+		usleep(500);
+#endif
 
-	return Result;
+	return (Result == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
 }
 
 /*****************************************************************************/
@@ -391,7 +440,7 @@ static int IDT_8T49N24x_GetIntDivTable(int FOut, int *DivTable, u8 Bypass)
 * @note None.
 *
 ******************************************************************************/
-static int IDT_8T49N24x_CalculateSettings(int FIn, int FOut,
+int IDT_8T49N24x_CalculateSettings(int FIn, int FOut,
 							IDT_8T49N24x_Settings* RegSettings)
 {
 	int DivTable[20];
@@ -613,6 +662,69 @@ static int IDT_8T49N24x_CalculateSettings(int FIn, int FOut,
 	return XST_SUCCESS;
 }
 
+/*****************************************************************************/
+/**
+*
+* This function returns the settings for the given frequencies. The standard
+* HDMI clocks are looked up in IDT_8T49N24x_Plans, other pairs are solved
+* once with IDT_8T49N24x_CalculateSettings and kept in a small LRU.
+*
+* @param FIn specifies the input frequency.
+* @param FOut specifies the output frequency.
+* @param RegSettings receives the settings.
+*
+* @return
+*    - XST_SUCCESS Settings found or calculated.
+*    - XST_FAILURE The calculation failed.
+*
+* @note None.
+*
+******************************************************************************/
+static int IDT_8T49N24x_GetSettings(int FIn, int FOut,
+							IDT_8T49N24x_Settings* RegSettings)
+{
+	const IDT_8T49N24x_Plan *Plan;
+	IDT_8T49N24x_Plan Solved;
+
+	if (IdtPlans.EntrySize == 0) {
+		clk_plan_init(&IdtPlans, IDT_8T49N24x_Plans,
+				sizeof(IDT_8T49N24x_Plans)/sizeof(IDT_8T49N24x_Plan),
+				IdtPlanLru, IDT_8T49N24X_PLAN_LRU, sizeof(IDT_8T49N24x_Plan));
+	}
+
+	Plan = clk_plan_find(&IdtPlans, FIn, FOut);
+	if (Plan != NULL) {
+		*RegSettings = Plan->Settings;
+		return XST_SUCCESS;
+	}
+
+	if (IDT_8T49N24x_CalculateSettings(FIn, FOut, &Solved.Settings) !=
+			XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	Solved.Key.FIn = FIn;
+	Solved.Key.FOut = FOut;
+	clk_plan_store(&IdtPlans, &Solved);
+	*RegSettings = Solved.Settings;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function prints the plan table hits, LRU hits and solver runs.
+*
+* @return None.
+*
+* @note None.
+*
+******************************************************************************/
+void IDT_8T49N24x_PlanReport(void)
+{
+	clk_plan_report(&IdtPlans, "idt_8t49n24x");
+}
+
 /*****************************************************************************/
 /**
 *
@@ -651,12 +763,18 @@ int IDT_8T49N24x_SetClock(u32 I2CBaseAddress, u8 I2CSlaveAddress, int FIn,
 
 	IDT_8T49N24x_Settings RegSettings;
 
-	/* Calculate settings */
-	IDT_8T49N24x_CalculateSettings(FIn, FOut, &RegSettings);
+	/* Calculate settings, a table hit for the standard HDMI clocks */
+	if (IDT_8T49N24x_GetSettings(FIn, FOut, &RegSettings) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
 	/* Disable DPLL and APLL calibration */
 	Result |= IDT_8T49N24x_Enable(I2CBaseAddress, I2CSlaveAddress, FALSE);
 
+	/* Collect the settings in the shadow, the PLLs are held off until
+	 * they are flushed */
+	iic_regcache_defer(IDT_8T49N24x_Cache(I2CBaseAddress, I2CSlaveAddress));
+
 	/* Mode */
 	if (FreeRun == TRUE) {
 		/* Disable reference clock input 0 */
@@ -732,6 +850,9 @@ int IDT_8T49N24x_SetClock(u32 I2CBaseAddress, u8 I2CSlaveAddress, int FIn,
 	Result |= IDT_8T49N24x_InputMonitorControl(I2CBaseAddress, I2CSlaveAddress,
 							RegSettings.LOS_x, 1);
 
+	/* Write the changed registers */
+	Result |= IDT_8T49N24x_Flush(I2CBaseAddress, I2CSlaveAddress);
+
 	/* Enable DPLL and APLL calibration */
 	Result |= IDT_8T49N24x_Enable(I2CBaseAddress, I2CSlaveAddress, TRUE);
 
@@ -1216,6 +1337,10 @@ int IDT_8T49N24x_Init(u32 I2CBaseAddress, u8 I2CSlaveAddress)
 
 	if (Result == XST_SUCCESS) {
 
+		/* Forget the register values of before a reset */
+		iic_regcache_invalidate(IDT_8T49N24x_Cache(I2CBaseAddress,
+							I2CSlaveAddress));
+
 		/* Disable DPLL and APLL calibration
 		 * The i2c interface is clocked by the APLL.
 		 * During the PLL parameters update, the i2c might become unresponsive.
@@ -1238,18 +1363,24 @@ int IDT_8T49N24x_Init(u32 I2CBaseAddress, u8 I2CSlaveAddress)
 
 static int IDT_8T49N24x_Configure_JA(u32 I2CBaseAddress, u8 I2CSlaveAddress)
 {
-	int Result;
+	int Result = XST_SUCCESS;
 	u32 Index;
 
+	/* Fill the shadow, then write it in bursts */
+	iic_regcache_defer(IDT_8T49N24x_Cache(I2CBaseAddress, I2CSlaveAddress));
+
 	/* The configuration is started from address 0x08 */
 	for (Index=8; Index<sizeof(IDT_8T49N24x_Config_JA); Index++) {
 		/* Skip address 0x70 */
 		/* Address 0x70 enables the DPLL and APLL calibration */
 		if (Index != 0x070) {
-			Result = IDT_8T49N24x_SetRegister(I2CBaseAddress, I2CSlaveAddress,
+			Result |= IDT_8T49N24x_SetRegister(I2CBaseAddress, I2CSlaveAddress,
 							Index, IDT_8T49N24x_Config_JA[Index]);
 		}
 	}
+
+	Result |= IDT_8T49N24x_Flush(I2CBaseAddress, I2CSlaveAddress);
+
 	return Result;
 }
 
@@ -1307,6 +1438,36 @@ void IDT_8T49N24x_RegisterDump(u32 I2CBaseAddress, u8 I2CSlaveAddress)
 	}
 }
 
+/*****************************************************************************/
+/**
+*
+* This function compares the shadow registers with the IDT 8TN49N24x
+* device and displays the shadow.
+*
+* @param I2CBaseAddress is the baseaddress of the I2C core.
+* @param I2CSlaveAddress is the 7-bit I2C slave address.
+*
+* @return
+*    - XST_SUCCESS All known registers match the device.
+*    - XST_FAILURE Mismatch or I2C error, mismatches are printed.
+*
+* @note None.
+*
+******************************************************************************/
+int IDT_8T49N24x_RegisterVerify(u32 I2CBaseAddress, u8 I2CSlaveAddress)
+{
+	IicRegCache *Cache;
+	int Result;
+
+	Cache = IDT_8T49N24x_Cache(I2CBaseAddress, I2CSlaveAddress);
+	iic_regcache_dump(Cache);
+
+	Result = iic_regcache_verify(Cache, 0, IDT_8T49N24X_CACHE_REGS);
+	iic_regcache_report(Cache);
+
+	return (Result == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+}
+
 #if (IDT_8T49N24X_ADV_FUNC_EN == 1)
 /*****************************************************************************/
 /**
@@ -1527,37 +1688,10 @@ int IDT_8T49N24x_SetGPOut(u32 I2CBaseAddress, u8 I2CSlaveAddress, u8 PortID,
 		return XST_FAILURE;
 	}
 
-	u32 ByteCount = 0;
-	u8 Data = 0;
-	u8 Buffer[3];
-
-	Buffer[0] = 0x00; /* MSB RegAddr */
-	Buffer[1] = 0x38; /* LSB RegAddr */
-	ByteCount = XIic_Send(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer, 2,
-							XIIC_REPEATED_START);
-	if (ByteCount != 2) {
-		return XST_FAILURE;
-	}
-	ByteCount = XIic_Recv(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer, 1,
-							XIIC_STOP);
-	if (ByteCount != 1) {
-		return XST_FAILURE;
-	}
-	Data = Buffer[0];
-
-	if (Set == TRUE) {
-		Data |= (1<<PortID);
-	}
-	else {
-		Data &= ~(1<<PortID);
-	}
-
-	Buffer[0] = 0x00; /* MSB RegAddr */
-	Buffer[1] = 0x38; /* LSB RegAddr */
-	Buffer[2] = Data;
-	ByteCount = XIic_Send(I2CBaseAddress, I2CSlaveAddress, (u8*)Buffer, 3,
-							XIIC_STOP);
-	if (ByteCount != 3) {
+	/* Through the shadow, the output state is usually known */
+	if (IDT_8T49N24x_ModifyRegister(I2CBaseAddress, I2CSlaveAddress, 0x0038,
+							(Set == TRUE) ? (1<<PortID) : 0,
+							(1<<PortID)) != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
@@ -34,6 +34,7 @@ extern "C" {
 
 /***************************** Include Files *********************************/
 #include "xil_types.h"
+#include "clk_plan.h"
 
 /************************** Constant Definitions *****************************/
 #define IDT_8T49N24X_REVID 0x0    		 //!< Device Revision
@@ -54,6 +55,8 @@ extern "C" {
 #define IDT_8T49N24X_FPD_MAX 128000      //!< Max Phase Detector Freq in Hz
 #define IDT_8T49N24X_FPD_MIN   8000      //!< Min Phase Detector Freq in Hz
 
+#define IDT_8T49N24X_PLAN_LRU 8 //!< Solved plans kept besides the table
+
 #define IDT_8T49N24X_P_MAX 4194304  /* pow(2,22) */  //!< Max P div value
 #define IDT_8T49N24X_M_MAX 16777216 /* pow(2,24) */  //!< Max M mult value
 
@@ -120,6 +123,12 @@ typedef struct {
 
 } IDT_8T49N24x_Settings;
 
+/* Settings for one (FIn, FOut) pair, see clk_plan.h */
+typedef struct {
+	ClkPlanKey Key;
+	IDT_8T49N24x_Settings Settings;
+} IDT_8T49N24x_Plan;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
@@ -128,6 +137,10 @@ int IDT_8T49N24x_Init(u32 I2CBaseAddress, u8 I2CSlaveAddress);
 int IDT_8T49N24x_SetClock(u32 I2CBaseAddress, u8 I2CSlaveAddress, int FIn,
 							int FOut, u8 FreeRun);
 void IDT_8T49N24x_RegisterDump(u32 I2CBaseAddress, u8 I2CSlaveAddress);
+int IDT_8T49N24x_RegisterVerify(u32 I2CBaseAddress, u8 I2CSlaveAddress);
+int IDT_8T49N24x_CalculateSettings(int FIn, int FOut,
+							IDT_8T49N24x_Settings* RegSettings);
+void IDT_8T49N24x_PlanReport(void);
 
 /************************** Variable Declarations ****************************/
 
@@ -0,0 +1,156 @@
+/*
+ * Generated by host_sim/clk_plan_gen.c (idt), do not edit.
+ * 149 plans solved with IDT_8T49N24x_CalculateSettings, sorted by FIn, FOut.
+ */
+static const IDT_8T49N24x_Plan IDT_8T49N24x_Plans[] = {
+	/* FIn, FOut, NS1_Qx, NS2_Qx, N_Qx, NFRAC_Qx, DSM_INT, DSM_FRAC, M1_x, PRE_x, LOS_x */
+	{ {  25174825,  25174825 }, { 1, 13, 78, 0, 49, 190649, 30576, 196, 22 } },
+	{ {  25200000,  25200000 }, { 1, 13, 78, 0, 49, 293601, 30576, 196, 22 } },
+	{ {  26973026,  26973026 }, { 1, 12, 72, 0, 48, 1156468, 30240, 210, 21 } },
+	{ {  27000000,  27000000 }, { 1, 12, 72, 0, 48, 1258291, 30240, 210, 21 } },
+	{ {  31468531,  31468531 }, { 1, 10, 60, 0, 47, 425295, 29400, 245, 18 } },
+	{ {  31500000,  31500000 }, { 1, 10, 60, 0, 47, 524288, 29520, 246, 18 } },
+	{ {  33716282,  33716282 }, { 2, 14, 56, 0, 47, 425292, 29456, 263, 17 } },
+	{ {  33750000,  33750000 }, { 2, 14, 56, 0, 47, 524288, 29456, 263, 17 } },
+	{ {  35500000,  35500000 }, { 2, 14, 56, 0, 49, 1468006, 31024, 277, 17 } },
+	{ {  36000000,  36000000 }, { 0, 11, 55, 0, 49, 1048576, 30910, 281, 16 } },
+	{ {  37762237,  37762237 }, { 2, 13, 52, 0, 49, 190648, 30680, 295, 16 } },
+	{ {  37800000,  37800000 }, { 2, 13, 52, 0, 49, 293601, 30680, 295, 16 } },
+	{ {  40000000,  25174825 }, { 1, 13, 78, 0, 49, 190649, 13071829, 133139, 15 } },
+	{ {  40000000,  25200000 }, { 1, 13, 78, 0, 49, 293601, 31941, 325, 15 } },
+	{ {  40000000,  26973026 }, { 1, 12, 72, 0, 48, 1156468, 3211484, 33073, 15 } },
+	{ {  40000000,  27000000 }, { 1, 12, 72, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000,  31468531 }, { 1, 10, 60, 0, 47, 425295, 4229937, 44806, 14 } },
+	{ {  40000000,  31500000 }, { 1, 10, 60, 0, 47, 524288, 29484, 312, 14 } },
+	{ {  40000000,  33716282 }, { 2, 14, 56, 0, 47, 425292, 1648416, 17461, 14 } },
+	{ {  40000000,  33750000 }, { 2, 14, 56, 0, 47, 524288, 29484, 312, 14 } },
+	{ {  40000000,  35500000 }, { 2, 14, 56, 0, 49, 1468006, 31311, 315, 15 } },
+	{ {  40000000,  36000000 }, { 0, 11, 55, 0, 49, 1048576, 30888, 312, 15 } },
+	{ {  40000000,  37762237 }, { 2, 13, 52, 0, 49, 190648, 4502029, 45854, 15 } },
+	{ {  40000000,  37800000 }, { 2, 13, 52, 0, 49, 293601, 31941, 325, 15 } },
+	{ {  40000000,  40000000 }, { 0, 10, 50, 0, 50, 0, 31200, 312, 15 } },
+	{ {  40000000,  40459539 }, { 1, 8, 48, 0, 48, 1156468, 3211484, 33073, 15 } },
+	{ {  40000000,  40500000 }, { 1, 8, 48, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000,  49500000 }, { 0, 8, 40, 0, 49, 1048576, 30888, 312, 15 } },
+	{ {  40000000,  50000000 }, { 0, 8, 40, 0, 50, 0, 31200, 312, 15 } },
+	{ {  40000000,  50349650 }, { 1, 6, 36, 0, 45, 659942, 1008433, 11127, 14 } },
+	{ {  40000000,  50400000 }, { 1, 6, 36, 0, 45, 754975, 29484, 325, 14 } },
+	{ {  40000000,  53946052 }, { 1, 6, 36, 0, 48, 1156468, 3211484, 33073, 15 } },
+	{ {  40000000,  53946053 }, { 1, 6, 36, 0, 48, 1156470, 3930531, 40478, 15 } },
+	{ {  40000000,  54000000 }, { 1, 6, 36, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000,  56250000 }, { 0, 7, 35, 0, 49, 458752, 31500, 320, 15 } },
+	{ {  40000000,  65000000 }, { 1, 5, 30, 0, 48, 1572864, 30420, 312, 15 } },
+	{ {  40000000,  67432566 }, { 2, 7, 28, 0, 47, 425294, 2633444, 27895, 14 } },
+	{ {  40000000,  67500000 }, { 2, 7, 28, 0, 47, 524288, 29484, 312, 14 } },
+	{ {  40000000,  68250000 }, { 2, 7, 28, 0, 47, 1625293, 30576, 320, 14 } },
+	{ {  40000000,  71000000 }, { 2, 7, 28, 0, 49, 1468006, 31311, 315, 15 } },
+	{ {  40000000,  74175824 }, { 0, 5, 25, 0, 46, 754744, 2309557, 24909, 14 } },
+	{ {  40000000,  74250000 }, { 0, 5, 25, 0, 46, 851968, 29700, 320, 14 } },
+	{ {  40000000,  75000000 }, { 0, 5, 25, 0, 46, 1835008, 29250, 312, 14 } },
+	{ {  40000000,  78750000 }, { 0, 5, 25, 0, 49, 458752, 31500, 320, 15 } },
+	{ {  40000000,  79500000 }, { 0, 5, 25, 0, 49, 1441792, 31005, 312, 15 } },
+	{ {  40000000,  80919079 }, { 1, 4, 24, 0, 48, 1156469, 2401743, 24734, 15 } },
+	{ {  40000000,  81000000 }, { 1, 4, 24, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000,  83500000 }, { 0, 4, 20, 0, 41, 1572864, 26052, 312, 13 } },
+	{ {  40000000,  85500000 }, { 0, 4, 20, 0, 42, 1572864, 26676, 312, 13 } },
+	{ {  40000000,  88750000 }, { 0, 4, 20, 0, 44, 786432, 27690, 312, 14 } },
+	{ {  40000000,  92719780 }, { 0, 4, 20, 0, 46, 754744, 2309557, 24909, 14 } },
+	{ {  40000000,  92812500 }, { 0, 4, 20, 0, 46, 851968, 29700, 320, 14 } },
+	{ {  40000000,  94500000 }, { 0, 4, 20, 0, 47, 524288, 29484, 312, 14 } },
+	{ {  40000000, 101000000 }, { 1, 3, 18, 0, 45, 943718, 29088, 320, 14 } },
+	{ {  40000000, 106500000 }, { 1, 3, 18, 0, 47, 1939866, 30672, 320, 14 } },
+	{ {  40000000, 107892106 }, { 1, 3, 18, 0, 48, 1156470, 3930531, 40478, 15 } },
+	{ {  40000000, 107892107 }, { 1, 3, 18, 0, 48, 1156471, 1813785, 18679, 15 } },
+	{ {  40000000, 108000000 }, { 1, 3, 18, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000, 111263736 }, { 2, 4, 16, 0, 44, 1060099, 4617089, 51871, 14 } },
+	{ {  40000000, 111375000 }, { 2, 4, 16, 0, 44, 1153434, 28512, 320, 14 } },
+	{ {  40000000, 119000000 }, { 2, 4, 16, 0, 47, 1258291, 29988, 315, 14 } },
+	{ {  40000000, 121750000 }, { 2, 4, 16, 0, 48, 1468006, 30681, 315, 15 } },
+	{ {  40000000, 134865133 }, { 1, 2, 12, 0, 40, 963725, 2310968, 28559, 13 } },
+	{ {  40000000, 135000000 }, { 1, 2, 12, 0, 40, 1048576, 25272, 312, 13 } },
+	{ {  40000000, 146250000 }, { 1, 2, 12, 0, 43, 1835008, 27378, 312, 13 } },
+	{ {  40000000, 148351648 }, { 1, 2, 12, 0, 44, 1060099, 4617089, 51871, 14 } },
+	{ {  40000000, 148500000 }, { 1, 2, 12, 0, 44, 1153434, 28512, 320, 14 } },
+	{ {  40000000, 154000000 }, { 1, 2, 12, 0, 46, 419430, 29106, 315, 14 } },
+	{ {  40000000, 156000000 }, { 1, 2, 12, 0, 46, 1677722, 29484, 315, 14 } },
+	{ {  40000000, 161838160 }, { 1, 2, 12, 0, 48, 1156470, 2813168, 28971, 15 } },
+	{ {  40000000, 162000000 }, { 1, 2, 12, 0, 48, 1258291, 30618, 315, 15 } },
+	{ {  40000000, 175500000 }, { 0, 2, 10, 0, 43, 1835008, 27378, 312, 13 } },
+	{ {  40000000, 185439560 }, { 0, 2, 10, 0, 46, 754744, 2309557, 24909, 14 } },
+	{ {  40000000, 185625000 }, { 0, 2, 10, 0, 46, 851968, 29700, 320, 14 } },
+	{ {  40000000, 187000000 }, { 0, 2, 10, 0, 46, 1572864, 29172, 312, 14 } },
+	{ {  40000000, 193250000 }, { 0, 2, 10, 0, 48, 655360, 30147, 312, 15 } },
+	{ {  40000000, 204750000 }, { 2, 2, 8, 0, 40, 1992294, 26208, 320, 13 } },
+	{ {  40000000, 215784214 }, { 2, 2, 8, 0, 43, 328923, 1569787, 18187, 13 } },
+	{ {  40000000, 216000000 }, { 2, 2, 8, 0, 43, 419430, 27216, 315, 13 } },
+	{ {  40000000, 222527472 }, { 2, 2, 8, 0, 44, 1060099, 4617089, 51871, 14 } },
+	{ {  40000000, 222750000 }, { 2, 2, 8, 0, 44, 1153434, 28512, 320, 14 } },
+	{ {  40000000, 234000000 }, { 2, 2, 8, 0, 46, 1677722, 29484, 315, 14 } },
+	{ {  40000000, 241500000 }, { 2, 2, 8, 0, 48, 629146, 30429, 315, 15 } },
+	{ {  40000000, 245250000 }, { 2, 2, 8, 0, 49, 104858, 31392, 320, 15 } },
+	{ {  40000000, 268250000 }, { 1, 1, 6, 0, 40, 498074, 25752, 320, 13 } },
+	{ {  40000000, 296703296 }, { 1, 1, 6, 0, 44, 1060099, 4617089, 51871, 14 } },
+	{ {  40000000, 297000000 }, { 1, 1, 6, 0, 44, 1153434, 28512, 320, 14 } },
+	{ {  40459539,  40459539 }, { 1, 8, 48, 0, 48, 1156468, 30336, 316, 15 } },
+	{ {  40500000,  40500000 }, { 1, 8, 48, 0, 48, 1258291, 30336, 316, 15 } },
+	{ {  49500000,  49500000 }, { 0, 8, 40, 0, 49, 1048576, 30880, 386, 13 } },
+	{ {  50000000,  50000000 }, { 0, 8, 40, 0, 50, 0, 31200, 390, 13 } },
+	{ {  50349650,  50349650 }, { 1, 6, 36, 0, 45, 659942, 28296, 393, 12 } },
+	{ {  50400000,  50400000 }, { 1, 6, 36, 0, 45, 754975, 28296, 393, 12 } },
+	{ {  53946052,  53946052 }, { 1, 6, 36, 0, 48, 1156468, 30312, 421, 12 } },
+	{ {  54000000,  54000000 }, { 1, 6, 36, 0, 48, 1258291, 30312, 421, 12 } },
+	{ {  56250000,  56250000 }, { 0, 7, 35, 0, 49, 458752, 30730, 439, 11 } },
+	{ {  65000000,  65000000 }, { 1, 5, 30, 0, 48, 1572864, 30420, 507, 10 } },
+	{ {  67432566,  67432566 }, { 2, 7, 28, 0, 47, 425294, 29456, 526, 10 } },
+	{ {  67500000,  67500000 }, { 2, 7, 28, 0, 47, 524288, 29512, 527, 10 } },
+	{ {  68250000,  68250000 }, { 2, 7, 28, 0, 47, 1625293, 29848, 533, 10 } },
+	{ {  71000000,  71000000 }, { 2, 7, 28, 0, 49, 1468006, 31024, 554, 10 } },
+	{ {  74175824,  74175824 }, { 0, 5, 25, 0, 46, 754744, 28950, 579, 9 } },
+	{ {  74250000,  74250000 }, { 0, 5, 25, 0, 46, 851968, 29000, 580, 9 } },
+	{ {  75000000,  75000000 }, { 0, 5, 25, 0, 46, 1835008, 29250, 585, 9 } },
+	{ {  78750000,  78750000 }, { 0, 5, 25, 0, 49, 458752, 30750, 615, 9 } },
+	{ {  79500000,  79500000 }, { 0, 5, 25, 0, 49, 1441792, 31050, 621, 9 } },
+	{ {  80919079,  80919079 }, { 1, 4, 24, 0, 48, 1156469, 30336, 632, 9 } },
+	{ {  81000000,  81000000 }, { 1, 4, 24, 0, 48, 1258291, 30336, 632, 9 } },
+	{ {  83500000,  83500000 }, { 0, 4, 20, 0, 41, 1572864, 26080, 652, 8 } },
+	{ {  85500000,  85500000 }, { 0, 4, 20, 0, 42, 1572864, 26680, 667, 8 } },
+	{ {  88750000,  88750000 }, { 0, 4, 20, 0, 44, 786432, 27720, 693, 8 } },
+	{ {  92719780,  92719780 }, { 0, 4, 20, 0, 46, 754744, 28960, 724, 8 } },
+	{ {  92719780, 370879120 }, { 0, 1, 5, 0, 46, 754744, 28960, 724, 8 } },
+	{ {  92812500,  92812500 }, { 0, 4, 20, 0, 46, 851968, 29000, 725, 8 } },
+	{ {  92812500, 371250000 }, { 0, 1, 5, 0, 46, 851968, 29000, 725, 8 } },
+	{ {  94500000,  94500000 }, { 0, 4, 20, 0, 47, 524288, 29520, 738, 8 } },
+	{ { 101000000, 101000000 }, { 1, 3, 18, 0, 45, 943718, 28404, 789, 7 } },
+	{ { 106500000, 106500000 }, { 1, 3, 18, 0, 47, 1939866, 29952, 832, 7 } },
+	{ { 107892106, 107892106 }, { 1, 3, 18, 0, 48, 1156470, 30312, 842, 7 } },
+	{ { 108000000, 108000000 }, { 1, 3, 18, 0, 48, 1258291, 30348, 843, 7 } },
+	{ { 111263736, 111263736 }, { 2, 4, 16, 0, 44, 1060099, 27808, 869, 7 } },
+	{ { 111375000, 111375000 }, { 2, 4, 16, 0, 44, 1153434, 27840, 870, 7 } },
+	{ { 119000000, 119000000 }, { 2, 4, 16, 0, 47, 1258291, 29728, 929, 7 } },
+	{ { 121750000, 121750000 }, { 2, 4, 16, 0, 48, 1468006, 30432, 951, 7 } },
+	{ { 134865133, 134865133 }, { 1, 2, 12, 0, 40, 963725, 25272, 1053, 6 } },
+	{ { 135000000, 135000000 }, { 1, 2, 12, 0, 40, 1048576, 25296, 1054, 6 } },
+	{ { 146250000, 146250000 }, { 1, 2, 12, 0, 43, 1835008, 27408, 1142, 6 } },
+	{ { 148351648, 148351648 }, { 1, 2, 12, 0, 44, 1060099, 27792, 1158, 6 } },
+	{ { 148500000, 148500000 }, { 1, 2, 12, 0, 44, 1153434, 27840, 1160, 6 } },
+	{ { 154000000, 154000000 }, { 1, 2, 12, 0, 46, 419430, 28872, 1203, 6 } },
+	{ { 156000000, 156000000 }, { 1, 2, 12, 0, 46, 1677722, 29232, 1218, 6 } },
+	{ { 161838160, 161838160 }, { 1, 2, 12, 0, 48, 1156470, 30336, 1264, 6 } },
+	{ { 162000000, 162000000 }, { 1, 2, 12, 0, 48, 1258291, 30360, 1265, 6 } },
+	{ { 175500000, 175500000 }, { 0, 2, 10, 0, 43, 1835008, 27420, 1371, 6 } },
+	{ { 185439560, 185439560 }, { 0, 2, 10, 0, 46, 754744, 28960, 1448, 6 } },
+	{ { 185625000, 185625000 }, { 0, 2, 10, 0, 46, 851968, 29000, 1450, 6 } },
+	{ { 187000000, 187000000 }, { 0, 2, 10, 0, 46, 1572864, 29200, 1460, 6 } },
+	{ { 193250000, 193250000 }, { 0, 2, 10, 0, 48, 655360, 30180, 1509, 6 } },
+	{ { 204750000, 204750000 }, { 2, 2, 8, 0, 40, 1992294, 25584, 1599, 6 } },
+	{ { 215784214, 215784214 }, { 2, 2, 8, 0, 43, 328923, 26960, 1685, 6 } },
+	{ { 216000000, 216000000 }, { 2, 2, 8, 0, 43, 419430, 26992, 1687, 6 } },
+	{ { 222527472, 222527472 }, { 2, 2, 8, 0, 44, 1060099, 27808, 1738, 6 } },
+	{ { 222750000, 222750000 }, { 2, 2, 8, 0, 44, 1153434, 27840, 1740, 6 } },
+	{ { 234000000, 234000000 }, { 2, 2, 8, 0, 46, 1677722, 29248, 1828, 6 } },
+	{ { 241500000, 241500000 }, { 2, 2, 8, 0, 48, 629146, 30176, 1886, 6 } },
+	{ { 245250000, 245250000 }, { 2, 2, 8, 0, 49, 104858, 30656, 1916, 6 } },
+	{ { 268250000, 268250000 }, { 1, 1, 6, 0, 40, 498074, 25140, 2095, 6 } },
+	{ { 296703296, 296703296 }, { 1, 1, 6, 0, 44, 1060099, 27804, 2317, 6 } },
+	{ { 297000000, 297000000 }, { 1, 1, 6, 0, 44, 1153434, 27840, 2320, 6 } },
+};
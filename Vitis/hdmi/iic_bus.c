@@ -0,0 +1,308 @@
+#include "iic_bus.h"
+#include "xil_printf.h"
+#include "sleep.h"
+
+#define IIC_BUS_PENDING         1       // Msg->Status while queued
+
+static IicBus Buses[IIC_BUS_MAX];
+static u8 NumBuses;
+
+IicBus *iic_bus_get(UINTPTR BaseAddress) {
+    IicBus *Bus;
+    u8 i;
+
+    for (i = 0; i < NumBuses; i++) {
+        if (Buses[i].BaseAddress == BaseAddress) {
+            return &Buses[i];
+        }
+    }
+
+    if (NumBuses == IIC_BUS_MAX) {
+        xil_printf("IIC bus: no room for controller 0x%08x\r\n", (u32)BaseAddress);
+        return NULL;
+    }
+
+    Bus = &Buses[NumBuses++];
+    Bus->BaseAddress = BaseAddress;
+    Bus->MuxAddr = IIC_BUS_MUX_ADDR;
+    Bus->MuxState = IIC_BUS_MUX_UNKNOWN;
+    Bus->Owned = 0;
+    Bus->Owner = NULL;
+    Bus->Session = NULL;
+    Bus->PendHead = 0;
+    Bus->PendTail = 0;
+    Bus->Ticks = NULL;
+    Bus->TickHz = 0;
+    Bus->MuxWrites = 0;
+    Bus->MuxSkipped = 0;
+    Bus->Clients = NULL;
+
+    return Bus;
+}
+
+void iic_bus_set_clock(IicBus *Bus, IicBusTicks Ticks, u32 TickHz) {
+    Bus->Ticks = Ticks;
+    Bus->TickHz = TickHz;
+}
+
+void iic_bus_client_init(IicBusClient *Client, IicBus *Bus, const char *Name, u8 Addr, s16 MuxChannel) {
+    IicBusClient *c;
+
+    Client->Name = Name;
+    Client->Bus = Bus;
+    Client->Addr = Addr;
+    Client->MuxChannel = MuxChannel;
+    Client->Transfers = 0;
+    Client->TxBytes = 0;
+    Client->RxBytes = 0;
+    Client->Nacks = 0;
+    Client->BusWaits = 0;
+    Client->Errors = 0;
+    Client->Busy = 0;
+    Client->Deferred = 0;
+    Client->LatencyTicks = 0;
+    Client->MaxLatencyTicks = 0;
+
+    for (c = Bus->Clients; c; c = c->Next) {
+        if (c == Client) {
+            return;
+        }
+    }
+    Client->Next = Bus->Clients;
+    Bus->Clients = Client;
+}
+
+static u64 iic_bus_now(IicBus *Bus) {
+    return Bus->Ticks ? Bus->Ticks() : 0;
+}
+
+static int iic_bus_acquire(IicBus *Bus, IicBusClient *Client) {
+    if (Bus->Owned) {
+        return FALSE;
+    }
+    Bus->Owned = 1;
+    Bus->Owner = Client;
+    return TRUE;
+}
+
+static int iic_bus_select(IicBus *Bus, IicBusClient *Client) {
+    u8 Channel;
+
+    if (Client->MuxChannel == IIC_BUS_ROOT) {
+        return XST_SUCCESS;
+    }
+    if (Bus->MuxState == Client->MuxChannel) {
+        Bus->MuxSkipped++;
+        return XST_SUCCESS;
+    }
+
+    Channel = (u8)Client->MuxChannel;
+    if (XIic_Send(Bus->BaseAddress, Bus->MuxAddr, &Channel, 1, XIIC_STOP) != 1) {
+        Bus->MuxState = IIC_BUS_MUX_UNKNOWN;
+        return XST_FAILURE;
+    }
+    Bus->MuxState = Client->MuxChannel;
+    Bus->MuxWrites++;
+
+    return XST_SUCCESS;
+}
+
+// Another master owns the bus until its STOP, check once per microsecond
+static int iic_bus_wait_idle(IicBus *Bus, IicBusClient *Client) {
+    int TimeOut = IIC_BUS_IDLE_TIMEOUT_US;
+
+    if (!(XIic_ReadReg(Bus->BaseAddress, XIIC_SR_REG_OFFSET) & XIIC_SR_BUS_BUSY_MASK)) {
+        return XST_SUCCESS;
+    }
+
+    Client->BusWaits++;
+    while (TimeOut) {
+        usleep(1U);
+        if (!(XIic_ReadReg(Bus->BaseAddress, XIIC_SR_REG_OFFSET) & XIIC_SR_BUS_BUSY_MASK)) {
+            return XST_SUCCESS;
+        }
+        TimeOut--;
+    }
+
+    return XST_FAILURE;
+}
+
+// One write, read or write + repeated START + read; the bus is held
+static int iic_bus_run(IicBusClient *Client, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen,
+                       int Retries, u64 Start) {
+    IicBus *Bus = Client->Bus;
+    unsigned Count;
+    u64 Latency;
+    int Status = XST_FAILURE;
+    int Tries;
+
+    if (iic_bus_select(Bus, Client) == XST_SUCCESS) {
+        for (Tries = 0; Tries <= Retries; Tries++) {
+            // Another master is not a NACK, wait for it without using up a retry
+            if (iic_bus_wait_idle(Bus, Client) != XST_SUCCESS) {
+                break;
+            }
+
+            if (WriteLen) {
+                Count = XIic_Send(Bus->BaseAddress, Client->Addr, WriteBuf, WriteLen,
+                                  ReadLen ? XIIC_REPEATED_START : XIIC_STOP);
+                if (Count != WriteLen) {
+                    // Send is aborted so reset Tx FIFO
+                    XIic_WriteReg(Bus->BaseAddress, XIIC_CR_REG_OFFSET, XIIC_CR_TX_FIFO_RESET_MASK);
+                    XIic_WriteReg(Bus->BaseAddress, XIIC_CR_REG_OFFSET, XIIC_CR_ENABLE_DEVICE_MASK);
+                    if (Count != 0) {
+                        break;
+                    }
+                    Client->Nacks++;
+                    continue;
+                }
+            }
+
+            if (ReadLen) {
+                Count = XIic_Recv(Bus->BaseAddress, Client->Addr, ReadBuf, ReadLen, XIIC_STOP);
+                if (Count != ReadLen) {
+                    if (Count != 0) {
+                        break;
+                    }
+                    Client->Nacks++;
+                    continue;
+                }
+            }
+
+            Status = XST_SUCCESS;
+            break;
+        }
+    }
+
+    Client->Transfers++;
+    if (Status == XST_SUCCESS) {
+        Client->TxBytes += WriteLen;
+        Client->RxBytes += ReadLen;
+    } else {
+        Client->Errors++;
+    }
+
+    Latency = iic_bus_now(Bus) - Start;
+    Client->LatencyTicks += Latency;
+    if (Latency > Client->MaxLatencyTicks) {
+        Client->MaxLatencyTicks = Latency;
+    }
+
+    return Status;
+}
+
+static void iic_bus_run_msg(IicBusMsg *Msg) {
+    Msg->Client->Bus->Owner = Msg->Client;
+    Msg->Status = iic_bus_run(Msg->Client, Msg->WriteBuf, Msg->WriteLen, Msg->ReadBuf, Msg->ReadLen,
+                              IIC_BUS_RETRIES, Msg->Queued);
+    if (Msg->Callback) {
+        Msg->Callback(Msg->CallBackRef, Msg);
+    }
+}
+
+// Runs what was queued meanwhile, then frees the bus
+static void iic_bus_release(IicBus *Bus) {
+    IicBusMsg *Msg;
+
+    do {
+        while (Bus->PendHead != Bus->PendTail) {
+            Msg = Bus->Pending[Bus->PendHead & (IIC_BUS_QUEUE - 1)];
+            iic_bus_run_msg(Msg);
+            Bus->PendHead++;
+        }
+        Bus->Owner = NULL;
+        Bus->Session = NULL;
+        Bus->Owned = 0;
+        // A handler may have queued between the last check and the release
+    } while (Bus->PendHead != Bus->PendTail && iic_bus_acquire(Bus, NULL));
+}
+
+static int iic_bus_sync(IicBusClient *Client, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen,
+                        int Retries) {
+    IicBus *Bus = Client->Bus;
+    u64 Start = iic_bus_now(Bus);
+    int Status;
+
+    // Inside iic_bus_begin()/iic_bus_end() of this client
+    if (Bus->Session == Client) {
+        return iic_bus_run(Client, WriteBuf, WriteLen, ReadBuf, ReadLen, Retries, Start);
+    }
+
+    if (!iic_bus_acquire(Bus, Client)) {
+        Client->Busy++;
+        return XST_DEVICE_BUSY;
+    }
+
+    Status = iic_bus_run(Client, WriteBuf, WriteLen, ReadBuf, ReadLen, Retries, Start);
+    iic_bus_release(Bus);
+
+    return Status;
+}
+
+int iic_bus_transfer(IicBusClient *Client, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen) {
+    return iic_bus_sync(Client, WriteBuf, WriteLen, ReadBuf, ReadLen, IIC_BUS_RETRIES);
+}
+
+int iic_bus_probe(IicBusClient *Client) {
+    u8 Byte;
+
+    return iic_bus_sync(Client, NULL, 0, &Byte, 1, 0);
+}
+
+int iic_bus_submit(IicBusMsg *Msg) {
+    IicBusClient *Client = Msg->Client;
+    IicBus *Bus = Client->Bus;
+
+    Msg->Status = IIC_BUS_PENDING;
+    Msg->Queued = iic_bus_now(Bus);
+
+    if (iic_bus_acquire(Bus, Client)) {
+        iic_bus_run_msg(Msg);
+        iic_bus_release(Bus);
+        return XST_SUCCESS;
+    }
+
+    if ((u8)(Bus->PendTail - Bus->PendHead) >= IIC_BUS_QUEUE) {
+        Client->Busy++;
+        return XST_DEVICE_BUSY;
+    }
+
+    Bus->Pending[Bus->PendTail & (IIC_BUS_QUEUE - 1)] = Msg;
+    Bus->PendTail++;
+    Client->Deferred++;
+
+    return XST_SUCCESS;
+}
+
+int iic_bus_begin(IicBusClient *Client) {
+    if (!iic_bus_acquire(Client->Bus, Client)) {
+        Client->Busy++;
+        return XST_DEVICE_BUSY;
+    }
+    Client->Bus->Session = Client;
+    return XST_SUCCESS;
+}
+
+void iic_bus_end(IicBusClient *Client) {
+    if (Client->Bus->Session == Client) {
+        iic_bus_release(Client->Bus);
+    }
+}
+
+static u32 iic_bus_us(IicBus *Bus, u64 Ticks) {
+    return Bus->TickHz ? (u32)(Ticks * 1000000ULL / Bus->TickHz) : 0;
+}
+
+void iic_bus_report(IicBus *Bus) {
+    IicBusClient *c;
+
+    xil_printf("#iicbus,client,addr,mux,transfers,tx,rx,nacks,bus_waits,errors,busy,deferred,avg_us,max_us\r\n");
+    for (c = Bus->Clients; c; c = c->Next) {
+        xil_printf("iicbus,%s,0x%02x,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\r\n", c->Name, c->Addr,
+                   c->MuxChannel, c->Transfers, c->TxBytes, c->RxBytes, c->Nacks, c->BusWaits, c->Errors,
+                   c->Busy, c->Deferred,
+                   c->Transfers ? iic_bus_us(Bus, c->LatencyTicks / c->Transfers) : 0,
+                   iic_bus_us(Bus, c->MaxLatencyTicks));
+    }
+    xil_printf("iicbus,mux,0x%02x,%d,%d,,,,,,,,,\r\n", Bus->MuxAddr, Bus->MuxWrites, Bus->MuxSkipped);
+}
@@ -0,0 +1,124 @@
+#ifndef IIC_BUS_H
+#define IIC_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xiic.h"
+
+/*
+ * Shared owner of one AXI IIC for every polled client (DP159, IDT
+ * 8T49N24x, Si5324, HDCP key EEPROM, ...).
+ *
+ * - The 0x74 mux channel last written is remembered, and a client only
+ *   writes the mux when it needs another channel. The HDMI drivers here
+ *   all sit on the root (IIC_BUS_ROOT) and never touch the mux; the
+ *   channel is for boards that put a client behind it.
+ * - Nobody spins on another client. The bus is taken with a flag; a
+ *   caller that finds it taken can only be an interrupt handler that
+ *   preempted the owner, and spinning there would never end. A
+ *   synchronous call gets XST_DEVICE_BUSY back. iic_bus_submit() queues
+ *   the message instead, and the owner runs it just before releasing the
+ *   bus.
+ * - Another master on the bus is waited out, up to
+ *   IIC_BUS_IDLE_TIMEOUT_US, without using up a NACK retry.
+ * - Every client counts transfers, bytes, NACK retries, waits for another
+ *   master, errors, and busy or deferred calls. It also keeps its latency, queueing included, in
+ *   ticks of the clock given to iic_bus_set_clock().
+ *
+ * The flag needs no critical section on one core as long as interrupt
+ * handlers do not nest: a handler always runs to completion before the
+ * code it preempted sees the flag again. The deferred queue has one
+ * consumer (the owner) and producers that cannot run concurrently, so a
+ * ring with separate head and tail indexes is enough.
+ */
+
+#define IIC_BUS_MAX             2       // AXI IIC controllers
+#define IIC_BUS_QUEUE           8       // Deferred messages per bus, power of 2
+#define IIC_BUS_RETRIES         255     // Address NACKs before a transfer fails
+#define IIC_BUS_IDLE_TIMEOUT_US 10000   // Wait for another master's STOP, a 100 byte transfer at 100 kHz
+#define IIC_BUS_MUX_ADDR        0x74    // PCA9548 on the ZCU10x/KC705 boards
+
+#define IIC_BUS_ROOT            (-1)    // Client not behind the mux, no switch
+#define IIC_BUS_MUX_UNKNOWN     (-1)
+
+typedef struct IicBus IicBus;
+typedef struct IicBusClient IicBusClient;
+typedef struct IicBusMsg IicBusMsg;
+
+typedef u64 (*IicBusTicks)(void);
+typedef void (*IicBusHandler)(void *CallBackRef, IicBusMsg *Msg);
+
+struct IicBusClient {
+    const char *Name;
+    IicBus *Bus;
+    u8 Addr;                        // 7-bit slave address
+    s16 MuxChannel;                 // Channel mask it needs, IIC_BUS_ROOT if none
+    u32 Transfers;
+    u32 TxBytes;
+    u32 RxBytes;
+    u32 Nacks;                      // Address phases NACKed and retried
+    u32 BusWaits;                   // Attempts that found another master on the bus
+    u32 Errors;
+    u32 Busy;                       // Synchronous calls refused, bus owned
+    u32 Deferred;                   // Messages run later by the owner
+    u64 LatencyTicks;               // Sum over all transfers
+    u64 MaxLatencyTicks;
+    IicBusClient *Next;
+};
+
+struct IicBusMsg {
+    IicBusClient *Client;
+    u8 *WriteBuf;
+    u16 WriteLen;
+    u8 *ReadBuf;
+    u16 ReadLen;
+    IicBusHandler Callback;         // Runs in the owner's context
+    void *CallBackRef;
+    volatile int Status;
+    u64 Queued;
+};
+
+struct IicBus {
+    UINTPTR BaseAddress;
+    u8 MuxAddr;
+    s16 MuxState;                   // Last channel mask written, IIC_BUS_MUX_UNKNOWN after an error
+    volatile u8 Owned;
+    IicBusClient *volatile Owner;
+    IicBusClient *volatile Session; // Holder between iic_bus_begin() and iic_bus_end()
+    IicBusMsg *Pending[IIC_BUS_QUEUE];
+    volatile u8 PendHead;           // Owner only
+    volatile u8 PendTail;           // Producers only
+    IicBusTicks Ticks;
+    u32 TickHz;
+    u32 MuxWrites;
+    u32 MuxSkipped;
+    IicBusClient *Clients;
+};
+
+IicBus *iic_bus_get(UINTPTR BaseAddress);
+void iic_bus_set_clock(IicBus *Bus, IicBusTicks Ticks, u32 TickHz);
+void iic_bus_client_init(IicBusClient *Client, IicBus *Bus, const char *Name, u8 Addr, s16 MuxChannel);
+
+// Write, then read with a repeated START; either length may be 0
+int iic_bus_transfer(IicBusClient *Client, u8 *WriteBuf, u16 WriteLen, u8 *ReadBuf, u16 ReadLen);
+int iic_bus_submit(IicBusMsg *Msg);
+
+// One byte read without retries, XST_SUCCESS if the device answers
+int iic_bus_probe(IicBusClient *Client);
+
+// Keep the bus over several transfers, e.g. read-modify-write
+int  iic_bus_begin(IicBusClient *Client);
+void iic_bus_end(IicBusClient *Client);
+
+void iic_bus_report(IicBus *Bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIC_BUS_H */
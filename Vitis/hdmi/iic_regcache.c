@@ -0,0 +1,291 @@
+#include "iic_regcache.h"
+#include "xil_printf.h"
+
+static int iic_regcache_bit(const u8 *Map, u16 Reg) {
+    return (Map[Reg >> 3] >> (Reg & 7)) & 1;
+}
+
+static void iic_regcache_set(u8 *Map, u16 Reg) {
+    Map[Reg >> 3] |= (u8)(1 << (Reg & 7));
+}
+
+static void iic_regcache_clear(u8 *Map, u16 Reg) {
+    Map[Reg >> 3] &= (u8)~(1 << (Reg & 7));
+}
+
+// Register kept in the shadow at all
+static int iic_regcache_cached(IicRegCache *Cache, u16 Reg) {
+    return Reg < Cache->NumRegs && !iic_regcache_bit(Cache->NoCache, Reg);
+}
+
+static int iic_regcache_hit(IicRegCache *Cache, u16 Reg) {
+    return iic_regcache_cached(Cache, Reg) && iic_regcache_bit(Cache->Valid, Reg);
+}
+
+static u8 iic_regcache_address(IicRegCache *Cache, u16 Reg, u8 *Buffer) {
+    if (Cache->AddrBytes == 2) {
+        Buffer[0] = (u8)(Reg >> 8);
+        Buffer[1] = (u8)Reg;
+        return 2;
+    }
+    Buffer[0] = (u8)Reg;
+    return 1;
+}
+
+// Count registers from Reg on, in one transfer
+static int iic_regcache_send(IicRegCache *Cache, u16 Reg, const u8 *Data, u16 Count) {
+    u8 Buffer[2 + IIC_REGCACHE_BURST];
+    u8 Len = iic_regcache_address(Cache, Reg, Buffer);
+    u16 i;
+
+    for (i = 0; i < Count; i++) {
+        Buffer[Len + i] = Data[i];
+    }
+    Cache->Transfers++;
+    return iic_bus_transfer(Cache->Client, Buffer, Len + Count, NULL, 0);
+}
+
+static int iic_regcache_recv(IicRegCache *Cache, u16 Reg, u8 *Data, u16 Count) {
+    u8 Buffer[2];
+    u8 Len = iic_regcache_address(Cache, Reg, Buffer);
+
+    Cache->Transfers++;
+    return iic_bus_transfer(Cache->Client, Buffer, Len, Data, Count);
+}
+
+int iic_regcache_init(IicRegCache *Cache, IicBusClient *Client, u16 NumRegs, u8 AddrBytes, u8 AutoInc) {
+    u16 i;
+
+    if (NumRegs > IIC_REGCACHE_MAX_REGS || (AddrBytes != 1 && AddrBytes != 2)) {
+        xil_printf("IIC 0x%02x: register cache geometry not supported\r\n", Client->Addr);
+        return XST_FAILURE;
+    }
+
+    Cache->Client = Client;
+    Cache->NumRegs = NumRegs;
+    Cache->AddrBytes = AddrBytes;
+    Cache->AutoInc = AutoInc;
+    for (i = 0; i < IIC_REGCACHE_MAX_REGS / 8; i++) {
+        Cache->NoCache[i] = 0;
+    }
+    iic_regcache_invalidate(Cache);
+
+    Cache->Reads = 0;
+    Cache->ReadHits = 0;
+    Cache->Writes = 0;
+    Cache->WriteSkips = 0;
+    Cache->Transfers = 0;
+    Cache->Mismatches = 0;
+
+    return XST_SUCCESS;
+}
+
+void iic_regcache_nocache(IicRegCache *Cache, u16 Reg) {
+    if (Reg < Cache->NumRegs) {
+        iic_regcache_set(Cache->NoCache, Reg);
+        iic_regcache_clear(Cache->Valid, Reg);
+        iic_regcache_clear(Cache->Dirty, Reg);
+    }
+}
+
+void iic_regcache_invalidate(IicRegCache *Cache) {
+    u16 i;
+
+    // Pending deferred writes are lost with the device state
+    for (i = 0; i < IIC_REGCACHE_MAX_REGS / 8; i++) {
+        Cache->Valid[i] = 0;
+        Cache->Dirty[i] = 0;
+    }
+    Cache->Deferred = 0;
+}
+
+int iic_regcache_read(IicRegCache *Cache, u16 Reg, u8 *Value) {
+    int Status;
+
+    Cache->Reads++;
+    if (iic_regcache_hit(Cache, Reg)) {
+        Cache->ReadHits++;
+        *Value = Cache->Shadow[Reg];
+        return XST_SUCCESS;
+    }
+
+    Status = iic_regcache_recv(Cache, Reg, Value, 1);
+    if (Status == XST_SUCCESS && iic_regcache_cached(Cache, Reg)) {
+        Cache->Shadow[Reg] = *Value;
+        iic_regcache_set(Cache->Valid, Reg);
+    }
+
+    return Status;
+}
+
+int iic_regcache_write(IicRegCache *Cache, u16 Reg, u8 Value) {
+    int Status;
+
+    Cache->Writes++;
+    if (!iic_regcache_cached(Cache, Reg)) {
+        return iic_regcache_send(Cache, Reg, &Value, 1);
+    }
+    if (iic_regcache_bit(Cache->Valid, Reg) && Cache->Shadow[Reg] == Value) {
+        Cache->WriteSkips++;
+        return XST_SUCCESS;
+    }
+
+    Cache->Shadow[Reg] = Value;
+    iic_regcache_set(Cache->Valid, Reg);
+    if (Cache->Deferred) {
+        iic_regcache_set(Cache->Dirty, Reg);
+        return XST_SUCCESS;
+    }
+
+    Status = iic_regcache_send(Cache, Reg, &Value, 1);
+    iic_regcache_clear(Cache->Dirty, Reg);
+    if (Status != XST_SUCCESS) {
+        // What the device holds now is unknown
+        iic_regcache_clear(Cache->Valid, Reg);
+    }
+
+    return Status;
+}
+
+int iic_regcache_modify(IicRegCache *Cache, u16 Reg, u8 Value, u8 Mask) {
+    IicBusClient *Client = Cache->Client;
+    int Held = FALSE;
+    int Status;
+    u8 Data;
+
+    // A miss reads the device; keep the bus up to the write
+    if (!iic_regcache_hit(Cache, Reg) && Client->Bus->Session != Client) {
+        Status = iic_bus_begin(Client);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+        Held = TRUE;
+    }
+
+    Status = iic_regcache_read(Cache, Reg, &Data);
+    if (Status == XST_SUCCESS) {
+        Status = iic_regcache_write(Cache, Reg, (u8)((Data & ~Mask) | (Value & Mask)));
+    }
+
+    if (Held) {
+        iic_bus_end(Client);
+    }
+
+    return Status;
+}
+
+void iic_regcache_defer(IicRegCache *Cache) {
+    Cache->Deferred = 1;
+}
+
+int iic_regcache_flush(IicRegCache *Cache) {
+    int Result = XST_SUCCESS;
+    int Status;
+    u16 First;
+    u16 Last;
+    u16 Next;
+    u16 Reg;
+
+    Cache->Deferred = 0;
+
+    for (Reg = 0; Reg < Cache->NumRegs; Reg = Last + 1) {
+        Last = Reg;
+        if (!iic_regcache_bit(Cache->Dirty, Reg)) {
+            continue;
+        }
+
+        // Extend the burst over dirty registers and short clean gaps
+        First = Reg;
+        if (Cache->AutoInc) {
+            for (Next = First + 1; Next < Cache->NumRegs && Next - First < IIC_REGCACHE_BURST; Next++) {
+                if (iic_regcache_bit(Cache->Dirty, Next)) {
+                    Last = Next;
+                } else if (Next - Last > IIC_REGCACHE_GAP || !iic_regcache_hit(Cache, Next)) {
+                    break;
+                }
+            }
+        }
+
+        Status = iic_regcache_send(Cache, First, &Cache->Shadow[First], Last - First + 1);
+        if (Status != XST_SUCCESS) {
+            // Left dirty for the next flush
+            Result = Status;
+            continue;
+        }
+        for (Next = First; Next <= Last; Next++) {
+            iic_regcache_clear(Cache->Dirty, Next);
+        }
+    }
+
+    return Result;
+}
+
+int iic_regcache_verify(IicRegCache *Cache, u16 First, u16 Count) {
+    u8 Buffer[IIC_REGCACHE_BURST];
+    int Result = XST_SUCCESS;
+    int Status;
+    u32 End;
+    u32 Reg;
+    u16 Len;
+    u16 i;
+
+    End = (u32)First + Count;
+    if (End > Cache->NumRegs) {
+        End = Cache->NumRegs;
+    }
+
+    for (Reg = First; Reg < End; Reg += Len) {
+        Len = Cache->AutoInc ? IIC_REGCACHE_BURST : 1;
+        if (Reg + Len > End) {
+            Len = (u16)(End - Reg);
+        }
+
+        Status = iic_regcache_recv(Cache, (u16)Reg, Buffer, Len);
+        if (Status != XST_SUCCESS) {
+            return Status;
+        }
+
+        for (i = 0; i < Len; i++) {
+            // Dirty registers are not on the device yet
+            if (!iic_regcache_hit(Cache, (u16)(Reg + i)) ||
+                iic_regcache_bit(Cache->Dirty, (u16)(Reg + i)) || Cache->Shadow[Reg + i] == Buffer[i]) {
+                continue;
+            }
+            xil_printf("IIC 0x%02x reg 0x%04x: shadow 0x%02x, device 0x%02x\r\n", Cache->Client->Addr,
+                       Reg + i, Cache->Shadow[Reg + i], Buffer[i]);
+            Cache->Mismatches++;
+            Result = XST_FAILURE;
+        }
+    }
+
+    return Result;
+}
+
+void iic_regcache_dump(IicRegCache *Cache) {
+    u16 Reg;
+
+    // Unknown registers --, not cached nc, dirty marked *
+    xil_printf("%s shadow\r\n     ", Cache->Client->Name);
+    for (Reg = 0; Reg < 16; Reg++) {
+        xil_printf("+%01x ", Reg);
+    }
+    for (Reg = 0; Reg < Cache->NumRegs; Reg++) {
+        if ((Reg % 16) == 0) {
+            xil_printf("\r\n%02x : ", Reg);
+        }
+        if (iic_regcache_bit(Cache->NoCache, Reg)) {
+            xil_printf("nc ");
+        } else if (!iic_regcache_bit(Cache->Valid, Reg)) {
+            xil_printf("-- ");
+        } else {
+            xil_printf("%02x%c", Cache->Shadow[Reg], iic_regcache_bit(Cache->Dirty, Reg) ? '*' : ' ');
+        }
+    }
+    xil_printf("\r\n");
+}
+
+void iic_regcache_report(IicRegCache *Cache) {
+    xil_printf("#iicregcache,client,reads,hits,writes,skipped,transfers,mismatches\r\n");
+    xil_printf("iicregcache,%s,%d,%d,%d,%d,%d,%d\r\n", Cache->Client->Name, Cache->Reads,
+               Cache->ReadHits, Cache->Writes, Cache->WriteSkips, Cache->Transfers, Cache->Mismatches);
+}
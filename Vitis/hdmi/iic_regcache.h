@@ -0,0 +1,74 @@
+#ifndef IIC_REGCACHE_H
+#define IIC_REGCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "iic_bus.h"
+
+/*
+ * Shadow copy of the registers of one IIC device (clock chip, retimer),
+ * on top of an iic_bus client.
+ *
+ * - Reads of a register the shadow knows cost no bus transfer, so a
+ *   read-modify-write of a field is a single write.
+ * - A write of the value the register already holds is dropped.
+ * - Writes go to the device at once (write-through). Between
+ *   iic_regcache_defer() and iic_regcache_flush() they only update the
+ *   shadow and mark the register dirty; the flush then writes each run of
+ *   contiguous dirty registers as one burst, in address order. Defer only
+ *   where that order does not matter, e.g. while the PLL is held off.
+ * - Registers marked with iic_regcache_nocache() (status, self-clearing,
+ *   "apply" strobes) are always read from and written to the device, at
+ *   once even while deferred. Registers past NumRegs are not shadowed.
+ *
+ * The shadow is only right as long as nobody else writes the device;
+ * iic_regcache_invalidate() after a reset, iic_regcache_verify() to check.
+ */
+
+#define IIC_REGCACHE_MAX_REGS   256     // Shadowed registers per device
+#define IIC_REGCACHE_BURST      32      // Registers per flush or verify transfer
+#define IIC_REGCACHE_GAP        2       // Clean registers written to join two dirty runs
+
+typedef struct {
+    IicBusClient *Client;
+    u16 NumRegs;                    // Registers 0 .. NumRegs - 1 are shadowed
+    u8 AddrBytes;                   // 1 or 2, sent MSB first
+    u8 AutoInc;                     // Device steps the register address within a transfer
+    u8 Deferred;
+    u8 Shadow[IIC_REGCACHE_MAX_REGS];
+    u8 Valid[IIC_REGCACHE_MAX_REGS / 8];
+    u8 Dirty[IIC_REGCACHE_MAX_REGS / 8];
+    u8 NoCache[IIC_REGCACHE_MAX_REGS / 8];
+    u32 Reads;
+    u32 ReadHits;
+    u32 Writes;
+    u32 WriteSkips;                 // Same value as the shadow, not sent
+    u32 Transfers;                  // Bus transfers made by the cache
+    u32 Mismatches;                 // Found by iic_regcache_verify()
+} IicRegCache;
+
+int  iic_regcache_init(IicRegCache *Cache, IicBusClient *Client, u16 NumRegs, u8 AddrBytes, u8 AutoInc);
+void iic_regcache_nocache(IicRegCache *Cache, u16 Reg);
+void iic_regcache_invalidate(IicRegCache *Cache);
+
+int iic_regcache_read(IicRegCache *Cache, u16 Reg, u8 *Value);
+int iic_regcache_write(IicRegCache *Cache, u16 Reg, u8 Value);
+int iic_regcache_modify(IicRegCache *Cache, u16 Reg, u8 Value, u8 Mask);
+
+void iic_regcache_defer(IicRegCache *Cache);
+int  iic_regcache_flush(IicRegCache *Cache);
+
+// Compare the known registers of First .. First + Count - 1 with the device
+int  iic_regcache_verify(IicRegCache *Cache, u16 First, u16 Count);
+void iic_regcache_dump(IicRegCache *Cache);
+void iic_regcache_report(IicRegCache *Cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIC_REGCACHE_H */
@@ -0,0 +1,159 @@
+/*
+ * Generated by host_sim/clk_plan_gen.c (si5324), do not edit.
+ * 152 plans solved with Si5324_CalcFreqSettings, sorted by FIn, FOut.
+ */
+static const si5324_plan_t Si5324_Plans[] = {
+    // FIn, FOut, N1_hs, N2_hs, BwSel, NCn_ls, N2_ls, N3n
+    { {  25174825,  25174825 }, 7, 7, 6, 17, 233, 12 },
+    { {  25200000,  25200000 }, 7, 6, 6, 17, 395, 19 },
+    { {  26973026,  26973026 }, 7, 4, 6, 17, 395, 15 },
+    { {  27000000,  27000000 }, 7, 6, 6, 17, 395, 19 },
+    { {  31468531,  31468531 }, 7, 7, 6, 15, 255, 15 },
+    { {  31500000,  31500000 }, 7, 7, 6, 13, 223, 15 },
+    { {  33716282,  33716282 }, 7, 7, 6, 13, 237, 16 },
+    { {  33750000,  33750000 }, 7, 6, 6, 13, 307, 19 },
+    { {  35500000,  35500000 }, 7, 6, 6, 13, 307, 19 },
+    { {  36000000,  36000000 }, 7, 7, 6, 13, 251, 17 },
+    { {  37762237,  37762237 }, 7, 5, 6, 11, 307, 20 },
+    { {  37800000,  37800000 }, 7, 6, 6, 11, 263, 19 },
+    { {  40000000,  40000000 }, 7, 7, 6, 11, 239, 19 },
+    { {  40459539,  40459539 }, 7, 4, 6, 11, 395, 23 },
+    { {  40500000,  40500000 }, 7, 6, 6, 11, 329, 24 },
+    { {  49500000,  49500000 }, 7, 7, 6, 9, 249, 24 },
+    { {  50000000,  50000000 }, 7, 7, 6, 9, 249, 24 },
+    { {  50349650,  50349650 }, 7, 7, 6, 9, 259, 25 },
+    { {  50400000,  50400000 }, 7, 4, 6, 9, 439, 31 },
+    { {  53946052,  53946052 }, 5, 4, 6, 9, 359, 31 },
+    { {  54000000,  54000000 }, 6, 6, 6, 9, 269, 26 },
+    { {  56250000,  56250000 }, 7, 6, 6, 7, 263, 29 },
+    { {  65000000,  65000000 }, 6, 7, 6, 7, 239, 32 },
+    { {  67432566,  67432566 }, 6, 6, 6, 7, 271, 33 },
+    { {  67500000,  67500000 }, 6, 5, 6, 7, 319, 35 },
+    { {  68250000,  68250000 }, 6, 6, 6, 7, 279, 34 },
+    { {  71000000,  71000000 }, 5, 6, 6, 7, 287, 39 },
+    { {  74175824,  74175824 }, 7, 2, 6, 5, 417, 37 },
+    { {  74250000,  74250000 }, 7, 6, 6, 5, 263, 39 },
+    { {  75000000,  75000000 }, 7, 6, 6, 5, 263, 39 },
+    { {  78750000,  78750000 }, 7, 7, 6, 5, 239, 39 },
+    { {  79500000,  79500000 }, 7, 7, 6, 5, 239, 39 },
+    { {  80919079,  80919079 }, 7, 1, 6, 5, 593, 44 },
+    { {  81000000,  81000000 }, 7, 6, 6, 5, 329, 49 },
+    { {  83500000,  83500000 }, 7, 6, 6, 5, 329, 49 },
+    { {  85500000,  85500000 }, 7, 6, 6, 5, 329, 49 },
+    { {  88750000,  88750000 }, 6, 7, 6, 5, 299, 54 },
+    { {  92719780,  92719780 }, 3, 5, 6, 7, 335, 53 },
+    { {  92719780, 370879120 }, 3, 5, 6, 1, 335, 53 },
+    { {  92812500,  92812500 }, 6, 7, 6, 5, 299, 54 },
+    { {  92812500, 371250000 }, 3, 7, 6, 1, 279, 54 },
+    { {  94500000,  94500000 }, 6, 6, 6, 5, 287, 47 },
+    { { 101000000, 101000000 }, 5, 2, 6, 5, 467, 51 },
+    { { 106500000, 106500000 }, 4, 3, 6, 5, 383, 55 },
+    { { 107892106, 107892106 }, 4, 3, 6, 5, 383, 55 },
+    { { 108000000, 108000000 }, 4, 5, 6, 5, 287, 53 },
+    { { 111263736, 111263736 }, 7, 2, 6, 3, 417, 56 },
+    { { 111263736, 445054944 }, 2, 5, 6, 1, 303, 56 },
+    { { 111375000, 111375000 }, 7, 6, 6, 3, 263, 59 },
+    { { 111375000, 445500000 }, 2, 7, 6, 1, 287, 65 },
+    { { 114285000,  25174825 }, 4, 7, 6, 25, 34417, 8262 },
+    { { 114285000,  25200000 }, 7, 7, 6, 17, 30239, 7618 },
+    { { 114285000,  26973026 }, 2, 2, 6, 33, 88341, 11008 },
+    { { 114285000,  27000000 }, 7, 7, 6, 17, 32399, 7618 },
+    { { 114285000,  31468531 }, 7, 3, 6, 15, 24673, 3563 },
+    { { 114285000,  31500000 }, 7, 7, 6, 13, 29399, 7618 },
+    { { 114285000,  33716282 }, 2, 1, 6, 25, 43997, 4779 },
+    { { 114285000,  33750000 }, 7, 7, 6, 13, 31499, 7618 },
+    { { 114285000,  35500000 }, 5, 6, 6, 15, 34079, 7618 },
+    { { 114285000,  36000000 }, 7, 7, 6, 13, 33599, 7618 },
+    { { 114285000,  37762237 }, 6, 3, 6, 13, 41533, 6284 },
+    { { 114285000,  37800000 }, 7, 7, 6, 11, 30239, 7618 },
+    { { 114285000,  40000000 }, 7, 7, 6, 11, 31999, 7618 },
+    { { 114285000,  40459539 }, 7, 3, 6, 11, 25641, 3840 },
+    { { 114285000,  40500000 }, 7, 7, 6, 11, 32399, 7618 },
+    { { 114285000,  49500000 }, 7, 7, 6, 9, 32999, 7618 },
+    { { 114285000,  50000000 }, 5, 6, 6, 11, 35999, 7618 },
+    { { 114285000,  50349650 }, 3, 5, 6, 13, 29123, 6070 },
+    { { 114285000,  50400000 }, 7, 7, 6, 9, 33599, 7618 },
+    { { 114285000,  53946052 }, 6, 6, 6, 9, 42765, 9059 },
+    { { 114285000,  53946053 }, 3, 4, 6, 13, 63397, 10963 },
+    { { 114285000,  54000000 }, 6, 6, 6, 9, 35999, 7618 },
+    { { 114285000,  56250000 }, 7, 7, 6, 7, 29999, 7618 },
+    { { 114285000,  65000000 }, 3, 6, 6, 11, 36399, 7618 },
+    { { 114285000,  67432566 }, 6, 7, 6, 7, 13881, 3234 },
+    { { 114285000,  67500000 }, 6, 6, 6, 7, 35999, 7618 },
+    { { 114285000,  68250000 }, 6, 6, 6, 7, 36399, 7618 },
+    { { 114285000,  71000000 }, 5, 6, 6, 7, 34079, 7618 },
+    { { 114285000,  74175824 }, 7, 3, 6, 5, 40235, 6574 },
+    { { 114285000,  74250000 }, 7, 7, 6, 5, 29699, 7618 },
+    { { 114285000,  75000000 }, 7, 7, 6, 5, 29999, 7618 },
+    { { 114285000,  78750000 }, 7, 7, 6, 5, 31499, 7618 },
+    { { 114285000,  79500000 }, 7, 7, 6, 5, 31799, 7618 },
+    { { 114285000,  80919079 }, 4, 2, 6, 7, 69633, 9219 },
+    { { 114285000,  81000000 }, 7, 7, 6, 5, 32399, 7618 },
+    { { 114285000,  83500000 }, 7, 7, 6, 5, 33399, 7618 },
+    { { 114285000,  85500000 }, 7, 7, 6, 5, 1799, 400 },
+    { { 114285000,  88750000 }, 6, 6, 6, 5, 35499, 7618 },
+    { { 114285000,  92719780 }, 6, 3, 6, 5, 20117, 2892 },
+    { { 114285000,  92812500 }, 6, 7, 6, 5, 33749, 7618 },
+    { { 114285000,  94500000 }, 6, 6, 6, 5, 37799, 7618 },
+    { { 114285000, 101000000 }, 5, 6, 6, 5, 36359, 7618 },
+    { { 114285000, 106500000 }, 4, 6, 6, 5, 34079, 7618 },
+    { { 114285000, 107892106 }, 4, 5, 6, 5, 56109, 11143 },
+    { { 114285000, 107892107 }, 4, 3, 6, 5, 40653, 6279 },
+    { { 114285000, 108000000 }, 4, 6, 6, 5, 34559, 7618 },
+    { { 114285000, 111263736 }, 7, 3, 6, 3, 40235, 6574 },
+    { { 114285000, 111375000 }, 7, 7, 6, 3, 29699, 7618 },
+    { { 114285000, 119000000 }, 3, 6, 6, 5, 33319, 7618 },
+    { { 114285000, 121750000 }, 3, 6, 6, 5, 34089, 7618 },
+    { { 114285000, 134865133 }, 6, 3, 6, 3, 41005, 6080 },
+    { { 114285000, 135000000 }, 6, 6, 6, 3, 35999, 7618 },
+    { { 114285000, 146250000 }, 5, 6, 6, 3, 35099, 7618 },
+    { { 114285000, 148351648 }, 5, 4, 6, 3, 36163, 6190 },
+    { { 114285000, 148500000 }, 5, 7, 6, 3, 32399, 7618 },
+    { { 114285000, 154000000 }, 5, 7, 6, 3, 33599, 7618 },
+    { { 114285000, 156000000 }, 5, 6, 6, 3, 37439, 7618 },
+    { { 114285000, 161838160 }, 4, 1, 6, 3, 96393, 10635 },
+    { { 114285000, 162000000 }, 4, 6, 6, 3, 34559, 7618 },
+    { { 114285000, 175500000 }, 4, 6, 6, 3, 37439, 7618 },
+    { { 114285000, 185439560 }, 3, 5, 6, 3, 46169, 9145 },
+    { { 114285000, 185625000 }, 3, 7, 6, 3, 31499, 7618 },
+    { { 114285000, 187000000 }, 3, 3, 6, 3, 14385, 2197 },
+    { { 114285000, 193250000 }, 3, 0, 6, 3, 83613, 7063 },
+    { { 114285000, 204750000 }, 2, 6, 6, 3, 32759, 7618 },
+    { { 114285000, 215784214 }, 2, 3, 6, 3, 40653, 6279 },
+    { { 114285000, 216000000 }, 2, 6, 6, 3, 34559, 7618 },
+    { { 114285000, 222527472 }, 7, 3, 6, 1, 40235, 6574 },
+    { { 114285000, 222750000 }, 7, 7, 6, 1, 29699, 7618 },
+    { { 114285000, 234000000 }, 7, 7, 6, 1, 31199, 7618 },
+    { { 114285000, 241500000 }, 7, 7, 6, 1, 32199, 7618 },
+    { { 114285000, 245250000 }, 7, 7, 6, 1, 32699, 7618 },
+    { { 114285000, 268250000 }, 6, 6, 6, 1, 52013, 11079 },
+    { { 114285000, 296703296 }, 5, 4, 6, 1, 36163, 6190 },
+    { { 114285000, 297000000 }, 5, 7, 6, 1, 32399, 7618 },
+    { { 119000000, 119000000 }, 3, 4, 6, 5, 335, 63 },
+    { { 121750000, 121750000 }, 7, 4, 6, 3, 351, 63 },
+    { { 134865133, 134865133 }, 6, 3, 6, 3, 399, 69 },
+    { { 135000000, 135000000 }, 6, 5, 6, 3, 319, 71 },
+    { { 146250000, 146250000 }, 5, 6, 6, 3, 269, 74 },
+    { { 148351648, 148351648 }, 5, 6, 6, 3, 269, 74 },
+    { { 148500000, 148500000 }, 5, 6, 6, 3, 269, 74 },
+    { { 154000000, 154000000 }, 5, 7, 6, 3, 251, 76 },
+    { { 156000000, 156000000 }, 5, 6, 6, 3, 287, 79 },
+    { { 161838160, 161838160 }, 4, 7, 6, 3, 255, 87 },
+    { { 162000000, 162000000 }, 4, 5, 6, 3, 287, 80 },
+    { { 175500000, 175500000 }, 4, 6, 6, 3, 287, 89 },
+    { { 185439560, 185439560 }, 3, 6, 6, 3, 265, 94 },
+    { { 185625000, 185625000 }, 3, 7, 6, 3, 251, 98 },
+    { { 187000000, 187000000 }, 3, 7, 6, 3, 251, 98 },
+    { { 193250000, 193250000 }, 3, 6, 6, 3, 279, 99 },
+    { { 204750000, 204750000 }, 2, 6, 6, 3, 251, 104 },
+    { { 215784214, 215784214 }, 2, 5, 6, 3, 287, 107 },
+    { { 216000000, 216000000 }, 2, 5, 6, 3, 287, 107 },
+    { { 222527472, 222527472 }, 7, 2, 6, 1, 417, 113 },
+    { { 222750000, 222750000 }, 7, 6, 6, 1, 263, 119 },
+    { { 234000000, 234000000 }, 7, 7, 6, 1, 233, 116 },
+    { { 241500000, 241500000 }, 7, 4, 6, 1, 351, 127 },
+    { { 245250000, 245250000 }, 7, 4, 6, 1, 351, 127 },
+    { { 268250000, 268250000 }, 6, 7, 6, 1, 259, 142 },
+    { { 296703296, 296703296 }, 5, 6, 6, 1, 269, 149 },
+    { { 297000000, 297000000 }, 5, 6, 6, 1, 269, 149 },
+};
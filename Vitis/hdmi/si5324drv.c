@@ -38,6 +38,13 @@
 
 #include "xiic.h"
 #include "xparameters.h"
+#include "iic_bus.h"
+#include "clk_plan.h"
+#include "si5324_plans.h"
+
+static IicBusClient Si5324Client;
+static ClkPlanCache Si5324Plans;
+static si5324_plan_t Si5324PlanLru[SI5324_PLAN_LRU];
 
 /******************************************************************************
  * User settable constant that depends on the specific board design.
@@ -255,7 +262,7 @@ s32 Si5324_SetClock_Ps(XIicPs *InstancePtr, u16 IICAddress, u8 ClkSrc,
     }
 
     // Calculate the frequency settings for the Si5324
-    Status = Si5324_CalcFreqSettings(ClkInFreq, ClkOutFreq,
+    Status = Si5324_GetFreqSettings(ClkInFreq, ClkOutFreq,
                                      &N1_hs, &NCn_ls, &N2_hs, &N2_ls, &N3n,
                                      &BwSel);
     if (Status != SI5324_SUCCESS) {
@@ -406,23 +413,35 @@ int Si5324_DoSettings(u32 IICBaseAddress, u8 IICAddress,
         }
         return SI5324_ERR_PARM;
     }
+    if (Si5324Client.Bus == NULL ||
+        Si5324Client.Bus->BaseAddress != IICBaseAddress ||
+        Si5324Client.Addr != IICAddress) {
+        iic_bus_client_init(&Si5324Client, iic_bus_get(IICBaseAddress),
+                            "si5324", IICAddress, IIC_BUS_ROOT);
+    }
+
+    // The whole list goes out without another client in between
+    if (iic_bus_begin(&Si5324Client) != XST_SUCCESS) {
+        return SI5324_ERR_IIC;
+    }
+
     for (i = 0; i < NumRegs; i++) {
-        result = XIic_Send(IICBaseAddress, IICAddress,
-                           BufPtr + (i << 1), 2,
-                           XIIC_STOP);
+        result = iic_bus_transfer(&Si5324Client, BufPtr + (i << 1), 2, NULL, 0);
 
 #ifdef versal
 		/* This delay prevents IIC access from hanging */
 		usleep(500);
 #endif
 
-	if (result != 2) {
+	if (result != XST_SUCCESS) {
             if (SI5324_DEBUG) {
                 xil_printf("Si5324: ERROR: IIC write request error.");
             }
+            iic_bus_end(&Si5324Client);
             return SI5324_ERR_IIC;
         }
     }
+    iic_bus_end(&Si5324Client);
     return SI5324_SUCCESS;
 }
 
@@ -857,6 +876,55 @@ int Si5324_CalcFreqSettings(u32 ClkInFreq, u32 ClkOutFreq,
 }
 
 
+/*****************************************************************************/
+/**
+ * Get the frequency settings for the desired output frequency, from the plan
+ * table or the LRU of earlier calculations when possible.
+ *
+ * Parameters and return values as Si5324_CalcFreqSettings.
+ *****************************************************************************/
+int Si5324_GetFreqSettings(u32 ClkInFreq, u32 ClkOutFreq,
+                        u8  *N1_hs, u32 *NCn_ls,
+                        u8  *N2_hs, u32 *N2_ls,
+                        u32 *N3n,   u8  *BwSel) {
+    const si5324_plan_t *plan;
+    si5324_plan_t solved;
+    int result;
+
+    if (Si5324Plans.EntrySize == 0) {
+        clk_plan_init(&Si5324Plans, Si5324_Plans,
+                      sizeof(Si5324_Plans) / sizeof(si5324_plan_t),
+                      Si5324PlanLru, SI5324_PLAN_LRU, sizeof(si5324_plan_t));
+    }
+
+    plan = clk_plan_find(&Si5324Plans, ClkInFreq, ClkOutFreq);
+    if (plan == NULL) {
+        result = Si5324_CalcFreqSettings(ClkInFreq, ClkOutFreq,
+                                         &solved.N1_hs, &solved.NCn_ls,
+                                         &solved.N2_hs, &solved.N2_ls,
+                                         &solved.N3n, &solved.BwSel);
+        if (result != SI5324_SUCCESS) {
+            return result;
+        }
+        solved.Key.FIn = ClkInFreq;
+        solved.Key.FOut = ClkOutFreq;
+        clk_plan_store(&Si5324Plans, &solved);
+        plan = &solved;
+    }
+
+    *N1_hs  = plan->N1_hs;
+    *NCn_ls = plan->NCn_ls;
+    *N2_hs  = plan->N2_hs;
+    *N2_ls  = plan->N2_ls;
+    *N3n    = plan->N3n;
+    *BwSel  = plan->BwSel;
+    return SI5324_SUCCESS;
+}
+
+void Si5324_PlanReport(void) {
+    clk_plan_report(&Si5324Plans, "si5324");
+}
+
 /*****************************************************************************/
 /**
  * Set the output frequency of the Si5324 clock generator.
@@ -909,7 +977,7 @@ int Si5324_SetClock(u32 IICBaseAddress, u8 IICAddress, u8 ClkSrc,
     }
 
     // Calculate the frequency settings for the Si5324
-    result = Si5324_CalcFreqSettings(ClkInFreq, ClkOutFreq,
+    result = Si5324_GetFreqSettings(ClkInFreq, ClkOutFreq,
                                      &N1_hs, &NCn_ls, &N2_hs, &N2_ls, &N3n,
                                      &BwSel);
     if (result != SI5324_SUCCESS) {
@@ -32,6 +32,7 @@
 
 #include "xil_types.h"
 #include "xparameters.h"
+#include "clk_plan.h"
 #if defined (ARMR5) || (__aarch64__)
 #include "xiicps.h"
 #endif
@@ -57,6 +58,11 @@
  */
 #define SI5324_DEBUG FALSE
 
+/**
+ * Solved frequency plans kept besides the table of standard HDMI clocks.
+ */
+#define SI5324_PLAN_LRU 8
+
 /**
  * The following constants are error codes generated by the functions in
  * this driver.
@@ -129,6 +135,19 @@ typedef struct {
     u32 best_n3;
 } si5324_settings_t;
 
+/**
+ * Register settings for one (ClkInFreq, ClkOutFreq) pair, see clk_plan.h.
+ */
+typedef struct {
+    ClkPlanKey Key;
+    u8  N1_hs;
+    u8  N2_hs;
+    u8  BwSel;
+    u32 NCn_ls;
+    u32 N2_ls;
+    u32 N3n;
+} si5324_plan_t;
+
 /*****************************************************************************/
 /**
  * Initialize the SiliconLabs Si5324 clock generator. After initialization,
@@ -165,6 +184,25 @@ int Si5324_CalcFreqSettings(u32 ClkInFreq, u32 ClkOutFreq,
                         u8  *N2_hs, u32 *N2_ls,
                         u32 *N3n,   u8  *BwSel);
 
+/*****************************************************************************/
+/**
+ * Get the frequency settings for the desired output frequency. The standard
+ * HDMI clocks come from the plan table, other frequencies are calculated with
+ * Si5324_CalcFreqSettings once and kept in a small LRU.
+ *
+ * Parameters and return values as Si5324_CalcFreqSettings.
+ *****************************************************************************/
+int Si5324_GetFreqSettings(u32 ClkInFreq, u32 ClkOutFreq,
+                        u8  *N1_hs, u32 *NCn_ls,
+                        u8  *N2_hs, u32 *N2_ls,
+                        u32 *N3n,   u8  *BwSel);
+
+/*****************************************************************************/
+/**
+ * Print the plan table hits, LRU hits and calculations.
+ *****************************************************************************/
+void Si5324_PlanReport(void);
+
 #if defined (ARMR5) || (__aarch64__)
 /*****************************************************************************/
 /**
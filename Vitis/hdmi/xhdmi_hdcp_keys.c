@@ -52,7 +52,7 @@
 static u16 Round16(u16 Size);
 static void Decrypt(u8 *CipherBufferPtr, u8 *PlainBufferPtr, u8 *Key, u16 Length);
 static u16 EepromGet(u16 Address, u8 *BufferPtr, u16 Length);
-static u8 EepromReadByte(u16 Address, u8 *BufferPtr, u16 ByteCount);
+static u16 EepromReadByte(u16 Address, u8 *BufferPtr, u16 ByteCount);
 static u8 EnterPassword (u8 *Password);
 
 static u32 XHdcp_KeyMgmtBlk_ReadReg(u32 BaseAddress, u32 RegOffset);
@@ -474,27 +474,9 @@ static void Decrypt(u8 *CipherBufferPtr, u8 *PlainBufferPtr, u8 *Key, u16 Length
  ******************************************************************************/
 static u16 EepromGet(u16 Address, u8 *BufferPtr, u16 Length)
 {
-	u16 i;
-	u8 BytesRead;
-	u16 TotalBytesRead;
-	u8 *Ptr;
-
-	Ptr = BufferPtr;
-	TotalBytesRead = 0;
-	for (i=0; i<(Length / XHDCP_EEPROM_PAGE_SIZE); i++)
-	{
-		BytesRead = EepromReadByte(Address, Ptr, XHDCP_EEPROM_PAGE_SIZE);
-		TotalBytesRead += BytesRead;
-		Address += BytesRead;
-		Ptr += BytesRead;
-	}
-
-	if (Length > TotalBytesRead)
-	{
-		BytesRead = EepromReadByte(Address, Ptr, (Length - TotalBytesRead));
-		TotalBytesRead += BytesRead;
-	}
-	return TotalBytesRead;
+	// The EEPROM increments its address across pages on a read,
+	// so the whole array comes in one sequential read
+	return EepromReadByte(Address, BufferPtr, Length);
 }
 
 /*****************************************************************************/
@@ -514,52 +496,32 @@ static u16 EepromGet(u16 Address, u8 *BufferPtr, u16 Length)
 * @note		None.
 *
 ****************************************************************************/
-u8 EepromReadByte(u16 Address, u8 *BufferPtr, u16 ByteCount)
+u16 EepromReadByte(u16 Address, u8 *BufferPtr, u16 ByteCount)
 {
-	volatile u8 ReceivedByteCount;
-	u16 StatusReg;
+	static IicBusClient EepromClient;
 	u8 WriteBuffer[sizeof(Address)];
 
+	if (EepromClient.Bus == NULL) {
+		iic_bus_client_init(&EepromClient, iic_bus_get(XHDCP_IIC_BASEADDR),
+				"hdcp_eeprom", XHDCP_EEPROM_ADDRESS, IIC_BUS_ROOT);
+	}
+
 	WriteBuffer[0] = (u8)(Address >> 8);
 	WriteBuffer[1] = (u8)(Address);
 
 	/*
-	 * Set the address register to the specified address by writing
-	 * the address to the device, this must be tried until it succeeds
-	 * because a previous write to the device could be pending and it
-	 * will not ack until that write is complete.
+	 * Write the address, then read the number of bytes at it after a
+	 * repeated START. A previous write to the device could be pending
+	 * and it will not ack until that write is complete; the bus manager
+	 * retries the address phase until it does.
 	 */
-	do {
-		StatusReg = XIic_ReadReg(XHDCP_IIC_BASEADDR, XIIC_SR_REG_OFFSET);
-		if(!(StatusReg & XIIC_SR_BUS_BUSY_MASK)) {
-			ReceivedByteCount = XIic_Send(XHDCP_IIC_BASEADDR,
-							XHDCP_EEPROM_ADDRESS,
-							WriteBuffer,
-							sizeof(Address),
-							XIIC_STOP);
-
-			if (ReceivedByteCount != sizeof(Address)) {
-
-				/* Send is aborted so reset Tx FIFO */
-				XIic_WriteReg(XHDCP_IIC_BASEADDR,
-						XIIC_CR_REG_OFFSET,
-						XIIC_CR_TX_FIFO_RESET_MASK);
-				XIic_WriteReg(XHDCP_IIC_BASEADDR,
-						XIIC_CR_REG_OFFSET,
-						XIIC_CR_ENABLE_DEVICE_MASK);
-			}
-		}
-
-	} while (ReceivedByteCount != sizeof(Address));
-
-	/*
-	 * Read the number of bytes at the specified address from the EEPROM.
-	 */
-	ReceivedByteCount = XIic_Recv(XHDCP_IIC_BASEADDR, XHDCP_EEPROM_ADDRESS,
-					BufferPtr, ByteCount, XIIC_STOP);
+	if (iic_bus_transfer(&EepromClient, WriteBuffer, sizeof(Address),
+				BufferPtr, ByteCount) != XST_SUCCESS) {
+		return 0;
+	}
 
 	/*
 	 * Return the number of bytes read from the EEPROM.
 	 */
-	return ReceivedByteCount;
+	return ByteCount;
 }
@@ -34,6 +34,7 @@ extern "C" {
 #include "xil_printf.h"
 #include "sleep.h"
 #include "xiic.h"
+#include "iic_bus.h"
 #include "aes256.h"
 #include "sha256.h"
 #include "xparameters.h"
@@ -0,0 +1,127 @@
+#include "dma_intr.h"
+#include "xtime_l.h"
+
+// Loop bound for the reset after an error
+#define DMA_INTR_RESET_TIMEOUT  10000
+// dma_intr_wait() gives up after this many milliseconds of the global timer
+#define DMA_INTR_WAIT_TIMEOUT_MS    1000
+
+static void dma_intr_handler(DmaIntr *IntrPtr, int Direction);
+
+int dma_intr_init(DmaIntr *IntrPtr, XAxiDma *DmaInsPtr) {
+    if (XAxiDma_HasSg(DmaInsPtr)) {
+        xil_printf("DMA interrupt completion needs simple mode\r\n");
+        return XST_FAILURE;
+    }
+
+    IntrPtr->DmaInsPtr = DmaInsPtr;
+    IntrPtr->Handler = NULL;
+    IntrPtr->CallBackRef = NULL;
+    dma_intr_arm(IntrPtr);
+
+    // Drop anything left over, then only completion and error interrupts
+    XAxiDma_IntrAckIrq(DmaInsPtr, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrAckIrq(DmaInsPtr, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrEnable(DmaInsPtr, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK,
+                       XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrEnable(DmaInsPtr, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK,
+                       XAXIDMA_DEVICE_TO_DMA);
+
+    return XST_SUCCESS;
+}
+
+void dma_intr_set_handler(DmaIntr *IntrPtr, DmaDoneHandler Handler, void *CallBackRef) {
+    IntrPtr->Handler = Handler;
+    IntrPtr->CallBackRef = CallBackRef;
+}
+
+// Clear the completion flags, must be called before every transfer
+void dma_intr_arm(DmaIntr *IntrPtr) {
+    IntrPtr->TxDone = 0;
+    IntrPtr->RxDone = 0;
+    IntrPtr->Error = 0;
+}
+
+// XST_NO_DATA while running, then XST_SUCCESS or XST_FAILURE
+int dma_intr_is_done(DmaIntr *IntrPtr) {
+    if (IntrPtr->Error) {
+        return XST_FAILURE;
+    }
+    if (IntrPtr->TxDone && IntrPtr->RxDone) {
+        return XST_SUCCESS;
+    }
+    return XST_NO_DATA;
+}
+
+int dma_intr_wait(DmaIntr *IntrPtr) {
+    XTime Start, Now;
+    int Status;
+
+    // The flags flip in the IOC handler: spin on them with no sleep in
+    // between, the global timer only bounds the wait
+    XTime_GetTime(&Start);
+    do {
+        Status = dma_intr_is_done(IntrPtr);
+        if (Status != XST_NO_DATA) {
+            return Status;
+        }
+        XTime_GetTime(&Now);
+    } while (Now - Start < (XTime)COUNTS_PER_SECOND / 1000 * DMA_INTR_WAIT_TIMEOUT_MS);
+
+    xil_printf("DMA interrupt timed out!\r\n");
+    return XST_FAILURE;
+}
+
+void dma_intr_tx_handler(void *CallBackRef) {
+    dma_intr_handler((DmaIntr *)CallBackRef, XAXIDMA_DMA_TO_DEVICE);
+}
+
+void dma_intr_rx_handler(void *CallBackRef) {
+    dma_intr_handler((DmaIntr *)CallBackRef, XAXIDMA_DEVICE_TO_DMA);
+}
+
+static void dma_intr_handler(DmaIntr *IntrPtr, int Direction) {
+    XAxiDma *DmaInsPtr = IntrPtr->DmaInsPtr;
+    u32 IrqStatus;
+    int TimeOut;
+
+    IrqStatus = XAxiDma_IntrGetIrq(DmaInsPtr, Direction);
+    XAxiDma_IntrAckIrq(DmaInsPtr, IrqStatus, Direction);
+
+    if (!(IrqStatus & XAXIDMA_IRQ_ALL_MASK)) {
+        return;
+    }
+
+    if (IrqStatus & XAXIDMA_IRQ_ERROR_MASK) {
+        IntrPtr->Error = 1;
+
+        // The engine halts on error, a reset is needed before the next transfer
+        XAxiDma_Reset(DmaInsPtr);
+        TimeOut = DMA_INTR_RESET_TIMEOUT;
+        while (TimeOut) {
+            if (XAxiDma_ResetIsDone(DmaInsPtr)) break;
+            TimeOut--;
+        }
+        XAxiDma_IntrEnable(DmaInsPtr, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK,
+                           XAXIDMA_DMA_TO_DEVICE);
+        XAxiDma_IntrEnable(DmaInsPtr, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK,
+                           XAXIDMA_DEVICE_TO_DMA);
+
+        if (IntrPtr->Handler) {
+            IntrPtr->Handler(IntrPtr->CallBackRef, XST_FAILURE);
+        }
+        return;
+    }
+
+    if (IrqStatus & XAXIDMA_IRQ_IOC_MASK) {
+        if (Direction == XAXIDMA_DMA_TO_DEVICE) {
+            IntrPtr->TxDone = 1;
+        } else {
+            IntrPtr->RxDone = 1;
+        }
+
+        if (IntrPtr->TxDone && IntrPtr->RxDone && IntrPtr->Handler) {
+            IntrPtr->Handler(IntrPtr->CallBackRef, XST_SUCCESS);
+        }
+    }
+}
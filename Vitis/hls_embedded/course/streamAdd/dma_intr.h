@@ -0,0 +1,43 @@
+#ifndef DMA_INTR_H
+#define DMA_INTR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xaxidma.h"
+#include "xil_printf.h"
+
+// Called from interrupt context once both channels finished, or on the first error
+typedef void (*DmaDoneHandler)(void *CallBackRef, int Status);
+
+/*
+ * IOC interrupt completion for simple-mode transfers.
+ * Connect dma_intr_tx_handler()/dma_intr_rx_handler() to the MM2S/S2MM
+ * interrupt lines, call dma_intr_arm() before kicking off a transfer, then
+ * either poll dma_intr_is_done() or block in dma_intr_wait().
+ */
+typedef struct {
+    XAxiDma *DmaInsPtr;
+    volatile u8 TxDone;
+    volatile u8 RxDone;
+    volatile u8 Error;
+    DmaDoneHandler Handler;
+    void *CallBackRef;
+} DmaIntr;
+
+int  dma_intr_init(DmaIntr *IntrPtr, XAxiDma *DmaInsPtr);
+void dma_intr_set_handler(DmaIntr *IntrPtr, DmaDoneHandler Handler, void *CallBackRef);
+void dma_intr_arm(DmaIntr *IntrPtr);
+int  dma_intr_is_done(DmaIntr *IntrPtr);
+int  dma_intr_wait(DmaIntr *IntrPtr);
+
+void dma_intr_tx_handler(void *CallBackRef);
+void dma_intr_rx_handler(void *CallBackRef);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_INTR_H */
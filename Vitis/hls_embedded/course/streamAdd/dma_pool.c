@@ -0,0 +1,235 @@
+#include "dma_pool.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+
+#define DMA_POOL_LINE_MASK  (DMA_POOL_CACHE_LINE - 1)
+
+static u32 dma_pool_round(u32 Size);
+static DmaBuf *dma_pool_slot(DmaPool *PoolPtr, u32 Size, u8 NonCached);
+
+static u32 dma_pool_round(u32 Size) {
+    return (Size + DMA_POOL_LINE_MASK) & ~(u32)DMA_POOL_LINE_MASK;
+}
+
+// Reuse a freed buffer of the same kind that is big enough, otherwise carve a new one
+static DmaBuf *dma_pool_slot(DmaPool *PoolPtr, u32 Size, u8 NonCached) {
+    DmaBuf *Unused = NULL;
+    DmaBuf *BufPtr;
+    int i;
+
+    for (i = 0; i < DMA_POOL_BUF_NUM; i++) {
+        BufPtr = &PoolPtr->Bufs[i];
+        if (BufPtr->State != DMA_BUF_FREE) {
+            continue;
+        }
+        if (BufPtr->Size == 0) {
+            if (!Unused) {
+                Unused = BufPtr;
+            }
+            continue;
+        }
+        if (BufPtr->NonCached == NonCached && BufPtr->Size >= Size) {
+            return BufPtr;
+        }
+    }
+
+    if (!Unused) {
+        return NULL;
+    }
+
+    if (NonCached) {
+        if (PoolPtr->NcSize - PoolPtr->NcUsed < Size) {
+            return NULL;
+        }
+        Unused->Addr = PoolPtr->NcBase + PoolPtr->NcUsed;
+        PoolPtr->NcUsed += Size;
+    } else {
+        if (PoolPtr->Size - PoolPtr->Used < Size) {
+            return NULL;
+        }
+        Unused->Addr = PoolPtr->Base + PoolPtr->Used;
+        PoolPtr->Used += Size;
+    }
+    Unused->Size = Size;
+    Unused->NonCached = NonCached;
+
+    return Unused;
+}
+
+int dma_pool_init(DmaPool *PoolPtr, UINTPTR Base, u32 Size, UINTPTR NcBase, u32 NcSize) {
+    UINTPTR Section;
+    int i;
+
+    if ((Base & DMA_POOL_LINE_MASK) || (Size & DMA_POOL_LINE_MASK)) {
+        xil_printf("DMA pool arena not cache line aligned\r\n");
+        return XST_FAILURE;
+    }
+
+    if ((NcBase % DMA_POOL_NC_SECTION) || (NcSize % DMA_POOL_NC_SECTION)) {
+        xil_printf("DMA pool non-cacheable region not section aligned\r\n");
+        return XST_FAILURE;
+    }
+
+    PoolPtr->Base = Base;
+    PoolPtr->Size = Size;
+    PoolPtr->Used = 0;
+    PoolPtr->NcBase = NcBase;
+    PoolPtr->NcSize = NcSize;
+    PoolPtr->NcUsed = 0;
+    PoolPtr->FlushBytes = 0;
+    PoolPtr->InvalBytes = 0;
+
+    for (i = 0; i < DMA_POOL_BUF_NUM; i++) {
+        PoolPtr->Bufs[i].Addr = 0;
+        PoolPtr->Bufs[i].Size = 0;
+        PoolPtr->Bufs[i].State = DMA_BUF_FREE;
+        PoolPtr->Bufs[i].NonCached = 0;
+        PoolPtr->Bufs[i].DirtyLo = 0;
+        PoolPtr->Bufs[i].DirtyHi = 0;
+    }
+
+    // Whatever the regions held before is written back once here, after that
+    // the per-buffer dirty ranges are the only lines that can be dirty. A
+    // whole-cache flush is bounded by the cache size, not the arena size.
+    Xil_DCacheFlush();
+
+    if (NcSize) {
+        for (Section = NcBase; Section < NcBase + NcSize; Section += DMA_POOL_NC_SECTION) {
+            Xil_SetTlbAttributes(Section, NORM_NONCACHE);
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
+DmaBuf *dma_pool_alloc(DmaPool *PoolPtr, u32 Size, u32 Flags) {
+    DmaBuf *BufPtr = NULL;
+
+    Size = dma_pool_round(Size);
+    if (Size == 0) {
+        return NULL;
+    }
+
+    if (Flags == DMA_POOL_NONCACHED ||
+        (Flags == DMA_POOL_AUTO && Size >= DMA_POOL_NC_THRESHOLD)) {
+        BufPtr = dma_pool_slot(PoolPtr, Size, 1);
+    }
+
+    // AUTO falls back to the cached arena when the non-cacheable region is full
+    if (!BufPtr && Flags != DMA_POOL_NONCACHED) {
+        BufPtr = dma_pool_slot(PoolPtr, Size, 0);
+    }
+
+    if (!BufPtr) {
+        xil_printf("DMA pool out of buffers for %d bytes\r\n", Size);
+        return NULL;
+    }
+
+    BufPtr->State = DMA_BUF_CPU_VALID;
+    BufPtr->DirtyLo = BufPtr->Size;
+    BufPtr->DirtyHi = 0;
+
+    return BufPtr;
+}
+
+void dma_pool_free(DmaPool *PoolPtr, DmaBuf *BufPtr) {
+    (void)PoolPtr;
+
+    if (BufPtr->State == DMA_BUF_DEVICE) {
+        xil_printf("DMA pool: freeing a buffer still owned by the DMA\r\n");
+    }
+
+    // The next owner starts with an empty dirty range, so lines still dirty
+    // from this one are written back now instead of being forgotten
+    if (BufPtr->State == DMA_BUF_CPU_DIRTY && !BufPtr->NonCached) {
+        Xil_DCacheFlushRange(BufPtr->Addr + BufPtr->DirtyLo, BufPtr->DirtyHi - BufPtr->DirtyLo);
+        PoolPtr->FlushBytes += BufPtr->DirtyHi - BufPtr->DirtyLo;
+    }
+
+    BufPtr->State = DMA_BUF_FREE;
+}
+
+// CPU is about to write [Offset, Offset + Len)
+void *dma_buf_cpu_write(DmaBuf *BufPtr, u32 Offset, u32 Len) {
+    if (BufPtr->State == DMA_BUF_FREE || BufPtr->State == DMA_BUF_DEVICE) {
+        xil_printf("DMA buffer not owned by the CPU\r\n");
+        return NULL;
+    }
+    if (Offset + Len > BufPtr->Size) {
+        xil_printf("DMA buffer write out of range\r\n");
+        return NULL;
+    }
+
+    if (Len) {
+        if (Offset < BufPtr->DirtyLo) {
+            BufPtr->DirtyLo = Offset;
+        }
+        if (Offset + Len > BufPtr->DirtyHi) {
+            BufPtr->DirtyHi = Offset + Len;
+        }
+        BufPtr->State = DMA_BUF_CPU_DIRTY;
+    }
+
+    return (void *)(BufPtr->Addr + Offset);
+}
+
+// CPU is about to read [Offset, Offset + Len)
+void *dma_buf_cpu_read(DmaBuf *BufPtr, u32 Offset, u32 Len) {
+    if (BufPtr->State == DMA_BUF_FREE || BufPtr->State == DMA_BUF_DEVICE) {
+        xil_printf("DMA buffer not owned by the CPU\r\n");
+        return NULL;
+    }
+    if (Offset + Len > BufPtr->Size) {
+        xil_printf("DMA buffer read out of range\r\n");
+        return NULL;
+    }
+
+    return (void *)(BufPtr->Addr + Offset);
+}
+
+// Hand the buffer to the DMA, call before the transfer is started
+int dma_buf_to_device(DmaPool *PoolPtr, DmaBuf *BufPtr) {
+    u32 Len;
+
+    if (BufPtr->State == DMA_BUF_FREE || BufPtr->State == DMA_BUF_DEVICE) {
+        xil_printf("DMA buffer not owned by the CPU\r\n");
+        return XST_FAILURE;
+    }
+
+    // Only lines the CPU wrote can be dirty. For the MM2S side they carry the
+    // data, for the S2MM side they must be written back now so an eviction
+    // cannot land on top of what the DMA writes. A clean buffer needs nothing.
+    if (BufPtr->State == DMA_BUF_CPU_DIRTY && !BufPtr->NonCached) {
+        Len = BufPtr->DirtyHi - BufPtr->DirtyLo;
+        Xil_DCacheFlushRange(BufPtr->Addr + BufPtr->DirtyLo, Len);
+        PoolPtr->FlushBytes += Len;
+    }
+
+    BufPtr->DirtyLo = BufPtr->Size;
+    BufPtr->DirtyHi = 0;
+    BufPtr->State = DMA_BUF_DEVICE;
+
+    return XST_SUCCESS;
+}
+
+// Take the buffer back once the transfer is done, Len is what the DMA wrote
+int dma_buf_from_device(DmaPool *PoolPtr, DmaBuf *BufPtr, int Direction, u32 Len) {
+    if (BufPtr->State != DMA_BUF_DEVICE) {
+        xil_printf("DMA buffer not owned by the DMA\r\n");
+        return XST_FAILURE;
+    }
+    if (Len > BufPtr->Size) {
+        Len = BufPtr->Size;
+    }
+
+    // Lines of an S2MM buffer may still sit in the cache from before (speculative
+    // fetches included), drop the ones the DMA wrote. MM2S leaves memory alone.
+    if (Direction == DMA_BUF_FROM_DEVICE && !BufPtr->NonCached && Len) {
+        Xil_DCacheInvalidateRange(BufPtr->Addr, Len);
+        PoolPtr->InvalBytes += Len;
+    }
+
+    BufPtr->State = DMA_BUF_CPU_VALID;
+
+    return XST_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#ifndef DMA_POOL_H
+#define DMA_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xil_types.h"
+#include "xil_printf.h"
+
+// Buffers handed out by one pool
+#define DMA_POOL_BUF_NUM        16
+
+// D-cache line size, buffers start and end on a line boundary
+#ifndef DMA_POOL_CACHE_LINE
+#define DMA_POOL_CACHE_LINE     64
+#endif
+
+// MMU section size, the granularity at which a region can be made non-cacheable
+// (2 MB on the Cortex-A53 translation tables)
+#ifndef DMA_POOL_NC_SECTION
+#define DMA_POOL_NC_SECTION     0x00200000
+#endif
+
+// DMA_POOL_AUTO picks the non-cacheable region from this size up, where
+// line-by-line maintenance costs more than uncached CPU access
+#ifndef DMA_POOL_NC_THRESHOLD
+#define DMA_POOL_NC_THRESHOLD   0x00040000
+#endif
+
+// dma_pool_alloc() flags
+#define DMA_POOL_CACHED         0
+#define DMA_POOL_NONCACHED      1
+#define DMA_POOL_AUTO           2
+
+// Direction of a transfer, same values as XAXIDMA_DMA_TO_DEVICE/DEVICE_TO_DMA
+#define DMA_BUF_TO_DEVICE       0
+#define DMA_BUF_FROM_DEVICE     1
+
+// Who may touch the buffer and what the cache holds for it
+#define DMA_BUF_FREE            0
+#define DMA_BUF_CPU_VALID       1   // Cache and memory agree, CPU may read or write
+#define DMA_BUF_CPU_DIRTY       2   // CPU wrote [DirtyLo, DirtyHi), not yet in memory
+#define DMA_BUF_DEVICE          3   // Owned by the DMA, CPU must not touch it
+
+typedef struct {
+    UINTPTR Addr;
+    u32 Size;
+    u8 State;
+    u8 NonCached;
+    u32 DirtyLo;                // Byte offsets written by the CPU since the last hand-off
+    u32 DirtyHi;
+} DmaBuf;
+
+/*
+ * DMA buffer pool over a cache-line-aligned arena plus an optional
+ * non-cacheable region. Every buffer tracks its cache state, so handing it
+ * to the DMA flushes only the bytes the CPU wrote and taking it back
+ * invalidates only the bytes the DMA wrote; non-cacheable buffers need
+ * neither.
+ */
+typedef struct {
+    UINTPTR Base;
+    u32 Size;
+    u32 Used;
+    UINTPTR NcBase;
+    u32 NcSize;
+    u32 NcUsed;
+    DmaBuf Bufs[DMA_POOL_BUF_NUM];
+    u32 FlushBytes;             // Maintenance actually issued, for tuning
+    u32 InvalBytes;
+} DmaPool;
+
+int     dma_pool_init(DmaPool *PoolPtr, UINTPTR Base, u32 Size, UINTPTR NcBase, u32 NcSize);
+DmaBuf *dma_pool_alloc(DmaPool *PoolPtr, u32 Size, u32 Flags);
+void    dma_pool_free(DmaPool *PoolPtr, DmaBuf *BufPtr);
+
+void   *dma_buf_cpu_write(DmaBuf *BufPtr, u32 Offset, u32 Len);
+void   *dma_buf_cpu_read(DmaBuf *BufPtr, u32 Offset, u32 Len);
+int     dma_buf_to_device(DmaPool *PoolPtr, DmaBuf *BufPtr);
+int     dma_buf_from_device(DmaPool *PoolPtr, DmaBuf *BufPtr, int Direction, u32 Len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_POOL_H */
@@ -0,0 +1,217 @@
+#include "dma_stream.h"
+#include "xil_cache.h"
+#include "sleep.h"
+
+// Loop bound for the reset after a failed submit
+#define DMA_STREAM_RESET_TIMEOUT    10000
+
+static int dma_stream_ring_setup(XAxiDma_BdRing *RingPtr, UINTPTR BdSpace);
+static int dma_stream_rings(DmaStream *StreamPtr);
+
+static int dma_stream_ring_setup(XAxiDma_BdRing *RingPtr, UINTPTR BdSpace) {
+    XAxiDma_Bd BdTemplate;
+    int Status;
+
+    // Completion is polled through dma_stream_complete()
+    XAxiDma_BdRingIntDisable(RingPtr, XAXIDMA_IRQ_ALL_MASK);
+
+    Status = XAxiDma_BdRingCreate(RingPtr, BdSpace, BdSpace,
+                                  XAXIDMA_BD_MINIMUM_ALIGNMENT, DMA_STREAM_BD_NUM);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA BD ring create failed\r\n");
+        return XST_FAILURE;
+    }
+
+    XAxiDma_BdClear(&BdTemplate);
+    Status = XAxiDma_BdRingClone(RingPtr, &BdTemplate);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA BD ring clone failed\r\n");
+        return XST_FAILURE;
+    }
+
+    Status = XAxiDma_BdRingStart(RingPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA BD ring start failed\r\n");
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+int dma_stream_init(DmaStream *StreamPtr, XAxiDma *DmaInsPtr, UINTPTR BdSpace) {
+    if (!XAxiDma_HasSg(DmaInsPtr)) {
+        xil_printf("DMA is not in scatter-gather mode\r\n");
+        return XST_FAILURE;
+    }
+
+    StreamPtr->DmaInsPtr = DmaInsPtr;
+    StreamPtr->BdSpace = BdSpace;
+    StreamPtr->InFlight = 0;
+
+    return dma_stream_rings(StreamPtr);
+}
+
+static int dma_stream_rings(DmaStream *StreamPtr) {
+    int Status;
+
+    // TX ring in the first half of the BD space, RX ring in the second
+    Status = dma_stream_ring_setup(XAxiDma_GetTxRing(StreamPtr->DmaInsPtr), StreamPtr->BdSpace);
+    if (Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    Status = dma_stream_ring_setup(XAxiDma_GetRxRing(StreamPtr->DmaInsPtr),
+                                   StreamPtr->BdSpace + DMA_STREAM_BD_SPACE / 2);
+    if (Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+// Stop both channels and give every descriptor back, including ones the
+// hardware already owns
+static void dma_stream_reset(DmaStream *StreamPtr) {
+    int TimeOut = DMA_STREAM_RESET_TIMEOUT;
+
+    XAxiDma_Reset(StreamPtr->DmaInsPtr);
+    while (TimeOut) {
+        if (XAxiDma_ResetIsDone(StreamPtr->DmaInsPtr)) break;
+        TimeOut--;
+    }
+
+    StreamPtr->InFlight = 0;
+    if (dma_stream_rings(StreamPtr) != XST_SUCCESS) {
+        xil_printf("DMA stream reset failed\r\n");
+    }
+}
+
+// Queue one packet, returns XST_DEVICE_BUSY when all descriptors are in flight
+int dma_stream_submit(DmaStream *StreamPtr, UINTPTR InAddr, UINTPTR OutAddr, u32 Length) {
+    XAxiDma_BdRing *TxRingPtr = XAxiDma_GetTxRing(StreamPtr->DmaInsPtr);
+    XAxiDma_BdRing *RxRingPtr = XAxiDma_GetRxRing(StreamPtr->DmaInsPtr);
+    XAxiDma_Bd *TxBdPtr;
+    XAxiDma_Bd *RxBdPtr;
+    int Status;
+
+    if (StreamPtr->InFlight >= DMA_STREAM_BD_NUM) {
+        return XST_DEVICE_BUSY;
+    }
+
+    Xil_DCacheFlushRange(InAddr, Length);
+    Xil_DCacheFlushRange(OutAddr, Length);
+
+    // S2MM first, so the receive side is ready before the IP produces data
+    Status = XAxiDma_BdRingAlloc(RxRingPtr, 1, &RxBdPtr);
+    if (Status != XST_SUCCESS) {
+        return XST_DEVICE_BUSY;
+    }
+
+    XAxiDma_BdSetBufAddr(RxBdPtr, OutAddr);
+    XAxiDma_BdSetLength(RxBdPtr, Length, RxRingPtr->MaxTransferLen);
+    XAxiDma_BdSetCtrl(RxBdPtr, 0);
+    XAxiDma_BdSetId(RxBdPtr, OutAddr);
+
+    Status = XAxiDma_BdRingAlloc(TxRingPtr, 1, &TxBdPtr);
+    if (Status != XST_SUCCESS) {
+        XAxiDma_BdRingUnAlloc(RxRingPtr, 1, RxBdPtr);
+        return XST_DEVICE_BUSY;
+    }
+
+    // One descriptor per packet, so it carries both SOF and EOF
+    XAxiDma_BdSetBufAddr(TxBdPtr, InAddr);
+    XAxiDma_BdSetLength(TxBdPtr, Length, TxRingPtr->MaxTransferLen);
+    XAxiDma_BdSetCtrl(TxBdPtr, XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK);
+    XAxiDma_BdSetId(TxBdPtr, InAddr);
+
+    Status = XAxiDma_BdRingToHw(RxRingPtr, 1, RxBdPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA RX BD to hw failed\r\n");
+        XAxiDma_BdRingUnAlloc(TxRingPtr, 1, TxBdPtr);
+        XAxiDma_BdRingUnAlloc(RxRingPtr, 1, RxBdPtr);
+        return XST_FAILURE;
+    }
+
+    Status = XAxiDma_BdRingToHw(TxRingPtr, 1, TxBdPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA TX BD to hw failed\r\n");
+        XAxiDma_BdRingUnAlloc(TxRingPtr, 1, TxBdPtr);
+        // The RX descriptor is already with S2MM and no packet will come for it
+        dma_stream_reset(StreamPtr);
+        return XST_FAILURE;
+    }
+
+    StreamPtr->InFlight++;
+
+    return XST_SUCCESS;
+}
+
+// Non-blocking, returns XST_NO_DATA while the oldest packet is still running
+int dma_stream_complete(DmaStream *StreamPtr, UINTPTR *OutAddrPtr, u32 *LengthPtr) {
+    XAxiDma_BdRing *TxRingPtr = XAxiDma_GetTxRing(StreamPtr->DmaInsPtr);
+    XAxiDma_BdRing *RxRingPtr = XAxiDma_GetRxRing(StreamPtr->DmaInsPtr);
+    XAxiDma_Bd *BdPtr;
+    XAxiDma_Bd *CurBdPtr;
+    int BdCount;
+    u32 BdSts;
+    int Status = XST_SUCCESS;
+
+    // Recycle every MM2S descriptor the hardware is done with
+    BdCount = XAxiDma_BdRingFromHw(TxRingPtr, XAXIDMA_ALL_BDS, &BdPtr);
+    if (BdCount > 0) {
+        CurBdPtr = BdPtr;
+        for (int Index = 0; Index < BdCount; Index++) {
+            if (XAxiDma_BdGetSts(CurBdPtr) & XAXIDMA_BD_STS_ALL_ERR_MASK) {
+                xil_printf("DMA TX BD error\r\n");
+                Status = XST_FAILURE;
+            }
+            CurBdPtr = (XAxiDma_Bd *)XAxiDma_BdRingNext(TxRingPtr, CurBdPtr);
+        }
+        XAxiDma_BdRingFree(TxRingPtr, BdCount, BdPtr);
+    }
+    if (Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    BdCount = XAxiDma_BdRingFromHw(RxRingPtr, 1, &BdPtr);
+    if (BdCount == 0) {
+        return XST_NO_DATA;
+    }
+
+    BdSts = XAxiDma_BdGetSts(BdPtr);
+    *OutAddrPtr = (UINTPTR)XAxiDma_BdGetId(BdPtr);
+    *LengthPtr = XAxiDma_BdGetActualLength(BdPtr, RxRingPtr->MaxTransferLen);
+    XAxiDma_BdRingFree(RxRingPtr, 1, BdPtr);
+    StreamPtr->InFlight--;
+
+    if ((BdSts & XAXIDMA_BD_STS_ALL_ERR_MASK) || !(BdSts & XAXIDMA_BD_STS_COMPLETE_MASK)) {
+        xil_printf("DMA RX BD error\r\n");
+        return XST_FAILURE;
+    }
+
+    Xil_DCacheInvalidateRange(*OutAddrPtr, *LengthPtr);
+
+    return XST_SUCCESS;
+}
+
+// Blocking version of dma_stream_complete()
+int dma_stream_wait(DmaStream *StreamPtr, UINTPTR *OutAddrPtr, u32 *LengthPtr) {
+    int Status;
+    int TimeOut = 1000000;  // Time threshold
+
+    if (StreamPtr->InFlight == 0) {
+        return XST_NO_DATA;
+    }
+
+    while (TimeOut) {
+        Status = dma_stream_complete(StreamPtr, OutAddrPtr, LengthPtr);
+        if (Status != XST_NO_DATA) {
+            return Status;
+        }
+        TimeOut--;
+        usleep(1U);
+    }
+
+    xil_printf("DMA stream timed out!\r\n");
+    return XST_FAILURE;
+}
@@ -0,0 +1,41 @@
+#ifndef DMA_STREAM_H
+#define DMA_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xparameters.h"
+#include "xaxidma.h"
+#include "xil_printf.h"
+
+// Descriptors per direction, i.e. how many packets can be in flight at once
+#define DMA_STREAM_BD_NUM       8
+
+// Bytes of BD space dma_stream_init() needs (TX ring followed by RX ring)
+#define DMA_STREAM_BD_SPACE     (2 * DMA_STREAM_BD_NUM * XAXIDMA_BD_MINIMUM_ALIGNMENT)
+
+/*
+ * Scatter-gather streaming engine.
+ * Every dma_stream_submit() queues one MM2S/S2MM descriptor pair and returns
+ * straight away, so the CPU can fill the next buffer while the IP works on
+ * the current one. Packets complete in submit order.
+ * If a submit fails after its S2MM descriptor went to the hardware, the
+ * engine is reset and the rings are rebuilt: every packet in flight is lost.
+ */
+typedef struct {
+    XAxiDma *DmaInsPtr;
+    UINTPTR BdSpace;
+    u32 InFlight;               // Packets submitted and not yet completed
+} DmaStream;
+
+int dma_stream_init(DmaStream *StreamPtr, XAxiDma *DmaInsPtr, UINTPTR BdSpace);
+int dma_stream_submit(DmaStream *StreamPtr, UINTPTR InAddr, UINTPTR OutAddr, u32 Length);
+int dma_stream_complete(DmaStream *StreamPtr, UINTPTR *OutAddrPtr, u32 *LengthPtr);
+int dma_stream_wait(DmaStream *StreamPtr, UINTPTR *OutAddrPtr, u32 *LengthPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_STREAM_H */
@@ -0,0 +1,544 @@
+#include "sim_model.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xaxidma.h"
+
+#include <map>
+#include <vector>
+#include <cstring>
+
+// MM2S/S2MM interrupt lines as wired in xparameters.h
+static const u32 dma_intr_id[2] = {
+    XPAR_FABRIC_AXI_DMA_0_MM2S_INTROUT_INTR,
+    XPAR_FABRIC_AXI_DMA_0_S2MM_INTROUT_INTR
+};
+
+/***** Register model *****/
+struct SimDmaChan {
+    u32 cr;
+    u32 sr;
+    u32 cdesc;
+    u32 tdesc;
+    u32 addr;
+    UINTPTR fetch;              // SG: next BD the engine will fetch, 0 = none
+    int observe;                // Simple mode: completion not yet seen by software
+    double kick;
+    std::map<UINTPTR, double> bd_kick;  // SG: RX BD -> kick time
+};
+
+static SimDmaChan chan[2];
+
+static void dma_update_irq(int Dir) {
+    sim_irq_set(dma_intr_id[Dir], (chan[Dir].sr & chan[Dir].cr & XAXIDMA_IRQ_ALL_MASK) != 0);
+}
+
+static void dma_raise(int Dir, u32 Mask) {
+    chan[Dir].sr |= Mask & chan[Dir].cr & XAXIDMA_IRQ_ALL_MASK;
+    if (Mask & XAXIDMA_IRQ_ERROR_MASK) {
+        chan[Dir].sr |= XAXIDMA_ERR_INTERNAL_MASK | XAXIDMA_HALTED_MASK;
+    }
+    dma_update_irq(Dir);
+}
+
+static void dma_chan_reset(int Dir) {
+    chan[Dir].cr = 0;
+    chan[Dir].sr = XAXIDMA_HALTED_MASK | (sim_cfg.has_sg ? XAXIDMA_SR_SGINCL_MASK : 0);
+    chan[Dir].cdesc = 0;
+    chan[Dir].tdesc = 0;
+    chan[Dir].addr = 0;
+    chan[Dir].fetch = 0;
+    chan[Dir].observe = 0;
+    chan[Dir].bd_kick.clear();
+    dma_update_irq(Dir);
+}
+
+void sim_dma_reset() {
+    dma_chan_reset(XAXIDMA_DMA_TO_DEVICE);
+    dma_chan_reset(XAXIDMA_DEVICE_TO_DMA);
+}
+
+// Simple mode: a BUFFLEN write starts the transfer
+static void dma_simple_start(int Dir, u32 Length) {
+    SimDmaChan &c = chan[Dir];
+
+    // Starting a halted channel is a programming error on real hardware
+    if (c.sr & XAXIDMA_HALTED_MASK) {
+        dma_raise(Dir, XAXIDMA_IRQ_ERROR_MASK);
+        return;
+    }
+    c.sr &= ~XAXIDMA_IDLE_MASK;
+
+    if (Dir == XAXIDMA_DMA_TO_DEVICE) {
+        SimMm2sReq req;
+        req.addr[0] = c.addr;
+        req.len[0] = Length;
+        req.segs = 1;
+        req.ready = sim_now();
+        req.done = []() {
+            chan[XAXIDMA_DMA_TO_DEVICE].sr |= XAXIDMA_IDLE_MASK;
+            dma_raise(XAXIDMA_DMA_TO_DEVICE, XAXIDMA_IRQ_IOC_MASK);
+        };
+        sim_datapath_mm2s(req);
+    } else {
+        SimS2mmReq req;
+        req.addr = c.addr;
+        req.len = Length;
+        req.ready = sim_now();
+        req.done = [](u32 actual, int error, double kick) {
+            SimDmaChan &rx = chan[XAXIDMA_DEVICE_TO_DMA];
+            (void)actual;
+            rx.sr |= XAXIDMA_IDLE_MASK;
+            rx.observe = 1;
+            rx.kick = kick;
+            dma_raise(XAXIDMA_DEVICE_TO_DMA, error ? XAXIDMA_IRQ_ERROR_MASK : XAXIDMA_IRQ_IOC_MASK);
+        };
+        sim_datapath_s2mm(req);
+    }
+    sim_datapath_kick();
+}
+
+// SG mode: fetch every BD up to the tail pointer, following the NDESC chain
+static void dma_sg_fetch(int Dir) {
+    SimDmaChan &c = chan[Dir];
+    static std::vector<UINTPTR> pkt_bds;    // TX BDs of the packet being gathered
+    SimMm2sReq pkt;
+    double ready = sim_now();
+
+    pkt.segs = 0;
+    while (c.fetch) {
+        XAxiDma_Bd *BdPtr = (XAxiDma_Bd *)c.fetch;
+        u32 Ctrl = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
+        UINTPTR Buf = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_BUFA_OFFSET);
+        u32 Len = Ctrl & XAXIDMA_MAX_TRANSFER_LEN;
+        int Last = (c.fetch == c.tdesc);
+
+        ready += sim_cfg.bd_fetch_ns;
+
+        if (Dir == XAXIDMA_DMA_TO_DEVICE) {
+            if (pkt.segs < 16) {
+                pkt.addr[pkt.segs] = Buf;
+                pkt.len[pkt.segs] = Len;
+                pkt.segs++;
+            }
+            pkt_bds.push_back(c.fetch);
+            // Every BD of the packet completes together with its EOF descriptor
+            if (Ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK) {
+                std::vector<UINTPTR> bds;
+                bds.swap(pkt_bds);
+                pkt.ready = ready;
+                pkt.done = [bds]() {
+                    for (size_t i = 0; i < bds.size(); i++) {
+                        u32 Len = XAxiDma_BdRead(bds[i], XAXIDMA_BD_CTRL_LEN_OFFSET) & XAXIDMA_MAX_TRANSFER_LEN;
+                        XAxiDma_BdWrite(bds[i], XAXIDMA_BD_STS_OFFSET, XAXIDMA_BD_STS_COMPLETE_MASK | Len);
+                    }
+                    dma_raise(XAXIDMA_DMA_TO_DEVICE, XAXIDMA_IRQ_IOC_MASK);
+                };
+                sim_datapath_mm2s(pkt);
+                pkt.segs = 0;
+            }
+        } else {
+            SimS2mmReq req;
+            UINTPTR bd = c.fetch;
+            req.addr = Buf;
+            req.len = Len;
+            req.ready = ready;
+            req.done = [bd](u32 actual, int error, double kick) {
+                u32 Sts = XAXIDMA_BD_STS_COMPLETE_MASK | XAXIDMA_BD_STS_RXSOF_MASK |
+                          XAXIDMA_BD_STS_RXEOF_MASK | (actual & XAXIDMA_BD_STS_ACTUAL_LEN_MASK);
+                if (error) Sts |= XAXIDMA_BD_STS_INT_ERR_MASK;
+                XAxiDma_BdWrite((XAxiDma_Bd *)bd, XAXIDMA_BD_STS_OFFSET, Sts);
+                chan[XAXIDMA_DEVICE_TO_DMA].bd_kick[bd] = kick;
+                dma_raise(XAXIDMA_DEVICE_TO_DMA, error ? XAXIDMA_IRQ_ERROR_MASK : XAXIDMA_IRQ_IOC_MASK);
+            };
+            sim_datapath_s2mm(req);
+        }
+
+        c.cdesc = (u32)c.fetch;
+        c.fetch = Last ? 0 : (UINTPTR)XAxiDma_BdRead(BdPtr, XAXIDMA_BD_NDESC_OFFSET);
+        if (Last) {
+            // Next TDESC write continues after the current tail
+            c.cdesc = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_NDESC_OFFSET);
+        }
+    }
+    sim_datapath_kick();
+}
+
+static u32 dma_read(u32 Offset) {
+    int Dir = Offset >= XAXIDMA_RX_OFFSET ? XAXIDMA_DEVICE_TO_DMA : XAXIDMA_DMA_TO_DEVICE;
+    SimDmaChan &c = chan[Dir];
+
+    switch (Offset - (Dir ? XAXIDMA_RX_OFFSET : 0)) {
+    case XAXIDMA_CR_OFFSET:
+        return c.cr;
+    case XAXIDMA_SR_OFFSET:
+        // First status read after an S2MM completion is when software sees it
+        if (Dir == XAXIDMA_DEVICE_TO_DMA && c.observe &&
+            (c.sr & (XAXIDMA_IDLE_MASK | XAXIDMA_IRQ_ALL_MASK))) {
+            sim_record_latency(sim_now() - c.kick);
+            c.observe = 0;
+        }
+        return c.sr;
+    case XAXIDMA_CDESC_OFFSET:
+        return c.cdesc;
+    case XAXIDMA_TDESC_OFFSET:
+        return c.tdesc;
+    case XAXIDMA_SRCADDR_OFFSET:
+        return c.addr;
+    default:
+        return 0;
+    }
+}
+
+static void dma_write(u32 Offset, u32 Value) {
+    int Dir = Offset >= XAXIDMA_RX_OFFSET ? XAXIDMA_DEVICE_TO_DMA : XAXIDMA_DMA_TO_DEVICE;
+    SimDmaChan &c = chan[Dir];
+
+    switch (Offset - (Dir ? XAXIDMA_RX_OFFSET : 0)) {
+    case XAXIDMA_CR_OFFSET:
+        if (Value & XAXIDMA_CR_RESET_MASK) {
+            // Soft reset hits both channels and completes at once
+            sim_dma_reset();
+            return;
+        }
+        c.cr = Value;
+        if (Value & XAXIDMA_CR_RUNSTOP_MASK) {
+            if ((c.sr & XAXIDMA_HALTED_MASK) && !sim_cfg.has_sg) c.sr |= XAXIDMA_IDLE_MASK;
+            c.sr &= ~XAXIDMA_HALTED_MASK;
+        } else {
+            c.sr |= XAXIDMA_HALTED_MASK;
+        }
+        dma_update_irq(Dir);
+        break;
+    case XAXIDMA_SR_OFFSET:
+        c.sr &= ~(Value & XAXIDMA_IRQ_ALL_MASK);
+        dma_update_irq(Dir);
+        break;
+    case XAXIDMA_CDESC_OFFSET:
+        c.cdesc = Value;
+        break;
+    case XAXIDMA_TDESC_OFFSET:
+        c.tdesc = Value;
+        if (!sim_cfg.has_sg || (c.sr & XAXIDMA_HALTED_MASK)) break;
+        c.sr &= ~XAXIDMA_IDLE_MASK;
+        if (!c.fetch) c.fetch = c.cdesc;
+        dma_sg_fetch(Dir);
+        break;
+    case XAXIDMA_SRCADDR_OFFSET:
+        c.addr = Value;
+        break;
+    case XAXIDMA_BUFFLEN_OFFSET:
+        if (!sim_cfg.has_sg) dma_simple_start(Dir, Value);
+        break;
+    default:
+        break;
+    }
+}
+
+static struct SimDmaMap {
+    SimDmaMap() {
+        SimRegWindow win = { XPAR_AXI_DMA_0_BASEADDR, 0x10000, dma_read, dma_write };
+        sim_map_regs(win);
+    }
+} dma_map;
+
+/***** Driver *****/
+static XAxiDma_Config dma_config;
+
+XAxiDma_Config *XAxiDma_LookupConfig(u32 DeviceId) {
+    if (DeviceId != XPAR_AXI_DMA_0_DEVICE_ID) {
+        return NULL;
+    }
+    memset(&dma_config, 0, sizeof(dma_config));
+    dma_config.DeviceId = DeviceId;
+    dma_config.BaseAddr = XPAR_AXI_DMA_0_BASEADDR;
+    dma_config.HasMm2S = 1;
+    dma_config.HasS2Mm = 1;
+    dma_config.HasSg = sim_cfg.has_sg;
+    dma_config.Mm2sNumChannels = 1;
+    dma_config.S2MmNumChannels = 1;
+    dma_config.AddrWidth = 32;
+    dma_config.SgLengthWidth = 23;
+    return &dma_config;
+}
+
+static void dma_ring_init(XAxiDma_BdRing *RingPtr, UINTPTR ChanBase, int IsRx) {
+    memset(RingPtr, 0, sizeof(*RingPtr));
+    RingPtr->ChanBase = ChanBase;
+    RingPtr->IsRxChannel = IsRx;
+    RingPtr->MaxTransferLen = XAXIDMA_MAX_TRANSFER_LEN;
+}
+
+int XAxiDma_CfgInitialize(XAxiDma *InstancePtr, XAxiDma_Config *Config) {
+    SimCall call;
+
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->RegBase = Config->BaseAddr;
+    InstancePtr->HasMm2S = Config->HasMm2S;
+    InstancePtr->HasS2Mm = Config->HasS2Mm;
+    InstancePtr->HasSg = Config->HasSg;
+    InstancePtr->TxNumChannels = Config->Mm2sNumChannels;
+    InstancePtr->RxNumChannels = Config->S2MmNumChannels;
+    InstancePtr->AddrWidth = Config->AddrWidth;
+    dma_ring_init(&InstancePtr->TxBdRing, Config->BaseAddr + XAXIDMA_TX_OFFSET, 0);
+    dma_ring_init(&InstancePtr->RxBdRing[0], Config->BaseAddr + XAXIDMA_RX_OFFSET, 1);
+
+    XAxiDma_Reset(InstancePtr);
+    if (!XAxiDma_ResetIsDone(InstancePtr)) {
+        return XST_DMA_ERROR;
+    }
+
+    // Simple mode runs straight away, SG rings start in XAxiDma_BdRingStart()
+    if (!InstancePtr->HasSg) {
+        Xil_Out32(InstancePtr->RegBase + XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET, XAXIDMA_CR_RUNSTOP_MASK);
+        Xil_Out32(InstancePtr->RegBase + XAXIDMA_RX_OFFSET + XAXIDMA_CR_OFFSET, XAXIDMA_CR_RUNSTOP_MASK);
+    }
+    InstancePtr->Initialized = 1;
+    return XST_SUCCESS;
+}
+
+void XAxiDma_Reset(XAxiDma *InstancePtr) {
+    Xil_Out32(InstancePtr->RegBase + XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET, XAXIDMA_CR_RESET_MASK);
+    InstancePtr->TxBdRing.RunState = 0;
+    InstancePtr->RxBdRing[0].RunState = 0;
+}
+
+int XAxiDma_ResetIsDone(XAxiDma *InstancePtr) {
+    return !(Xil_In32(InstancePtr->RegBase + XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET) & XAXIDMA_CR_RESET_MASK);
+}
+
+static UINTPTR dma_chan_base(XAxiDma *InstancePtr, int Direction) {
+    return InstancePtr->RegBase + (Direction == XAXIDMA_DMA_TO_DEVICE ? XAXIDMA_TX_OFFSET : XAXIDMA_RX_OFFSET);
+}
+
+int XAxiDma_Busy(XAxiDma *InstancePtr, int Direction) {
+    return (Xil_In32(dma_chan_base(InstancePtr, Direction) + XAXIDMA_SR_OFFSET) & XAXIDMA_IDLE_MASK) ? FALSE : TRUE;
+}
+
+u32 XAxiDma_SimpleTransfer(XAxiDma *InstancePtr, UINTPTR BuffAddr, u32 Length, int Direction) {
+    UINTPTR Base = dma_chan_base(InstancePtr, Direction);
+
+    if (Length < 1 || Length > XAXIDMA_MAX_TRANSFER_LEN || InstancePtr->HasSg) {
+        return XST_INVALID_PARAM;
+    }
+    if (!(Xil_In32(Base + XAXIDMA_SR_OFFSET) & XAXIDMA_IDLE_MASK) &&
+        !(Xil_In32(Base + XAXIDMA_SR_OFFSET) & XAXIDMA_HALTED_MASK)) {
+        return XST_FAILURE;
+    }
+
+    Xil_Out32(Base + XAXIDMA_SRCADDR_OFFSET, (u32)BuffAddr);
+    Xil_Out32(Base + XAXIDMA_CR_OFFSET, Xil_In32(Base + XAXIDMA_CR_OFFSET) | XAXIDMA_CR_RUNSTOP_MASK);
+    Xil_Out32(Base + XAXIDMA_BUFFLEN_OFFSET, Length);
+    return XST_SUCCESS;
+}
+
+void XAxiDma_IntrEnable(XAxiDma *InstancePtr, u32 Mask, int Direction) {
+    UINTPTR Base = dma_chan_base(InstancePtr, Direction);
+    Xil_Out32(Base + XAXIDMA_CR_OFFSET, Xil_In32(Base + XAXIDMA_CR_OFFSET) | (Mask & XAXIDMA_IRQ_ALL_MASK));
+}
+
+void XAxiDma_IntrDisable(XAxiDma *InstancePtr, u32 Mask, int Direction) {
+    UINTPTR Base = dma_chan_base(InstancePtr, Direction);
+    Xil_Out32(Base + XAXIDMA_CR_OFFSET, Xil_In32(Base + XAXIDMA_CR_OFFSET) & ~(Mask & XAXIDMA_IRQ_ALL_MASK));
+}
+
+u32 XAxiDma_IntrGetIrq(XAxiDma *InstancePtr, int Direction) {
+    return Xil_In32(dma_chan_base(InstancePtr, Direction) + XAXIDMA_SR_OFFSET) & XAXIDMA_IRQ_ALL_MASK;
+}
+
+void XAxiDma_IntrAckIrq(XAxiDma *InstancePtr, u32 Mask, int Direction) {
+    Xil_Out32(dma_chan_base(InstancePtr, Direction) + XAXIDMA_SR_OFFSET, Mask & XAXIDMA_IRQ_ALL_MASK);
+}
+
+/***** Buffer descriptors *****/
+int XAxiDma_BdSetLength(XAxiDma_Bd *BdPtr, u32 LenBytes, u32 LengthMask) {
+    if (LenBytes == 0 || LenBytes > LengthMask) {
+        return XST_INVALID_PARAM;
+    }
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET,
+                    (XAxiDma_BdRead(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET) & ~LengthMask) | LenBytes);
+    return XST_SUCCESS;
+}
+
+u32 XAxiDma_BdSetBufAddr(XAxiDma_Bd *BdPtr, UINTPTR Addr) {
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_BUFA_OFFSET, (u32)Addr);
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_BUFA_MSB_OFFSET, (u32)((u64)Addr >> 32));
+    return XST_SUCCESS;
+}
+
+void XAxiDma_BdSetCtrl(XAxiDma_Bd *BdPtr, u32 Data) {
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET,
+                    (XAxiDma_BdRead(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET) & ~XAXIDMA_BD_CTRL_ALL_MASK) |
+                    (Data & XAXIDMA_BD_CTRL_ALL_MASK));
+}
+
+/***** Descriptor ring, same bookkeeping as xaxidma_bdring.c *****/
+static XAxiDma_Bd *dma_ring_seek(XAxiDma_BdRing *RingPtr, XAxiDma_Bd *BdPtr, int NumBd) {
+    UINTPTR Addr = (UINTPTR)BdPtr - RingPtr->FirstBdAddr;
+    UINTPTR Span = (UINTPTR)RingPtr->AllCnt * RingPtr->Separation;
+
+    Addr = (Addr + (UINTPTR)((NumBd % RingPtr->AllCnt + RingPtr->AllCnt) % RingPtr->AllCnt) *
+            RingPtr->Separation) % Span;
+    return (XAxiDma_Bd *)(RingPtr->FirstBdAddr + Addr);
+}
+
+int XAxiDma_BdRingCreate(XAxiDma_BdRing *RingPtr, UINTPTR PhysAddr, UINTPTR VirtAddr,
+                         u32 Alignment, int BdCount) {
+    SimCall call;
+
+    if (BdCount <= 0 || (VirtAddr % Alignment) || PhysAddr != VirtAddr) {
+        return XST_INVALID_PARAM;
+    }
+
+    RingPtr->Separation = (sizeof(XAxiDma_Bd) + (Alignment - 1)) & ~(Alignment - 1);
+    RingPtr->FirstBdAddr = VirtAddr;
+    RingPtr->LastBdAddr = VirtAddr + (BdCount - 1) * RingPtr->Separation;
+    RingPtr->AllCnt = BdCount;
+    RingPtr->FreeCnt = BdCount;
+    RingPtr->PreCnt = 0;
+    RingPtr->HwCnt = 0;
+    RingPtr->PostCnt = 0;
+    RingPtr->FreeHead = (XAxiDma_Bd *)VirtAddr;
+    RingPtr->PreHead = (XAxiDma_Bd *)VirtAddr;
+    RingPtr->HwHead = (XAxiDma_Bd *)VirtAddr;
+    RingPtr->HwTail = (XAxiDma_Bd *)VirtAddr;
+    RingPtr->PostHead = (XAxiDma_Bd *)VirtAddr;
+
+    memset((void *)VirtAddr, 0, BdCount * RingPtr->Separation);
+    for (int i = 0; i < BdCount; i++) {
+        UINTPTR Bd = VirtAddr + i * RingPtr->Separation;
+        UINTPTR Next = (i == BdCount - 1) ? VirtAddr : Bd + RingPtr->Separation;
+        XAxiDma_BdWrite(Bd, XAXIDMA_BD_NDESC_OFFSET, (u32)Next);
+    }
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingClone(XAxiDma_BdRing *RingPtr, XAxiDma_Bd *SrcBdPtr) {
+    if (RingPtr->FreeCnt != RingPtr->AllCnt) {
+        return XST_DMA_SG_LIST_EMPTY;
+    }
+    for (int i = 0; i < RingPtr->AllCnt; i++) {
+        UINTPTR Bd = RingPtr->FirstBdAddr + i * RingPtr->Separation;
+        u32 Next = XAxiDma_BdRead(Bd, XAXIDMA_BD_NDESC_OFFSET);
+        memcpy((void *)Bd, SrcBdPtr, sizeof(XAxiDma_Bd));
+        XAxiDma_BdWrite(Bd, XAXIDMA_BD_NDESC_OFFSET, Next);
+        XAxiDma_BdWrite(Bd, XAXIDMA_BD_STS_OFFSET, 0);
+    }
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingStart(XAxiDma_BdRing *RingPtr) {
+    if (RingPtr->AllCnt == 0) {
+        return XST_DMA_SG_NO_LIST;
+    }
+    Xil_Out32(RingPtr->ChanBase + XAXIDMA_CDESC_OFFSET, (u32)(UINTPTR)RingPtr->HwHead);
+    Xil_Out32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET,
+              Xil_In32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET) | XAXIDMA_CR_RUNSTOP_MASK);
+    RingPtr->RunState = 1;
+    if (RingPtr->HwCnt > 0) {
+        Xil_Out32(RingPtr->ChanBase + XAXIDMA_TDESC_OFFSET, (u32)(UINTPTR)RingPtr->HwTail);
+    }
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd **BdSetPtr) {
+    if (NumBd <= 0 || RingPtr->FreeCnt < NumBd) {
+        return XST_FAILURE;
+    }
+    *BdSetPtr = RingPtr->FreeHead;
+    RingPtr->FreeHead = dma_ring_seek(RingPtr, RingPtr->FreeHead, NumBd);
+    RingPtr->FreeCnt -= NumBd;
+    RingPtr->PreCnt += NumBd;
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingUnAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr) {
+    (void)BdSetPtr;
+    if (NumBd <= 0 || RingPtr->PreCnt < NumBd) {
+        return XST_FAILURE;
+    }
+    RingPtr->FreeHead = dma_ring_seek(RingPtr, RingPtr->FreeHead, -NumBd);
+    RingPtr->FreeCnt += NumBd;
+    RingPtr->PreCnt -= NumBd;
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingToHw(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr) {
+    SimCall call;
+    XAxiDma_Bd *BdPtr = BdSetPtr;
+
+    if (NumBd <= 0 || RingPtr->PreCnt < NumBd || BdSetPtr != RingPtr->PreHead) {
+        return XST_DMA_SG_LIST_EMPTY;
+    }
+
+    for (int i = 0; i < NumBd; i++) {
+        XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_STS_OFFSET, 0);
+        RingPtr->HwTail = BdPtr;
+        BdPtr = XAxiDma_BdRingNext(RingPtr, BdPtr);
+    }
+    RingPtr->PreHead = BdPtr;
+    RingPtr->PreCnt -= NumBd;
+    RingPtr->HwCnt += NumBd;
+
+    if (RingPtr->RunState) {
+        Xil_Out32(RingPtr->ChanBase + XAXIDMA_TDESC_OFFSET, (u32)(UINTPTR)RingPtr->HwTail);
+    }
+    return XST_SUCCESS;
+}
+
+int XAxiDma_BdRingFromHw(XAxiDma_BdRing *RingPtr, int BdLimit, XAxiDma_Bd **BdSetPtr) {
+    SimCall call;
+    XAxiDma_Bd *BdPtr = RingPtr->HwHead;
+    int BdCount = 0;
+
+    while (BdCount < BdLimit && BdCount < RingPtr->HwCnt &&
+           (XAxiDma_BdGetSts(BdPtr) & XAXIDMA_BD_STS_COMPLETE_MASK)) {
+        if (RingPtr->IsRxChannel) {
+            std::map<UINTPTR, double> &kicks = chan[XAXIDMA_DEVICE_TO_DMA].bd_kick;
+            std::map<UINTPTR, double>::iterator it = kicks.find((UINTPTR)BdPtr);
+            if (it != kicks.end()) {
+                sim_record_latency(sim_now() - it->second);
+                kicks.erase(it);
+            }
+        }
+        BdCount++;
+        BdPtr = XAxiDma_BdRingNext(RingPtr, BdPtr);
+    }
+
+    if (BdCount == 0) {
+        *BdSetPtr = NULL;
+        return 0;
+    }
+    *BdSetPtr = RingPtr->HwHead;
+    RingPtr->HwHead = BdPtr;
+    RingPtr->HwCnt -= BdCount;
+    RingPtr->PostCnt += BdCount;
+    return BdCount;
+}
+
+int XAxiDma_BdRingFree(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr) {
+    if (NumBd <= 0 || RingPtr->PostCnt < NumBd || BdSetPtr != RingPtr->PostHead) {
+        return XST_DMA_SG_LIST_EMPTY;
+    }
+    RingPtr->PostHead = dma_ring_seek(RingPtr, RingPtr->PostHead, NumBd);
+    RingPtr->PostCnt -= NumBd;
+    RingPtr->FreeCnt += NumBd;
+    return XST_SUCCESS;
+}
+
+void XAxiDma_BdRingIntEnable(XAxiDma_BdRing *RingPtr, u32 Mask) {
+    Xil_Out32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET,
+              Xil_In32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET) | (Mask & XAXIDMA_IRQ_ALL_MASK));
+}
+
+void XAxiDma_BdRingIntDisable(XAxiDma_BdRing *RingPtr, u32 Mask) {
+    Xil_Out32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET,
+              Xil_In32(RingPtr->ChanBase + XAXIDMA_CR_OFFSET) & ~(Mask & XAXIDMA_IRQ_ALL_MASK));
+}
+
+u32 XAxiDma_BdRingGetIrq(XAxiDma_BdRing *RingPtr) {
+    return Xil_In32(RingPtr->ChanBase + XAXIDMA_SR_OFFSET) & XAXIDMA_IRQ_ALL_MASK;
+}
+
+void XAxiDma_BdRingAckIrq(XAxiDma_BdRing *RingPtr, u32 Mask) {
+    Xil_Out32(RingPtr->ChanBase + XAXIDMA_SR_OFFSET, Mask & XAXIDMA_IRQ_ALL_MASK);
+}
@@ -0,0 +1,112 @@
+// Runs the unmodified streamAdd application (built with -Dmain=app_main)
+// against the DMA + smul models and prints throughput and latency figures.
+
+#include "sim_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" int app_main(void);
+extern int sim_quiet;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --mode simple|sg      DMA build (default simple)\n"
+            "  --runs N              application runs (default 100)\n"
+            "  --mem-mbps F          DDR bandwidth per DMA channel\n"
+            "  --dma-setup-ns F      kick-off to first beat\n"
+            "  --bd-fetch-ns F       per descriptor fetch in SG mode\n"
+            "  --ip-mhz F            smul clock\n"
+            "  --ip-latency N        smul pipeline depth in cycles\n"
+            "  --axil-ns F           AXI-Lite register access\n"
+            "  --flush-ns F          per cache line flushed\n"
+            "  --inval-ns F          per cache line invalidated\n"
+            "  --isr-ns F            interrupt entry + exit\n"
+            "  --cpu-scale F         host time -> target time for native code\n"
+            "  --verbose             keep the application console output\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    int runs = 100;
+    int verbose = 0;
+    int failures = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (!strcmp(opt, "--verbose")) {
+            verbose = 1;
+            continue;
+        }
+        if (val == NULL) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+        if (!strcmp(opt, "--mode")) {
+            if (!strcmp(val, "sg")) {
+                sim_cfg.has_sg = 1;
+            } else if (!strcmp(val, "simple")) {
+                sim_cfg.has_sg = 0;
+            } else {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(opt, "--runs")) {
+            runs = atoi(val);
+        } else if (!strcmp(opt, "--mem-mbps")) {
+            sim_cfg.mem_mbps = atof(val);
+        } else if (!strcmp(opt, "--dma-setup-ns")) {
+            sim_cfg.dma_setup_ns = atof(val);
+        } else if (!strcmp(opt, "--bd-fetch-ns")) {
+            sim_cfg.bd_fetch_ns = atof(val);
+        } else if (!strcmp(opt, "--ip-mhz")) {
+            sim_cfg.ip_mhz = atof(val);
+        } else if (!strcmp(opt, "--ip-latency")) {
+            sim_cfg.ip_latency = atoi(val);
+        } else if (!strcmp(opt, "--axil-ns")) {
+            sim_cfg.axil_ns = atof(val);
+        } else if (!strcmp(opt, "--flush-ns")) {
+            sim_cfg.flush_ns = atof(val);
+        } else if (!strcmp(opt, "--inval-ns")) {
+            sim_cfg.inval_ns = atof(val);
+        } else if (!strcmp(opt, "--isr-ns")) {
+            sim_cfg.isr_ns = atof(val);
+        } else if (!strcmp(opt, "--cpu-scale")) {
+            sim_cfg.cpu_scale = atof(val);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (runs < 1 || sim_cfg.mem_mbps <= 0 || sim_cfg.ip_mhz <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sim_quiet = !verbose;
+    sim_stats_reset();
+
+    // Every run starts from reset, the statistics accumulate over all of them
+    double elapsed = 0;
+    for (int r = 0; r < runs; r++) {
+        sim_reset();
+        double t0 = sim_now();
+        if (app_main() != 0) {
+            failures++;
+        }
+        elapsed += sim_now() - t0;
+    }
+
+    printf("mode: %s\n", sim_cfg.has_sg ? "sg" : "simple");
+    printf("runs: %d\n", runs);
+    printf("failures: %d\n", failures);
+    sim_stats_report(elapsed);
+
+    return failures ? 1 : 0;
+}
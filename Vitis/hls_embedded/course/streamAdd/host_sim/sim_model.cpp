@@ -0,0 +1,405 @@
+#include "sim_model.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+#include "xil_exception.h"
+#include "xscugic.h"
+#include "sleep.h"
+#include "xtime_l.h"
+
+#include <map>
+#include <vector>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <ctime>
+#include <sys/mman.h>
+
+SimConfig sim_cfg = {
+    0,          // has_sg
+    150.0,      // axil_ns
+    1200.0,     // mem_mbps
+    400.0,      // dma_setup_ns
+    120.0,      // bd_fetch_ns
+    250.0,      // ip_mhz
+    6,          // ip_latency
+    64,         // cache_line
+    12.0,       // flush_ns
+    6.0,        // inval_ns
+    800.0,      // isr_ns
+    0.0,        // cpu_scale
+    20.0,       // timer_ns
+};
+SimStats sim_stats;
+
+u8 *sim_ddr_base;
+
+int sim_quiet;
+
+// Simulated time only moves inside model calls. Every wait in the
+// application goes through usleep(), a register read or a timer read, so
+// interrupts are delivered there; a loop spinning on plain memory would
+// never see one.
+static double now_ns;
+static std::multimap<double, std::function<void()> > events;
+
+static int in_model;
+static struct timespec host_mark;
+
+static u32 irq_level[SIM_GIC_MAX_INTR];
+static XScuGic *gic;
+static Xil_ExceptionHandler exc_handler;
+static void *exc_data;
+static int exc_enabled;
+static int in_isr;
+
+static void sim_irq_deliver();
+
+/***** Time and events *****/
+double sim_now() {
+    return now_ns;
+}
+
+void sim_charge(double ns) {
+    now_ns += ns;
+}
+
+void sim_schedule(double t, std::function<void()> fn) {
+    events.insert(std::make_pair(t, fn));
+}
+
+void sim_service() {
+    while (!events.empty() && events.begin()->first <= now_ns) {
+        std::function<void()> fn = events.begin()->second;
+        events.erase(events.begin());
+        fn();
+    }
+    sim_irq_deliver();
+}
+
+static double host_elapsed_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    double ns = (t.tv_sec - host_mark.tv_sec) * 1e9 + (t.tv_nsec - host_mark.tv_nsec);
+    host_mark = t;
+    return ns;
+}
+
+SimCall::SimCall() {
+    in_model++;
+    if (in_model == 1) {
+        double host_ns = host_elapsed_ns();
+        now_ns += host_ns * sim_cfg.cpu_scale;
+        sim_service();
+    }
+}
+
+SimCall::~SimCall() {
+    if (in_model == 1) {
+        host_elapsed_ns();
+    }
+    in_model--;
+}
+
+void sim_reset() {
+    static int mapped;
+
+    if (!mapped) {
+        // Low mapping so buffer addresses fit the 32-bit BD ID/address words
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_32BIT
+        flags |= MAP_32BIT;
+#endif
+        void *p = mmap((void *)0x20000000, SIM_DDR_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED || (UINTPTR)p + SIM_DDR_SIZE > 0xA0000000UL) {
+            fprintf(stderr, "sim: cannot map DDR below 0xA0000000\n");
+            exit(1);
+        }
+        sim_ddr_base = (u8 *)p;
+        mapped = 1;
+    }
+
+    in_model++;
+    events.clear();
+    memset(irq_level, 0, sizeof(irq_level));
+    gic = NULL;
+    exc_handler = NULL;
+    exc_enabled = 0;
+    in_isr = 0;
+    sim_dma_reset();
+    sim_smul_reset();
+    host_elapsed_ns();
+    in_model--;
+}
+
+/***** Register windows and memory *****/
+// Devices register from static constructors in other files, so the list is
+// built on first use rather than relying on initialisation order
+static std::vector<SimRegWindow> &sim_windows() {
+    static std::vector<SimRegWindow> windows;
+    return windows;
+}
+
+void sim_map_regs(const SimRegWindow &win) {
+    sim_windows().push_back(win);
+}
+
+static const SimRegWindow *sim_find_window(UINTPTR Addr) {
+    const std::vector<SimRegWindow> &windows = sim_windows();
+    for (size_t i = 0; i < windows.size(); i++) {
+        if (Addr >= windows[i].base && Addr < windows[i].base + windows[i].size) {
+            return &windows[i];
+        }
+    }
+    return NULL;
+}
+
+u32 Xil_In32(UINTPTR Addr) {
+    SimCall call;
+    const SimRegWindow *win = sim_find_window(Addr);
+
+    if (win == NULL) {
+        return *(volatile u32 *)Addr;
+    }
+
+    sim_charge(sim_cfg.axil_ns);
+    sim_stats.reg_access++;
+    return win->read((u32)(Addr - win->base));
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value) {
+    SimCall call;
+    const SimRegWindow *win = sim_find_window(Addr);
+
+    if (win == NULL) {
+        *(volatile u32 *)Addr = Value;
+        return;
+    }
+
+    sim_charge(sim_cfg.axil_ns);
+    sim_stats.reg_access++;
+    win->write((u32)(Addr - win->base), Value);
+}
+
+/***** Cache maintenance: host memory is coherent, only the cost is modelled *****/
+static void sim_cache_range(UINTPTR adr, u32 len, double ns_per_line) {
+    SimCall call;
+    UINTPTR line = (UINTPTR)sim_cfg.cache_line;
+    UINTPTR first = adr & ~(line - 1);
+    UINTPTR end = (adr + len + line - 1) & ~(line - 1);
+    u64 lines = len ? (end - first) / line : 0;
+
+    sim_charge(lines * ns_per_line);
+    sim_stats.cache_lines += lines;
+    sim_stats.cache_ns += lines * ns_per_line;
+}
+
+void Xil_DCacheEnable(void) {}
+void Xil_DCacheDisable(void) {}
+
+void Xil_DCacheFlush(void) {
+    sim_cache_range(0, 32 * 1024, sim_cfg.flush_ns);
+}
+
+void Xil_DCacheInvalidate(void) {
+    sim_cache_range(0, 32 * 1024, sim_cfg.inval_ns);
+}
+
+void Xil_DCacheFlushRange(UINTPTR adr, u32 len) {
+    sim_cache_range(adr, len, sim_cfg.flush_ns);
+}
+
+void Xil_DCacheInvalidateRange(UINTPTR adr, u32 len) {
+    sim_cache_range(adr, len, sim_cfg.inval_ns);
+}
+
+/***** MMU: attributes have no effect on host memory *****/
+void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib) {
+    (void)Addr;
+    (void)attrib;
+}
+
+/***** Console and sleep *****/
+void xil_printf(const char *ctrl1, ...) {
+    va_list args;
+
+    if (sim_quiet) {
+        return;
+    }
+    va_start(args, ctrl1);
+    vprintf(ctrl1, args);
+    va_end(args);
+}
+
+int sim_usleep(unsigned long useconds) {
+    SimCall call;
+
+    sim_charge(useconds * 1000.0);
+    sim_stats.sleep_ns += useconds * 1000.0;
+    sim_service();
+    return 0;
+}
+
+unsigned sim_sleep(unsigned int seconds) {
+    sim_usleep(seconds * 1000000UL);
+    return 0;
+}
+
+void XTime_GetTime(XTime *Xtime_Global) {
+    SimCall call;
+
+    sim_charge(sim_cfg.timer_ns);
+    sim_service();
+    *Xtime_Global = (XTime)(sim_now() * (COUNTS_PER_SECOND / 1e9));
+}
+
+/***** Exceptions and GIC *****/
+void Xil_ExceptionInit(void) {}
+
+void Xil_ExceptionEnable(void) {
+    SimCall call;
+    exc_enabled = 1;
+}
+
+void Xil_ExceptionDisable(void) {
+    exc_enabled = 0;
+}
+
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data) {
+    if (Exception_id == XIL_EXCEPTION_ID_INT) {
+        exc_handler = Handler;
+        exc_data = Data;
+    }
+}
+
+void sim_irq_set(u32 IntrId, int Level) {
+    if (IntrId < SIM_GIC_MAX_INTR) {
+        irq_level[IntrId] = Level ? 1 : 0;
+    }
+}
+
+static int sim_irq_pending() {
+    if (gic == NULL) {
+        return 0;
+    }
+    for (u32 Id = 0; Id < SIM_GIC_MAX_INTR; Id++) {
+        if (irq_level[Id] && gic->Enabled[Id] && gic->Handler[Id]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Take the IRQ exception while a line is high, bounded in case a handler never acks
+static void sim_irq_deliver() {
+    int Rounds = 16;
+
+    while (!in_isr && exc_enabled && exc_handler && sim_irq_pending() && Rounds--) {
+        in_isr = 1;
+        sim_charge(sim_cfg.isr_ns);
+        sim_stats.isr_ns += sim_cfg.isr_ns;
+        sim_stats.interrupts++;
+        exc_handler(exc_data);
+        in_isr = 0;
+    }
+}
+
+static XScuGic_Config gic_config = { XPAR_SCUGIC_SINGLE_DEVICE_ID, 0xF9020000, 0xF9010000 };
+
+XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId) {
+    return DeviceId == XPAR_SCUGIC_SINGLE_DEVICE_ID ? &gic_config : NULL;
+}
+
+int XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr, u32 EffectiveAddr) {
+    memset(InstancePtr, 0, sizeof(*InstancePtr));
+    InstancePtr->Config = *ConfigPtr;
+    InstancePtr->Config.CpuBaseAddress = EffectiveAddr;
+    InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+    gic = InstancePtr;
+    return XST_SUCCESS;
+}
+
+int XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id, Xil_InterruptHandler Handler, void *CallBackRef) {
+    if (Int_Id >= SIM_GIC_MAX_INTR || Handler == NULL) {
+        return XST_INVALID_PARAM;
+    }
+    InstancePtr->Handler[Int_Id] = Handler;
+    InstancePtr->CallBackRef[Int_Id] = CallBackRef;
+    return XST_SUCCESS;
+}
+
+void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id) {
+    InstancePtr->Handler[Int_Id] = NULL;
+    InstancePtr->Enabled[Int_Id] = 0;
+}
+
+void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id) {
+    SimCall call;
+    InstancePtr->Enabled[Int_Id] = 1;
+}
+
+void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id) {
+    InstancePtr->Enabled[Int_Id] = 0;
+}
+
+void XScuGic_InterruptHandler(XScuGic *InstancePtr) {
+    for (u32 Id = 0; Id < SIM_GIC_MAX_INTR; Id++) {
+        if (irq_level[Id] && InstancePtr->Enabled[Id] && InstancePtr->Handler[Id]) {
+            InstancePtr->Handler[Id](InstancePtr->CallBackRef[Id]);
+        }
+    }
+}
+
+/***** Statistics *****/
+void sim_stats_reset() {
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_stats.lat_min = 1e300;
+}
+
+void sim_record_latency(double ns) {
+    int b = 0;
+
+    while (b < SimStats::HIST_BUCKETS - 1 && ns >= (double)(2ULL << b)) {
+        b++;
+    }
+    sim_stats.lat_hist[b]++;
+    sim_stats.lat_count++;
+    sim_stats.lat_sum += ns;
+    if (ns < sim_stats.lat_min) sim_stats.lat_min = ns;
+    if (ns > sim_stats.lat_max) sim_stats.lat_max = ns;
+}
+
+void sim_stats_report(double elapsed_ns) {
+    const SimStats &s = sim_stats;
+    u64 peak = 0;
+
+    printf("sim_time_ns: %.0f\n", elapsed_ns);
+    printf("packets: %llu\n", (unsigned long long)s.packets);
+    printf("bytes_in: %llu\n", (unsigned long long)s.bytes_in);
+    printf("bytes_out: %llu\n", (unsigned long long)s.bytes_out);
+    printf("throughput_mbps: %.2f\n", elapsed_ns > 0 ? s.bytes_out * 1e3 / elapsed_ns : 0.0);
+    printf("datapath_util: %.3f\n", elapsed_ns > 0 ? s.busy_ns / elapsed_ns : 0.0);
+    printf("reg_access: %llu (%.0f ns)\n", (unsigned long long)s.reg_access, s.reg_access * sim_cfg.axil_ns);
+    printf("cache_lines: %llu (%.0f ns)\n", (unsigned long long)s.cache_lines, s.cache_ns);
+    printf("interrupts: %llu (%.0f ns)\n", (unsigned long long)s.interrupts, s.isr_ns);
+    printf("sleep_ns: %.0f\n", s.sleep_ns);
+
+    if (s.lat_count == 0) {
+        return;
+    }
+    printf("latency_ns: min %.0f avg %.0f max %.0f\n",
+           s.lat_min, s.lat_sum / s.lat_count, s.lat_max);
+    for (int b = 0; b < SimStats::HIST_BUCKETS; b++) {
+        if (s.lat_hist[b] > peak) peak = s.lat_hist[b];
+    }
+    for (int b = 0; b < SimStats::HIST_BUCKETS; b++) {
+        if (s.lat_hist[b] == 0) continue;
+        int bar = (int)(s.lat_hist[b] * 40 / peak);
+        printf("  < %10llu ns %8llu ", (unsigned long long)(2ULL << b),
+               (unsigned long long)s.lat_hist[b]);
+        for (int i = 0; i < (bar ? bar : 1); i++) putchar('#');
+        putchar('\n');
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef SIM_MODEL_H
+#define SIM_MODEL_H
+
+// Internal interface between the host device models, not seen by the
+// application. All times are simulated CPU time in ns.
+
+#include <functional>
+#include "xil_types.h"
+
+/***** Timing parameters *****/
+struct SimConfig {
+    int    has_sg;              // DMA built with scatter-gather
+    double axil_ns;             // One AXI-Lite register access
+    double mem_mbps;            // DDR bandwidth seen by each DMA channel
+    double dma_setup_ns;        // Kick-off to first beat (address phase, DDR latency)
+    double bd_fetch_ns;         // Extra per descriptor in SG mode
+    double ip_mhz;              // smul clock, one beat per cycle (II=1)
+    int    ip_latency;          // smul pipeline depth in cycles
+    int    cache_line;          // Bytes per D-cache line
+    double flush_ns;            // Per line flushed
+    double inval_ns;            // Per line invalidated
+    double isr_ns;              // Interrupt entry + exit
+    double cpu_scale;           // Host time -> target time for native code, 0 = free
+    double timer_ns;            // One global timer read
+};
+
+struct SimStats {
+    u64    packets;
+    u64    bytes_in;
+    u64    bytes_out;
+    u64    reg_access;
+    u64    interrupts;
+    u64    cache_lines;
+    double cache_ns;
+    double sleep_ns;
+    double isr_ns;
+    double busy_ns;             // Time the datapath was moving data
+    // Kick-off to completion seen by software, log2 buckets of ns
+    enum { HIST_BUCKETS = 32 };
+    u64    lat_hist[HIST_BUCKETS];
+    u64    lat_count;
+    double lat_sum;
+    double lat_min;
+    double lat_max;
+};
+
+extern SimConfig sim_cfg;
+extern SimStats sim_stats;
+
+/***** Time and events *****/
+double sim_now();
+void   sim_charge(double ns);
+void   sim_schedule(double t, std::function<void()> fn);
+void   sim_service();
+void   sim_reset();
+
+// Brackets every model entry point: accounts host time spent in native code
+// since the last call, then delivers whatever became due
+struct SimCall {
+    SimCall();
+    ~SimCall();
+};
+
+/***** Interrupt lines into the GIC model *****/
+void sim_irq_set(u32 IntrId, int Level);
+
+/***** Register windows *****/
+struct SimRegWindow {
+    UINTPTR base;
+    u32 size;
+    u32  (*read)(u32 offset);
+    void (*write)(u32 offset, u32 value);
+};
+void sim_map_regs(const SimRegWindow &win);
+
+/***** Statistics *****/
+void sim_stats_reset();
+void sim_record_latency(double ns);
+void sim_stats_report(double elapsed_ns);
+
+/***** Device hooks *****/
+void sim_dma_reset();
+void sim_smul_reset();
+
+// DMA -> smul datapath: one MM2S packet and one S2MM buffer per request.
+// `done` callbacks run as scheduled events at the completion time.
+struct SimMm2sReq {
+    UINTPTR addr[16];
+    u32 len[16];
+    int segs;
+    double ready;
+    std::function<void()> done;
+};
+struct SimS2mmReq {
+    UINTPTR addr;
+    u32 len;
+    double ready;
+    std::function<void(u32 actual, int error, double kick)> done;
+};
+void sim_datapath_mm2s(const SimMm2sReq &req);
+void sim_datapath_s2mm(const SimS2mmReq &req);
+void sim_datapath_kick();
+
+#endif // SIM_MODEL_H
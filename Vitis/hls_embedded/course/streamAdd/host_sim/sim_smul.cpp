@@ -0,0 +1,306 @@
+#include "sim_model.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xsmul.h"
+
+#include "streamAdd.h"
+
+#include <deque>
+#include <algorithm>
+#include <cstring>
+
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define AP_READY        0x08
+#define AP_AUTO_RESTART 0x80
+
+#define BEAT_BYTES      (4 * SMUL_LANES)
+
+/***** Register model *****/
+static struct {
+    u32 length;
+    int armed;                  // ap_start seen, waiting for or running a packet
+    int auto_restart;
+    int done;                   // ap_done, clear on read
+    int idle;
+    u32 gie;
+    u32 ier;
+    u32 isr;
+    double armed_at;
+} ip;
+
+// Datapath between the DMA channels and the kernel
+static std::deque<SimMm2sReq> mm2s_q;
+static std::deque<SimS2mmReq> s2mm_q;
+static hls::stream<trans_pkt> ip_in;        // Beats left over when length < packet
+static double mm2s_free;                    // Channel busy until
+static double s2mm_free;
+static double busy_until;
+
+void sim_smul_reset() {
+    memset(&ip, 0, sizeof(ip));
+    ip.idle = 1;
+    mm2s_q.clear();
+    s2mm_q.clear();
+    while (!ip_in.empty()) {
+        ip_in.read();
+    }
+    mm2s_free = 0;
+    s2mm_free = 0;
+    busy_until = 0;
+}
+
+void sim_datapath_mm2s(const SimMm2sReq &req) {
+    mm2s_q.push_back(req);
+}
+
+void sim_datapath_s2mm(const SimS2mmReq &req) {
+    s2mm_q.push_back(req);
+}
+
+// Feed the packet through the real kernel and write its output to the S2MM
+// buffer, returns the bytes written and whether the buffer was too short
+static u32 smul_exec(const SimMm2sReq &in, const SimS2mmReq &out, u32 *beats, int *error) {
+    hls::stream<trans_pkt> ip_out;
+    u32 total = 0;
+    u32 actual = 0;
+
+    for (int s = 0; s < in.segs; s++) {
+        total += in.len[s];
+    }
+
+    // Pack the gathered bytes into beats, TKEEP marks the tail, TLAST the end
+    u32 pos = 0;
+    int seg = 0;
+    u32 seg_pos = 0;
+    while (pos < total) {
+        trans_pkt beat;
+        beat.data = 0;
+        beat.keep = 0;
+        beat.strb = 0;
+        beat.last = 0;
+        for (int b = 0; b < BEAT_BYTES && pos < total; b++, pos++) {
+            while (seg_pos >= in.len[seg]) {
+                seg++;
+                seg_pos = 0;
+            }
+            u8 byte = *(u8 *)(in.addr[seg] + seg_pos++);
+            beat.data.range(8 * b + 7, 8 * b) = byte;
+            beat.keep[b] = 1;
+            beat.strb[b] = 1;
+        }
+        beat.last = (pos == total);
+        ip_in.write(beat);
+    }
+
+    smul(ip_in, ip_out, ip.length);
+
+    *beats = 0;
+    *error = 0;
+    while (!ip_out.empty()) {
+        trans_pkt beat = ip_out.read();
+        (*beats)++;
+        for (int b = 0; b < BEAT_BYTES; b++) {
+            if (!beat.keep[b]) continue;
+            if (actual >= out.len) {
+                *error = 1;
+                continue;
+            }
+            *(u8 *)(out.addr + actual++) = (u8)beat.data.range(8 * b + 7, 8 * b);
+        }
+    }
+    return actual;
+}
+
+// Pair up queued MM2S packets with S2MM buffers while the IP is started
+void sim_datapath_kick() {
+    double bw = sim_cfg.mem_mbps / 1000.0;      // Bytes per ns
+    double clk = 1000.0 / sim_cfg.ip_mhz;
+
+    while (!mm2s_q.empty() && !s2mm_q.empty() && ip.armed) {
+        SimMm2sReq in = mm2s_q.front();
+        SimS2mmReq out = s2mm_q.front();
+        u32 in_bytes = 0;
+        u32 beats;
+        int error;
+
+        mm2s_q.pop_front();
+        s2mm_q.pop_front();
+        for (int s = 0; s < in.segs; s++) {
+            in_bytes += in.len[s];
+        }
+
+        u32 actual = smul_exec(in, out, &beats, &error);
+
+        // Both channels and the IP overlap, the slowest of them sets the pace
+        double kick = std::max(std::max(in.ready, out.ready), ip.armed_at);
+        double t0 = std::max(kick, mm2s_free);
+        double t_in = in_bytes / bw;
+        double t_out = actual / bw;
+        double t_ip = beats * clk;
+        double mm2s_done = t0 + sim_cfg.dma_setup_ns + t_in;
+        double s2mm_done = std::max(t0 + sim_cfg.dma_setup_ns + std::max(std::max(t_in, t_ip), t_out) +
+                                    sim_cfg.ip_latency * clk,
+                                    s2mm_free + t_out);
+
+        mm2s_free = mm2s_done;
+        s2mm_free = s2mm_done;
+
+        sim_stats.packets++;
+        sim_stats.bytes_in += in_bytes;
+        sim_stats.bytes_out += actual;
+        sim_stats.busy_ns += s2mm_done - std::max(t0, busy_until);
+        busy_until = s2mm_done;
+
+        sim_schedule(mm2s_done, in.done);
+        std::function<void(u32, int, double)> out_done = out.done;
+        sim_schedule(s2mm_done, [out_done, actual, error, kick]() {
+            out_done(actual, error, kick);
+        });
+
+        if (ip.auto_restart) {
+            ip.armed_at = s2mm_done;
+        } else {
+            ip.armed = 0;
+            sim_schedule(s2mm_done, []() {
+                ip.done = 1;
+                ip.idle = 1;
+                ip.isr |= ip.ier & 0x1;
+            });
+        }
+    }
+}
+
+static u32 smul_read(u32 Offset) {
+    u32 Data;
+
+    switch (Offset) {
+    case XSMUL_CTRL_ADDR_AP_CTRL:
+        Data = (ip.armed ? AP_START : 0) | (ip.done ? AP_DONE : 0) |
+               (ip.idle ? AP_IDLE : 0) | (ip.auto_restart ? AP_AUTO_RESTART : 0);
+        ip.done = 0;
+        return Data;
+    case XSMUL_CTRL_ADDR_GIE:
+        return ip.gie;
+    case XSMUL_CTRL_ADDR_IER:
+        return ip.ier;
+    case XSMUL_CTRL_ADDR_ISR:
+        return ip.isr;
+    case XSMUL_CTRL_ADDR_LENGTH_DATA:
+        return ip.length;
+    default:
+        return 0;
+    }
+}
+
+static void smul_write(u32 Offset, u32 Value) {
+    switch (Offset) {
+    case XSMUL_CTRL_ADDR_AP_CTRL:
+        ip.auto_restart = (Value & AP_AUTO_RESTART) != 0;
+        if ((Value & AP_START) && !ip.armed) {
+            ip.armed = 1;
+            ip.idle = 0;
+            ip.armed_at = sim_now();
+            sim_datapath_kick();
+        }
+        break;
+    case XSMUL_CTRL_ADDR_GIE:
+        ip.gie = Value & 0x1;
+        break;
+    case XSMUL_CTRL_ADDR_IER:
+        ip.ier = Value & 0x3;
+        break;
+    case XSMUL_CTRL_ADDR_ISR:
+        ip.isr ^= Value & ip.isr;   // Toggle on write
+        break;
+    case XSMUL_CTRL_ADDR_LENGTH_DATA:
+        ip.length = Value;
+        break;
+    default:
+        break;
+    }
+}
+
+static struct SimSmulMap {
+    SimSmulMap() {
+        SimRegWindow win = { XPAR_SMUL_0_S_AXI_CTRL_BASEADDR, 0x10000, smul_read, smul_write };
+        sim_map_regs(win);
+    }
+} smul_map;
+
+/***** Driver, same calls as the generated xsmul.c *****/
+static XSmul_Config smul_config = { XPAR_SMUL_0_DEVICE_ID, XPAR_SMUL_0_S_AXI_CTRL_BASEADDR };
+
+XSmul_Config *XSmul_LookupConfig(u16 DeviceId) {
+    return DeviceId == XPAR_SMUL_0_DEVICE_ID ? &smul_config : NULL;
+}
+
+int XSmul_CfgInitialize(XSmul *InstancePtr, XSmul_Config *ConfigPtr) {
+    InstancePtr->Ctrl_BaseAddress = ConfigPtr->Ctrl_BaseAddress;
+    InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+    return XST_SUCCESS;
+}
+
+void XSmul_Start(XSmul *InstancePtr) {
+    u32 Data = Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL) & 0x80;
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL, Data | 0x01);
+}
+
+u32 XSmul_IsDone(XSmul *InstancePtr) {
+    return (Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL) >> 1) & 0x1;
+}
+
+u32 XSmul_IsIdle(XSmul *InstancePtr) {
+    return (Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL) >> 2) & 0x1;
+}
+
+u32 XSmul_IsReady(XSmul *InstancePtr) {
+    return !(Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL) & 0x1);
+}
+
+void XSmul_EnableAutoRestart(XSmul *InstancePtr) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL, 0x80);
+}
+
+void XSmul_DisableAutoRestart(XSmul *InstancePtr) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_AP_CTRL, 0);
+}
+
+void XSmul_Set_length(XSmul *InstancePtr, u32 Data) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_LENGTH_DATA, Data);
+}
+
+u32 XSmul_Get_length(XSmul *InstancePtr) {
+    return Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_LENGTH_DATA);
+}
+
+void XSmul_InterruptGlobalEnable(XSmul *InstancePtr) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_GIE, 1);
+}
+
+void XSmul_InterruptGlobalDisable(XSmul *InstancePtr) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_GIE, 0);
+}
+
+void XSmul_InterruptEnable(XSmul *InstancePtr, u32 Mask) {
+    u32 Register = Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_IER);
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_IER, Register | Mask);
+}
+
+void XSmul_InterruptDisable(XSmul *InstancePtr, u32 Mask) {
+    u32 Register = Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_IER);
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_IER, Register & (~Mask));
+}
+
+void XSmul_InterruptClear(XSmul *InstancePtr, u32 Mask) {
+    Xil_Out32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_ISR, Mask);
+}
+
+u32 XSmul_InterruptGetEnabled(XSmul *InstancePtr) {
+    return Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_IER);
+}
+
+u32 XSmul_InterruptGetStatus(XSmul *InstancePtr) {
+    return Xil_In32(InstancePtr->Ctrl_BaseAddress + XSMUL_CTRL_ADDR_ISR);
+}
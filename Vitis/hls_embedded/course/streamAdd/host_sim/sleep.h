@@ -0,0 +1,22 @@
+#ifndef SLEEP_H
+#define SLEEP_H
+
+// Pull in the libc prototypes first so the macros below do not rename them
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Advance simulated time instead of sleeping
+int sim_usleep(unsigned long useconds);
+unsigned sim_sleep(unsigned int seconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define usleep(us)  sim_usleep(us)
+#define sleep(s)    sim_sleep(s)
+
+#endif /* SLEEP_H */
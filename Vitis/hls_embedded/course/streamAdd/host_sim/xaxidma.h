@@ -0,0 +1,193 @@
+#ifndef XAXIDMA_H
+#define XAXIDMA_H
+
+// Host model of the AXI DMA driver. Register offsets, bit masks and the BD
+// layout follow xaxidma_hw.h; the driver calls go through Xil_In32/Xil_Out32
+// into the register model in sim_axidma.cpp.
+
+#include <string.h>
+#include "xil_types.h"
+#include "xil_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***** Register map *****/
+#define XAXIDMA_TX_OFFSET           0x00000000
+#define XAXIDMA_RX_OFFSET           0x00000030
+
+#define XAXIDMA_CR_OFFSET           0x00000000
+#define XAXIDMA_SR_OFFSET           0x00000004
+#define XAXIDMA_CDESC_OFFSET        0x00000008
+#define XAXIDMA_TDESC_OFFSET        0x00000010
+#define XAXIDMA_SRCADDR_OFFSET      0x00000018
+#define XAXIDMA_DESTADDR_OFFSET     0x00000018
+#define XAXIDMA_BUFFLEN_OFFSET      0x00000028
+
+#define XAXIDMA_CR_RUNSTOP_MASK     0x00000001
+#define XAXIDMA_CR_RESET_MASK       0x00000004
+
+#define XAXIDMA_HALTED_MASK         0x00000001
+#define XAXIDMA_IDLE_MASK           0x00000002
+#define XAXIDMA_SR_SGINCL_MASK      0x00000008
+#define XAXIDMA_ERR_INTERNAL_MASK   0x00000010
+
+#define XAXIDMA_IRQ_IOC_MASK        0x00001000
+#define XAXIDMA_IRQ_DELAY_MASK      0x00002000
+#define XAXIDMA_IRQ_ERROR_MASK      0x00004000
+#define XAXIDMA_IRQ_ALL_MASK        0x00007000
+
+#define XAXIDMA_DMA_TO_DEVICE       0x00
+#define XAXIDMA_DEVICE_TO_DMA       0x01
+
+#define XAXIDMA_MAX_TRANSFER_LEN    0x007FFFFF
+#define XAXIDMA_NO_CHANGE           0xFFFFFFFF
+#define XAXIDMA_ALL_BDS             0x0FFFFFFF
+
+/***** Buffer descriptor *****/
+#define XAXIDMA_BD_NDESC_OFFSET         0x00
+#define XAXIDMA_BD_BUFA_OFFSET          0x08
+#define XAXIDMA_BD_BUFA_MSB_OFFSET      0x0C
+#define XAXIDMA_BD_CTRL_LEN_OFFSET      0x18
+#define XAXIDMA_BD_STS_OFFSET           0x1C
+#define XAXIDMA_BD_ID_OFFSET            0x34
+#define XAXIDMA_BD_NUM_WORDS            16U
+#define XAXIDMA_BD_MINIMUM_ALIGNMENT    0x40
+
+#define XAXIDMA_BD_CTRL_TXSOF_MASK      0x08000000
+#define XAXIDMA_BD_CTRL_TXEOF_MASK      0x04000000
+#define XAXIDMA_BD_CTRL_ALL_MASK        0x0C000000
+
+#define XAXIDMA_BD_STS_COMPLETE_MASK    0x80000000
+#define XAXIDMA_BD_STS_DEC_ERR_MASK     0x40000000
+#define XAXIDMA_BD_STS_SLV_ERR_MASK     0x20000000
+#define XAXIDMA_BD_STS_INT_ERR_MASK     0x10000000
+#define XAXIDMA_BD_STS_ALL_ERR_MASK     0x70000000
+#define XAXIDMA_BD_STS_RXSOF_MASK       0x08000000
+#define XAXIDMA_BD_STS_RXEOF_MASK       0x04000000
+#define XAXIDMA_BD_STS_ACTUAL_LEN_MASK  0x007FFFFF
+
+typedef u32 XAxiDma_Bd[XAXIDMA_BD_NUM_WORDS];
+
+#define XAxiDma_BdRead(BaseAddress, Offset) \
+    (*(u32 *)((UINTPTR)(void *)(BaseAddress) + (u32)(Offset)))
+#define XAxiDma_BdWrite(BaseAddress, Offset, Data) \
+    (*(u32 *)((UINTPTR)(void *)(BaseAddress) + (u32)(Offset))) = (u32)(Data)
+
+#define XAxiDma_BdClear(BdPtr)              memset((void *)(BdPtr), 0, sizeof(XAxiDma_Bd))
+#define XAxiDma_BdGetCtrl(BdPtr)            (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_CTRL_LEN_OFFSET) & XAXIDMA_BD_CTRL_ALL_MASK)
+#define XAxiDma_BdGetSts(BdPtr)             XAxiDma_BdRead((BdPtr), XAXIDMA_BD_STS_OFFSET)
+#define XAxiDma_BdGetLength(BdPtr, LengthMask) \
+    (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_CTRL_LEN_OFFSET) & (LengthMask))
+#define XAxiDma_BdSetId(BdPtr, Id)          XAxiDma_BdWrite((BdPtr), XAXIDMA_BD_ID_OFFSET, (UINTPTR)(Id))
+#define XAxiDma_BdGetId(BdPtr)              (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_ID_OFFSET))
+#define XAxiDma_BdGetBufAddr(BdPtr)         (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_BUFA_OFFSET))
+#define XAxiDma_BdGetActualLength(BdPtr, LengthMask) \
+    (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_STS_OFFSET) & (LengthMask))
+
+int  XAxiDma_BdSetLength(XAxiDma_Bd *BdPtr, u32 LenBytes, u32 LengthMask);
+u32  XAxiDma_BdSetBufAddr(XAxiDma_Bd *BdPtr, UINTPTR Addr);
+void XAxiDma_BdSetCtrl(XAxiDma_Bd *BdPtr, u32 Data);
+
+/***** Descriptor ring *****/
+typedef struct {
+    UINTPTR ChanBase;
+    int IsRxChannel;
+    int RunState;
+    u32 MaxTransferLen;
+    UINTPTR FirstBdAddr;
+    UINTPTR LastBdAddr;
+    u32 Separation;
+    XAxiDma_Bd *FreeHead;
+    XAxiDma_Bd *PreHead;
+    XAxiDma_Bd *HwHead;
+    XAxiDma_Bd *HwTail;
+    XAxiDma_Bd *PostHead;
+    int FreeCnt;
+    int PreCnt;
+    int HwCnt;
+    int PostCnt;
+    int AllCnt;
+} XAxiDma_BdRing;
+
+#define XAxiDma_BdRingCntCalc(Alignment, Bytes) \
+    (u32)((Bytes) / ((sizeof(XAxiDma_Bd) + ((Alignment) - 1)) & ~((Alignment) - 1)))
+#define XAxiDma_BdRingMemCalc(Alignment, NumBd) \
+    (int)((sizeof(XAxiDma_Bd) + ((Alignment) - 1)) & ~((Alignment) - 1)) * (NumBd)
+#define XAxiDma_BdRingGetCnt(RingPtr)       ((RingPtr)->AllCnt)
+#define XAxiDma_BdRingGetFreeCnt(RingPtr)   ((RingPtr)->FreeCnt)
+#define XAxiDma_BdRingNext(RingPtr, BdPtr) \
+    (((UINTPTR)(BdPtr) >= (RingPtr)->LastBdAddr) ? \
+     (XAxiDma_Bd *)(RingPtr)->FirstBdAddr : \
+     (XAxiDma_Bd *)((UINTPTR)(BdPtr) + (RingPtr)->Separation))
+
+int  XAxiDma_BdRingCreate(XAxiDma_BdRing *RingPtr, UINTPTR PhysAddr, UINTPTR VirtAddr,
+                          u32 Alignment, int BdCount);
+int  XAxiDma_BdRingClone(XAxiDma_BdRing *RingPtr, XAxiDma_Bd *SrcBdPtr);
+int  XAxiDma_BdRingStart(XAxiDma_BdRing *RingPtr);
+int  XAxiDma_BdRingAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd **BdSetPtr);
+int  XAxiDma_BdRingUnAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr);
+int  XAxiDma_BdRingToHw(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr);
+int  XAxiDma_BdRingFromHw(XAxiDma_BdRing *RingPtr, int BdLimit, XAxiDma_Bd **BdSetPtr);
+int  XAxiDma_BdRingFree(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr);
+void XAxiDma_BdRingIntEnable(XAxiDma_BdRing *RingPtr, u32 Mask);
+void XAxiDma_BdRingIntDisable(XAxiDma_BdRing *RingPtr, u32 Mask);
+u32  XAxiDma_BdRingGetIrq(XAxiDma_BdRing *RingPtr);
+void XAxiDma_BdRingAckIrq(XAxiDma_BdRing *RingPtr, u32 Mask);
+
+/***** Instance *****/
+typedef struct {
+    u32 DeviceId;
+    UINTPTR BaseAddr;
+    int HasStsCntrlStrm;
+    int HasMm2S;
+    int HasMm2SDRE;
+    int Mm2SDataWidth;
+    int HasS2Mm;
+    int HasS2MmDRE;
+    int S2MmDataWidth;
+    int HasSg;
+    int Mm2sNumChannels;
+    int S2MmNumChannels;
+    int Mm2SBurstSize;
+    int S2MmBurstSize;
+    int MicroDmaMode;
+    int AddrWidth;
+    int SgLengthWidth;
+} XAxiDma_Config;
+
+typedef struct {
+    UINTPTR RegBase;
+    int HasMm2S;
+    int HasS2Mm;
+    int Initialized;
+    int HasSg;
+    XAxiDma_BdRing TxBdRing;
+    XAxiDma_BdRing RxBdRing[16];
+    int TxNumChannels;
+    int RxNumChannels;
+    int MicroDmaMode;
+    int AddrWidth;
+} XAxiDma;
+
+#define XAxiDma_GetTxRing(InstancePtr)  (&((InstancePtr)->TxBdRing))
+#define XAxiDma_GetRxRing(InstancePtr)  (&((InstancePtr)->RxBdRing[0]))
+#define XAxiDma_HasSg(InstancePtr)      (((InstancePtr)->HasSg) ? TRUE : FALSE)
+
+XAxiDma_Config *XAxiDma_LookupConfig(u32 DeviceId);
+int  XAxiDma_CfgInitialize(XAxiDma *InstancePtr, XAxiDma_Config *Config);
+void XAxiDma_Reset(XAxiDma *InstancePtr);
+int  XAxiDma_ResetIsDone(XAxiDma *InstancePtr);
+int  XAxiDma_Busy(XAxiDma *InstancePtr, int Direction);
+u32  XAxiDma_SimpleTransfer(XAxiDma *InstancePtr, UINTPTR BuffAddr, u32 Length, int Direction);
+void XAxiDma_IntrEnable(XAxiDma *InstancePtr, u32 Mask, int Direction);
+void XAxiDma_IntrDisable(XAxiDma *InstancePtr, u32 Mask, int Direction);
+u32  XAxiDma_IntrGetIrq(XAxiDma *InstancePtr, int Direction);
+void XAxiDma_IntrAckIrq(XAxiDma *InstancePtr, u32 Mask, int Direction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XAXIDMA_H */
@@ -0,0 +1,22 @@
+#ifndef XIL_CACHE_H
+#define XIL_CACHE_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host memory is coherent, these only charge simulated time per cache line
+void Xil_DCacheEnable(void);
+void Xil_DCacheDisable(void);
+void Xil_DCacheFlush(void);
+void Xil_DCacheInvalidate(void);
+void Xil_DCacheFlushRange(UINTPTR adr, u32 len);
+void Xil_DCacheInvalidateRange(UINTPTR adr, u32 len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XIL_CACHE_H */
@@ -0,0 +1,21 @@
+#ifndef XIL_EXCEPTION_H
+#define XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XIL_EXCEPTION_ID_INT    5U
+
+void Xil_ExceptionInit(void);
+void Xil_ExceptionEnable(void);
+void Xil_ExceptionDisable(void);
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XIL_EXCEPTION_H */
@@ -0,0 +1,18 @@
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register windows go to the device models, anything else is plain memory
+u32  Xil_In32(UINTPTR Addr);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XIL_IO_H */
@@ -0,0 +1,21 @@
+#ifndef XIL_MMU_H
+#define XIL_MMU_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory attributes, only told apart by the stats
+#define NORM_NONCACHE   0x401UL
+#define NORM_WB_CACHE   0x705UL
+
+// Host memory has no MMU attributes, this only counts remapped sections
+void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XIL_MMU_H */
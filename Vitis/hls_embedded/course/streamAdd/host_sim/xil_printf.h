@@ -0,0 +1,15 @@
+#ifndef XIL_PRINTF_H
+#define XIL_PRINTF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Silenced by the simulator while benchmarking, see sim_set_quiet()
+void xil_printf(const char *ctrl1, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XIL_PRINTF_H */
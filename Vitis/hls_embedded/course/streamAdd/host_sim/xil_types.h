@@ -0,0 +1,42 @@
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+// Host model of the standalone BSP types
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+typedef uintptr_t UINTPTR;
+typedef int XStatus;
+
+#define XST_SUCCESS             0L
+#define XST_FAILURE             1L
+#define XST_DMA_ERROR           9L
+#define XST_NO_DATA             13L
+#define XST_INVALID_PARAM       15L
+#define XST_DEVICE_BUSY         21L
+#define XST_DMA_SG_LIST_EMPTY   513L
+#define XST_DMA_SG_NO_LIST      523L
+
+#ifndef TRUE
+#define TRUE    1U
+#endif
+#ifndef FALSE
+#define FALSE   0U
+#endif
+
+#define XIL_COMPONENT_IS_READY  0x11111111U
+
+typedef void (*XInterruptHandler)(void *InstancePtr);
+typedef void (*Xil_InterruptHandler)(void *data);
+typedef void (*Xil_ExceptionHandler)(void *data);
+
+#endif /* XIL_TYPES_H */
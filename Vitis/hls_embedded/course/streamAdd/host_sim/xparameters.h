@@ -0,0 +1,31 @@
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// Host model of the hardware platform: DDR is a host buffer, the AXI-Lite
+// register windows are decoded by Xil_In32/Xil_Out32 in sim_model.cpp
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern u8 *sim_ddr_base;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define XPAR_PSU_DDR_0_S_AXI_BASEADDR           ((UINTPTR)sim_ddr_base)
+#define SIM_DDR_SIZE                            0x01000000
+
+#define XPAR_AXI_DMA_0_DEVICE_ID                0
+#define XPAR_AXI_DMA_0_BASEADDR                 0xA0000000
+#define XPAR_SMUL_0_DEVICE_ID                   0
+#define XPAR_SMUL_0_S_AXI_CTRL_BASEADDR         0xA0010000
+
+#define XPAR_SCUGIC_SINGLE_DEVICE_ID            0
+#define XPAR_FABRIC_AXI_DMA_0_MM2S_INTROUT_INTR 121U
+#define XPAR_FABRIC_AXI_DMA_0_S2MM_INTROUT_INTR 122U
+
+#endif /* XPARAMETERS_H */
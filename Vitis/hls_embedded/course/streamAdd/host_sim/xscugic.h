@@ -0,0 +1,41 @@
+#ifndef XSCUGIC_H
+#define XSCUGIC_H
+
+// Host model of the GIC driver: level-sensitive lines raised by the device
+// models, dispatched through the handler registered with Xil_Exception*
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_GIC_MAX_INTR    256
+
+typedef struct {
+    u16 DeviceId;
+    u32 CpuBaseAddress;
+    u32 DistBaseAddress;
+} XScuGic_Config;
+
+typedef struct {
+    XScuGic_Config Config;
+    u32 IsReady;
+    Xil_InterruptHandler Handler[SIM_GIC_MAX_INTR];
+    void *CallBackRef[SIM_GIC_MAX_INTR];
+    u8 Enabled[SIM_GIC_MAX_INTR];
+} XScuGic;
+
+XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId);
+int  XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr, u32 EffectiveAddr);
+int  XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id, Xil_InterruptHandler Handler, void *CallBackRef);
+void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XSCUGIC_H */
@@ -0,0 +1,50 @@
+#ifndef XSMUL_H
+#define XSMUL_H
+
+// Host model of the Vitis HLS generated smul driver, same register map
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XSMUL_CTRL_ADDR_AP_CTRL     0x00
+#define XSMUL_CTRL_ADDR_GIE         0x04
+#define XSMUL_CTRL_ADDR_IER         0x08
+#define XSMUL_CTRL_ADDR_ISR         0x0c
+#define XSMUL_CTRL_ADDR_LENGTH_DATA 0x10
+
+typedef struct {
+    u16 DeviceId;
+    UINTPTR Ctrl_BaseAddress;
+} XSmul_Config;
+
+typedef struct {
+    UINTPTR Ctrl_BaseAddress;
+    u32 IsReady;
+} XSmul;
+
+XSmul_Config *XSmul_LookupConfig(u16 DeviceId);
+int  XSmul_CfgInitialize(XSmul *InstancePtr, XSmul_Config *ConfigPtr);
+void XSmul_Start(XSmul *InstancePtr);
+u32  XSmul_IsDone(XSmul *InstancePtr);
+u32  XSmul_IsIdle(XSmul *InstancePtr);
+u32  XSmul_IsReady(XSmul *InstancePtr);
+void XSmul_EnableAutoRestart(XSmul *InstancePtr);
+void XSmul_DisableAutoRestart(XSmul *InstancePtr);
+void XSmul_Set_length(XSmul *InstancePtr, u32 Data);
+u32  XSmul_Get_length(XSmul *InstancePtr);
+void XSmul_InterruptGlobalEnable(XSmul *InstancePtr);
+void XSmul_InterruptGlobalDisable(XSmul *InstancePtr);
+void XSmul_InterruptEnable(XSmul *InstancePtr, u32 Mask);
+void XSmul_InterruptDisable(XSmul *InstancePtr, u32 Mask);
+void XSmul_InterruptClear(XSmul *InstancePtr, u32 Mask);
+u32  XSmul_InterruptGetEnabled(XSmul *InstancePtr);
+u32  XSmul_InterruptGetStatus(XSmul *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XSMUL_H */
@@ -0,0 +1,21 @@
+#ifndef XTIME_L_H
+#define XTIME_L_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Global timer of the model, a read is a model call like a register access
+typedef u64 XTime;
+
+#define COUNTS_PER_SECOND   100000000ULL
+
+void XTime_GetTime(XTime *Xtime_Global);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XTIME_L_H */
@@ -4,6 +4,11 @@
 #include "xaxidma.h"
 #include "sleep.h"
 #include "xsmul.h"
+#include "xil_exception.h"
+#include "xscugic.h"
+#include "dma_stream.h"
+#include "dma_intr.h"
+#include "dma_pool.h"
 
 /***** Define ******/ 
 // Device addr
@@ -11,11 +16,19 @@
 #define SMUL_DEV_ID             XPAR_SMUL_0_DEVICE_ID
 #define DMA_BASE_ADDR           XPAR_AXI_DMA_0_BASEADDR
 #define SMUL_BASE_ADDR          XPAR_SMUL_0_S_AXI_CTRL_BASEADDR
+#define INTC_DEV_ID             XPAR_SCUGIC_SINGLE_DEVICE_ID
+#define DMA_TX_INTR_ID          XPAR_FABRIC_AXI_DMA_0_MM2S_INTROUT_INTR
+#define DMA_RX_INTR_ID          XPAR_FABRIC_AXI_DMA_0_S2MM_INTROUT_INTR
 
 // PS DDR addr
 #define MEM_BASE_ADDR XPAR_PSU_DDR_0_S_AXI_BASEADDR
 #define INPUT_BUFFER (MEM_BASE_ADDR + 0x00100000)
 #define OUTPUT_BUFFER (MEM_BASE_ADDR + 0x00300000)
+#define BD_SPACE (MEM_BASE_ADDR + 0x00500000)
+#define POOL_BASE (MEM_BASE_ADDR + 0x00600000)      // Cached arena of the simple-mode buffer pool
+#define POOL_SIZE 0x00100000
+#define POOL_NC_BASE (MEM_BASE_ADDR + 0x00800000)   // Non-cacheable region, one 2 MB MMU section
+#define POOL_NC_SIZE 0x00200000
 
 // HLS IP Register Offsets
 // 0x0 : Control signals
@@ -30,9 +43,31 @@
 #define CTRL_ADDR_GIE     (SMUL_BASE_ADDR + 0x4)
 #define CTRL_ADDR_IER     (SMUL_BASE_ADDR + 0x8)
 #define CTRL_ADDR_ISR     (SMUL_BASE_ADDR + 0xc)
+// 0x10 : Data signal of length
+//        bit 31~0 - length[31:0] (Read/Write)
+#define CTRL_ADDR_LENGTH  (SMUL_BASE_ADDR + 0x10)
 
 /***** HLS interactive data size ******/ 
+#ifndef DATA_SIZE
 #define DATA_SIZE 20
+#endif
+
+/***** AXI-Stream width ******/ 
+// 32-bit words per beat, must match SMUL_LANES the smul IP was synthesized with
+// (1: 32-bit, 4: 128-bit, 8: 256-bit, 16: 512-bit stream)
+#ifndef SMUL_LANES
+#define SMUL_LANES          1
+#endif
+#define SMUL_BEAT_BYTES     (SMUL_LANES * sizeof(u32))
+// Beats needed for n words, the last one may be partial (TKEEP masked by the DMA)
+#define SMUL_BEATS(n)       (((n) + SMUL_LANES - 1) / SMUL_LANES)
+
+/***** Scatter-gather streaming ******/ 
+#define STREAM_BUF_NUM      2           // Double buffering of INPUT_BUFFER/OUTPUT_BUFFER
+#define STREAM_BUF_STRIDE   0x00010000  // 64 KB per buffer slot
+#ifndef STREAM_BLOCKS
+#define STREAM_BLOCKS       16          // Blocks of DATA_SIZE words pushed through the IP
+#endif
 
 /***** Function prototype *****/ 
 // Vitis hls ip function
@@ -41,10 +76,17 @@ void smul_ip_status();
 void smul_ip_stop();
 
 XStatus smul_start(XSmul *SmulInst);
+XStatus smul_run(XSmul *SmulInst, u32 length);
+XStatus smul_wait(XSmul *SmulInst);
+XStatus smul_stream_start(XSmul *SmulInst, u32 length);
 
 // Axi Dma control
 XStatus DmaSetup(XAxiDma *DmaInsPtr);
-int DmaTransfer(XAxiDma *DmaInsPtr, u32 *input_buffer, u32 *output_buffer, int data_size);
+int SetupInterruptSystem(XScuGic *GicInstPtr, DmaIntr *DmaIntrPtr);
+int DmaTransferStart(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size);
+int DmaTransferWait(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size);
+int DmaTransfer(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size);
+int DmaStreamRun(XAxiDma *DmaInsPtr, XSmul *SmulInst);
 
 
 // void smul_ip_start() {
@@ -117,11 +159,56 @@ XStatus smul_start(XSmul *SmulInst){
         return XST_FAILURE;
     }
 
+    // Burst mode: no auto restart, every smul_run() covers one DMA buffer
+    XSmul_DisableAutoRestart(SmulInst);
+
+    return XST_SUCCESS;
+};
+
+// Arm the IP for one packet of `length` beats, call before the DMA kick-off
+XStatus smul_run(XSmul *SmulInst, u32 length){
+    if(!XSmul_IsIdle(SmulInst)){
+        xil_printf("Smul is still busy!\r\n");
+        return XST_FAILURE;
+    }
+
+    XSmul_Set_length(SmulInst, length);
     XSmul_Start(SmulInst);
+
+    return XST_SUCCESS;
+}
+
+// ap_done is raised once the TLAST beat (or the length-th beat) is written out
+XStatus smul_wait(XSmul *SmulInst){
+    int TimeOut = 1000000;
+
+    while (TimeOut) {
+        if (XSmul_IsDone(SmulInst)) break;
+        TimeOut--;
+        usleep(1U);
+    }
+
+    if (TimeOut == 0) {
+        xil_printf("Smul done timed out!\r\n");
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+// Every packet has the same length, so let the IP restart itself between them
+XStatus smul_stream_start(XSmul *SmulInst, u32 length){
+    if(!XSmul_IsIdle(SmulInst)){
+        xil_printf("Smul is still busy!\r\n");
+        return XST_FAILURE;
+    }
+
+    XSmul_Set_length(SmulInst, length);
     XSmul_EnableAutoRestart(SmulInst);
+    XSmul_Start(SmulInst);
 
     return XST_SUCCESS;
-};
+}
 
 
 XStatus DmaSetup(XAxiDma *DmaInsPtr){
@@ -141,72 +228,227 @@ XStatus DmaSetup(XAxiDma *DmaInsPtr){
         return XST_FAILURE;
     }
 
-    // Make sure scatter-gather mode is disabled
+    // Scatter-gather builds go through DmaStreamRun(), simple mode through DmaTransfer()
     if(XAxiDma_HasSg(DmaInsPtr)){
+        xil_printf("Dma in scatter-gather mode\r\n");
+    }
+
+    return XST_SUCCESS;
+}
+
+int SetupInterruptSystem(XScuGic *GicInstPtr, DmaIntr *DmaIntrPtr) {
+    XScuGic_Config *GicConfig;
+    int Status;
+
+    GicConfig = XScuGic_LookupConfig(INTC_DEV_ID);
+    if (GicConfig == NULL) {
+        return XST_FAILURE;
+    }
+
+    Status = XScuGic_CfgInitialize(GicInstPtr, GicConfig, GicConfig->CpuBaseAddress);
+    if (Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    // One handler per DMA channel, both completing the same DmaIntr
+    Status = XScuGic_Connect(GicInstPtr, DMA_TX_INTR_ID,
+                             (Xil_InterruptHandler)dma_intr_tx_handler, DmaIntrPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA TX intr connect failed\r\n");
         return XST_FAILURE;
     }
 
+    Status = XScuGic_Connect(GicInstPtr, DMA_RX_INTR_ID,
+                             (Xil_InterruptHandler)dma_intr_rx_handler, DmaIntrPtr);
+    if (Status != XST_SUCCESS) {
+        xil_printf("DMA RX intr connect failed\r\n");
+        return XST_FAILURE;
+    }
+
+    XScuGic_Enable(GicInstPtr, DMA_TX_INTR_ID);
+    XScuGic_Enable(GicInstPtr, DMA_RX_INTR_ID);
+
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XScuGic_InterruptHandler, GicInstPtr);
+    Xil_ExceptionEnable();
+
     return XST_SUCCESS;
 }
 
-// Dma transfer
-int DmaTransfer(XAxiDma *DmaInsPtr, u32 *input_buffer, u32 *output_buffer, int data_size){
+// Dma transfer, returns as soon as both channels are running
+int DmaTransferStart(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size){
+    XAxiDma *DmaInsPtr = DmaIntrPtr->DmaInsPtr;
     int Status;
-    int TimeOut = 1000000;  // Time threshold
 
-    Xil_DCacheFlushRange((UINTPTR)input_buffer, data_size * sizeof(u32));
-    Xil_DCacheFlushRange((UINTPTR)output_buffer, data_size * sizeof(u32));
+    // Without the DMA realignment engine, wide streams need beat-aligned buffers
+    if ((InBuf->Addr % SMUL_BEAT_BYTES) || (OutBuf->Addr % SMUL_BEAT_BYTES)) {
+        xil_printf("DMA buffers must be %d-byte aligned!\r\n", (int)SMUL_BEAT_BYTES);
+        return XST_FAILURE;
+    }
 
-    Status = XAxiDma_SimpleTransfer(DmaInsPtr, (UINTPTR)input_buffer, data_size * sizeof(u32), XAXIDMA_DMA_TO_DEVICE);
+    // The pool flushes only what the CPU wrote since the last transfer
+    if (dma_buf_to_device(PoolPtr, InBuf) != XST_SUCCESS ||
+        dma_buf_to_device(PoolPtr, OutBuf) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    dma_intr_arm(DmaIntrPtr);
+
+    Status = XAxiDma_SimpleTransfer(DmaInsPtr, OutBuf->Addr, data_size * sizeof(u32), XAXIDMA_DEVICE_TO_DMA);
     if (Status != XST_SUCCESS) {
-        xil_printf("DMA transfer to device failed!\r\n");
+        xil_printf("DMA transfer from device failed!\r\n");
         return XST_FAILURE;
     }
 
-    Status = XAxiDma_SimpleTransfer(DmaInsPtr, (UINTPTR)output_buffer, data_size * sizeof(u32), XAXIDMA_DEVICE_TO_DMA);
+    Status = XAxiDma_SimpleTransfer(DmaInsPtr, InBuf->Addr, data_size * sizeof(u32), XAXIDMA_DMA_TO_DEVICE);
     if (Status != XST_SUCCESS) {
         xil_printf("DMA transfer to device failed!\r\n");
         return XST_FAILURE;
     }
 
-    while (TimeOut) {
-        if (!(XAxiDma_Busy(DmaInsPtr, XAXIDMA_DEVICE_TO_DMA)) && !(XAxiDma_Busy(DmaInsPtr, XAXIDMA_DMA_TO_DEVICE))) break; 
-        TimeOut--;
-        usleep(1U); 
-    }
+    return XST_SUCCESS;
+}
 
-    if (TimeOut == 0) {
-        xil_printf("DMA transfer timed out!\r\n");
-        return XST_FAILURE; 
+// Block until the IOC interrupts of both channels have been served
+int DmaTransferWait(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size){
+    if (dma_intr_wait(DmaIntrPtr) != XST_SUCCESS) {
+        xil_printf("DMA transfer failed!\r\n");
+        return XST_FAILURE;
     }
 
-    Xil_DCacheInvalidateRange((UINTPTR)output_buffer, data_size * sizeof(u32));
+    // Only the bytes S2MM wrote are invalidated, the input needs nothing
+    if (dma_buf_from_device(PoolPtr, InBuf, DMA_BUF_TO_DEVICE, data_size * sizeof(u32)) != XST_SUCCESS ||
+        dma_buf_from_device(PoolPtr, OutBuf, DMA_BUF_FROM_DEVICE, data_size * sizeof(u32)) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
 
     return XST_SUCCESS;
+}
+
+int DmaTransfer(DmaIntr *DmaIntrPtr, DmaPool *PoolPtr, DmaBuf *InBuf, DmaBuf *OutBuf, int data_size){
+    if (DmaTransferStart(DmaIntrPtr, PoolPtr, InBuf, OutBuf, data_size) != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    return DmaTransferWait(DmaIntrPtr, PoolPtr, InBuf, OutBuf, data_size);
+}
+
+// Scatter-gather streaming: fill the next buffer while the IP processes the current one
+int DmaStreamRun(XAxiDma *DmaInsPtr, XSmul *SmulInst){
+    DmaStream Stream;
+    UINTPTR OutAddr;
+    u32 Length;
+    int Status;
+    int Block;
+
+    if(dma_stream_init(&Stream, DmaInsPtr, BD_SPACE) != XST_SUCCESS){
+        xil_printf("Dma stream init failed!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(smul_stream_start(SmulInst, SMUL_BEATS(DATA_SIZE)) != XST_SUCCESS){
+        return XST_FAILURE;
+    }
+
+    for(Block = 0; Block < STREAM_BLOCKS + 1; Block++){
+        // Queue the next block before waiting on the oldest one
+        if(Block < STREAM_BLOCKS){
+            u32 Slot = Block % STREAM_BUF_NUM;
+            u32* input_buffer = (u32*)(INPUT_BUFFER + Slot * STREAM_BUF_STRIDE);
+            u32* output_buffer = (u32*)(OUTPUT_BUFFER + Slot * STREAM_BUF_STRIDE);
+
+            for(int i=0; i<DATA_SIZE; i++){
+                input_buffer[i] = Block * DATA_SIZE + i;
+            }
+
+            Status = dma_stream_submit(&Stream, (UINTPTR)input_buffer, (UINTPTR)output_buffer,
+                                       DATA_SIZE * sizeof(u32));
+            if(Status != XST_SUCCESS){
+                xil_printf("Dma stream submit failed at block %d!\r\n", Block);
+                return XST_FAILURE;
+            }
+        }
+
+        // Keep STREAM_BUF_NUM blocks in flight, drain everything at the end
+        if(Stream.InFlight < STREAM_BUF_NUM && Block < STREAM_BLOCKS){
+            continue;
+        }
+
+        Status = dma_stream_wait(&Stream, &OutAddr, &Length);
+        if(Status != XST_SUCCESS){
+            xil_printf("Dma stream failed!\r\n");
+            return XST_FAILURE;
+        }
+
+        u32* output_buffer = (u32*)OutAddr;
+        u32 Done = Block + 1 - STREAM_BUF_NUM;
+        for(u32 i=0; i<Length / sizeof(u32); ++i){
+            if(output_buffer[i] != 2 * (Done * DATA_SIZE + i)){
+                xil_printf("Block %d mismatch at %d: %d\r\n", Done, i, output_buffer[i]);
+                return XST_FAILURE;
+            }
+        }
+    }
 
+    XSmul_DisableAutoRestart(SmulInst);
+
+    xil_printf("Streamed %d blocks of %d words\r\n", STREAM_BLOCKS, DATA_SIZE);
+
+    return XST_SUCCESS;
 }
 
 int main(){
 
     XSmul SmulInst;
     XAxiDma DmaInst;
-    u32* input_buffer = (u32*)INPUT_BUFFER;
-    u32* output_buffer = (u32*)OUTPUT_BUFFER;
+    XScuGic IntrCtrl;
+    DmaIntr DmaIntrInst;
+    DmaPool Pool;
+    DmaBuf *InBuf, *OutBuf;
+    u32* input_buffer;
+    u32* output_buffer;
 
     if(DmaSetup(&DmaInst) != XST_SUCCESS){
         xil_printf("Failed to initialize Dma!\r\n");
         return XST_FAILURE;
     }
 
-    for(int i=0; i<DATA_SIZE; i++){
-        input_buffer[i] = i;
+    if(smul_start(&SmulInst) != XST_SUCCESS){
+        xil_printf("Failed to start smul!\r\n");
+        return XST_FAILURE;
     }
 
+    if(XAxiDma_HasSg(&DmaInst)){
+        return DmaStreamRun(&DmaInst, &SmulInst);
+    }
 
-    if(smul_start(&SmulInst) != XST_SUCCESS){
-        xil_printf("Failed to start smul!\r\n");
+    if(dma_intr_init(&DmaIntrInst, &DmaInst) != XST_SUCCESS){
+        xil_printf("Failed to initialize Dma interrupts!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(SetupInterruptSystem(&IntrCtrl, &DmaIntrInst) != XST_SUCCESS){
+        xil_printf("Intr setup failed\r\n");
+        return XST_FAILURE;
+    }
+
+    if(dma_pool_init(&Pool, POOL_BASE, POOL_SIZE, POOL_NC_BASE, POOL_NC_SIZE) != XST_SUCCESS){
+        xil_printf("Failed to set up the Dma buffer pool!\r\n");
         return XST_FAILURE;
     }
+
+    // Large transfers go to the non-cacheable region, small ones stay cached
+    InBuf = dma_pool_alloc(&Pool, DATA_SIZE * sizeof(u32), DMA_POOL_AUTO);
+    OutBuf = dma_pool_alloc(&Pool, DATA_SIZE * sizeof(u32), DMA_POOL_AUTO);
+    if(!InBuf || !OutBuf){
+        return XST_FAILURE;
+    }
+
+    input_buffer = (u32*)dma_buf_cpu_write(InBuf, 0, DATA_SIZE * sizeof(u32));
+    for(int i=0; i<DATA_SIZE; i++){
+        input_buffer[i] = i;
+    }
     // xil_printf("\r\n");
     // smul_ip_status();
     // xil_printf("\r\n");
@@ -217,16 +459,31 @@ int main(){
     // smul_ip_status();
     // xil_printf("\r\n");
 
-    if(DmaTransfer(&DmaInst, input_buffer, output_buffer, DATA_SIZE) != XST_SUCCESS){
+    if(smul_run(&SmulInst, SMUL_BEATS(DATA_SIZE)) != XST_SUCCESS){
+        xil_printf("Failed to run smul!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(DmaTransfer(&DmaIntrInst, &Pool, InBuf, OutBuf, DATA_SIZE) != XST_SUCCESS){
         xil_printf("Dma Transefer failed!\r\n");
         return XST_FAILURE;
     }
+
+    if(smul_wait(&SmulInst) != XST_SUCCESS){
+        xil_printf("Smul did not finish!\r\n");
+        return XST_FAILURE;
+    }
     
+    output_buffer = (u32*)dma_buf_cpu_read(OutBuf, 0, DATA_SIZE * sizeof(u32));
     for(int i=0; i<DATA_SIZE; ++i){
         xil_printf("Input: %d, Output: %d\r\n", input_buffer[i], output_buffer[i]);
     }
 
-    XSmul_DisableAutoRestart(&SmulInst);
+    xil_printf("Cache maintenance: %d bytes flushed, %d bytes invalidated\r\n",
+               Pool.FlushBytes, Pool.InvalBytes);
+
+    dma_pool_free(&Pool, InBuf);
+    dma_pool_free(&Pool, OutBuf);
 
     return XST_SUCCESS;
 
@@ -0,0 +1,249 @@
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xaxidma.h"
+#include "sleep.h"
+#include "xkinetics_pipe.h"
+
+// Host side of the smul -> michaelis_menten -> twoStream DATAFLOW IP.
+// The input goes out once over MM2S and the final results come back over
+// S2MM, nothing in between touches DDR.
+
+/***** Define ******/
+// Device addr
+#define DMA_DEV_ID              XPAR_AXI_DMA_0_DEVICE_ID
+#define KP_DEV_ID               XPAR_KINETICS_PIPE_0_DEVICE_ID
+
+// PS DDR addr
+#define MEM_BASE_ADDR XPAR_PSU_DDR_0_S_AXI_BASEADDR
+#define INPUT_BUFFER (MEM_BASE_ADDR + 0x00100000)
+#define OUTPUT_BUFFER (MEM_BASE_ADDR + 0x00300000)
+
+/***** Pipeline parameters ******/
+#define DATA_SIZE   1024        // Words per packet
+#define KP_VMAX     15.0f
+#define KP_KM       5.0f
+#define KP_ALPHA    0.5f
+
+// Last stage op, same encoding as TWOSTREAM_OP_* in twoStream.h
+#define KP_OP_ADD   0
+#define KP_OP_SUB   1
+#define KP_OP_MUL   2
+#define KP_OP_FMA   3
+#define KP_OP       KP_OP_MUL
+
+/***** Function prototype *****/
+XStatus kp_setup(XKinetics_pipe *KpInst);
+XStatus kp_run(XKinetics_pipe *KpInst, u32 length, u32 op);
+XStatus kp_wait(XKinetics_pipe *KpInst);
+XStatus DmaSetup(XAxiDma *DmaInsPtr);
+int DmaTransfer(XAxiDma *DmaInsPtr, u32 *input_buffer, u32 *output_buffer, int data_size);
+float kp_reference(u32 x, u32 op);
+
+// The generated driver takes float registers as their raw bits
+static u32 float_to_u32(float f){
+    union { u32 u; float f; } c;
+    c.f = f;
+    return c.u;
+}
+
+static float u32_to_float(u32 u){
+    union { u32 u; float f; } c;
+    c.u = u;
+    return c.f;
+}
+
+XStatus kp_setup(XKinetics_pipe *KpInst){
+    XKinetics_pipe_Config *KpCfg;
+    int Status;
+
+    KpCfg = XKinetics_pipe_LookupConfig(KP_DEV_ID);
+    if(!KpCfg){
+        xil_printf("Kinetics pipe dev not found!\r\n");
+        return XST_FAILURE;
+    }
+
+    Status = XKinetics_pipe_CfgInitialize(KpInst, KpCfg);
+    if(Status != XST_SUCCESS){
+        xil_printf("Kinetics pipe configuration failed!\r\n");
+        return XST_FAILURE;
+    }
+
+    XKinetics_pipe_DisableAutoRestart(KpInst);
+
+    return XST_SUCCESS;
+}
+
+// Load the registers of every stage and start the whole graph, call before the DMA kick-off
+XStatus kp_run(XKinetics_pipe *KpInst, u32 length, u32 op){
+    if(!XKinetics_pipe_IsIdle(KpInst)){
+        xil_printf("Kinetics pipe is still busy!\r\n");
+        return XST_FAILURE;
+    }
+
+    XKinetics_pipe_Set_length(KpInst, length);
+    XKinetics_pipe_Set_Vmax(KpInst, float_to_u32(KP_VMAX));
+    XKinetics_pipe_Set_Km(KpInst, float_to_u32(KP_KM));
+    XKinetics_pipe_Set_op(KpInst, op);
+    XKinetics_pipe_Set_alpha(KpInst, float_to_u32(KP_ALPHA));
+    XKinetics_pipe_Start(KpInst);
+
+    return XST_SUCCESS;
+}
+
+// ap_done is raised once the last stage has written TLAST
+XStatus kp_wait(XKinetics_pipe *KpInst){
+    int TimeOut = 1000000;
+
+    while (TimeOut) {
+        if (XKinetics_pipe_IsDone(KpInst)) break;
+        TimeOut--;
+        usleep(1U);
+    }
+
+    if (TimeOut == 0) {
+        xil_printf("Kinetics pipe done timed out!\r\n");
+        return XST_FAILURE;
+    }
+
+    return XST_SUCCESS;
+}
+
+XStatus DmaSetup(XAxiDma *DmaInsPtr){
+    XAxiDma_Config *DmaCfg;
+    int Status;
+
+    DmaCfg = XAxiDma_LookupConfig(DMA_DEV_ID);
+    if(!DmaCfg){
+        xil_printf("Dma dev not found!\r\n");
+        return XST_FAILURE;
+    }
+
+    Status = XAxiDma_CfgInitialize(DmaInsPtr, DmaCfg);
+    if(Status != XST_SUCCESS){
+        xil_printf("Dma configuration failed!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(XAxiDma_HasSg(DmaInsPtr)){
+        xil_printf("Dma in SG mode, expected simple mode\r\n");
+        return XST_FAILURE;
+    }
+
+    // Completion is polled
+    XAxiDma_IntrDisable(DmaInsPtr, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+    XAxiDma_IntrDisable(DmaInsPtr, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+
+    return XST_SUCCESS;
+}
+
+// One packet in, one packet out
+int DmaTransfer(XAxiDma *DmaInsPtr, u32 *input_buffer, u32 *output_buffer, int data_size){
+    int Status;
+    int TimeOut = 1000000;
+
+    Xil_DCacheFlushRange((UINTPTR)input_buffer, data_size * sizeof(u32));
+    Xil_DCacheFlushRange((UINTPTR)output_buffer, data_size * sizeof(u32));
+
+    // S2MM first, so the results have somewhere to go
+    Status = XAxiDma_SimpleTransfer(DmaInsPtr, (UINTPTR)output_buffer,
+                                    data_size * sizeof(u32), XAXIDMA_DEVICE_TO_DMA);
+    if(Status != XST_SUCCESS){
+        xil_printf("Dma RX start failed\r\n");
+        return XST_FAILURE;
+    }
+
+    Status = XAxiDma_SimpleTransfer(DmaInsPtr, (UINTPTR)input_buffer,
+                                    data_size * sizeof(u32), XAXIDMA_DMA_TO_DEVICE);
+    if(Status != XST_SUCCESS){
+        xil_printf("Dma TX start failed\r\n");
+        return XST_FAILURE;
+    }
+
+    while (TimeOut) {
+        if (!XAxiDma_Busy(DmaInsPtr, XAXIDMA_DMA_TO_DEVICE) &&
+            !XAxiDma_Busy(DmaInsPtr, XAXIDMA_DEVICE_TO_DMA)) break;
+        TimeOut--;
+        usleep(1U);
+    }
+
+    if (TimeOut == 0) {
+        xil_printf("Dma transfer timed out!\r\n");
+        return XST_FAILURE;
+    }
+
+    Xil_DCacheInvalidateRange((UINTPTR)output_buffer, data_size * sizeof(u32));
+
+    return XST_SUCCESS;
+}
+
+// CPU version of the whole graph for checking
+float kp_reference(u32 x, u32 op){
+    float S = (float)(int)(2 * x);
+    float v = (KP_VMAX * S) / (KP_KM + S);
+
+    switch (op) {
+    case KP_OP_SUB: return v - S;
+    case KP_OP_MUL: return v * S;
+    case KP_OP_FMA: return KP_ALPHA * v + S;
+    default:        return v + S;
+    }
+}
+
+int main(){
+
+    XKinetics_pipe KpInst;
+    XAxiDma DmaInst;
+    u32* input_buffer = (u32*)INPUT_BUFFER;
+    u32* output_buffer = (u32*)OUTPUT_BUFFER;
+    int Errors = 0;
+
+    if(DmaSetup(&DmaInst) != XST_SUCCESS){
+        xil_printf("Failed to initialize Dma!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(kp_setup(&KpInst) != XST_SUCCESS){
+        xil_printf("Failed to set up kinetics pipe!\r\n");
+        return XST_FAILURE;
+    }
+
+    for(int i=0; i<DATA_SIZE; i++){
+        input_buffer[i] = i;
+    }
+
+    if(kp_run(&KpInst, DATA_SIZE, KP_OP) != XST_SUCCESS){
+        xil_printf("Failed to run kinetics pipe!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(DmaTransfer(&DmaInst, input_buffer, output_buffer, DATA_SIZE) != XST_SUCCESS){
+        xil_printf("Dma Transefer failed!\r\n");
+        return XST_FAILURE;
+    }
+
+    if(kp_wait(&KpInst) != XST_SUCCESS){
+        xil_printf("Kinetics pipe did not finish!\r\n");
+        return XST_FAILURE;
+    }
+
+    for(int i=0; i<DATA_SIZE; ++i){
+        float got = u32_to_float(output_buffer[i]);
+        float ref = kp_reference(input_buffer[i], KP_OP);
+        float err = got > ref ? got - ref : ref - got;
+        float tol = (ref > 0 ? ref : -ref) * 1e-5f + 1e-3f;
+
+        if(err > tol){
+            // xil_printf has no %f, print milli-units
+            xil_printf("Mismatch at %d: got %d, expected %d (x1000)\r\n",
+                       i, (int)(got * 1000), (int)(ref * 1000));
+            Errors++;
+        }
+    }
+
+    xil_printf("Kinetics pipe: %d words, %d mismatches\r\n", DATA_SIZE, Errors);
+
+    return Errors ? XST_FAILURE : XST_SUCCESS;
+
+}
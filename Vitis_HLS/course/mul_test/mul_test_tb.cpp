@@ -10,6 +10,7 @@ int main(int argc, char *argv[]){
       mul_test(&y, x);
       if(y!=2*x){
               cout << "Test Failed: output(" << y << ") is not equal to 2x" << x << endl;
+              return 1;
       }else{
               cout << "Test Passed" << endl;
       }
@@ -2,15 +2,15 @@
 #include "hls_stream.h"
 #include "streamAdd.h"
 
-void smul(hls::stream< trans_pkt > &INPUT, hls::stream< trans_pkt > &OUTPUT)
+void smul(hls::stream< trans_pkt > &INPUT, hls::stream< trans_pkt > &OUTPUT, unsigned int length)
 {
 #pragma HLS INTERFACE s_axilite port = return bundle = CTRL
+#pragma HLS INTERFACE s_axilite port = length bundle = CTRL
 
                 #pragma HLS INTERFACE axis port=INPUT
                 #pragma HLS INTERFACE axis port=OUTPUT
-                trans_pkt data_p;
 
-                INPUT.read(data_p);
-                data_p.data *= 2;
-                OUTPUT.write(data_p);
+                // Burst mode: a whole DMA buffer per start instead of one word,
+                // SMUL_LANES words per beat
+                smul_lanes<SMUL_LANES>(INPUT, OUTPUT, length);
 }
@@ -4,10 +4,51 @@
 #include "ap_axi_sdata.h"
 #include "hls_stream.h"
 
+// 32-bit words per AXI-Stream beat: 1 (32-bit bus), 4 (128), 8 (256) or 16 (512).
+// Must match the DMA stream width and SMUL_LANES in the host application.
+#ifndef SMUL_LANES
+#define SMUL_LANES 1
+#endif
+
 // Define AXI Stream Data format
-typedef ap_axiu<32, 0, 0, 0> trans_pkt;
+typedef ap_axiu<32 * SMUL_LANES, 0, 0, 0> trans_pkt;
+
+// Largest DMA buffer (in beats) one ap_start is expected to cover,
+// only used as the loop tripcount hint for synthesis reports
+#define SMUL_MAX_LEN 65536
+
+// Lane-parallel body shared by every bus width.
+// Lanes whose TKEEP nibble is clear (tail of a partial final beat) are zeroed
+// and keep their TKEEP, so the S2MM side only writes the valid words.
+template <int N>
+void smul_lanes(hls::stream< ap_axiu<32 * N, 0, 0, 0> > &INPUT,
+                hls::stream< ap_axiu<32 * N, 0, 0, 0> > &OUTPUT, unsigned int length)
+{
+                ap_axiu<32 * N, 0, 0, 0> data_p;
+
+                smul_loop:
+                for (unsigned int i = 0; i < length; i++) {
+                #pragma HLS PIPELINE II=1
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=SMUL_MAX_LEN
+                                INPUT.read(data_p);
+
+                                lane_loop:
+                                for (int l = 0; l < N; l++) {
+                                #pragma HLS UNROLL
+                                                ap_uint<32> word = data_p.data.range(32 * l + 31, 32 * l);
+                                                ap_uint<4> keep = data_p.keep.range(4 * l + 3, 4 * l);
+                                                data_p.data.range(32 * l + 31, 32 * l) = (keep != 0) ? (ap_uint<32>)(word * 2) : (ap_uint<32>)0;
+                                }
+
+                                // Close the S2MM packet even if the length cuts the frame short
+                                if (i == length - 1) data_p.last = 1;
+                                OUTPUT.write(data_p);
+                                if (data_p.last) break;
+                }
+}
 
 // Function declare
-void smul(hls::stream<trans_pkt> &INPUT, hls::stream<trans_pkt> &OUTPUT);
+// One ap_start processes up to `length` beats, stopping early on TLAST
+void smul(hls::stream<trans_pkt> &INPUT, hls::stream<trans_pkt> &OUTPUT, unsigned int length);
 
 #endif // SMUL_H
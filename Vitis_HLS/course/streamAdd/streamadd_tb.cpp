@@ -3,6 +3,11 @@
 
 using namespace std;
 
+// Words per test packet, deliberately not a multiple of the lane count
+// so wide builds also exercise the partial final beat
+#define TB_LEN 10
+#define TB_BEATS ((TB_LEN + SMUL_LANES - 1) / SMUL_LANES)
+
 int main() {
 
     hls::stream<trans_pkt> input_stream;
@@ -10,28 +15,73 @@ int main() {
 
     trans_pkt input_data;
     trans_pkt output_data;
-    for(int i=0; i<10; ++i){
-        input_data.data = i + 1;
-        input_data.keep = -1;
-        input_data.strb = -1;
+    for(int b=0; b<TB_BEATS; ++b){
+        input_data.data = 0;
+        input_data.keep = 0;
+        input_data.strb = 0;
         input_data.user = 0;
         input_data.id = 0;
         input_data.dest = 0;
+        for(int l=0; l<SMUL_LANES; ++l){
+            int i = b * SMUL_LANES + l;
+            if(i >= TB_LEN) break;
+            input_data.data.range(32 * l + 31, 32 * l) = i + 1;
+            input_data.keep.range(4 * l + 3, 4 * l) = 0xF;
+            input_data.strb.range(4 * l + 3, 4 * l) = 0xF;
+        }
+        input_data.last = (b == TB_BEATS - 1);
 
         input_stream.write(input_data);
+    }
 
-        smul(input_stream, output_stream);
+    // Single start for the whole packet
+    smul(input_stream, output_stream, TB_BEATS);
 
-        if (!output_stream.empty()) {
-            output_data = output_stream.read();
-            cout << "Input Data: " << input_data.data
-                      << ", Output Data: " << output_data.data;
+    for(int b=0; b<TB_BEATS; ++b){
+        if (output_stream.empty()) {
+            cout << "Output Stream is empty!\n";
+            return 1;
+        }
+        output_data = output_stream.read();
+        if (output_data.last != (b == TB_BEATS - 1)) {
+            cout << "Test Failed: TLAST wrong at beat " << b << "\n";
+            return 1;
+        }
+        for(int l=0; l<SMUL_LANES; ++l){
+            int i = b * SMUL_LANES + l;
+            unsigned int word = output_data.data.range(32 * l + 31, 32 * l);
+            unsigned int keep = output_data.keep.range(4 * l + 3, 4 * l);
+            if(i >= TB_LEN){
+                if (keep != 0 || word != 0) {
+                    cout << "Test Failed: lane " << l << " past the end was not masked\n";
+                    return 1;
+                }
+                continue;
+            }
+            cout << "Input Data: " << i + 1
+                      << ", Output Data: " << word;
             cout << "\n";
-        } else {
-           cout << "Output Stream is empty!\n";
+            if (word != 2 * (unsigned int)(i + 1) || keep != 0xF) {
+                cout << "Test Failed at word " << i << "\n";
+                return 1;
+            }
         }
+    }
 
+    // TLAST must end the burst before the length register runs out
+    input_data.data = 7;
+    input_data.keep = -1;
+    input_data.last = 1;
+    input_stream.write(input_data);
+    input_data.data = 8;
+    input_data.last = 0;
+    input_stream.write(input_data);
+    smul(input_stream, output_stream, TB_BEATS);
+    if (output_stream.size() != 1 || input_stream.size() != 1) {
+        cout << "Test Failed: burst did not stop on TLAST\n";
+        return 1;
     }
 
+    cout << "Test Passed\n";
     return 0;
 }
@@ -16,22 +16,13 @@ void example(hls::stream<ap_axis<32,2,5,6>> &A, hls::stream<ap_axis<32,2,5,6>>&B
 }
 */
 
-void example(hls::stream<transPkt> &A, hls::stream<transPkt> &B, hls::stream<transPkt> &C){
+void example(hls::stream<transPkt> &A, hls::stream<transPkt> &B, hls::stream<transPkt> &C,
+		unsigned int length, unsigned int op, unsigned int mode, float alpha){
 #pragma HLS INTERFACE mode=axis port=A,B,C
+#pragma HLS INTERFACE mode=s_axilite port=length
+#pragma HLS INTERFACE mode=s_axilite port=op
+#pragma HLS INTERFACE mode=s_axilite port=mode
+#pragma HLS INTERFACE mode=s_axilite port=alpha
 #pragma HLS INTERFACE mode=s_axilite port=return
-	fp_int Adata, Bdata, Cdata;
-	transPkt Apkt, Bpkt;
-
-	for (unsigned int i = 0; i<LEN; i++){
-		Apkt = A.read();
-		Bpkt = B.read();
-		// Use integer type to read from the AXIS packets
-		Adata.i = Apkt.data;
-		Bdata.i = Bpkt.data;
-		// Do the calculation s with floating points
-		Cdata.fp = Adata.fp + Bdata.fp;
-		//AXIS output packets are expecting integer type
-		Apkt.data = Cdata.i;
-		C.write(Apkt);
-	}
+	twostream_lanes<TWOSTREAM_LANES>(A, B, C, length, op, mode, alpha);
 }
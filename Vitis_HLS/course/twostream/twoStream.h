@@ -1,14 +1,87 @@
+#ifndef TWOSTREAM_H
+#define TWOSTREAM_H
+
 #include "ap_axi_sdata.h"
 #include "hls_stream.h"
 
-#define LEN 10
+// Floats per beat: 1 (32-bit bus), 4 (128) or 8 (256)
+#ifndef TWOSTREAM_LANES
+#define TWOSTREAM_LANES 1
+#endif
+
+// Longest vector (in beats) per start, only used as the loop tripcount hint
+#define TWOSTREAM_MAX_LEN 65536
 
-typedef ap_axis<32,2,5,6> transPkt;
+typedef ap_axis<32 * TWOSTREAM_LANES, 2, 5, 6> transPkt;
 
 union fp_int {
 	int i;
 	float fp;
 };
 
+// Elementwise op, written to the `op` register
+#define TWOSTREAM_OP_ADD	0	// C = A + B
+#define TWOSTREAM_OP_SUB	1	// C = A - B
+#define TWOSTREAM_OP_MUL	2	// C = A * B
+#define TWOSTREAM_OP_FMA	3	// C = alpha * A + B
+
+// Termination, written to the `mode` register
+#define TWOSTREAM_MODE_LENGTH	0	// exactly `length` beats
+#define TWOSTREAM_MODE_TLAST	1	// until TLAST on A, `length` = 0 means no limit
+
+// One float op per lane, all four are built and the `op` register picks one
+inline float twostream_op(float a, float b, unsigned int op, float alpha){
+#pragma HLS INLINE
+	switch (op){
+	case TWOSTREAM_OP_SUB:	return a - b;
+	case TWOSTREAM_OP_MUL:	return a * b;
+	case TWOSTREAM_OP_FMA:	return alpha * a + b;
+	default:				return a + b;
+	}
+}
+
+// Lane-parallel body shared by every bus width
+template <int N>
+void twostream_lanes(hls::stream< ap_axis<32 * N, 2, 5, 6> > &A, hls::stream< ap_axis<32 * N, 2, 5, 6> > &B,
+		hls::stream< ap_axis<32 * N, 2, 5, 6> > &C,
+		unsigned int length, unsigned int op, unsigned int mode, float alpha){
+	fp_int Adata, Bdata, Cdata;
+	ap_axis<32 * N, 2, 5, 6> Apkt, Bpkt;
+	bool use_last = (mode == TWOSTREAM_MODE_TLAST);
+
+	// Without TLAST a zero length would never end
+	if (length == 0 && !use_last) return;
+
+	vec_loop:
+	for (unsigned int i = 0; length == 0 || i < length; i++){
+#pragma HLS PIPELINE II=1
+#pragma HLS LOOP_TRIPCOUNT min=1 max=TWOSTREAM_MAX_LEN
+		Apkt = A.read();
+		Bpkt = B.read();
+
+		lane_loop:
+		for (int l = 0; l < N; l++){
+#pragma HLS UNROLL
+			// Use integer type to read from the AXIS packets
+			Adata.i = Apkt.data.range(32 * l + 31, 32 * l);
+			Bdata.i = Bpkt.data.range(32 * l + 31, 32 * l);
+			// Do the calculation s with floating points, lanes past the end
+			// of a partial final beat stay zero
+			bool valid = Apkt.keep.range(4 * l + 3, 4 * l) != 0;
+			Cdata.fp = valid ? twostream_op(Adata.fp, Bdata.fp, op, alpha) : 0.0f;
+			//AXIS output packets are expecting integer type
+			Apkt.data.range(32 * l + 31, 32 * l) = Cdata.i;
+		}
+
+		bool done = (use_last && Apkt.last) || (length != 0 && i == length - 1);
+		Apkt.last = done;
+		C.write(Apkt);
+		if (done) break;
+	}
+}
+
 //void example(hls::stream<ap_axis<32,2,5,6>> &A, hls::stream<ap_axis<32,2,5,6>>&B, hls::stream<ap_axis<32,2,5,6>>&C);
-void example(hls::stream<transPkt> &A, hls::stream<transPkt>&B, hls::stream<transPkt>&C);
+void example(hls::stream<transPkt> &A, hls::stream<transPkt>&B, hls::stream<transPkt>&C,
+		unsigned int length, unsigned int op, unsigned int mode, float alpha);
+
+#endif // TWOSTREAM_H
@@ -1,41 +1,47 @@
-#include "ap_axi_sdata.h"
-#include "hls_stream.h"
+#include "twoStream.h"
 #include <iostream>
 #include <cmath>
 #include <cassert>
 
+// Floats per test vector, deliberately not a multiple of the lane count
 #define LEN 10
+#define BEATS ((LEN + TWOSTREAM_LANES - 1) / TWOSTREAM_LANES)
+
+static float expected_op(float a, float b, unsigned int op, float alpha) {
+    switch (op) {
+    case TWOSTREAM_OP_SUB: return a - b;
+    case TWOSTREAM_OP_MUL: return a * b;
+    case TWOSTREAM_OP_FMA: return alpha * a + b;
+    default:               return a + b;
+    }
+}
 
-typedef ap_axis<32, 2, 5, 6> transPkt;
-
-union fp_int {
-    int i;
-    float fp;
-};
-
-// Prototype of the function to test
-void example(hls::stream<transPkt> &A, hls::stream<transPkt> &B, hls::stream<transPkt> &C);
-
-int main() {
+// Push LEN floats through with the given registers and check `beats` results.
+// `last_at` is the beat that carries TLAST on the inputs.
+static int run(unsigned int length, unsigned int op, unsigned int mode, int last_at, int beats) {
     // Declare HLS streams for A, B, and C
     hls::stream<transPkt> A, B, C;
+    const float alpha = 0.5f;
 
     // Initialize input data
     fp_int Adata, Bdata;
-    for (int i = 0; i < LEN; i++) {
+    for (int b = 0; b < BEATS; b++) {
         transPkt pktA, pktB;
-
-        // Set float values
-        Adata.fp = i * 1.5; // Example: A[i] = 1.5 * i
-        Bdata.fp = i * 2.0; // Example: B[i] = 2.0 * i
-
-        // Convert to integer for packet data
-        pktA.data = Adata.i;
-        pktB.data = Bdata.i;
-
-        pktA.keep = pktB.keep = -1; // Assume valid keep signal
-        pktA.strb = pktB.strb = -1; // Assume valid strb signal
-        pktA.last = pktB.last = (i == LEN - 1); // Mark the last packet
+        pktA.data = pktB.data = 0;
+        pktA.keep = pktB.keep = 0;
+        pktA.strb = pktB.strb = 0;
+
+        for (int l = 0; l < TWOSTREAM_LANES; l++) {
+            int i = b * TWOSTREAM_LANES + l;
+            if (i >= LEN) break;
+            Adata.fp = i * 1.5; // Example: A[i] = 1.5 * i
+            Bdata.fp = i * 2.0; // Example: B[i] = 2.0 * i
+            pktA.data.range(32 * l + 31, 32 * l) = Adata.i;
+            pktB.data.range(32 * l + 31, 32 * l) = Bdata.i;
+            pktA.keep.range(4 * l + 3, 4 * l) = pktB.keep.range(4 * l + 3, 4 * l) = 0xF;
+            pktA.strb.range(4 * l + 3, 4 * l) = pktB.strb.range(4 * l + 3, 4 * l) = 0xF;
+        }
+        pktA.last = pktB.last = (b == last_at); // Mark the last packet
 
         // Push packets into streams
         A.write(pktA);
@@ -43,30 +49,72 @@ int main() {
     }
 
     // Call the function
-    example(A, B, C);
+    example(A, B, C, length, op, mode, alpha);
 
     // Verify output data
-    for (int i = 0; i < LEN; i++) {
-        transPkt pktC;
+    for (int b = 0; b < beats; b++) {
+        if (C.empty()) {
+            std::cerr << "Output ended early at beat " << b << std::endl;
+            return 1;
+        }
+        transPkt pktC = C.read();
         fp_int Cdata;
 
-        // Read output packet
-        if (!C.empty()) {
-            pktC = C.read();
-            Cdata.i = pktC.data;
-
-            // Expected result
-            float expected = (i * 1.5) + (i * 2.0);
+        for (int l = 0; l < TWOSTREAM_LANES; l++) {
+            int i = b * TWOSTREAM_LANES + l;
+            Cdata.i = pktC.data.range(32 * l + 31, 32 * l);
+            float expected = (i < LEN) ? expected_op(i * 1.5f, i * 2.0f, op, alpha) : 0.0f;
 
             // Check output
             if (std::fabs(Cdata.fp - expected) > 1e-6) {
-                std::cerr << "Test failed at index " << i << ": expected " << expected
+                std::cerr << "Test failed at index " << i << " op " << op << ": expected " << expected
                           << ", got " << Cdata.fp << std::endl;
                 return 1;
             }
         }
+        if ((int)pktC.last != (b == beats - 1)) {
+            std::cerr << "TLAST wrong at beat " << b << std::endl;
+            return 1;
+        }
+    }
+    if (!C.empty()) {
+        std::cerr << "Extra output beats" << std::endl;
+        return 1;
     }
+    return 0;
+}
+
+int main() {
+    int errors = 0;
+
+    // Every op over the full vector, by length
+    for (unsigned int op = TWOSTREAM_OP_ADD; op <= TWOSTREAM_OP_FMA; op++) {
+        errors += run(BEATS, op, TWOSTREAM_MODE_LENGTH, BEATS - 1, BEATS);
+    }
+
+    // TLAST driven with no length limit
+    errors += run(0, TWOSTREAM_OP_ADD, TWOSTREAM_MODE_TLAST, BEATS - 1, BEATS);
 
+    // Early TLAST ends the vector before the length does
+    if (BEATS > 2) {
+        errors += run(BEATS, TWOSTREAM_OP_MUL, TWOSTREAM_MODE_TLAST, 1, 2);
+    }
+
+    // Length shorter than the packet in TLAST mode: the length wins and the
+    // result is closed with TLAST
+    if (BEATS > 2) {
+        errors += run(2, TWOSTREAM_OP_SUB, TWOSTREAM_MODE_TLAST, BEATS - 1, 2);
+    }
+
+    // Zero length without TLAST does nothing
+    hls::stream<transPkt> A, B, C;
+    example(A, B, C, 0, TWOSTREAM_OP_ADD, TWOSTREAM_MODE_LENGTH, 0.0f);
+    assert(C.empty());
+
+    if (errors) {
+        std::cerr << errors << " tests failed" << std::endl;
+        return 1;
+    }
     std::cout << "Test passed successfully!" << std::endl;
     return 0;
 }
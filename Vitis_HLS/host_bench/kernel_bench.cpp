@@ -0,0 +1,370 @@
+// C-simulation throughput and regression harness for the HLS kernels.
+// Each kernel is run over many samples in frames, timed per sample and
+// checked against a plain CPU reference written so the compiler vectorizes it.
+//
+//   kernel_bench [--samples N] [--kernel smul|twostream|mm|mm_batch|mul_test|all]
+
+#include "streamAdd.h"
+#include "twoStream.h"
+#include "michaelis_menten.h"
+#include "mm_batch.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+void mul_test(int* out, int in);
+
+// Beats per kernel start, keeps the host streams small
+#define BENCH_FRAME_BEATS 4096
+
+struct BenchResult {
+    const char *name;
+    size_t samples;
+    double kernel_ns;           // Per sample: pack, kernel, unpack
+    double golden_ns;           // Per sample: CPU reference
+    size_t mismatches;
+    double max_err;
+};
+
+static double now_ns() {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const BenchResult &r) {
+    printf("%-16s %10zu samples  kernel %9.2f ns/sample  golden %7.3f ns/sample  "
+           "mismatches %zu  max_err %.3g\n",
+           r.name, r.samples, r.kernel_ns, r.golden_ns, r.mismatches, r.max_err);
+}
+
+static float bits_to_float(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static uint32_t float_to_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// Pack words [first, first + n) of `src` into lane-wide beats with TKEEP on
+// the valid lanes and TLAST on the final beat
+template <typename Pkt, int LANES>
+static int pack(hls::stream<Pkt> &s, const uint32_t *src, size_t n) {
+    int beats = (int)((n + LANES - 1) / LANES);
+    for (int b = 0; b < beats; b++) {
+        Pkt p;
+        p.data = 0;
+        p.keep = 0;
+        p.strb = 0;
+        p.user = 0;
+        p.id = 0;
+        p.dest = 0;
+        for (int l = 0; l < LANES; l++) {
+            size_t i = (size_t)b * LANES + l;
+            if (i >= n) break;
+            p.data.range(32 * l + 31, 32 * l) = src[i];
+            p.keep.range(4 * l + 3, 4 * l) = 0xF;
+            p.strb.range(4 * l + 3, 4 * l) = 0xF;
+        }
+        p.last = (b == beats - 1);
+        s.write(p);
+    }
+    return beats;
+}
+
+template <typename Pkt, int LANES>
+static void unpack(hls::stream<Pkt> &s, uint32_t *dst, size_t n) {
+    size_t i = 0;
+    while (!s.empty()) {
+        Pkt p = s.read();
+        for (int l = 0; l < LANES && i < n; l++, i++) {
+            dst[i] = (uint32_t)p.data.range(32 * l + 31, 32 * l);
+        }
+    }
+}
+
+/***** smul *****/
+static void golden_smul(const uint32_t *in, uint32_t *out, size_t n) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] * 2;
+    }
+}
+
+static BenchResult bench_smul(size_t n) {
+    std::vector<uint32_t> in(n), out(n), ref(n);
+    BenchResult r = { "smul", n, 0, 0, 0, 0 };
+    const size_t frame = (size_t)BENCH_FRAME_BEATS * SMUL_LANES;
+
+    for (size_t i = 0; i < n; i++) in[i] = (uint32_t)(i * 2654435761u);
+
+    double t0 = now_ns();
+    golden_smul(in.data(), ref.data(), n);
+    r.golden_ns = (now_ns() - t0) / n;
+
+    t0 = now_ns();
+    for (size_t f = 0; f < n; f += frame) {
+        size_t len = (n - f < frame) ? n - f : frame;
+        hls::stream<trans_pkt> is, os;
+        int beats = pack<trans_pkt, SMUL_LANES>(is, &in[f], len);
+        smul(is, os, beats);
+        unpack<trans_pkt, SMUL_LANES>(os, &out[f], len);
+    }
+    r.kernel_ns = (now_ns() - t0) / n;
+
+    for (size_t i = 0; i < n; i++) {
+        if (out[i] != ref[i]) r.mismatches++;
+    }
+    return r;
+}
+
+/***** twoStream *****/
+static void golden_twostream(const float *a, const float *b, float *c, size_t n,
+                             unsigned int op, float alpha) {
+    switch (op) {
+    case TWOSTREAM_OP_SUB:
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) c[i] = a[i] - b[i];
+        break;
+    case TWOSTREAM_OP_MUL:
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) c[i] = a[i] * b[i];
+        break;
+    case TWOSTREAM_OP_FMA:
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) c[i] = alpha * a[i] + b[i];
+        break;
+    default:
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) c[i] = a[i] + b[i];
+        break;
+    }
+}
+
+static BenchResult bench_twostream(size_t n, unsigned int op) {
+    static const char *names[] = { "twostream_add", "twostream_sub", "twostream_mul", "twostream_fma" };
+    std::vector<float> a(n), b(n), ref(n);
+    std::vector<uint32_t> abits(n), bbits(n), out(n);
+    BenchResult r = { names[op & 3], n, 0, 0, 0, 0 };
+    const size_t frame = (size_t)BENCH_FRAME_BEATS * TWOSTREAM_LANES;
+    const float alpha = 0.75f;
+
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (float)(i % 1000) * 0.25f;
+        b[i] = (float)(i % 777) * -0.5f;
+        abits[i] = float_to_bits(a[i]);
+        bbits[i] = float_to_bits(b[i]);
+    }
+
+    double t0 = now_ns();
+    golden_twostream(a.data(), b.data(), ref.data(), n, op, alpha);
+    r.golden_ns = (now_ns() - t0) / n;
+
+    t0 = now_ns();
+    for (size_t f = 0; f < n; f += frame) {
+        size_t len = (n - f < frame) ? n - f : frame;
+        hls::stream<transPkt> A, B, C;
+        int beats = pack<transPkt, TWOSTREAM_LANES>(A, &abits[f], len);
+        pack<transPkt, TWOSTREAM_LANES>(B, &bbits[f], len);
+        example(A, B, C, beats, op, TWOSTREAM_MODE_LENGTH, alpha);
+        unpack<transPkt, TWOSTREAM_LANES>(C, &out[f], len);
+    }
+    r.kernel_ns = (now_ns() - t0) / n;
+
+    // The reference may be contracted into a real FMA, allow an ulp or so
+    for (size_t i = 0; i < n; i++) {
+        double err = std::fabs((double)bits_to_float(out[i]) - ref[i]);
+        if (err > r.max_err) r.max_err = err;
+        if (err > 1e-6 * std::fabs(ref[i]) + 1e-6) r.mismatches++;
+    }
+    return r;
+}
+
+/***** michaelis_menten *****/
+static void golden_mm(const float *S, float *v, size_t n, float Vmax, float Km) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        v[i] = (Vmax * S[i]) / (Km + S[i]);
+    }
+}
+
+static double mm_tolerance(float ref) {
+    return (MM_DATAPATH == MM_DATAPATH_FIXED) ? 2e-3 : 1e-5 * std::fabs(ref) + 1e-6;
+}
+
+static BenchResult bench_mm(size_t n) {
+    std::vector<float> S(n), ref(n);
+    std::vector<uint32_t> in(n), out(n);
+    BenchResult r = { "michaelis_menten", n, 0, 0, 0, 0 };
+    const float Vmax = 15.0f, Km = 5.0f;
+
+    for (size_t i = 0; i < n; i++) {
+        S[i] = (float)(i % 100000) * 0.01f;
+        in[i] = float_to_bits(S[i]);
+    }
+
+    double t0 = now_ns();
+    golden_mm(S.data(), ref.data(), n, Vmax, Km);
+    r.golden_ns = (now_ns() - t0) / n;
+
+    t0 = now_ns();
+    for (size_t f = 0; f < n; f += BENCH_FRAME_BEATS) {
+        size_t len = (n - f < BENCH_FRAME_BEATS) ? n - f : BENCH_FRAME_BEATS;
+        hls::stream<AXI_VAL> is, os;
+        pack<AXI_VAL, 1>(is, &in[f], len);
+        michaelis_menten(is, os, Vmax, Km);
+        unpack<AXI_VAL, 1>(os, &out[f], len);
+    }
+    r.kernel_ns = (now_ns() - t0) / n;
+
+    for (size_t i = 0; i < n; i++) {
+        double err = std::fabs((double)bits_to_float(out[i]) - ref[i]);
+        if (err > r.max_err) r.max_err = err;
+        if (err > mm_tolerance(ref[i])) r.mismatches++;
+    }
+    return r;
+}
+
+/***** mm_batch *****/
+static void golden_mm_batch(const float *S, const int *ch, float *v, size_t n,
+                            const float *vmax, const float *km) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        v[i] = (vmax[ch[i]] * S[i]) / (km[ch[i]] + S[i]);
+    }
+}
+
+static BenchResult bench_mm_batch(size_t n) {
+    static float vmax[MM_BATCH_CH], km[MM_BATCH_CH];
+    std::vector<float> S(n), ref(n);
+    std::vector<int> ch(n);
+    std::vector<uint32_t> in(n), out(n);
+    BenchResult r = { "mm_batch", n, 0, 0, 0, 0 };
+    const size_t frame = (size_t)BENCH_FRAME_BEATS * MM_BATCH_LANES;
+
+    for (int c = 0; c < MM_BATCH_CH; c++) {
+        vmax[c] = 1.0f + (c % 97);
+        km[c] = 0.5f + (c % 31);
+    }
+    for (size_t i = 0; i < n; i++) {
+        S[i] = (float)(i % 10000) * 0.01f;
+        ch[i] = (int)((i * 40503u) % MM_BATCH_CH);
+        in[i] = float_to_bits(S[i]);
+    }
+
+    double t0 = now_ns();
+    golden_mm_batch(S.data(), ch.data(), ref.data(), n, vmax, km);
+    r.golden_ns = (now_ns() - t0) / n;
+
+    t0 = now_ns();
+    for (size_t f = 0; f < n; f += frame) {
+        size_t len = (n - f < frame) ? n - f : frame;
+        hls::stream<MM_BATCH_VAL> is, os;
+        // Same packing as pack() plus the channel tag of every lane
+        int beats = (int)((len + MM_BATCH_LANES - 1) / MM_BATCH_LANES);
+        for (int b = 0; b < beats; b++) {
+            MM_BATCH_VAL p;
+            p.data = 0;
+            p.keep = 0;
+            p.strb = 0;
+            p.user = 0;
+            p.id = 0;
+            p.dest = 0;
+            for (int l = 0; l < MM_BATCH_LANES; l++) {
+                size_t i = f + (size_t)b * MM_BATCH_LANES + l;
+                if (i >= f + len) break;
+                p.data.range(32 * l + 31, 32 * l) = in[i];
+                p.user.range((l + 1) * MM_BATCH_CH_BITS - 1, l * MM_BATCH_CH_BITS) = ch[i];
+                p.keep.range(4 * l + 3, 4 * l) = 0xF;
+            }
+            p.last = (b == beats - 1);
+            is.write(p);
+        }
+        // Table goes in with the first start only
+        mm_batch(is, os, vmax, km, f == 0);
+        unpack<MM_BATCH_VAL, MM_BATCH_LANES>(os, &out[f], len);
+    }
+    r.kernel_ns = (now_ns() - t0) / n;
+
+    for (size_t i = 0; i < n; i++) {
+        double err = std::fabs((double)bits_to_float(out[i]) - ref[i]);
+        if (err > r.max_err) r.max_err = err;
+        if (err > mm_tolerance(ref[i])) r.mismatches++;
+    }
+    return r;
+}
+
+/***** mul_test *****/
+static BenchResult bench_mul_test(size_t n) {
+    std::vector<int> in(n), out(n), ref(n);
+    BenchResult r = { "mul_test", n, 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < n; i++) in[i] = (int)(i % 1000000) - 500000;
+
+    double t0 = now_ns();
+    #pragma omp simd
+    for (size_t i = 0; i < n; i++) ref[i] = 2 * in[i];
+    r.golden_ns = (now_ns() - t0) / n;
+
+    t0 = now_ns();
+    for (size_t i = 0; i < n; i++) mul_test(&out[i], in[i]);
+    r.kernel_ns = (now_ns() - t0) / n;
+
+    for (size_t i = 0; i < n; i++) {
+        if (out[i] != ref[i]) r.mismatches++;
+    }
+    return r;
+}
+
+int main(int argc, char *argv[]) {
+    size_t samples = 1000000;
+    const char *kernel = "all";
+    std::vector<BenchResult> results;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            samples = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--kernel") && i + 1 < argc) {
+            kernel = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--samples N] [--kernel smul|twostream|mm|mm_batch|mul_test|all]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (samples == 0) {
+        fprintf(stderr, "--samples must be > 0\n");
+        return 2;
+    }
+
+    bool all = !strcmp(kernel, "all");
+    if (all || !strcmp(kernel, "smul")) results.push_back(bench_smul(samples));
+    if (all || !strcmp(kernel, "twostream")) {
+        for (unsigned int op = TWOSTREAM_OP_ADD; op <= TWOSTREAM_OP_FMA; op++) {
+            results.push_back(bench_twostream(samples, op));
+        }
+    }
+    if (all || !strcmp(kernel, "mm")) results.push_back(bench_mm(samples));
+    if (all || !strcmp(kernel, "mm_batch")) results.push_back(bench_mm_batch(samples));
+    if (all || !strcmp(kernel, "mul_test")) results.push_back(bench_mul_test(samples));
+
+    if (results.empty()) {
+        fprintf(stderr, "unknown kernel %s\n", kernel);
+        return 2;
+    }
+
+    printf("SMUL_LANES=%d TWOSTREAM_LANES=%d MM_DATAPATH=%d MM_BATCH_LANES=%d\n",
+           SMUL_LANES, TWOSTREAM_LANES, MM_DATAPATH, MM_BATCH_LANES);
+    size_t failed = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        report(results[i]);
+        if (results[i].mismatches) failed++;
+    }
+    return failed ? 1 : 0;
+}
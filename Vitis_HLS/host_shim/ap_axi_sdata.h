@@ -0,0 +1,30 @@
+#ifndef AP_AXI_SDATA_H
+#define AP_AXI_SDATA_H
+
+// Host-only stand-in for the Vitis ap_axi_sdata.h (see ap_int.h)
+
+#include "ap_int.h"
+
+template <int D, int U, int TI, int TD>
+struct ap_axis {
+    ap_int<D>             data;
+    ap_uint<(D + 7) / 8>  keep;
+    ap_uint<(D + 7) / 8>  strb;
+    ap_uint<U>            user;
+    ap_uint<1>            last;
+    ap_uint<TI>           id;
+    ap_uint<TD>           dest;
+};
+
+template <int D, int U, int TI, int TD>
+struct ap_axiu {
+    ap_uint<D>            data;
+    ap_uint<(D + 7) / 8>  keep;
+    ap_uint<(D + 7) / 8>  strb;
+    ap_uint<U>            user;
+    ap_uint<1>            last;
+    ap_uint<TI>           id;
+    ap_uint<TD>           dest;
+};
+
+#endif // AP_AXI_SDATA_H
@@ -0,0 +1,104 @@
+#ifndef AP_FIXED_H
+#define AP_FIXED_H
+
+// Host-only stand-in for the Vitis ap_fixed.h (see ap_int.h).
+// Default modes only: AP_TRN quantisation and AP_WRAP overflow. Values are
+// held in a long double snapped to the W/I grid, exact up to 64 significant
+// bits, which covers the full-precision products of 32-bit operands.
+
+#include <math.h>
+#include "ap_int.h"
+
+template <int W, int I, bool S>
+struct ap_fixed_base {
+    long double v;
+
+    ap_fixed_base() : v(0) {}
+    ap_fixed_base(long double x) { set(x); }
+
+    void set(long double x) {
+        long double scale = ldexpl(1.0L, W - I);
+        long double span = ldexpl(1.0L, W);
+        long double r = floorl(x * scale);          // AP_TRN
+        r = fmodl(r, span);                         // AP_WRAP
+        if (r < 0) r += span;
+        if (S && r >= span / 2) r -= span;
+        v = r / scale;
+    }
+
+    float to_float() const { return (float)v; }
+    double to_double() const { return (double)v; }
+    int to_int() const { return (int)truncl(v); }
+    long long to_int64() const { return (long long)truncl(v); }
+    int length() const { return W; }
+
+    // Raw two's complement bits, as range() returns on the real type
+    uint64_t bits() const { return (uint64_t)(long long)ldexpl(v, W - I) & (W >= 64 ? ~0ULL : ((1ULL << W) - 1)); }
+};
+
+template <int W, int I>
+struct ap_fixed : ap_fixed_base<W, I, true> {
+    typedef ap_fixed_base<W, I, true> Base;
+    ap_fixed() {}
+    ap_fixed(long double x) : Base(x) {}
+    ap_fixed(double x) : Base(x) {}
+    ap_fixed(float x) : Base(x) {}
+    ap_fixed(int x) : Base(x) {}
+    template <int W2, int I2, bool S2> ap_fixed(const ap_fixed_base<W2, I2, S2> &o) : Base(o.v) {}
+};
+
+template <int W, int I>
+struct ap_ufixed : ap_fixed_base<W, I, false> {
+    typedef ap_fixed_base<W, I, false> Base;
+    ap_ufixed() {}
+    ap_ufixed(long double x) : Base(x) {}
+    ap_ufixed(double x) : Base(x) {}
+    ap_ufixed(float x) : Base(x) {}
+    ap_ufixed(int x) : Base(x) {}
+    template <int W2, int I2, bool S2> ap_ufixed(const ap_fixed_base<W2, I2, S2> &o) : Base(o.v) {}
+};
+
+// Result types follow the full-precision rules of the real library
+#define AP_FX_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline ap_fixed<AP_FX_MAX(I1, I2) + 1 + AP_FX_MAX(W1 - I1, W2 - I2), AP_FX_MAX(I1, I2) + 1>
+operator+(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) {
+    return ap_fixed<AP_FX_MAX(I1, I2) + 1 + AP_FX_MAX(W1 - I1, W2 - I2), AP_FX_MAX(I1, I2) + 1>(a.v + b.v);
+}
+
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline ap_fixed<AP_FX_MAX(I1, I2) + 1 + AP_FX_MAX(W1 - I1, W2 - I2), AP_FX_MAX(I1, I2) + 1>
+operator-(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) {
+    return ap_fixed<AP_FX_MAX(I1, I2) + 1 + AP_FX_MAX(W1 - I1, W2 - I2), AP_FX_MAX(I1, I2) + 1>(a.v - b.v);
+}
+
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline ap_fixed<W1 + W2, I1 + I2>
+operator*(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) {
+    return ap_fixed<W1 + W2, I1 + I2>(a.v * b.v);
+}
+
+// Quotient keeps the dividend's fraction bits, integer part grows by the
+// divisor's fraction bits
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline ap_fixed<W1 + W2 - I2 + 1, I1 + W2 - I2 + 1>
+operator/(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) {
+    return ap_fixed<W1 + W2 - I2 + 1, I1 + W2 - I2 + 1>(a.v / b.v);
+}
+
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline bool operator==(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) { return a.v == b.v; }
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline bool operator!=(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) { return a.v != b.v; }
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline bool operator<(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) { return a.v < b.v; }
+template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+inline bool operator>(const ap_fixed_base<W1, I1, S1> &a, const ap_fixed_base<W2, I2, S2> &b) { return a.v > b.v; }
+
+template <int W, int I, bool S>
+inline bool operator==(const ap_fixed_base<W, I, S> &a, int b) { return a.v == b; }
+template <int W, int I, bool S>
+inline bool operator!=(const ap_fixed_base<W, I, S> &a, int b) { return a.v != b; }
+
+#endif // AP_FIXED_H
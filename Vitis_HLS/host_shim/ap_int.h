@@ -0,0 +1,150 @@
+#ifndef AP_INT_H
+#define AP_INT_H
+
+// Host-only stand-in for the Vitis ap_int.h, enough for C simulation of the
+// kernels in this repo on machines without Vitis installed.
+// Values up to 64 bits behave like the real types; wider values (512-bit
+// AXI-Stream beats) support bit/range access and conversion of the low word.
+
+#include <stdint.h>
+#include <string.h>
+
+template <int W, bool S> struct ap_int_base;
+
+// Proxy returned by range()/operator()(hi, lo), at most 64 bits wide
+template <int W, bool S>
+struct ap_range_ref {
+    ap_int_base<W, S> &v;
+    int hi, lo;
+    ap_range_ref(ap_int_base<W, S> &v_, int hi_, int lo_) : v(v_), hi(hi_), lo(lo_) {}
+    inline operator uint64_t() const;
+    inline ap_range_ref &operator=(uint64_t x);
+    inline ap_range_ref &operator=(const ap_range_ref &r) { return *this = (uint64_t)r; }
+    uint64_t to_uint64() const { return (uint64_t)*this; }
+    unsigned to_uint() const { return (unsigned)(uint64_t)*this; }
+    int to_int() const { return (int)(uint64_t)*this; }
+};
+
+// Proxy returned by operator[]
+template <int W, bool S>
+struct ap_bit_ref {
+    ap_int_base<W, S> &v;
+    int b;
+    ap_bit_ref(ap_int_base<W, S> &v_, int b_) : v(v_), b(b_) {}
+    inline operator bool() const;
+    inline ap_bit_ref &operator=(bool x);
+    inline ap_bit_ref &operator=(const ap_bit_ref &r) { return *this = (bool)r; }
+};
+
+template <int W, bool S>
+struct ap_int_base {
+    enum { NW = W > 0 ? (W + 63) / 64 : 1 };
+    uint64_t w[NW];
+
+    ap_int_base() { memset(w, 0, sizeof(w)); }
+    ap_int_base(long long x) { set(x); }
+
+    void set(long long x) {
+        for (int i = 0; i < NW; i++) {
+            w[i] = (i == 0) ? (uint64_t)x : (x < 0 ? ~0ULL : 0);
+        }
+        trim();
+    }
+    // Keep the unused top bits clear so compares and conversions stay exact
+    void trim() {
+        int r = W % 64;
+        if (W == 0) w[0] = 0;
+        else if (r) w[NW - 1] &= (~0ULL >> (64 - r));
+    }
+
+    operator long long() const {
+        uint64_t lo = w[0];
+        if (S && W > 0 && W < 64 && ((lo >> (W - 1)) & 1)) lo |= ~0ULL << W;
+        return (long long)lo;
+    }
+
+    bool get_bit(int b) const { return (w[b / 64] >> (b % 64)) & 1; }
+    void set_bit(int b, bool x) {
+        if (x) w[b / 64] |= 1ULL << (b % 64);
+        else   w[b / 64] &= ~(1ULL << (b % 64));
+    }
+    uint64_t get_range(int hi, int lo) const {
+        int n = hi - lo + 1;
+        if (lo % 64 + n <= 64) {
+            uint64_t r = w[lo / 64] >> (lo % 64);
+            return n == 64 ? r : r & ((1ULL << n) - 1);
+        }
+        uint64_t r = 0;
+        for (int b = hi; b >= lo; b--) r = (r << 1) | get_bit(b);
+        return r;
+    }
+    void set_range(int hi, int lo, uint64_t x) {
+        int n = hi - lo + 1;
+        if (lo % 64 + n <= 64) {
+            uint64_t m = (n == 64 ? ~0ULL : ((1ULL << n) - 1)) << (lo % 64);
+            w[lo / 64] = (w[lo / 64] & ~m) | ((x << (lo % 64)) & m);
+            return;
+        }
+        for (int b = lo; b <= hi; b++, x >>= 1) set_bit(b, x & 1);
+    }
+
+    ap_range_ref<W, S> range(int hi, int lo) { return ap_range_ref<W, S>(*this, hi, lo); }
+    uint64_t range(int hi, int lo) const { return get_range(hi, lo); }
+    ap_range_ref<W, S> operator()(int hi, int lo) { return range(hi, lo); }
+    uint64_t operator()(int hi, int lo) const { return get_range(hi, lo); }
+    ap_bit_ref<W, S> operator[](int b) { return ap_bit_ref<W, S>(*this, b); }
+    bool operator[](int b) const { return get_bit(b); }
+
+    int to_int() const { return (int)(long long)*this; }
+    unsigned to_uint() const { return (unsigned)(long long)*this; }
+    long long to_int64() const { return (long long)*this; }
+    unsigned long long to_uint64() const { return (unsigned long long)(long long)*this; }
+    int length() const { return W; }
+};
+
+template <int W, bool S>
+inline ap_range_ref<W, S>::operator uint64_t() const { return v.get_range(hi, lo); }
+template <int W, bool S>
+inline ap_range_ref<W, S> &ap_range_ref<W, S>::operator=(uint64_t x) { v.set_range(hi, lo, x); return *this; }
+template <int W, bool S>
+inline ap_bit_ref<W, S>::operator bool() const { return v.get_bit(b); }
+template <int W, bool S>
+inline ap_bit_ref<W, S> &ap_bit_ref<W, S>::operator=(bool x) { v.set_bit(b, x); return *this; }
+
+template <int W>
+struct ap_uint : ap_int_base<W, false> {
+    typedef ap_int_base<W, false> Base;
+    ap_uint() {}
+    ap_uint(long long x) : Base(x) {}
+    template <int W2, bool S2> ap_uint(const ap_range_ref<W2, S2> &r) : Base((long long)(uint64_t)r) {}
+    template <int W2, bool S2> ap_uint(const ap_int_base<W2, S2> &o) { copy(o); }
+    template <int W2, bool S2> void copy(const ap_int_base<W2, S2> &o) {
+        for (int i = 0; i < Base::NW; i++) {
+            this->w[i] = i < ap_int_base<W2, S2>::NW ? o.w[i]
+                       : ((long long)o < 0 && S2 ? ~0ULL : 0);
+        }
+        this->trim();
+    }
+    ap_uint &operator=(long long x) { this->set(x); return *this; }
+    template <int W2, bool S2> ap_uint &operator=(const ap_range_ref<W2, S2> &r) { this->set((long long)(uint64_t)r); return *this; }
+    ap_uint &operator+=(long long x) { this->set((long long)*this + x); return *this; }
+    ap_uint &operator-=(long long x) { this->set((long long)*this - x); return *this; }
+    ap_uint &operator*=(long long x) { this->set((long long)*this * x); return *this; }
+    ap_uint &operator++() { return *this += 1; }
+};
+
+template <int W>
+struct ap_int : ap_int_base<W, true> {
+    typedef ap_int_base<W, true> Base;
+    ap_int() {}
+    ap_int(long long x) : Base(x) {}
+    template <int W2, bool S2> ap_int(const ap_range_ref<W2, S2> &r) : Base((long long)(uint64_t)r) {}
+    ap_int &operator=(long long x) { this->set(x); return *this; }
+    template <int W2, bool S2> ap_int &operator=(const ap_range_ref<W2, S2> &r) { this->set((long long)(uint64_t)r); return *this; }
+    ap_int &operator+=(long long x) { this->set((long long)*this + x); return *this; }
+    ap_int &operator-=(long long x) { this->set((long long)*this - x); return *this; }
+    ap_int &operator*=(long long x) { this->set((long long)*this * x); return *this; }
+    ap_int &operator++() { return *this += 1; }
+};
+
+#endif // AP_INT_H
@@ -0,0 +1,19 @@
+#ifndef HLS_MATH_H
+#define HLS_MATH_H
+
+// Host-only stand-in for the Vitis hls_math.h (see ap_int.h), only the
+// functions the kernels in this repo use
+
+#include <math.h>
+
+namespace hls {
+
+inline float recip(float x) { return 1.0f / x; }
+inline double recip(double x) { return 1.0 / x; }
+
+inline float fabs(float x) { return ::fabsf(x); }
+inline double fabs(double x) { return ::fabs(x); }
+
+} // namespace hls
+
+#endif // HLS_MATH_H
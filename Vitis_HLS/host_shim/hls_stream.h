@@ -0,0 +1,50 @@
+#ifndef HLS_STREAM_H
+#define HLS_STREAM_H
+
+// Host-only stand-in for the Vitis hls_stream.h (see ap_int.h).
+// Unbounded FIFO; reading an empty stream aborts like the C simulation does.
+
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+
+namespace hls {
+
+template <typename T>
+class stream {
+public:
+    stream() {}
+    stream(const char *) {}
+
+    bool empty() const { return q.empty(); }
+    bool full() const { return false; }
+    size_t size() const { return q.size(); }
+
+    void read(T &v) { v = read(); }
+    T read() {
+        if (q.empty()) {
+            fprintf(stderr, "hls::stream read while empty\n");
+            abort();
+        }
+        T v = q.front();
+        q.pop_front();
+        return v;
+    }
+    bool read_nb(T &v) {
+        if (q.empty()) return false;
+        v = read();
+        return true;
+    }
+    void write(const T &v) { q.push_back(v); }
+    bool write_nb(const T &v) { write(v); return true; }
+
+    stream &operator>>(T &v) { read(v); return *this; }
+    stream &operator<<(const T &v) { write(v); return *this; }
+
+private:
+    std::deque<T> q;
+};
+
+} // namespace hls
+
+#endif // HLS_STREAM_H
@@ -0,0 +1,126 @@
+#include "kinetics_pipe.h"
+
+// smul output (integer count) -> substrate S as float, teed to the bypass
+static void kp_substrate(
+    hls::stream<kp_pkt>& in,
+    hls::stream<AXI_VAL>& mm_in,
+    hls::stream<kp_op_pkt>& bypass
+) {
+    substrate_loop:
+    for (bool last = false; !last; ) {
+    #pragma HLS PIPELINE II=1
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=MM_MAX_LEN
+        kp_pkt p = in.read();
+        ap_uint<32> S = mm_float_to_bits((float)p.data.to_int());
+
+        AXI_VAL m;
+        m.data = S;
+        m.keep = p.keep;
+        m.strb = p.strb;
+        m.user = 0;
+        m.id = 0;
+        m.dest = 0;
+        m.last = p.last;
+        mm_in.write(m);
+
+        kp_op_pkt b;
+        b.data = S.to_uint();
+        b.keep = p.keep;
+        b.strb = p.strb;
+        b.user = 0;
+        b.id = 0;
+        b.dest = 0;
+        b.last = p.last;
+        bypass.write(b);
+
+        last = p.last;
+    }
+}
+
+// michaelis_menten output -> twoStream A operand
+static void kp_operand(
+    hls::stream<AXI_VAL>& mm_out,
+    hls::stream<kp_op_pkt>& a
+) {
+    operand_loop:
+    for (bool last = false; !last; ) {
+    #pragma HLS PIPELINE II=1
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=MM_MAX_LEN
+        AXI_VAL m = mm_out.read();
+
+        kp_op_pkt p;
+        p.data = m.data.to_uint();
+        p.keep = m.keep;
+        p.strb = m.strb;
+        p.user = 0;
+        p.id = 0;
+        p.dest = 0;
+        p.last = m.last;
+        a.write(p);
+
+        last = m.last;
+    }
+}
+
+// twoStream result -> output stream for the S2MM side
+static void kp_output(
+    hls::stream<kp_op_pkt>& c,
+    hls::stream<kp_pkt>& Y
+) {
+    output_loop:
+    for (bool last = false; !last; ) {
+    #pragma HLS PIPELINE II=1
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=MM_MAX_LEN
+        kp_op_pkt p = c.read();
+
+        kp_pkt y;
+        y.data = p.data.range(31, 0);
+        y.keep = p.keep;
+        y.strb = p.strb;
+        y.last = p.last;
+        Y.write(y);
+
+        last = p.last;
+    }
+}
+
+void kinetics_pipe(
+    hls::stream<kp_pkt>& X,
+    hls::stream<kp_pkt>& Y,
+    unsigned int length,
+    float Vmax,
+    float Km,
+    unsigned int op,
+    float alpha
+) {
+    #pragma HLS INTERFACE axis port=X
+    #pragma HLS INTERFACE axis port=Y
+    #pragma HLS INTERFACE s_axilite port=length bundle=control
+    #pragma HLS INTERFACE s_axilite port=Vmax bundle=control
+    #pragma HLS INTERFACE s_axilite port=Km bundle=control
+    #pragma HLS INTERFACE s_axilite port=op bundle=control
+    #pragma HLS INTERFACE s_axilite port=alpha bundle=control
+    #pragma HLS INTERFACE s_axilite port=return bundle=control
+    #pragma HLS DATAFLOW
+
+    hls::stream<kp_pkt> s_smul("s_smul");
+    hls::stream<AXI_VAL> s_mm_in("s_mm_in");
+    hls::stream<AXI_VAL> s_mm_out("s_mm_out");
+    hls::stream<kp_op_pkt> s_bypass("s_bypass");
+    hls::stream<kp_op_pkt> s_a("s_a");
+    hls::stream<kp_op_pkt> s_c("s_c");
+    #pragma HLS STREAM variable=s_smul depth=KP_FIFO_DEPTH
+    #pragma HLS STREAM variable=s_mm_in depth=KP_FIFO_DEPTH
+    #pragma HLS STREAM variable=s_mm_out depth=KP_FIFO_DEPTH
+    #pragma HLS STREAM variable=s_a depth=KP_FIFO_DEPTH
+    #pragma HLS STREAM variable=s_c depth=KP_FIFO_DEPTH
+    #pragma HLS STREAM variable=s_bypass depth=KP_BYPASS_DEPTH
+
+    // smul closes the packet after `length` words, 0 leaves it to TLAST
+    smul_lanes<1>(X, s_smul, length ? length : 0xFFFFFFFFu);
+    kp_substrate(s_smul, s_mm_in, s_bypass);
+    michaelis_menten(s_mm_in, s_mm_out, Vmax, Km);
+    kp_operand(s_mm_out, s_a);
+    twostream_lanes<1>(s_a, s_bypass, s_c, 0, op, TWOSTREAM_MODE_TLAST, alpha);
+    kp_output(s_c, Y);
+}
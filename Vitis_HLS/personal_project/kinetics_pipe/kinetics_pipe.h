@@ -0,0 +1,47 @@
+#ifndef KINETICS_PIPE_H
+#define KINETICS_PIPE_H
+
+#include <hls_stream.h>
+#include <ap_axi_sdata.h>
+#include "streamAdd.h"
+#include "twoStream.h"
+#include "../michaelis_menten/michaelis_menten.h"
+
+// smul -> michaelis_menten -> twoStream as one DATAFLOW region, so the
+// intermediate results stay in on-chip FIFOs instead of going through DDR:
+//
+//   X --smul--> 2x --to float--> S --michaelis_menten--> v --+
+//                                 |                          +--twoStream--> Y
+//                                 +------------- S ---------->+
+//
+// Y = op(v, S) with the twoStream op set, e.g. MUL gives v * S and FMA
+// gives alpha * v + S. X is a packet of 32-bit integers ended by TLAST,
+// Y carries floats with the same TKEEP/TLAST.
+
+// Depth of the FIFOs between neighbouring stages
+#ifndef KP_FIFO_DEPTH
+#define KP_FIFO_DEPTH 2
+#endif
+
+// Depth of the S bypass around michaelis_menten, it must cover that
+// stage's latency or the substrate stage stalls
+#ifndef KP_BYPASS_DEPTH
+#define KP_BYPASS_DEPTH 64
+#endif
+
+// Every stage runs one 32-bit word per beat
+typedef ap_axiu<32, 0, 0, 0> kp_pkt;
+typedef ap_axis<32, 2, 5, 6> kp_op_pkt;
+
+// One start processes one packet of at most `length` words (0: until TLAST)
+void kinetics_pipe(
+    hls::stream<kp_pkt>& X,
+    hls::stream<kp_pkt>& Y,
+    unsigned int length,
+    float Vmax,
+    float Km,
+    unsigned int op,
+    float alpha
+);
+
+#endif // KINETICS_PIPE_H
@@ -0,0 +1,71 @@
+#include "kinetics_pipe.h"
+#include <iostream>
+#include <cmath>
+
+#define TB_LEN 64
+
+// Golden model of the whole chain
+static float kp_ref(int x, float Vmax, float Km, unsigned int op, float alpha) {
+    float S = (float)(2 * x);
+    float v = (Vmax * S) / (Km + S);
+    return twostream_op(v, S, op, alpha);
+}
+
+static int run(unsigned int length, int outputs, unsigned int op) {
+    hls::stream<kp_pkt> X, Y;
+    const float Vmax = 15.0f, Km = 5.0f, alpha = 0.5f;
+    int errors = 0;
+
+    for (int i = 0; i < TB_LEN; i++) {
+        kp_pkt x;
+        x.data = i;
+        x.keep = 0xF;
+        x.strb = 0xF;
+        x.last = (i == TB_LEN - 1);
+        X.write(x);
+    }
+
+    kinetics_pipe(X, Y, length, Vmax, Km, op, alpha);
+
+    for (int i = 0; i < outputs; i++) {
+        if (Y.empty()) {
+            std::cout << "Output ended early at " << i << std::endl;
+            return errors + 1;
+        }
+        kp_pkt y = Y.read();
+        float got = mm_bits_to_float(y.data);
+        float ref = kp_ref(i, Vmax, Km, op, alpha);
+        if (std::fabs(got - ref) > 1e-5 * std::fabs(ref) + 2e-3) {
+            std::cout << "Y[" << i << "] = " << got << " expected " << ref << std::endl;
+            errors++;
+        }
+        if ((int)y.last != (i == outputs - 1)) {
+            std::cout << "TLAST wrong at " << i << std::endl;
+            errors++;
+        }
+    }
+    if (!Y.empty()) {
+        std::cout << "Extra output words" << std::endl;
+        errors++;
+    }
+    return errors;
+}
+
+int main() {
+    int errors = 0;
+
+    // Whole packet through every op of the last stage, ended by TLAST
+    for (unsigned int op = TWOSTREAM_OP_ADD; op <= TWOSTREAM_OP_FMA; op++) {
+        errors += run(0, TB_LEN, op);
+    }
+
+    // Length register shorter than the packet closes every stage early
+    errors += run(10, 10, TWOSTREAM_OP_MUL);
+
+    if (errors) {
+        std::cout << "Test failed with " << errors << " errors" << std::endl;
+        return 1;
+    }
+    std::cout << "Test passed" << std::endl;
+    return 0;
+}
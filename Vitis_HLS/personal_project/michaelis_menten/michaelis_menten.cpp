@@ -13,19 +13,30 @@ void michaelis_menten(
 	#pragma HLS INTERFACE s_axilite port=Km bundle=control
     #pragma HLS INTERFACE s_axilite port=return bundle=control
 
-    while (!input_stream.empty()) {
+    // Parameters are sampled once at ap_start and held for the whole frame
+    const mm_datapath<MM_DATAPATH> dp(Vmax, Km);
+
+    // TLAST ends the frame, so the loop no longer depends on empty()
+    frame_loop:
+    for (bool last = false; !last; ) {
+    #pragma HLS PIPELINE II=1
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=MM_MAX_LEN
 
         AXI_VAL input_val = input_stream.read();
-        float S = *((float*)(&input_val.data));
+        float S = mm_bits_to_float(input_val.data);
 
-        float v = (Vmax * S) / (Km + S);
+        float v = dp.rate(S);
 
         AXI_VAL output_val;
-        output_val.data = *((int*)(&v));
+        output_val.data = mm_float_to_bits(v);
         output_val.keep = input_val.keep;
         output_val.strb = input_val.strb;
+        output_val.user = input_val.user;
+        output_val.id = input_val.id;
+        output_val.dest = input_val.dest;
         output_val.last = input_val.last;
 
         output_stream.write(output_val);
+        last = input_val.last;
     }
 }
@@ -3,10 +3,74 @@
 
 #include <hls_stream.h>
 #include <ap_axi_sdata.h>
+#include <ap_fixed.h>
+#include <hls_math.h>
 
 
 typedef ap_axiu<32, 1, 1, 1> AXI_VAL;
 
+// Datapath for v = Vmax * S / (Km + S), chosen at synthesis time.
+// The stream always carries IEEE-754 floats, only the arithmetic changes.
+#define MM_DATAPATH_DIV     0   // float multiply + float divide (reference)
+#define MM_DATAPATH_RECIP   1   // float reciprocal of (Km + S), then multiply
+#define MM_DATAPATH_FIXED   2   // ap_fixed<MM_FX_W, MM_FX_I> multiply + divide
+
+#ifndef MM_DATAPATH
+#define MM_DATAPATH MM_DATAPATH_DIV
+#endif
+
+// Fixed-point format: Q16.16 covers S, Vmax, Km in [0, 32768)
+#define MM_FX_W 32
+#define MM_FX_I 16
+typedef ap_fixed<MM_FX_W, MM_FX_I> mm_fixed_t;
+
+// Longest frame expected per start, only used as the loop tripcount hint
+#define MM_MAX_LEN 4096
+
+// Bit-exact float <-> stream word conversion without pointer casts
+inline float mm_bits_to_float(ap_uint<32> bits) {
+    union { unsigned int u; float f; } c;
+    c.u = bits.to_uint();
+    return c.f;
+}
+
+inline ap_uint<32> mm_float_to_bits(float f) {
+    union { unsigned int u; float f; } c;
+    c.f = f;
+    return c.u;
+}
+
+// Vmax and Km are latched into the datapath once per frame
+template <int DP>
+struct mm_datapath {
+    float vmax, km;
+    mm_datapath(float Vmax, float Km) : vmax(Vmax), km(Km) {}
+    float rate(float S) const { return (vmax * S) / (km + S); }
+};
+
+template <>
+struct mm_datapath<MM_DATAPATH_RECIP> {
+    float vmax, km;
+    mm_datapath(float Vmax, float Km) : vmax(Vmax), km(Km) {}
+    // Reciprocal core is smaller and shorter than the divider, the
+    // Vmax * S product runs alongside it
+    float rate(float S) const { return (vmax * S) * hls::recip(km + S); }
+};
+
+template <>
+struct mm_datapath<MM_DATAPATH_FIXED> {
+    mm_fixed_t vmax, km;
+    mm_datapath(float Vmax, float Km) : vmax(Vmax), km(Km) {}
+    float rate(float S) const {
+        mm_fixed_t s = S;
+        ap_fixed<2 * MM_FX_W, 2 * MM_FX_I> num = vmax * s;
+        ap_fixed<MM_FX_W + 1, MM_FX_I + 1> den = km + s;
+        mm_fixed_t v = (den == 0) ? mm_fixed_t(0) : mm_fixed_t(num / den);
+        return v.to_float();
+    }
+};
+
+// One start processes one frame of S samples, ending on TLAST
 void michaelis_menten(
     hls::stream<AXI_VAL>& input_stream,
     hls::stream<AXI_VAL>& output_stream,
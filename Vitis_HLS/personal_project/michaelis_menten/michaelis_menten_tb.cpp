@@ -1,39 +1,139 @@
 #include "michaelis_menten.h"
 #include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <ctime>
 
-int main() {
-    hls::stream<AXI_VAL> input_stream;
-    hls::stream<AXI_VAL> output_stream;
+#define SWEEP_LEN 4096
 
-    float Vmax = 15.0;
-    float Km = 5.0;
-    float S_array[] = {3.0, 5.0, 10.0, 15.0};
-    int array_size = sizeof(S_array) / sizeof(S_array[0]);
+static double mm_ref(double S, double Vmax, double Km) {
+    return (Vmax * S) / (Km + S);
+}
 
-    AXI_VAL input_val;
-    input_val.data = *((int*)(&Vmax));
-    input_val.keep = -1;
-    input_val.strb = -1;
-    input_val.last = 0;
-    input_stream.write(input_val);
+// Worst-case error a datapath may show against the double reference
+static double mm_tolerance(int dp, double ref) {
+    if (dp == MM_DATAPATH_FIXED) {
+        return 2e-3;                        // Q16.16 quantisation of S and v
+    }
+    return 1e-5 * std::fabs(ref) + 1e-6;    // A few float ulps
+}
 
-    input_val.data = *((int*)(&Km));
-    input_val.last = 0;
-    input_stream.write(input_val);
+// Push one frame through the kernel and check it against the reference
+static int run_frame(float Vmax, float Km, const float *S, int n) {
+    hls::stream<AXI_VAL> input_stream;
+    hls::stream<AXI_VAL> output_stream;
+    int errors = 0;
 
-    for (int i = 0; i < array_size; i++) {
-        input_val.data = *((int*)(&S_array[i]));
-        input_val.last = (i == array_size - 1) ? 1 : 0;
+    for (int i = 0; i < n; i++) {
+        AXI_VAL input_val;
+        input_val.data = mm_float_to_bits(S[i]);
+        input_val.keep = -1;
+        input_val.strb = -1;
+        input_val.user = 0;
+        input_val.id = 0;
+        input_val.dest = 0;
+        input_val.last = (i == n - 1) ? 1 : 0;
         input_stream.write(input_val);
     }
 
     michaelis_menten(input_stream, output_stream, Vmax, Km);
 
-    for (int i = 0; i < array_size; i++) {
+    for (int i = 0; i < n; i++) {
+        if (output_stream.empty()) {
+            std::cout << "Frame ended early at " << i << std::endl;
+            return errors + 1;
+        }
         AXI_VAL output_val = output_stream.read();
-        float v = *((float*)(&output_val.data));
-        std::cout << "Output v[" << i << "] = " << v << std::endl;
+        float v = mm_bits_to_float(output_val.data);
+        double ref = mm_ref(S[i], Vmax, Km);
+        std::cout << "Output v[" << i << "] = " << v << " (ref " << ref << ")" << std::endl;
+
+        if (std::fabs(v - ref) > mm_tolerance(MM_DATAPATH, ref)) {
+            std::cout << "  mismatch" << std::endl;
+            errors++;
+        }
+        if ((int)output_val.last != (i == n - 1)) {
+            std::cout << "  TLAST wrong" << std::endl;
+            errors++;
+        }
+        if (output_val.keep != 0xF) {
+            std::cout << "  TKEEP not passed through" << std::endl;
+            errors++;
+        }
+    }
+    if (!output_stream.empty()) {
+        std::cout << "Extra output beats" << std::endl;
+        errors++;
     }
+    return errors;
+}
+
+// Accuracy and C-sim speed of one datapath over a log sweep of S. There is
+// no II column, C simulation cannot measure it: every datapath is pipelined
+// at II=1 by the PIPELINE pragma in michaelis_menten.cpp, and the II each one
+// achieves is in its csynth report. They differ in latency and resources.
+template <int DP>
+static int report_datapath(const char *name, float Vmax, float Km, const float *S, int n) {
+    const mm_datapath<DP> dp(Vmax, Km);
+    static float v[SWEEP_LEN];
+    double max_abs = 0, max_rel = 0, sum_abs = 0;
+    int errors = 0;
 
+    clock_t t0 = clock();
+    for (int rep = 0; rep < 100; rep++) {
+        for (int i = 0; i < n; i++) {
+            v[i] = dp.rate(S[i]);
+        }
+    }
+    double ns = (double)(clock() - t0) * 1e9 / CLOCKS_PER_SEC / (100.0 * n);
+
+    for (int i = 0; i < n; i++) {
+        double ref = mm_ref(S[i], Vmax, Km);
+        double err = std::fabs(v[i] - ref);
+        if (err > max_abs) max_abs = err;
+        if (ref != 0 && err / std::fabs(ref) > max_rel) max_rel = err / std::fabs(ref);
+        sum_abs += err;
+        if (err > mm_tolerance(DP, ref)) errors++;
+    }
+
+    std::cout << std::left << std::setw(8) << name << std::right
+              << std::scientific << std::setprecision(3)
+              << std::setw(12) << max_abs
+              << std::setw(12) << sum_abs / n
+              << std::setw(12) << max_rel
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << ns
+              << std::setw(8) << errors << std::endl;
+    return errors;
+}
+
+int main() {
+    int errors = 0;
+
+    // Two frames back to back, each start latches its own Vmax and Km
+    float S_array[] = {3.0, 5.0, 10.0, 15.0};
+    int array_size = sizeof(S_array) / sizeof(S_array[0]);
+    errors += run_frame(15.0f, 5.0f, S_array, array_size);
+    errors += run_frame(2.5f, 0.75f, S_array, array_size);
+
+    // Single-beat frame
+    float S_one[] = {1.0f};
+    errors += run_frame(15.0f, 5.0f, S_one, 1);
+
+    // Side-by-side accuracy against the double reference
+    static float sweep[SWEEP_LEN];
+    for (int i = 0; i < SWEEP_LEN; i++) {
+        sweep[i] = (float)(0.01 * std::pow(1e5, (double)i / (SWEEP_LEN - 1)));  // 0.01 .. 1000
+    }
+    std::cout << std::endl << "Datapath  max_abs     mean_abs    max_rel     csim_ns  errors" << std::endl;
+    errors += report_datapath<MM_DATAPATH_DIV>("div", 15.0f, 5.0f, sweep, SWEEP_LEN);
+    errors += report_datapath<MM_DATAPATH_RECIP>("recip", 15.0f, 5.0f, sweep, SWEEP_LEN);
+    errors += report_datapath<MM_DATAPATH_FIXED>("fixed", 15.0f, 5.0f, sweep, SWEEP_LEN);
+
+    if (errors) {
+        std::cout << "Test failed with " << errors << " errors" << std::endl;
+        return 1;
+    }
+    std::cout << "Test passed (datapath " << MM_DATAPATH << ")" << std::endl;
     return 0;
 }
@@ -0,0 +1,63 @@
+#include "mm_batch.h"
+
+// Batched Michaelis-Menten function definition
+void mm_batch(
+    hls::stream<MM_BATCH_VAL>& input_stream,
+    hls::stream<MM_BATCH_VAL>& output_stream,
+    float vmax_table[MM_BATCH_CH],
+    float km_table[MM_BATCH_CH],
+    unsigned int load
+) {
+    #pragma HLS INTERFACE axis port=input_stream
+    #pragma HLS INTERFACE axis port=output_stream
+    #pragma HLS INTERFACE s_axilite port=vmax_table bundle=control
+    #pragma HLS INTERFACE s_axilite port=km_table bundle=control
+    #pragma HLS INTERFACE s_axilite port=load bundle=control
+    #pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    // One copy of the table per lane so every lane has its own read port,
+    // kept across starts
+    static float vmax_lane[MM_BATCH_LANES][MM_BATCH_CH];
+    static float km_lane[MM_BATCH_LANES][MM_BATCH_CH];
+    #pragma HLS ARRAY_PARTITION variable=vmax_lane dim=1 complete
+    #pragma HLS ARRAY_PARTITION variable=km_lane dim=1 complete
+
+    if (load) {
+        load_loop:
+        for (int c = 0; c < MM_BATCH_CH; c++) {
+        #pragma HLS PIPELINE II=1
+            float vmax = vmax_table[c];
+            float km = km_table[c];
+            for (int l = 0; l < MM_BATCH_LANES; l++) {
+            #pragma HLS UNROLL
+                vmax_lane[l][c] = vmax;
+                km_lane[l][c] = km;
+            }
+        }
+    }
+
+    frame_loop:
+    for (bool last = false; !last; ) {
+    #pragma HLS PIPELINE II=1
+    #pragma HLS LOOP_TRIPCOUNT min=1 max=MM_MAX_LEN
+
+        MM_BATCH_VAL beat = input_stream.read();
+
+        lane_loop:
+        for (int l = 0; l < MM_BATCH_LANES; l++) {
+        #pragma HLS UNROLL
+            ap_uint<MM_BATCH_CH_BITS> ch = beat.user.range((l + 1) * MM_BATCH_CH_BITS - 1, l * MM_BATCH_CH_BITS);
+            ap_uint<4> keep = beat.keep.range(4 * l + 3, 4 * l);
+            const mm_datapath<MM_DATAPATH> dp(vmax_lane[l][ch], km_lane[l][ch]);
+            float S = mm_bits_to_float(beat.data.range(32 * l + 31, 32 * l));
+
+            // Lanes past the end of a partial final beat stay zero
+            float v = (keep != 0) ? dp.rate(S) : 0.0f;
+            beat.data.range(32 * l + 31, 32 * l) = mm_float_to_bits(v);
+        }
+
+        // keep/strb/user/last pass through, so the channel tags follow the results
+        output_stream.write(beat);
+        last = beat.last;
+    }
+}
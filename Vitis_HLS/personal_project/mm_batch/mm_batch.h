@@ -0,0 +1,38 @@
+#ifndef MM_BATCH_H
+#define MM_BATCH_H
+
+#include <hls_stream.h>
+#include <ap_axi_sdata.h>
+#include "../michaelis_menten/michaelis_menten.h"
+
+// Batched Michaelis-Menten: many (Vmax, Km) sets held in an on-chip table,
+// every sample picks its set through the channel index in TUSER.
+
+// Samples per beat, each with its own compute lane and table copy
+#ifndef MM_BATCH_LANES
+#define MM_BATCH_LANES 4
+#endif
+
+// Channel index width per lane, the table has 2^MM_BATCH_CH_BITS entries
+#ifndef MM_BATCH_CH_BITS
+#define MM_BATCH_CH_BITS 10
+#endif
+#define MM_BATCH_CH (1 << MM_BATCH_CH_BITS)
+
+// AXI_VAL's 1-bit TUSER/TID only address two channels, so the batch stream
+// widens TUSER to one channel field per lane: lane l uses
+// user[(l+1)*MM_BATCH_CH_BITS-1 : l*MM_BATCH_CH_BITS]
+typedef ap_axiu<32 * MM_BATCH_LANES, MM_BATCH_LANES * MM_BATCH_CH_BITS, 1, 1> MM_BATCH_VAL;
+
+// One start processes one TLAST-terminated frame. With `load` set the
+// parameter tables are first copied from the AXI-Lite arrays into the
+// lane-local BRAMs; later starts reuse them with load = 0.
+void mm_batch(
+    hls::stream<MM_BATCH_VAL>& input_stream,
+    hls::stream<MM_BATCH_VAL>& output_stream,
+    float vmax_table[MM_BATCH_CH],
+    float km_table[MM_BATCH_CH],
+    unsigned int load
+);
+
+#endif // MM_BATCH_H
@@ -0,0 +1,140 @@
+#include "mm_batch.h"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#define TB_SAMPLES  1001    // Not a multiple of the lane count: partial last beat
+
+static float vmax_table[MM_BATCH_CH];
+static float km_table[MM_BATCH_CH];
+
+static void fill_tables(unsigned seed) {
+    srand(seed);
+    for (int c = 0; c < MM_BATCH_CH; c++) {
+        vmax_table[c] = 1.0f + (rand() % 1000) / 10.0f;
+        km_table[c] = 0.5f + (rand() % 500) / 10.0f;
+    }
+}
+
+// One frame of random (channel, S) samples, checked against the double reference
+static int run_frame(unsigned int load, unsigned seed) {
+    hls::stream<MM_BATCH_VAL> input_stream;
+    hls::stream<MM_BATCH_VAL> output_stream;
+    static int ch[TB_SAMPLES];
+    static float S[TB_SAMPLES];
+    const int beats = (TB_SAMPLES + MM_BATCH_LANES - 1) / MM_BATCH_LANES;
+    int errors = 0;
+
+    srand(seed);
+    for (int i = 0; i < TB_SAMPLES; i++) {
+        ch[i] = rand() % MM_BATCH_CH;
+        S[i] = (rand() % 10000) / 100.0f;
+    }
+
+    for (int b = 0; b < beats; b++) {
+        MM_BATCH_VAL beat;
+        beat.data = 0;
+        beat.keep = 0;
+        beat.strb = 0;
+        beat.user = 0;
+        beat.id = 0;
+        beat.dest = 0;
+        for (int l = 0; l < MM_BATCH_LANES; l++) {
+            int i = b * MM_BATCH_LANES + l;
+            if (i >= TB_SAMPLES) break;
+            beat.data.range(32 * l + 31, 32 * l) = mm_float_to_bits(S[i]);
+            beat.user.range((l + 1) * MM_BATCH_CH_BITS - 1, l * MM_BATCH_CH_BITS) = ch[i];
+            beat.keep.range(4 * l + 3, 4 * l) = 0xF;
+            beat.strb.range(4 * l + 3, 4 * l) = 0xF;
+        }
+        beat.last = (b == beats - 1);
+        input_stream.write(beat);
+    }
+
+    mm_batch(input_stream, output_stream, vmax_table, km_table, load);
+
+    for (int b = 0; b < beats; b++) {
+        if (output_stream.empty()) {
+            std::cout << "Frame ended early at beat " << b << std::endl;
+            return errors + 1;
+        }
+        MM_BATCH_VAL beat = output_stream.read();
+        for (int l = 0; l < MM_BATCH_LANES; l++) {
+            int i = b * MM_BATCH_LANES + l;
+            float v = mm_bits_to_float(beat.data.range(32 * l + 31, 32 * l));
+            if (i >= TB_SAMPLES) {
+                if (v != 0.0f || beat.keep.range(4 * l + 3, 4 * l) != 0) {
+                    std::cout << "Lane " << l << " of the last beat not empty" << std::endl;
+                    errors++;
+                }
+                continue;
+            }
+            int out_ch = (int)beat.user.range((l + 1) * MM_BATCH_CH_BITS - 1, l * MM_BATCH_CH_BITS);
+            double ref = (double)vmax_table[ch[i]] * S[i] / ((double)km_table[ch[i]] + S[i]);
+            double tol = (MM_DATAPATH == MM_DATAPATH_FIXED) ? 2e-3 : 1e-5 * std::fabs(ref) + 1e-6;
+            if (out_ch != ch[i]) {
+                std::cout << "Sample " << i << ": channel tag " << out_ch << " expected " << ch[i] << std::endl;
+                errors++;
+            }
+            if (std::fabs(v - ref) > tol) {
+                std::cout << "Sample " << i << " ch " << ch[i] << ": v = " << v << " expected " << ref << std::endl;
+                errors++;
+            }
+        }
+        if ((int)beat.last != (b == beats - 1)) {
+            std::cout << "TLAST wrong on beat " << b << std::endl;
+            errors++;
+        }
+    }
+    if (!output_stream.empty()) {
+        std::cout << "Extra output beats" << std::endl;
+        errors++;
+    }
+    return errors;
+}
+
+int main() {
+    int errors = 0;
+
+    // Load once, then run frames against the resident table
+    fill_tables(1);
+    errors += run_frame(1, 100);
+    errors += run_frame(0, 101);
+
+    // The AXI-Lite arrays change but load = 0: the BRAM copy must be used
+    float saved_vmax[MM_BATCH_CH];
+    for (int c = 0; c < MM_BATCH_CH; c++) {
+        saved_vmax[c] = vmax_table[c];
+        vmax_table[c] = -1.0f;
+    }
+    hls::stream<MM_BATCH_VAL> in, out;
+    MM_BATCH_VAL beat;
+    beat.data = 0;
+    beat.data.range(31, 0) = mm_float_to_bits(10.0f);
+    beat.keep = 0xF;
+    beat.strb = 0xF;
+    beat.user = 7;
+    beat.last = 1;
+    in.write(beat);
+    mm_batch(in, out, vmax_table, km_table, 0);
+    float v = mm_bits_to_float(out.read().data.range(31, 0));
+    if (std::fabs(v - saved_vmax[7] * 10.0f / (km_table[7] + 10.0f)) > 2e-3) {
+        std::cout << "Resident table was not used: v = " << v << std::endl;
+        errors++;
+    }
+
+    // Reload with a new parameter set
+    fill_tables(2);
+    errors += run_frame(1, 102);
+
+    std::cout << MM_BATCH_LANES << " lanes, " << MM_BATCH_CH << " channels: "
+              << MM_BATCH_LANES << " samples per clock at II=1, "
+              << MM_BATCH_CH << " cycles to load the table" << std::endl;
+
+    if (errors) {
+        std::cout << "Test failed with " << errors << " errors" << std::endl;
+        return 1;
+    }
+    std::cout << "Test passed" << std::endl;
+    return 0;
+}